@@ -11,5 +11,6 @@ public class KiwiJam2025Target : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_5;
 		ExtraModuleNames.Add("KiwiJam2025");
+		ExtraModuleNames.Add("KiwiJam2025UI");
 	}
 }
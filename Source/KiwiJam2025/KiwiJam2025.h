@@ -3,3 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// stat KiwiJam
+DECLARE_STATS_GROUP(TEXT("KiwiJam"), STATGROUP_KiwiJam, STATCAT_Advanced);
@@ -0,0 +1,367 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Audio/ParkourAudio.h"
+#include "KiwiJam2025.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundAttenuation.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "Containers/Ticker.h"
+#include "UObject/UObjectIterator.h"
+
+DEFINE_LOG_CATEGORY(LogParkourAudio);
+
+DECLARE_CYCLE_STAT(TEXT("Audio Event"), STAT_ParkourAudioEvent, STATGROUP_KiwiJam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Events Played"), STAT_ParkourAudioPlayed, STATGROUP_KiwiJam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Events Out Of Range"), STAT_ParkourAudioCulled, STATGROUP_KiwiJam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Events Over Limit"), STAT_ParkourAudioLimited, STATGROUP_KiwiJam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Voices Stolen"), STAT_ParkourAudioStolen, STATGROUP_KiwiJam);
+
+// Loops can't be pooled as one-shots; they get this long before the voice counts as free
+static constexpr float MaxVoiceDuration = 10.f;
+
+UParkourAudioData::UParkourAudioData()
+{
+	Categories.SetNum((int32)EParkourAudioCategory::Count);
+	for (int32 Index = 0; Index < Categories.Num(); ++Index)
+	{
+		Categories[Index].Category = (EParkourAudioCategory)Index;
+	}
+
+	// Automatic fire wants more overlap than footfalls and grabs
+	Categories[(int32)EParkourAudioCategory::Weapon].MaxVoices = 8;
+}
+
+bool UParkourAudioSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UParkourAudioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    if (UParkourEventBus* Events = Collection.InitializeDependency<UParkourEventBus>())
+    {
+        VaultHandle = Events->OnEvents<FParkourVaultEvent>(EParkourEventPhase::FrameEnd).AddUObject(this, &UParkourAudioSubsystem::HandleVaults);
+        ClimbHandle = Events->OnEvents<FParkourClimbEvent>(EParkourEventPhase::FrameEnd).AddUObject(this, &UParkourAudioSubsystem::HandleClimbs);
+        LandedHandle = Events->OnEvents<FParkourLandedEvent>(EParkourEventPhase::FrameEnd).AddUObject(this, &UParkourAudioSubsystem::HandleLandings);
+    }
+}
+
+void UParkourAudioSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    if (InWorld.GetNetMode() == NM_DedicatedServer || AudioData.IsNull()) return;
+
+    if (AudioData.Get())
+    {
+        OnAudioDataLoaded();
+        return;
+    }
+
+    TWeakObjectPtr<UParkourAudioSubsystem> WeakThis(this);
+    UAssetManager::GetStreamableManager().RequestAsyncLoad(AudioData.ToSoftObjectPath(), [WeakThis]()
+        {
+            if (WeakThis.IsValid())
+            {
+                WeakThis->OnAudioDataLoaded();
+            }
+        });
+}
+
+void UParkourAudioSubsystem::OnAudioDataLoaded()
+{
+    LoadedAudioData = AudioData.Get();
+    UWorld* World = GetWorld();
+    if (!LoadedAudioData || !World || Pool.Num() > 0) return;
+
+    for (int32& Index : EventDefIndex)
+    {
+        Index = INDEX_NONE;
+    }
+    for (int32 Index = 0; Index < LoadedAudioData->Events.Num(); ++Index)
+    {
+        EventDefIndex[(int32)LoadedAudioData->Events[Index].Event] = Index;
+    }
+
+    for (int32 Index = 0; Index < (int32)EParkourAudioCategory::Count; ++Index)
+    {
+        CategoryDefs[Index] = LoadedAudioData->Categories.IsValidIndex(Index) ? LoadedAudioData->Categories[Index] : FParkourAudioCategoryDef();
+        CategoryDefs[Index].MaxVoices = FMath::Max(1, CategoryDefs[Index].MaxVoices);
+    }
+
+    // Every component this layer will ever use, owned by the world settings so they live as long as the level
+    AActor* Owner = World->GetWorldSettings();
+    const int32 PoolSize = FMath::Clamp(LoadedAudioData->PoolSize, 1, 128);
+    Pool.Reserve(PoolSize);
+    Voices.SetNum(PoolSize);
+    for (int32 Index = 0; Index < PoolSize; ++Index)
+    {
+        UAudioComponent* Component = NewObject<UAudioComponent>(Owner, NAME_None, RF_Transient);
+        Component->bAutoActivate = false;
+        Component->bAutoDestroy = false;
+        Component->bAllowSpatialization = true;
+        Component->bIsUISound = false;
+        Component->AttenuationSettings = LoadedAudioData->DefaultAttenuation;
+        Component->RegisterComponentWithWorld(World);
+        Pool.Add(Component);
+    }
+
+    PitchRandom.Initialize(1234);
+
+    UE_LOG(LogParkourAudio, Log, TEXT("Audio pool ready: %d voices, %d events"), PoolSize, LoadedAudioData->Events.Num());
+}
+
+void UParkourAudioSubsystem::Deinitialize()
+{
+    for (UAudioComponent* Component : Pool)
+    {
+        if (Component)
+        {
+            Component->Stop();
+            Component->DestroyComponent();
+        }
+    }
+    Pool.Reset();
+    Voices.Reset();
+
+    if (UParkourEventBus* Events = GetWorld() ? GetWorld()->GetSubsystem<UParkourEventBus>() : nullptr)
+    {
+        Events->OnEvents<FParkourVaultEvent>(EParkourEventPhase::FrameEnd).Remove(VaultHandle);
+        Events->OnEvents<FParkourClimbEvent>(EParkourEventPhase::FrameEnd).Remove(ClimbHandle);
+        Events->OnEvents<FParkourLandedEvent>(EParkourEventPhase::FrameEnd).Remove(LandedHandle);
+    }
+
+    Super::Deinitialize();
+}
+
+void UParkourAudioSubsystem::HandleVaults(TConstArrayView<FParkourVaultEvent> Batch)
+{
+    for (const FParkourVaultEvent& Event : Batch)
+    {
+        PlayEvent(EParkourAudioEvent::Vault, FVector(Event.Location), Event.Surface);
+    }
+}
+
+void UParkourAudioSubsystem::HandleClimbs(TConstArrayView<FParkourClimbEvent> Batch)
+{
+    for (const FParkourClimbEvent& Event : Batch)
+    {
+        PlayEvent(Event.bHang ? EParkourAudioEvent::LedgeGrab : EParkourAudioEvent::Climb, FVector(Event.Location), Event.Surface);
+    }
+}
+
+void UParkourAudioSubsystem::HandleLandings(TConstArrayView<FParkourLandedEvent> Batch)
+{
+    for (const FParkourLandedEvent& Event : Batch)
+    {
+        PlayEvent(EParkourAudioEvent::Land, FVector(Event.Location), Event.Surface);
+    }
+}
+
+bool UParkourAudioSubsystem::Play(const UWorld* World, EParkourAudioEvent Event, const FVector& Location, EPhysicalSurface Surface, USoundBase* FallbackSound)
+{
+    UParkourAudioSubsystem* Audio = World ? World->GetSubsystem<UParkourAudioSubsystem>() : nullptr;
+    return Audio && Audio->PlayEvent(Event, Location, Surface, FallbackSound);
+}
+
+bool UParkourAudioSubsystem::PlayEvent(EParkourAudioEvent Event, const FVector& Location, EPhysicalSurface Surface, USoundBase* FallbackSound)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ParkourAudioEvent);
+
+    if (Pool.Num() == 0) return false;
+
+    const int32 DefIndex = EventDefIndex[(int32)Event];
+    const FParkourAudioEventDef* Def = DefIndex != INDEX_NONE ? &LoadedAudioData->Events[DefIndex] : nullptr;
+
+    USoundBase* Sound = FallbackSound;
+    if (Def)
+    {
+        const TObjectPtr<USoundBase>* SurfaceSound = Def->SurfaceSounds.Find(Surface);
+        Sound = SurfaceSound && *SurfaceSound ? SurfaceSound->Get() : Def->DefaultSound ? Def->DefaultSound.Get() : FallbackSound;
+    }
+    if (!Sound) return false;
+
+    // Out of earshot: done before any pool work
+    const float MaxDistance = Def ? Def->MaxDistance : 3000.f;
+    if (const APlayerController* PC = GetWorld()->GetFirstPlayerController())
+    {
+        FVector ListenerLocation, ListenerFront, ListenerRight;
+        PC->GetAudioListenerPosition(ListenerLocation, ListenerFront, ListenerRight);
+        if (FVector::DistSquared(ListenerLocation, Location) > FMath::Square(MaxDistance))
+        {
+            INC_DWORD_STAT(STAT_ParkourAudioCulled);
+            return false;
+        }
+    }
+
+    const EParkourAudioCategory Category = Def ? Def->Category : Event == EParkourAudioEvent::WeaponFire ? EParkourAudioCategory::Weapon : EParkourAudioCategory::Traversal;
+    const FParkourAudioCategoryDef& CategoryDef = CategoryDefs[(int32)Category];
+
+    // One pass over the pool: a free voice, the category's count and the oldest voices to steal
+    const double Now = GetWorld()->GetAudioTimeSeconds();
+    int32 Free = INDEX_NONE;
+    int32 OldestInCategory = INDEX_NONE;
+    int32 OldestOverall = INDEX_NONE;
+    int32 InCategory = 0;
+    for (int32 Index = 0; Index < Voices.Num(); ++Index)
+    {
+        const FVoice& Voice = Voices[Index];
+        if (Voice.EndTime <= Now)
+        {
+            if (Free == INDEX_NONE) Free = Index;
+            continue;
+        }
+
+        if (OldestOverall == INDEX_NONE || Voice.StartTime < Voices[OldestOverall].StartTime) OldestOverall = Index;
+        if (Voice.Category == Category)
+        {
+            ++InCategory;
+            if (OldestInCategory == INDEX_NONE || Voice.StartTime < Voices[OldestInCategory].StartTime) OldestInCategory = Index;
+        }
+    }
+
+    int32 Chosen = Free;
+    if (InCategory >= CategoryDef.MaxVoices)
+    {
+        if (!CategoryDef.bStealOldest)
+        {
+            INC_DWORD_STAT(STAT_ParkourAudioLimited);
+            return false;
+        }
+        Chosen = OldestInCategory;
+    }
+    else if (Free == INDEX_NONE)
+    {
+        Chosen = OldestOverall;
+    }
+
+    UAudioComponent* Component = Pool[Chosen];
+    if (Chosen != Free)
+    {
+        Component->Stop();
+        INC_DWORD_STAT(STAT_ParkourAudioStolen);
+    }
+
+    const float Variance = Def ? Def->PitchVariance : 0.f;
+    const float Pitch = 1.f + (Variance > 0.f ? PitchRandom.FRandRange(-Variance, Variance) : 0.f);
+
+    Component->SetSound(Sound);
+    Component->SetWorldLocation(Location);
+    Component->SetVolumeMultiplier(Def ? Def->VolumeMultiplier : 1.f);
+    Component->SetPitchMultiplier(Pitch);
+    Component->Play();
+
+    FVoice& Voice = Voices[Chosen];
+    Voice.StartTime = Now;
+    Voice.EndTime = Now + FMath::Min(Sound->GetDuration(), MaxVoiceDuration) / Pitch;
+    Voice.Category = Category;
+
+    INC_DWORD_STAT(STAT_ParkourAudioPlayed);
+    return true;
+}
+
+int32 UParkourAudioSubsystem::GetActiveVoices(EParkourAudioCategory Category) const
+{
+    const double Now = GetWorld()->GetAudioTimeSeconds();
+    int32 Count = 0;
+    for (const FVoice& Voice : Voices)
+    {
+        if (Voice.EndTime > Now && (Category == EParkourAudioCategory::Count || Voice.Category == Category))
+        {
+            ++Count;
+        }
+    }
+    return Count;
+}
+
+namespace ParkourAudio
+{
+    static FTSTicker::FDelegateHandle TickHandle;
+
+    static int32 CountAudioComponents(const UWorld* World)
+    {
+        int32 Count = 0;
+        for (TObjectIterator<UAudioComponent> It; It; ++It)
+        {
+            Count += It->GetWorld() == World ? 1 : 0;
+        }
+        return Count;
+    }
+
+    // Automatic fire plus a traversal event every half second in front of the listener.
+    // Checks that no audio components get created and voices stay within the pool and limits.
+    static void Run(UWorld* World, float Seconds, float ShotsPerSecond)
+    {
+        UParkourAudioSubsystem* Audio = World->GetSubsystem<UParkourAudioSubsystem>();
+        if (!Audio || !Audio->IsReady())
+        {
+            UE_LOG(LogParkourAudio, Warning, TEXT("[AudioBench] No audio pool, set AudioData on UParkourAudioSubsystem in DefaultGame.ini"));
+            return;
+        }
+
+        FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+        const int32 StartComponents = CountAudioComponents(World);
+        const double StartTime = FPlatformTime::Seconds();
+        TSharedRef<double> ShotBudget = MakeShared<double>(0.0);
+        TSharedRef<double> TraversalBudget = MakeShared<double>(0.0);
+        TSharedRef<int32> Requested = MakeShared<int32>(0);
+        TSharedRef<int32> Started = MakeShared<int32>(0);
+        TSharedRef<int32> MaxVoices = MakeShared<int32>(0);
+        TWeakObjectPtr<UWorld> WeakWorld(World);
+
+        TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+            [WeakWorld, Seconds, ShotsPerSecond, StartComponents, StartTime, ShotBudget, TraversalBudget, Requested, Started, MaxVoices](float DeltaTime)
+            {
+                UWorld* World = WeakWorld.Get();
+                UParkourAudioSubsystem* Audio = World ? World->GetSubsystem<UParkourAudioSubsystem>() : nullptr;
+                const APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+                if (!Audio || !PC) return false;
+
+                FVector Listener, Front, Right;
+                PC->GetAudioListenerPosition(Listener, Front, Right);
+
+                for (*ShotBudget += DeltaTime * ShotsPerSecond; *ShotBudget >= 1.0; *ShotBudget -= 1.0)
+                {
+                    ++*Requested;
+                    *Started += Audio->PlayEvent(EParkourAudioEvent::WeaponFire, Listener + Front * 50.f) ? 1 : 0;
+                }
+                for (*TraversalBudget += DeltaTime * 2.0; *TraversalBudget >= 1.0; *TraversalBudget -= 1.0)
+                {
+                    ++*Requested;
+                    *Started += Audio->PlayEvent(EParkourAudioEvent::Vault, Listener + Front * 100.f) ? 1 : 0;
+                }
+
+                *MaxVoices = FMath::Max(*MaxVoices, Audio->GetActiveVoices());
+
+                const double Elapsed = FPlatformTime::Seconds() - StartTime;
+                if (Elapsed < Seconds) return true;
+
+                const int32 NewComponents = CountAudioComponents(World) - StartComponents;
+                UE_LOG(LogParkourAudio, Log, TEXT("[AudioBench] %.1fs: %d events requested, %d started, peak %d of %d voices, %d audio components created"),
+                    Elapsed, *Requested, *Started, *MaxVoices, Audio->GetPoolSize(), NewComponents);
+                return false;
+            }));
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs BenchCommand(
+        TEXT("Parkour.AudioBench"),
+        TEXT("Plays sustained weapon fire plus vaults through the audio pool and logs voices and components created. Args: [Seconds=10] [ShotsPerSecond=15]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                if (World)
+                {
+                    Run(World,
+                        Args.Num() > 0 ? FMath::Max(1.f, FCString::Atof(*Args[0])) : 10.f,
+                        Args.Num() > 1 ? FMath::Max(0.1f, FCString::Atof(*Args[1])) : 15.f);
+                }
+            }));
+}
@@ -3,38 +3,60 @@
 
 #include "Character/ClimbableDetectorComponent.h"
 #include "GameFramework/Character.h" 
+#include "GameFramework/CharacterMovementComponent.h"
+#include "KiwiJam2025.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Reverse.h"
+#include "Telemetry/TraversalTelemetry.h"
+#include "World/TraversalProxyComponent.h"
+#include "World/TraversalMeshInfo.h"
+#include "World/RideRailComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+DECLARE_CYCLE_STAT(TEXT("Affordance Scan"), STAT_AffordanceScan, STATGROUP_KiwiJam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Affordance Scan Traces"), STAT_AffordanceScanTraces, STATGROUP_KiwiJam);
 
 // Sets default values for this component's properties
 UClimbableDetectorComponent::UClimbableDetectorComponent()
 {
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = false;
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	// Scan from where movement left the owner this frame
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
 
 	// ...
 }
 
 void UClimbableDetectorComponent::SetOwnerCharacter(ACharacter* Character)
 {
-    if (Character)
+    SetOwnerActor(Character);
+}
+
+void UClimbableDetectorComponent::SetOwnerActor(AActor* Actor)
+{
+    if (Actor)
     {
-        OwnerCharacter = Character;
+        OwnerActor = Actor;
     }
 }
 
 bool UClimbableDetectorComponent::DetectClimbableSurface(FClimbableSurfaceResult& OutResult)
 {
-    if (!OwnerCharacter) return false;
+    if (!OwnerActor) return false;
 
     //check head space
     FHitResult HeadHit;
     if (TraceHead(HeadHit))
     {
+        RecordProbe(ETraversalTelemetryEvent::ProbeHeadBlocked);
+
         // Optional debug
         if (bDebugDraw)
         {
-            FVector Start = OwnerCharacter->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
-            FVector End = Start + OwnerCharacter->GetActorUpVector() * UpTraceHeight;
+            FVector Start = OwnerActor->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
+            FVector End = Start + OwnerActor->GetActorUpVector() * UpTraceHeight;
             DrawDebugLine(GetWorld(), Start, End, FColor::Red, false, 1.0f, 0, 2.f);
         }
         return false;
@@ -46,8 +68,8 @@ bool UClimbableDetectorComponent::DetectClimbableSurface(FClimbableSurfaceResult
         // Optional debug
         if (bDebugDraw)
         {
-            FVector Start = OwnerCharacter->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
-            FVector End = Start + OwnerCharacter->GetActorForwardVector() * ForwardTraceDistance;
+            FVector Start = OwnerActor->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
+            FVector End = Start + OwnerActor->GetActorForwardVector() * ForwardTraceDistance;
             DrawDebugLine(GetWorld(), Start, End, FColor::Red, false, 1.0f, 0, 2.f);
         }
         return false;
@@ -64,25 +86,32 @@ bool UClimbableDetectorComponent::DetectClimbableSurface(FClimbableSurfaceResult
         return false;
     }
 
-    const float SurfaceHeight = LedgeTopLocation.Z - OwnerCharacter->GetActorLocation().Z;
+    const float SurfaceHeight = LedgeTopLocation.Z - OwnerActor->GetActorLocation().Z;
 
     if (SurfaceHeight < MinLedgeHeight || SurfaceHeight > MaxLedgeHeight)
+    {
+        RecordProbe(ETraversalTelemetryEvent::ProbeHeightOutOfRange);
         return false;
+    }
 
     OutResult.bIsValid = true;
     OutResult.ImpactPoint = LedgeTopLocation;
     OutResult.ImpactNormal = ForwardHit.ImpactNormal;
     OutResult.SurfaceForward = -ForwardHit.ImpactNormal;
     OutResult.HitActor = ForwardHit.GetActor();
+    OutResult.HitComponent = ForwardHit.GetComponent();
     OutResult.SurfaceHeight = SurfaceHeight;
     OutResult.SurfaceType = EClimbableSurfaceType::Ledge; // classify more later
+    OutResult.PhysicalSurface = UPhysicalMaterial::DetermineSurfaceType(ForwardHit.PhysMaterial.Get());
+
+    RecordProbe(ETraversalTelemetryEvent::ProbeSuccess);
 
     // Debug visualization 
     if (bDebugDraw) 
     {
         // Forward Trace
-        FVector Start = OwnerCharacter->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
-        FVector End = Start + OwnerCharacter->GetActorForwardVector() * ForwardTraceDistance;
+        FVector Start = OwnerActor->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
+        FVector End = Start + OwnerActor->GetActorForwardVector() * ForwardTraceDistance;
         DrawDebugLine(GetWorld(), Start, End, FColor::Green, false, 2.f, 0, 2.f);
 
         // Impact normal
@@ -103,19 +132,20 @@ bool UClimbableDetectorComponent::DetectClimbableSurface(FClimbableSurfaceResult
 
 bool UClimbableDetectorComponent::CheckVaultSurface(FClimbableSurfaceResult& OutInfo)
 {
-    if (!OwnerCharacter) return false;
+    if (!OwnerActor) return false;
 
-    FVector Start = OwnerCharacter->GetActorLocation();
-    FVector Forward = OwnerCharacter->GetActorForwardVector();
-    FVector End = Start + Forward * VaultForwardTraceDistance; // Short forward check
+    FVector Start, End;
+    FVector Forward = OwnerActor->GetActorForwardVector();
+    GetProbeSegment(EAffordanceProbe::VaultForward, OwnerActor->GetActorLocation(), Forward, FVector::ZeroVector, Start, End); // Short forward check
 
     // 1. Forward trace to detect obstacle
     FHitResult Hit;
     FCollisionQueryParams Params;
-    Params.AddIgnoredActor(OwnerCharacter);
+    Params.AddIgnoredActor(OwnerActor);
+    Params.bReturnPhysicalMaterial = true;
     if (bDebugDraw)
         DrawDebugLine(GetWorld(), Start, End, FColor::Yellow, false, 2.0f); 
-    if (!GetWorld()->LineTraceSingleByChannel(Hit, Start, End, TraceChannel, Params))
+    if (!TraceLine(Hit, Start, End, Params))
     {
         return false;
     }
@@ -123,25 +153,30 @@ bool UClimbableDetectorComponent::CheckVaultSurface(FClimbableSurfaceResult& Out
     if (bDebugDraw)
     DrawDebugSphere(GetWorld(), Hit.ImpactPoint, 15.f, 12, FColor::Cyan, false, 2.f);
 
-    float ObstacleTopZ = Hit.ImpactPoint.Z + Hit.Component->Bounds.BoxExtent.Z;
-    float PlayerFeetZ = OwnerCharacter->GetActorLocation().Z;
+    bool bRejected = false;
+    float ObstacleTopZ = GetVaultObstacleTopZ(Hit, Forward, bRejected);
+    float PlayerFeetZ = OwnerActor->GetActorLocation().Z;
 
     float ObstacleHeight = ObstacleTopZ - PlayerFeetZ;
 
     // 2. Height check
     if (ObstacleHeight < VaultObstacleHeightMin || ObstacleHeight > VaultObstacleHeightMax)
+    {
+        RecordProbe(ETraversalTelemetryEvent::ProbeHeightOutOfRange);
         return false;
+    }
 
-    // 3. Check for landing spot beyond the obstacle
-    FVector VaultCheckStart = Hit.ImpactPoint + Forward * VaultObstacleDistance + FVector(0,0,50);
-    FVector VaultCheckEnd = VaultCheckStart - FVector(0, 0, 120);
+    // 3. Check for landing spot beyond the obstacle. The cached shape can rule it out without a trace.
+    FVector VaultCheckStart, VaultCheckEnd;
+    GetProbeSegment(EAffordanceProbe::VaultLanding, OwnerActor->GetActorLocation(), Forward, Hit.ImpactPoint, VaultCheckStart, VaultCheckEnd);
     if (bDebugDraw)
-        DrawDebugLine(GetWorld(), VaultCheckStart, VaultCheckEnd, FColor::Yellow, false, 2.0f);
+        DrawDebugLine(GetWorld(), VaultCheckStart, VaultCheckEnd, bRejected ? FColor::Silver : FColor::Yellow, false, 2.0f);
     FHitResult VaultLandingHit;
-    if (GetWorld()->LineTraceSingleByChannel(VaultLandingHit, VaultCheckStart, VaultCheckEnd, TraceChannel, Params))
+    if (bRejected || TraceLine(VaultLandingHit, VaultCheckStart, VaultCheckEnd, Params))
     {
         if (bDebugDraw)
-            DrawDebugSphere(GetWorld(), VaultLandingHit.ImpactPoint, 15.f, 12, FColor::Cyan, false, 5.f);
+            DrawDebugSphere(GetWorld(), bRejected ? VaultCheckEnd : VaultLandingHit.ImpactPoint, 15.f, 12, FColor::Cyan, false, 5.f);
+        RecordProbe(ETraversalTelemetryEvent::ProbeLandingBlocked);
         return false;
     }
 
@@ -150,33 +185,380 @@ bool UClimbableDetectorComponent::CheckVaultSurface(FClimbableSurfaceResult& Out
     OutInfo.ImpactNormal = Hit.ImpactNormal;
     OutInfo.SurfaceForward = -Hit.ImpactNormal;
     OutInfo.HitActor = Hit.GetActor();
+    OutInfo.HitComponent = Hit.GetComponent();
     OutInfo.SurfaceHeight = ObstacleHeight;
     OutInfo.SurfaceType = EClimbableSurfaceType::Vaultable; // We'll classify more later
+    OutInfo.PhysicalSurface = UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get());
+
+    RecordProbe(ETraversalTelemetryEvent::ProbeSuccess);
 
     if (bDebugDraw)
     {
         DrawDebugLine(GetWorld(), Start, End, FColor::Yellow, false, 2.0f);
         DrawDebugBox(GetWorld(), Hit.ImpactPoint, FVector(10, 10, 10), FColor::Red, false, 2.0f);
-        DrawDebugBox(GetWorld(), VaultLandingHit.ImpactPoint, FVector(10, 10, 10), FColor::Green, false, 2.0f);
+        DrawDebugBox(GetWorld(), VaultCheckEnd, FVector(10, 10, 10), FColor::Green, false, 2.0f);
     }
   
     return true;
 }
 
 
+void FLedgeCache::Reset()
+{
+    Points.Reset();
+    Normals.Reset();
+    Distances.Reset();
+    bEndClosed[0] = bEndClosed[1] = false;
+}
+
+void FLedgeCache::RebuildDistances()
+{
+    Distances.SetNumUninitialized(Points.Num());
+    float Total = 0.f;
+    for (int32 i = 0; i < Points.Num(); ++i)
+    {
+        Total += i > 0 ? FVector::Dist(Points[i - 1], Points[i]) : 0.f;
+        Distances[i] = Total;
+    }
+}
+
+void FLedgeCache::Sample(float Distance, FVector& OutPoint, FVector& OutNormal) const
+{
+    if (Points.Num() == 0) return;
+
+    Distance = FMath::Clamp(Distance, 0.f, GetLength());
+
+    // Binary search keeps long, repeatedly extended ledges cheap
+    int32 Segment = Algo::UpperBound(Distances, Distance) - 1;
+    Segment = FMath::Clamp(Segment, 0, Points.Num() - 2);
+
+    const float SegLength = Distances[Segment + 1] - Distances[Segment];
+    const float Alpha = SegLength > UE_KINDA_SMALL_NUMBER ? (Distance - Distances[Segment]) / SegLength : 0.f;
+
+    OutPoint = FMath::Lerp(Points[Segment], Points[Segment + 1], Alpha);
+    OutNormal = FMath::Lerp(Normals[Segment], Normals[Segment + 1], Alpha).GetSafeNormal();
+}
+
+bool UClimbableDetectorComponent::TraceLedgeSample(const FVector& GuessPoint, const FVector& GuessNormal, FVector& OutPoint, FVector& OutNormal) const
+{
+    FCollisionQueryParams Params;
+    Params.AddIgnoredActor(OwnerActor);
+
+    // Into the wall just under the lip
+    const FVector WallStart = GuessPoint + GuessNormal * 60.f - FVector(0.f, 0.f, 15.f);
+    const FVector WallEnd = WallStart - GuessNormal * 120.f;
+
+    FHitResult WallHit;
+    if (!TraceLine(WallHit, WallStart, WallEnd, Params))
+        return false;
+
+    const FVector Normal = FVector(WallHit.ImpactNormal.X, WallHit.ImpactNormal.Y, 0.f).GetSafeNormal();
+    if (Normal.IsNearlyZero())
+        return false;
+
+    // Down onto the top, just inside the wall face
+    const FVector TopStart = WallHit.ImpactPoint - Normal * 20.f + FVector(0.f, 0.f, 55.f);
+    const FVector TopEnd = TopStart - FVector(0.f, 0.f, 80.f);
+
+    FHitResult TopHit;
+    if (!TraceLine(TopHit, TopStart, TopEnd, Params))
+        return false;
+
+    OutPoint = FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, TopHit.ImpactPoint.Z);
+    OutNormal = Normal;
+
+    if (bDebugDraw)
+    {
+        DrawDebugPoint(GetWorld(), OutPoint, 8.f, FColor::Magenta, false, 2.f);
+    }
+    return true;
+}
+
+bool UClimbableDetectorComponent::ExtractLedge(const FVector& LedgePoint, const FVector& SurfaceForward, FLedgeCache& OutCache) const
+{
+    OutCache.Reset();
+    if (!OwnerActor) return false;
+
+    FVector Point, Normal;
+    if (!TraceLedgeSample(LedgePoint, -SurfaceForward.GetSafeNormal2D(), Point, Normal))
+        return false;
+
+    OutCache.Points.Add(Point);
+    OutCache.Normals.Add(Normal);
+    OutCache.RebuildDistances();
+
+    ExtendLedge(OutCache, true);
+    ExtendLedge(OutCache, false);
+
+    return OutCache.IsValid();
+}
+
+bool UClimbableDetectorComponent::ExtendLedge(FLedgeCache& Cache, bool bAtEnd) const
+{
+    if (!OwnerActor || Cache.Points.Num() == 0 || Cache.bEndClosed[bAtEnd ? 1 : 0]) return false;
+
+    TArray<FVector> NewPoints;
+    TArray<FVector> NewNormals;
+
+    FVector Point = bAtEnd ? Cache.Points.Last() : Cache.Points[0];
+    FVector Normal = bAtEnd ? Cache.Normals.Last() : Cache.Normals[0];
+
+    for (int32 i = 0; i < LedgeSamplesPerSide; ++i)
+    {
+        // Tangent follows the last sample's normal so gentle curves are tracked
+        const FVector Tangent = FVector::CrossProduct(FVector::UpVector, -Normal) * (bAtEnd ? 1.f : -1.f);
+
+        FVector NextPoint, NextNormal;
+        if (!TraceLedgeSample(Point + Tangent * LedgeSampleSpacing, Normal, NextPoint, NextNormal))
+        {
+            // Ledge ends or turns a corner too sharp to follow
+            Cache.bEndClosed[bAtEnd ? 1 : 0] = true;
+            break;
+        }
+
+        NewPoints.Add(NextPoint);
+        NewNormals.Add(NextNormal);
+        Point = NextPoint;
+        Normal = NextNormal;
+    }
+
+    if (NewPoints.Num() == 0) return false;
+
+    if (bAtEnd)
+    {
+        Cache.Points.Append(NewPoints);
+        Cache.Normals.Append(NewNormals);
+    }
+    else
+    {
+        Algo::Reverse(NewPoints);
+        Algo::Reverse(NewNormals);
+        Cache.Points.Insert(NewPoints, 0);
+        Cache.Normals.Insert(NewNormals, 0);
+    }
+    Cache.RebuildDistances();
+    return true;
+}
+
 // Called when the game starts
 void UClimbableDetectorComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// ...
-	
+	Telemetry = GetWorld()->GetSubsystem<UTraversalTelemetrySubsystem>();
+
+	SetComponentTickEnabled(bContinuousScan);
+}
+
+void UClimbableDetectorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    SCOPE_CYCLE_COUNTER(STAT_AffordanceScan);
+
+    if (!ShouldScan())
+    {
+        // Start over from a clean cycle when scanning resumes
+        Scan = FAffordanceScanState();
+        ScanTime = -1.0;
+        SetAffordance(EClimbableSurfaceType::None);
+        return;
+    }
+
+    // Skipped probes are free, so this always ends on a trace. Each cycle starts with one.
+    int32 Traces = 0;
+    while (Traces < MaxScanTracesPerFrame)
+    {
+        Traces += StepScan() ? 1 : 0;
+    }
+    INC_DWORD_STAT_BY(STAT_AffordanceScanTraces, Traces);
+}
+
+bool UClimbableDetectorComponent::ShouldScan() const
+{
+    if (!OwnerActor) return false;
+
+    // Only the local player sees prompts or presses jump
+    const APawn* Pawn = Cast<APawn>(OwnerActor);
+    if (Pawn && !(Pawn->IsLocallyControlled() && Pawn->IsPlayerControlled())) return false;
+
+    // Nothing to offer while already climbing, vaulting, hanging or sliding
+    if (const ACharacter* Character = Cast<ACharacter>(OwnerActor))
+    {
+        const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+        if (Movement && Movement->MovementMode == MOVE_Custom) return false;
+    }
+    return true;
+}
+
+bool UClimbableDetectorComponent::StepScan()
+{
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(AffordanceScan));
+    Params.AddIgnoredActor(OwnerActor);
+    Params.bReturnPhysicalMaterial = true;
+
+    const EAffordanceProbe Probe = Scan.Probe;
+    Scan.Probe = (EAffordanceProbe)((uint8)Probe + 1);
+
+    FVector Start, End;
+    FHitResult Hit;
+    bool bTraced = false;
+
+    switch (Probe)
+    {
+    case EAffordanceProbe::VaultForward:
+        Scan = FAffordanceScanState();
+        Scan.Probe = EAffordanceProbe::VaultLanding;
+        Scan.Origin = OwnerActor->GetActorLocation();
+        Scan.Forward = OwnerActor->GetActorForwardVector();
+        Scan.StartTime = GetWorld()->GetTimeSeconds();
+
+        GetProbeSegment(Probe, Scan.Origin, Scan.Forward, FVector::ZeroVector, Start, End);
+        bTraced = true;
+        if (TraceLine(Scan.VaultHit, Start, End, Params))
+        {
+            // A cached shape that rules the vault out skips the landing probe
+            bool bRejected = false;
+            Scan.VaultHeight = GetVaultObstacleTopZ(Scan.VaultHit, Scan.Forward, bRejected) - Scan.Origin.Z;
+            Scan.bVaultObstacle = !bRejected && Scan.VaultHeight >= VaultObstacleHeightMin && Scan.VaultHeight <= VaultObstacleHeightMax;
+        }
+        break;
+
+    case EAffordanceProbe::VaultLanding:
+        if (!Scan.bVaultObstacle) break;
+
+        GetProbeSegment(Probe, Scan.Origin, Scan.Forward, Scan.VaultHit.ImpactPoint, Start, End);
+        bTraced = true;
+        Scan.bVault = !TraceLine(Hit, Start, End, Params);
+
+        // A jump takes the vault first, the climb probes would be wasted
+        if (Scan.bVault) Scan.Probe = EAffordanceProbe::Count;
+        break;
+
+    case EAffordanceProbe::Head:
+        GetProbeSegment(Probe, Scan.Origin, Scan.Forward, FVector::ZeroVector, Start, End);
+        bTraced = true;
+        Scan.bHeadBlocked = TraceLine(Hit, Start, End, Params);
+        break;
+
+    case EAffordanceProbe::ClimbForward:
+        if (Scan.bHeadBlocked) break;
+
+        GetProbeSegment(Probe, Scan.Origin, Scan.Forward, FVector::ZeroVector, Start, End);
+        bTraced = true;
+        Scan.bForwardHit = TraceLine(Scan.ForwardHit, Start, End, Params);
+        break;
+
+    case EAffordanceProbe::LedgeTop:
+        if (!Scan.bForwardHit) break;
+
+        GetProbeSegment(Probe, Scan.Origin, Scan.Forward, Scan.ForwardHit.ImpactPoint - Scan.ForwardHit.ImpactNormal * 20, Start, End);
+        bTraced = true;
+        if (TraceLine(Hit, Start, End, Params) && IsLedgeTopHit(Hit))
+        {
+            const float Height = Hit.ImpactPoint.Z - Scan.Origin.Z;
+            Scan.LedgeTop = Hit.ImpactPoint;
+            Scan.bLedge = Height >= MinLedgeHeight && Height <= MaxLedgeHeight;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (Scan.Probe == EAffordanceProbe::Count)
+    {
+        FinishScan();
+        Scan.Probe = EAffordanceProbe::VaultForward;
+    }
+    return bTraced;
+}
+
+void UClimbableDetectorComponent::FinishScan()
+{
+    // Same fields the synchronous checks fill in, so a jump can't tell the difference
+    ScanResult = FClimbableSurfaceResult();
+    if (Scan.bVault)
+    {
+        ScanResult.bIsValid = true;
+        ScanResult.ImpactPoint = Scan.VaultHit.ImpactPoint;
+        ScanResult.ImpactNormal = Scan.VaultHit.ImpactNormal;
+        ScanResult.SurfaceForward = -Scan.VaultHit.ImpactNormal;
+        ScanResult.HitActor = Scan.VaultHit.GetActor();
+        ScanResult.HitComponent = Scan.VaultHit.GetComponent();
+        ScanResult.SurfaceHeight = Scan.VaultHeight;
+        ScanResult.SurfaceType = EClimbableSurfaceType::Vaultable;
+        ScanResult.PhysicalSurface = UPhysicalMaterial::DetermineSurfaceType(Scan.VaultHit.PhysMaterial.Get());
+    }
+    else if (Scan.bLedge)
+    {
+        ScanResult.bIsValid = true;
+        ScanResult.ImpactPoint = Scan.LedgeTop;
+        ScanResult.ImpactNormal = Scan.ForwardHit.ImpactNormal;
+        ScanResult.SurfaceForward = -Scan.ForwardHit.ImpactNormal;
+        ScanResult.HitActor = Scan.ForwardHit.GetActor();
+        ScanResult.HitComponent = Scan.ForwardHit.GetComponent();
+        ScanResult.SurfaceHeight = Scan.LedgeTop.Z - Scan.Origin.Z;
+        ScanResult.SurfaceType = EClimbableSurfaceType::Ledge;
+        ScanResult.PhysicalSurface = UPhysicalMaterial::DetermineSurfaceType(Scan.ForwardHit.PhysMaterial.Get());
+    }
+    ScanResult.bHeadBlocked = Scan.bHeadBlocked;
+
+    ScanOrigin = Scan.Origin;
+    ScanForward = Scan.Forward;
+    ScanTime = Scan.StartTime;
+
+    // A jump grabs a rail before anything else, so it's what the prompt offers
+    FRailAttachment Rail;
+    SetAffordance(DetectRail(Rail) ? EClimbableSurfaceType::Rail : ScanResult.SurfaceType);
+}
+
+void UClimbableDetectorComponent::SetAffordance(EClimbableSurfaceType Affordance)
+{
+    if (CurrentAffordance != Affordance)
+    {
+        CurrentAffordance = Affordance;
+        OnAffordanceChanged.Broadcast(Affordance);
+    }
+}
+
+bool UClimbableDetectorComponent::ConsumeAffordance(FClimbableSurfaceResult& OutResult) const
+{
+    if (!OwnerActor || !IsComponentTickEnabled() || ScanTime < 0.0) return false;
+
+    if (GetWorld()->GetTimeSeconds() - ScanTime > MaxAffordanceAge) return false;
+
+    const FVector Location = OwnerActor->GetActorLocation();
+    if (FVector::DistSquared(Location, ScanOrigin) > FMath::Square(MaxAffordanceDrift)) return false;
+
+    if ((OwnerActor->GetActorForwardVector() | ScanForward) < FMath::Cos(FMath::DegreesToRadians(MaxAffordanceTurnDegrees))) return false;
+
+    OutResult = ScanResult;
+    if (!OutResult.bIsValid) return true;
+
+    // Heights are relative to the feet, which may have moved since the scan
+    OutResult.SurfaceHeight += ScanOrigin.Z - Location.Z;
+    const bool bVault = OutResult.SurfaceType == EClimbableSurfaceType::Vaultable;
+    const float MinHeight = bVault ? VaultObstacleHeightMin : MinLedgeHeight;
+    const float MaxHeight = bVault ? VaultObstacleHeightMax : MaxLedgeHeight;
+    if (OutResult.SurfaceHeight < MinHeight || OutResult.SurfaceHeight > MaxHeight) return false;
+
+    RecordProbe(ETraversalTelemetryEvent::ProbeSuccess);
+    return true;
+}
+
+void UClimbableDetectorComponent::RecordProbe(ETraversalTelemetryEvent Type) const
+{
+    if (Telemetry && OwnerActor)
+    {
+        Telemetry->Record(Type, OwnerActor->GetActorLocation());
+    }
 }
 
 bool UClimbableDetectorComponent::TraceForward(FHitResult& OutHit)
 {
-    FVector Start = OwnerCharacter->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
-    FVector End = Start + OwnerCharacter->GetActorForwardVector() * ForwardTraceDistance;
+    FVector Start, End;
+    GetProbeSegment(EAffordanceProbe::ClimbForward, OwnerActor->GetActorLocation(), OwnerActor->GetActorForwardVector(), FVector::ZeroVector, Start, End);
 
     if (bDebugDraw)
     {
@@ -184,15 +566,16 @@ bool UClimbableDetectorComponent::TraceForward(FHitResult& OutHit)
     }
 
     FCollisionQueryParams Params; 
-    Params.AddIgnoredActor(OwnerCharacter); 
+    Params.AddIgnoredActor(OwnerActor); 
+    Params.bReturnPhysicalMaterial = true;
 
-    return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, TraceChannel, Params); 
+    return TraceLine(OutHit, Start, End, Params); 
 }
 
 bool UClimbableDetectorComponent::TraceHead(FHitResult& OutHit)
 {
-    FVector Start = OwnerCharacter->GetActorLocation() + FVector(0, 0, VerticalTraceHeight * 0.5f);
-    FVector End = Start + OwnerCharacter->GetActorUpVector() * UpTraceHeight;
+    FVector Start, End;
+    GetProbeSegment(EAffordanceProbe::Head, OwnerActor->GetActorLocation(), OwnerActor->GetActorForwardVector(), FVector::ZeroVector, Start, End);
 
     if (bDebugDraw)
     {
@@ -200,32 +583,150 @@ bool UClimbableDetectorComponent::TraceHead(FHitResult& OutHit)
     }
 
     FCollisionQueryParams Params;
-    Params.AddIgnoredActor(OwnerCharacter);
+    Params.AddIgnoredActor(OwnerActor);
 
-    return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, TraceChannel, Params);
+    return TraceLine(OutHit, Start, End, Params);
 }
 
 bool UClimbableDetectorComponent::TraceLedgeTop(const FVector& ForwardHitLocation, FVector& OutLedgeLocation)
 {
-    FVector Start = ForwardHitLocation + FVector(0, 0, MaxLedgeHeight);
-    FVector End = ForwardHitLocation + FVector(0, 0, MinLedgeHeight);
+    FVector Start, End;
+    GetProbeSegment(EAffordanceProbe::LedgeTop, OwnerActor->GetActorLocation(), OwnerActor->GetActorForwardVector(), ForwardHitLocation, Start, End);
 
     FHitResult LedgeHit;
     FCollisionQueryParams Params;
-    Params.AddIgnoredActor(OwnerCharacter);
+    Params.AddIgnoredActor(OwnerActor);
 
     if (bDebugDraw)
     {
         DrawDebugLine(GetWorld(), Start, End, FColor::Orange, false, 2.f, 0, 2.f);
     }
 
-    if (!GetWorld()->LineTraceSingleByChannel(LedgeHit, Start, End, TraceChannel, Params))
+    if (!TraceLine(LedgeHit, Start, End, Params))
+        return false;
+
+    if (!IsLedgeTopHit(LedgeHit))
         return false;
 
     OutLedgeLocation = LedgeHit.ImpactPoint;
     return true;
 }
 
+bool UClimbableDetectorComponent::DetectRail(FRailAttachment& OutRail) const
+{
+    if (!OwnerActor) return false;
+
+    const URideRailSubsystem* Rails = GetWorld()->GetSubsystem<URideRailSubsystem>();
+    return Rails && Rails->GetNumRails() > 0 && Rails->FindRail(OwnerActor->GetActorLocation(), RailGrabRadius, OutRail);
+}
+
+FTraversalReachLimits UClimbableDetectorComponent::GetReachLimits() const
+{
+    FTraversalReachLimits Limits;
+    Limits.MinLedgeHeight = MinLedgeHeight;
+    Limits.MaxLedgeHeight = MaxLedgeHeight;
+    Limits.VaultObstacleHeightMin = VaultObstacleHeightMin;
+    Limits.VaultObstacleHeightMax = VaultObstacleHeightMax;
+    Limits.ForwardTraceDistance = ForwardTraceDistance;
+    Limits.VerticalTraceHeight = VerticalTraceHeight;
+    Limits.UpTraceHeight = UpTraceHeight;
+    Limits.VaultForwardTraceDistance = VaultForwardTraceDistance;
+    Limits.VaultObstacleDistance = VaultObstacleDistance;
+    Limits.TraversalObjectType = UTraversalProxyComponent::GetProxyObjectType();
+    Limits.bUseTraversalChannel = bUseTraversalChannel && Limits.TraversalObjectType != ECC_MAX;
+    Limits.TraceChannel = TraceChannel;
+    return Limits;
+}
+
+bool UClimbableDetectorComponent::TraceLine(FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params) const
+{
+    const ECollisionChannel ProxyObjectType = UTraversalProxyComponent::GetProxyObjectType();
+    if (bUseTraversalChannel && ProxyObjectType != ECC_MAX)
+    {
+        // Only the simplified proxies, none of the render-detail collision
+        return GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, FCollisionObjectQueryParams(ProxyObjectType), Params);
+    }
+    return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, TraceChannel, Params);
+}
+
+void UClimbableDetectorComponent::GetProbeSegment(EAffordanceProbe Probe, const FVector& Origin, const FVector& Forward, const FVector& Anchor, FVector& OutStart, FVector& OutEnd) const
+{
+    GetProbeSegment(GetReachLimits(), Probe, Origin, Forward, Anchor, OutStart, OutEnd);
+}
+
+void UClimbableDetectorComponent::GetProbeSegment(const FTraversalReachLimits& Limits, EAffordanceProbe Probe, const FVector& Origin, const FVector& Forward,
+    const FVector& Anchor, FVector& OutStart, FVector& OutEnd)
+{
+    switch (Probe)
+    {
+    case EAffordanceProbe::VaultForward:
+        OutStart = Origin;
+        OutEnd = Origin + Forward * Limits.VaultForwardTraceDistance;
+        break;
+    case EAffordanceProbe::VaultLanding:
+        OutStart = Anchor + Forward * Limits.VaultObstacleDistance + FVector(0, 0, 50);
+        OutEnd = OutStart - FVector(0, 0, 120);
+        break;
+    case EAffordanceProbe::Head:
+        // Owners stay upright, so the actor's up is world up
+        OutStart = Origin + FVector(0, 0, Limits.VerticalTraceHeight * 0.5f);
+        OutEnd = OutStart + FVector::UpVector * Limits.UpTraceHeight;
+        break;
+    case EAffordanceProbe::ClimbForward:
+        OutStart = Origin + FVector(0, 0, Limits.VerticalTraceHeight * 0.5f);
+        OutEnd = OutStart + Forward * Limits.ForwardTraceDistance;
+        break;
+    case EAffordanceProbe::LedgeTop:
+    default:
+        OutStart = Anchor + FVector(0, 0, Limits.MaxLedgeHeight);
+        OutEnd = Anchor + FVector(0, 0, Limits.MinLedgeHeight);
+        break;
+    }
+}
+
+bool UClimbableDetectorComponent::IsLedgeTopHit(const FHitResult& Hit) const
+{
+    if (bUseTraversalChannel)
+    {
+        const UTraversalProxyComponent* Proxy = Cast<UTraversalProxyComponent>(Hit.GetComponent());
+        if (Proxy && !Proxy->IsLedgeCapable())
+            return false;
+    }
+    return true;
+}
+
+float UClimbableDetectorComponent::GetVaultObstacleTopZ(const FHitResult& Hit, const FVector& Forward, bool& bOutRejected) const
+{
+    return GetVaultObstacleTopZ(GetReachLimits(), OwnerActor->GetActorLocation(), Hit, Forward, bOutRejected);
+}
+
+float UClimbableDetectorComponent::GetVaultObstacleTopZ(const FTraversalReachLimits& Limits, const FVector& Origin, const FHitResult& Hit, const FVector& Forward,
+    bool& bOutRejected)
+{
+    bOutRejected = false;
+
+    FTransform ToWorld;
+    if (const FTraversalMeshInfo* Info = FTraversalMeshInfo::FindForHit(Hit, ToWorld))
+    {
+        // Enough rise to see any top a vault from the ground could reach
+        const float MaxRise = Origin.Z + Limits.VaultObstacleHeightMax - Hit.ImpactPoint.Z + 10.f;
+
+        FTraversalObstacle Obstacle;
+        if (Info->QueryObstacle(ToWorld, Hit.ImpactPoint, Forward, MaxRise, Limits.VaultObstacleDistance * 2.f, Limits.VaultObstacleDistance, Obstacle))
+        {
+            FVector LandingStart, LandingEnd;
+            GetProbeSegment(Limits, EAffordanceProbe::VaultLanding, Origin, Forward, Hit.ImpactPoint, LandingStart, LandingEnd);
+
+            // Other geometry can still be in the way, so a pass here doesn't clear the landing
+            bOutRejected = Obstacle.SurfaceType != EClimbableSurfaceType::Vaultable || Info->IntersectsSegment(ToWorld, LandingStart, LandingEnd);
+            return Obstacle.TopZ;
+        }
+    }
+
+    // Not a cached shape or taller than any vault; the top of its bounds is right for boxes and never too low
+    return Hit.Component.IsValid() ? Hit.Component->Bounds.GetBox().Max.Z : Hit.ImpactPoint.Z;
+}
+
 void UClimbableDetectorComponent::DrawDebugBoxAtPoint(UWorld* World, const FVector& Point, const FColor& Color, float Size)
 {
     DrawDebugBox(World, Point, FVector(Size), Color, false, 2.f, 0, 1.f); 
@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/Mover/ParkourMoverComponent.h"
+#include "Character/Mover/ParkourMoverModes.h"
+#include "Character/ParkourCharacter.h"
+#include "Character/ParkourMovementComponent.h"
+#include "Character/TraversalActionData.h"
+#include "Backends/MoverNetworkPhysicsLiaison.h"
+#include "DefaultMovementSet/Modes/WalkingMode.h"
+#include "DefaultMovementSet/Modes/FallingMode.h"
+#include "PhysicsMover/Modes/PhysicsDrivenWalkingMode.h"
+#include "PhysicsMover/Modes/PhysicsDrivenFallingMode.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+
+UParkourMoverComponent::UParkourMoverComponent()
+{
+    // The physics liaison needs physics-driven ground modes, the default backend the plain ones
+    if (UsesAsyncPhysics())
+    {
+        BackendClass = UMoverNetworkPhysicsLiaisonComponent::StaticClass();
+        MovementModes.Add(DefaultModeNames::Walking, CreateDefaultSubobject<UPhysicsDrivenWalkingMode>(TEXT("WalkingMode")));
+        MovementModes.Add(DefaultModeNames::Falling, CreateDefaultSubobject<UPhysicsDrivenFallingMode>(TEXT("FallingMode")));
+    }
+    else
+    {
+        MovementModes.Add(DefaultModeNames::Walking, CreateDefaultSubobject<UWalkingMode>(TEXT("WalkingMode")));
+        MovementModes.Add(DefaultModeNames::Falling, CreateDefaultSubobject<UFallingMode>(TEXT("FallingMode")));
+    }
+
+    UParkourTraversalMode* ClimbMode = CreateDefaultSubobject<UParkourTraversalMode>(TEXT("ClimbMode"));
+    ClimbMode->ActionName = ParkourModeNames::Climb;
+    MovementModes.Add(ParkourModeNames::Climb, ClimbMode);
+
+    UParkourTraversalMode* VaultMode = CreateDefaultSubobject<UParkourTraversalMode>(TEXT("VaultMode"));
+    VaultMode->ActionName = ParkourModeNames::Vault;
+    MovementModes.Add(ParkourModeNames::Vault, VaultMode);
+
+    Transitions.Add(CreateDefaultSubobject<UParkourTraversalStartTransition>(TEXT("TraversalStartTransition")));
+
+    StartingMovementMode = DefaultModeNames::Falling;
+
+    TraversalSource = TSoftClassPtr<AParkourCharacter>(FSoftObjectPath(TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter.BP_FirstPersonCharacter_C")));
+
+    // Always present, so rollback restores traversal progress along with the transform
+    PersistentSyncStateDataTypes.Add(FMoverDataPersistence(FParkourTraversalSyncState::StaticStruct(), true));
+}
+
+bool UParkourMoverComponent::UsesAsyncPhysics()
+{
+    const UPhysicsSettings* Settings = UPhysicsSettings::Get();
+    return Settings && Settings->bTickPhysicsAsync;
+}
+
+void UParkourMoverComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // The source class first, its movement defaults name the rest
+    if (!TraversalSource.IsNull() && !TraversalSource.Get())
+    {
+        UAssetManager::GetStreamableManager().RequestAsyncLoad(TraversalSource.ToSoftObjectPath(),
+            FStreamableDelegate::CreateUObject(this, &UParkourMoverComponent::LoadTraversalAssets));
+        return;
+    }
+    LoadTraversalAssets();
+}
+
+void UParkourMoverComponent::LoadTraversalAssets()
+{
+    TArray<FSoftObjectPath> Paths;
+    GatherTraversalPaths(Paths);
+
+    TArray<FSoftObjectPath> Missing;
+    for (const FSoftObjectPath& Path : Paths)
+    {
+        if (!Path.ResolveObject()) Missing.Add(Path);
+    }
+
+    if (Missing.Num() > 0)
+    {
+        UAssetManager::GetStreamableManager().RequestAsyncLoad(Missing,
+            FStreamableDelegate::CreateUObject(this, &UParkourMoverComponent::ResolveTraversalActions));
+    }
+    else
+    {
+        ResolveTraversalActions();
+    }
+}
+
+void UParkourMoverComponent::LoadTraversalActionsBlocking()
+{
+    TraversalSource.LoadSynchronous();
+
+    TArray<FSoftObjectPath> Paths;
+    GatherTraversalPaths(Paths);
+    for (const FSoftObjectPath& Path : Paths)
+    {
+        Path.TryLoad();
+    }
+    ResolveTraversalActions();
+}
+
+const UParkourMovementComponent* UParkourMoverComponent::GetSourceMovement() const
+{
+    const UClass* SourceClass = TraversalSource.Get();
+    const AParkourCharacter* SourceDefaults = SourceClass ? SourceClass->GetDefaultObject<AParkourCharacter>() : nullptr;
+    return SourceDefaults ? Cast<UParkourMovementComponent>(SourceDefaults->GetCharacterMovement()) : nullptr;
+}
+
+void UParkourMoverComponent::GatherTraversalPaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+    if (!TraversalActions.IsNull())
+    {
+        OutPaths.Add(TraversalActions.ToSoftObjectPath());
+        return;
+    }
+
+    if (const UParkourMovementComponent* Source = GetSourceMovement())
+    {
+        if (!Source->GetTraversalActionsAsset().IsNull())
+        {
+            OutPaths.Add(Source->GetTraversalActionsAsset().ToSoftObjectPath());
+        }
+        else
+        {
+            Source->GetTraversalCurvePaths(OutPaths);
+        }
+    }
+}
+
+void UParkourMoverComponent::ResolveTraversalActions()
+{
+    // Published once, the simulation may already be reading it
+    if (GetTraversalTable()) return;
+
+    TArray<FSoftObjectPath> Paths;
+    GatherTraversalPaths(Paths);
+
+    // Anything that failed to load is left out, as UParkourMovementComponent does
+    LoadedTraversalAssets.Reset();
+    if (UClass* SourceClass = TraversalSource.Get())
+    {
+        LoadedTraversalAssets.Add(SourceClass);
+    }
+    for (const FSoftObjectPath& Path : Paths)
+    {
+        if (UObject* Asset = Path.ResolveObject())
+        {
+            LoadedTraversalAssets.Add(Asset);
+        }
+    }
+
+    const UParkourMovementComponent* Source = GetSourceMovement();
+    LoadedTraversalActions = !TraversalActions.IsNull() ? TraversalActions.Get()
+        : Source ? Source->GetTraversalActionsAsset().Get() : nullptr;
+
+    if (LoadedTraversalActions)
+    {
+        Table.store(&LoadedTraversalActions->GetTable(), std::memory_order_release);
+    }
+    else if (Source)
+    {
+        Source->BuildDefaultTraversalTable(FallbackTable);
+        Table.store(&FallbackTable, std::memory_order_release);
+    }
+}
+
+bool UParkourMoverComponent::RequestTraversal(FName ModeName, const FClimbableSurfaceResult& Surface)
+{
+    if (!Surface.bIsValid || IsTraversing()) return false;
+
+    const FTraversalActionTable* ActionTable = GetTraversalTable();
+    if (!ActionTable || ActionTable->FindAction(ModeName) == INDEX_NONE) return false;
+
+    PendingTraversal.ModeName = ModeName;
+    PendingTraversal.SurfacePoint = Surface.ImpactPoint;
+    PendingTraversal.SurfaceForward = Surface.SurfaceForward.GetSafeNormal2D();
+    PendingTraversal.SurfaceHeight = Surface.SurfaceHeight;
+    return true;
+}
+
+bool UParkourMoverComponent::ConsumePendingTraversal(FParkourTraversalInputs& OutInputs)
+{
+    if (!PendingTraversal.HasRequest()) return false;
+
+    OutInputs = PendingTraversal;
+    PendingTraversal = FParkourTraversalInputs();
+    return true;
+}
+
+bool UParkourMoverComponent::IsTraversing() const
+{
+    const FName Mode = GetMovementModeName();
+    return Mode == ParkourModeNames::Climb || Mode == ParkourModeNames::Vault || PendingTraversal.HasRequest();
+}
@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/Mover/ParkourMoverModes.h"
+#include "Character/Mover/ParkourMoverComponent.h"
+#include "Character/Mover/ParkourMoverTypes.h"
+#include "Character/TraversalActionData.h"
+#include "KiwiJam2025.h"
+#include "MoverComponent.h"
+#include "MoverDataModelTypes.h"
+#include "MoverSimulationTypes.h"
+#include "MoveLibrary/MovementUtils.h"
+
+DECLARE_CYCLE_STAT(TEXT("Mover Traversal Tick"), STAT_ParkourMoverTraversal, STATGROUP_KiwiJam);
+
+namespace ParkourMover
+{
+    // Moves the scene component on the game-thread backend. With async physics the liaison
+    // pushes the output sync state to the physics particle instead, and scene components
+    // must not be touched from the physics thread.
+    static void ApplyKinematicMove(const FSimulationTickParams& Params, const FVector& Delta, const FQuat& Orientation)
+    {
+        if (!IsInGameThread()) return;
+
+        FHitResult Hit;
+        UMovementUtils::TrySafeMoveUpdatedComponent(Params.MovingComps, Delta, Orientation, false, Hit, ETeleportType::None);
+    }
+
+    static void WriteSyncState(const FSimulationTickParams& Params, FMoverTickEndData& OutputState, const FVector& Location, const FRotator& Orientation, const FVector& Velocity)
+    {
+        FMoverDefaultSyncState& OutSync = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
+        OutSync.SetTransforms_WorldSpace(Location, Orientation, Velocity, nullptr);
+    }
+}
+
+void UParkourTraversalMode::GenerateMove_Implementation(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const
+{
+    const UParkourMoverComponent* MoverComp = GetMoverComponent<UParkourMoverComponent>();
+    const FTraversalActionTable* Table = MoverComp ? MoverComp->GetTraversalTable() : nullptr;
+    const FMoverDefaultSyncState* StartSync = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
+    const FParkourTraversalSyncState* StartTraversal = StartState.SyncState.SyncStateCollection.FindDataByType<FParkourTraversalSyncState>();
+
+    const float DeltaSeconds = TimeStep.StepMs * 0.001f;
+    if (!Table || !StartSync || !StartTraversal || !StartTraversal->IsActive() || DeltaSeconds <= 0.f) return;
+
+    // Preview the step on a copy, the sim tick does the real advance
+    FTraversalRunState Run = StartTraversal->ToRunState();
+    FVector NewLocation;
+    Table->Evaluate(Run, DeltaSeconds, NewLocation);
+
+    OutProposedMove.LinearVelocity = (NewLocation - StartSync->GetLocation_WorldSpace()) / DeltaSeconds;
+}
+
+void UParkourTraversalMode::SimulationTick_Implementation(const FSimulationTickParams& Params, FMoverTickEndData& OutputState)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ParkourMoverTraversal);
+
+    const UParkourMoverComponent* MoverComp = GetMoverComponent<UParkourMoverComponent>();
+    const FTraversalActionTable* Table = MoverComp ? MoverComp->GetTraversalTable() : nullptr;
+
+    const FMoverSyncState& StartSyncState = Params.StartState.SyncState;
+    const FMoverDefaultSyncState* StartSync = StartSyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
+    const FParkourTraversalSyncState* StartTraversal = StartSyncState.SyncStateCollection.FindDataByType<FParkourTraversalSyncState>();
+    const FParkourTraversalInputs* Inputs = Params.StartState.InputCmd.InputCollection.FindDataByType<FParkourTraversalInputs>();
+
+    FParkourTraversalSyncState& OutTraversal = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FParkourTraversalSyncState>();
+    OutputState.MovementEndState.RemainingMs = 0.f;
+
+    if (!StartSync)
+    {
+        OutputState.MovementEndState.NextModeName = DefaultModeNames::Falling;
+        return;
+    }
+
+    const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
+    const FVector StartLocation = StartSync->GetLocation_WorldSpace();
+    const FRotator Orientation = StartSync->GetOrientation_WorldSpace();
+
+    FTraversalRunState Run = StartTraversal ? StartTraversal->ToRunState() : FTraversalRunState();
+
+    // First frame in the mode: start from the surface the request carried
+    if (!Run.IsActive() && Table && Inputs && Inputs->ModeName == ActionName)
+    {
+        Run.ActionIndex = Table->FindAction(ActionName);
+        Run.SurfacePoint = Inputs->SurfacePoint;
+        Run.SurfaceForward = Inputs->SurfaceForward;
+        Run.SurfaceHeight = Inputs->SurfaceHeight;
+        Run.PhaseStart = StartLocation;
+        Run.EntryVelocity = StartSync->GetVelocity_WorldSpace();
+    }
+
+    if (!Table || !Run.IsActive())
+    {
+        OutTraversal = FParkourTraversalSyncState();
+        OutputState.MovementEndState.NextModeName = DefaultModeNames::Falling;
+        return;
+    }
+
+    FVector NewLocation = StartLocation;
+    const bool bStillRunning = Table->Evaluate(Run, DeltaSeconds, NewLocation);
+
+    FVector NewVelocity = DeltaSeconds > 0.f ? (NewLocation - StartLocation) / DeltaSeconds : FVector::ZeroVector;
+
+    if (bStillRunning)
+    {
+        OutTraversal.FromRunState(Run);
+    }
+    else
+    {
+        // Same exit rules as UParkourMovementComponent::EndTraversal
+        const FTraversalCompiledAction& Action = Table->Actions[Run.ActionIndex];
+        const bool bHasExitVelocity = Action.bCarryEntryVelocity || Action.ExitForwardSpeed != 0.f;
+
+        NewVelocity = bHasExitVelocity
+            ? Run.SurfaceForward * Action.ExitForwardSpeed + (Action.bCarryEntryVelocity ? Run.EntryVelocity : FVector::ZeroVector)
+            : FVector::ZeroVector;
+
+        OutTraversal = FParkourTraversalSyncState();
+        OutputState.MovementEndState.NextModeName = bHasExitVelocity ? DefaultModeNames::Falling : DefaultModeNames::Walking;
+    }
+
+    ParkourMover::ApplyKinematicMove(Params, NewLocation - StartLocation, Orientation.Quaternion());
+    ParkourMover::WriteSyncState(Params, OutputState, NewLocation, Orientation, NewVelocity);
+}
+
+FTransitionEvalResult UParkourTraversalStartTransition::Evaluate_Implementation(const FSimulationTickParams& Params) const
+{
+    const FParkourTraversalInputs* Inputs = Params.StartState.InputCmd.InputCollection.FindDataByType<FParkourTraversalInputs>();
+    if (!Inputs || !Inputs->HasRequest())
+    {
+        return FTransitionEvalResult::NoTransition;
+    }
+
+    if (Params.StartState.SyncState.MovementMode == Inputs->ModeName)
+    {
+        return FTransitionEvalResult::NoTransition;
+    }
+
+    const UMoverComponent* MoverComp = GetMoverComponent();
+    if (!MoverComp || !MoverComp->MovementModes.Contains(Inputs->ModeName))
+    {
+        return FTransitionEvalResult::NoTransition;
+    }
+
+    return FTransitionEvalResult(Inputs->ModeName);
+}
@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/Mover/ParkourMoverPawn.h"
+#include "Character/Mover/ParkourMoverComponent.h"
+#include "Character/ClimbableDetectorComponent.h"
+#include "Character/ParkourCharacter.h"
+#include "Camera/CameraComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "DefaultMovementSet/CharacterMoverComponent.h"
+#include "MoverDataModelTypes.h"
+#include "EnhancedInputComponent.h"
+#include "EnhancedInputSubsystems.h"
+#include "InputActionValue.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+
+AParkourMoverPawn::AParkourMoverPawn()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Same capsule as AParkourCharacter so the detector sees the same geometry
+	CapsuleComponent = CreateDefaultSubobject<UCapsuleComponent>(TEXT("CollisionCylinder"));
+	CapsuleComponent->InitCapsuleSize(55.f, 96.0f);
+	CapsuleComponent->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
+	RootComponent = CapsuleComponent;
+
+	FirstPersonCameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("FirstPersonCamera"));
+	FirstPersonCameraComponent->SetupAttachment(CapsuleComponent);
+	FirstPersonCameraComponent->SetRelativeLocation(FVector(-10.f, 0.f, 60.f));
+	FirstPersonCameraComponent->bUsePawnControlRotation = true;
+
+	MoverComponent = CreateDefaultSubobject<UParkourMoverComponent>(TEXT("MoverComponent"));
+
+	ClimbableDetectorComponent = CreateDefaultSubobject<UClimbableDetectorComponent>(TEXT("ClimbableDetector"));
+	ClimbableDetectorComponent->SetOwnerActor(this);
+
+	// Mover owns the transform, replication goes through its backend
+	SetReplicatingMovement(false);
+}
+
+void AParkourMoverPawn::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	bJumpJustPressed = false;
+}
+
+void AParkourMoverPawn::TryTraversal()
+{
+	if (!MoverComponent || !ClimbableDetectorComponent || MoverComponent->IsTraversing()) return;
+
+	FClimbableSurfaceResult Result;
+	if (ClimbableDetectorComponent->CheckVaultSurface(Result) && Result.SurfaceType == EClimbableSurfaceType::Vaultable)
+	{
+		MoverComponent->RequestTraversal(ParkourModeNames::Vault, Result);
+	}
+	else if (ClimbableDetectorComponent->DetectClimbableSurface(Result) && Result.SurfaceType == EClimbableSurfaceType::Ledge)
+	{
+		MoverComponent->RequestTraversal(ParkourModeNames::Climb, Result);
+	}
+}
+
+void AParkourMoverPawn::ProduceInput_Implementation(int32 SimTimeMs, FMoverInputCmdContext& InputCmdResult)
+{
+	FCharacterDefaultInputs& CharacterInputs = InputCmdResult.InputCollection.FindOrAddMutableDataByType<FCharacterDefaultInputs>();
+
+	const FRotator ControlRotation = Controller ? Controller->GetControlRotation() : GetActorRotation();
+	const FRotator YawOnly(0.f, ControlRotation.Yaw, 0.f);
+
+	const FVector MoveIntent = YawOnly.RotateVector(FVector(CachedMoveInput.Y, CachedMoveInput.X, 0.f));
+	CharacterInputs.SetMoveInput(EMoveInputType::DirectionalIntent, MoveIntent.GetClampedToMaxSize(1.f));
+	CharacterInputs.OrientationIntent = YawOnly.Vector();
+	CharacterInputs.ControlRotation = ControlRotation;
+	CharacterInputs.bIsJumpPressed = bJumpPressed;
+	CharacterInputs.bIsJumpJustPressed = bJumpJustPressed;
+
+	FParkourTraversalInputs& TraversalInputs = InputCmdResult.InputCollection.FindOrAddMutableDataByType<FParkourTraversalInputs>();
+	if (!MoverComponent || !MoverComponent->ConsumePendingTraversal(TraversalInputs))
+	{
+		TraversalInputs = FParkourTraversalInputs();
+	}
+	else
+	{
+		// A traversal replaces the jump it was triggered by
+		CharacterInputs.bIsJumpPressed = false;
+		CharacterInputs.bIsJumpJustPressed = false;
+	}
+}
+
+void AParkourMoverPawn::Move(const FInputActionValue& Value)
+{
+	CachedMoveInput = Value.Get<FVector2D>();
+}
+
+void AParkourMoverPawn::Look(const FInputActionValue& Value)
+{
+	const FVector2D LookAxisVector = Value.Get<FVector2D>();
+
+	AddControllerYawInput(LookAxisVector.X);
+	AddControllerPitchInput(LookAxisVector.Y);
+}
+
+void AParkourMoverPawn::BeginJump(const FInputActionValue& Value)
+{
+	TryTraversal();
+
+	bJumpPressed = true;
+	bJumpJustPressed = true;
+}
+
+void AParkourMoverPawn::EndJump(const FInputActionValue& Value)
+{
+	bJumpPressed = false;
+}
+
+void AParkourMoverPawn::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	if (APlayerController* PlayerController = Cast<APlayerController>(Controller))
+	{
+		if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
+		{
+			Subsystem->AddMappingContext(DefaultMappingContext, 0);
+		}
+	}
+}
+
+void AParkourMoverPawn::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent))
+	{
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &AParkourMoverPawn::BeginJump);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &AParkourMoverPawn::EndJump);
+		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AParkourMoverPawn::Move);
+		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Completed, this, &AParkourMoverPawn::Move);
+		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &AParkourMoverPawn::Look);
+	}
+	else
+	{
+		UE_LOG(LogParkourCharacter, Error, TEXT("'%s' Failed to find an Enhanced Input Component!"), *GetNameSafe(this));
+	}
+}
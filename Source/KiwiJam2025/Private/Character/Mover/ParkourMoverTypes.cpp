@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/Mover/ParkourMoverTypes.h"
+
+bool FParkourTraversalInputs::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    Super::NetSerialize(Ar, Map, bOutSuccess);
+
+    Ar << ModeName;
+
+    // Surface only matters on the frame a request is made
+    if (HasRequest())
+    {
+        SerializePackedVector<10, 24>(SurfacePoint, Ar);
+        SerializeFixedVector<1, 16>(SurfaceForward, Ar);
+        Ar << SurfaceHeight;
+    }
+
+    bOutSuccess = true;
+    return true;
+}
+
+void FParkourTraversalInputs::ToString(FAnsiStringBuilderBase& Out) const
+{
+    Super::ToString(Out);
+
+    Out.Appendf("ModeName=%s SurfacePoint=%s SurfaceForward=%s SurfaceHeight=%.2f\n",
+        TCHAR_TO_ANSI(*ModeName.ToString()), TCHAR_TO_ANSI(*SurfacePoint.ToCompactString()),
+        TCHAR_TO_ANSI(*SurfaceForward.ToCompactString()), SurfaceHeight);
+}
+
+FTraversalRunState FParkourTraversalSyncState::ToRunState() const
+{
+    FTraversalRunState State;
+    State.ActionIndex = ActionIndex;
+    State.PhaseIndex = PhaseIndex;
+    State.PhaseElapsed = PhaseElapsed;
+    State.SurfacePoint = SurfacePoint;
+    State.SurfaceForward = SurfaceForward;
+    State.SurfaceHeight = SurfaceHeight;
+    State.PhaseStart = PhaseStart;
+    State.EntryVelocity = EntryVelocity;
+    return State;
+}
+
+void FParkourTraversalSyncState::FromRunState(const FTraversalRunState& State)
+{
+    ActionIndex = State.ActionIndex;
+    PhaseIndex = State.PhaseIndex;
+    PhaseElapsed = State.PhaseElapsed;
+    SurfacePoint = State.SurfacePoint;
+    SurfaceForward = State.SurfaceForward;
+    SurfaceHeight = State.SurfaceHeight;
+    PhaseStart = State.PhaseStart;
+    EntryVelocity = State.EntryVelocity;
+}
+
+bool FParkourTraversalSyncState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    Super::NetSerialize(Ar, Map, bOutSuccess);
+
+    Ar << ActionIndex;
+
+    if (IsActive())
+    {
+        Ar << PhaseIndex;
+        Ar << PhaseElapsed;
+        SerializePackedVector<10, 24>(SurfacePoint, Ar);
+        SerializeFixedVector<1, 16>(SurfaceForward, Ar);
+        Ar << SurfaceHeight;
+        SerializePackedVector<10, 24>(PhaseStart, Ar);
+        SerializePackedVector<10, 18>(EntryVelocity, Ar);
+    }
+
+    bOutSuccess = true;
+    return true;
+}
+
+void FParkourTraversalSyncState::ToString(FAnsiStringBuilderBase& Out) const
+{
+    Super::ToString(Out);
+
+    Out.Appendf("ActionIndex=%d PhaseIndex=%d PhaseElapsed=%.4f\n",
+        ActionIndex, PhaseIndex, PhaseElapsed);
+}
+
+bool FParkourTraversalSyncState::ShouldReconcile(const FMoverDataStructBase& AuthorityState) const
+{
+    const FParkourTraversalSyncState& Authority = static_cast<const FParkourTraversalSyncState&>(AuthorityState);
+
+    return ActionIndex != Authority.ActionIndex
+        || PhaseIndex != Authority.PhaseIndex
+        || !FMath::IsNearlyEqual(PhaseElapsed, Authority.PhaseElapsed, 0.005f);
+}
+
+void FParkourTraversalSyncState::Interpolate(const FMoverDataStructBase& From, const FMoverDataStructBase& To, float Pct)
+{
+    const FParkourTraversalSyncState& FromState = static_cast<const FParkourTraversalSyncState&>(From);
+    const FParkourTraversalSyncState& ToState = static_cast<const FParkourTraversalSyncState&>(To);
+
+    *this = ToState;
+
+    // Blend progress only inside the same phase, otherwise snap to the newer one
+    if (FromState.ActionIndex == ToState.ActionIndex && FromState.PhaseIndex == ToState.PhaseIndex)
+    {
+        PhaseElapsed = FMath::Lerp(FromState.PhaseElapsed, ToState.PhaseElapsed, Pct);
+    }
+}
@@ -0,0 +1,273 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Game-thread cost of UParkourMovementComponent vs the Mover backend, side by side.
+// Run headless with: -nullrhi -ExecCmds="Parkour.BackendCompare 32 10"
+// Add -ini:Engine:[/Script/Engine.PhysicsSettings]:bTickPhysicsAsync=True to put the Mover
+// simulation on the physics thread.
+// Both backends vault with the same table: the Mover pawn builds it from its TraversalSource,
+// which defaults to the same first person character the game mode spawns.
+
+#include "CoreMinimal.h"
+#include "Character/ParkourCharacter.h"
+#include "Character/ParkourMovementComponent.h"
+#include "Character/Mover/ParkourMoverComponent.h"
+#include "Character/Mover/ParkourMoverPawn.h"
+#include "Containers/Ticker.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace TraversalBackendCompare
+{
+    // Away from the level and the traversal harness lanes
+    static const FVector TestOrigin(0.f, 0.f, 60000.f);
+    static const float PawnSpacing = 600.f;
+    static const int32 WarmupFrames = 30;
+
+    struct FBackendResult
+    {
+        FString Name;
+        int32 Pawns = 0;
+        int32 Frames = 0;
+        int32 Traversals = 0;
+        TArray<double> GameThreadMs;
+    };
+
+    struct FRun
+    {
+        TWeakObjectPtr<UWorld> World;
+        int32 PawnCount = 16;
+        float Seconds = 5.f;
+
+        // 0 = CMC, 1 = Mover, 2 = done
+        int32 Backend = 0;
+        int32 Frame = 0;
+        float Elapsed = 0.f;
+
+        TArray<TWeakObjectPtr<APawn>> Pawns;
+        TWeakObjectPtr<AActor> Floor;
+        TArray<FBackendResult> Results;
+    };
+
+    // Vault over an imaginary box ahead, turning round at the edge of the floor.
+    // The surface is synthetic so both backends pay only for the move, not for detection.
+    static FClimbableSurfaceResult MakeSurface(const APawn* Pawn, const FVector& LaneOrigin)
+    {
+        const float Direction = Pawn->GetActorLocation().X > LaneOrigin.X ? -1.f : 1.f;
+
+        FClimbableSurfaceResult Surface;
+        Surface.bIsValid = true;
+        Surface.SurfaceType = EClimbableSurfaceType::Vaultable;
+        Surface.SurfaceForward = FVector(Direction, 0.f, 0.f);
+        Surface.ImpactPoint = Pawn->GetActorLocation() + Surface.SurfaceForward * 80.f;
+        Surface.SurfaceHeight = 70.f;
+        return Surface;
+    }
+
+    static FVector LaneOrigin(int32 Index)
+    {
+        return TestOrigin + FVector(0.f, Index * PawnSpacing, 0.f);
+    }
+
+    static void SpawnPawns(FRun& Run, UWorld* World)
+    {
+        UClass* PawnClass = nullptr;
+        if (Run.Backend == 0)
+        {
+            PawnClass = AParkourCharacter::StaticClass();
+            const AGameModeBase* GameMode = World->GetAuthGameMode();
+            if (GameMode && GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(AParkourCharacter::StaticClass()))
+            {
+                PawnClass = GameMode->DefaultPawnClass;
+            }
+        }
+        else
+        {
+            PawnClass = AParkourMoverPawn::StaticClass();
+        }
+
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        for (int32 i = 0; i < Run.PawnCount; ++i)
+        {
+            APawn* Pawn = World->SpawnActor<APawn>(PawnClass, LaneOrigin(i), FRotator::ZeroRotator, Params);
+            if (!Pawn) continue;
+
+            if (AParkourCharacter* Character = Cast<AParkourCharacter>(Pawn))
+            {
+                if (UParkourMovementComponent* MoveComp = Cast<UParkourMovementComponent>(Character->GetCharacterMovement()))
+                {
+                    MoveComp->LoadTraversalCurvesBlocking();
+                }
+            }
+            else if (AParkourMoverPawn* MoverPawn = Cast<AParkourMoverPawn>(Pawn))
+            {
+                MoverPawn->GetParkourMover()->LoadTraversalActionsBlocking();
+            }
+            Run.Pawns.Add(Pawn);
+        }
+
+        FBackendResult& Result = Run.Results.AddDefaulted_GetRef();
+        Result.Name = Run.Backend == 0 ? TEXT("CharacterMovement") : TEXT("Mover");
+        Result.Pawns = Run.Pawns.Num();
+    }
+
+    static void DestroyPawns(FRun& Run)
+    {
+        for (const TWeakObjectPtr<APawn>& Pawn : Run.Pawns)
+        {
+            if (Pawn.IsValid()) Pawn->Destroy();
+        }
+        Run.Pawns.Reset();
+    }
+
+    // Keeps every pawn mid-vault, returns how many started this frame
+    static int32 DrivePawns(FRun& Run)
+    {
+        int32 Started = 0;
+        for (int32 i = 0; i < Run.Pawns.Num(); ++i)
+        {
+            APawn* Pawn = Run.Pawns[i].Get();
+            if (!Pawn) continue;
+
+            const FClimbableSurfaceResult Surface = MakeSurface(Pawn, LaneOrigin(i));
+
+            if (AParkourCharacter* Character = Cast<AParkourCharacter>(Pawn))
+            {
+                UParkourMovementComponent* MoveComp = Cast<UParkourMovementComponent>(Character->GetCharacterMovement());
+                if (MoveComp && !MoveComp->IsTraversing() && MoveComp->IsMovingOnGround())
+                {
+                    MoveComp->BeginVault(Surface);
+                    ++Started;
+                }
+            }
+            else if (AParkourMoverPawn* MoverPawn = Cast<AParkourMoverPawn>(Pawn))
+            {
+                if (MoverPawn->GetParkourMover()->RequestTraversal(ParkourModeNames::Vault, Surface))
+                {
+                    ++Started;
+                }
+            }
+        }
+        return Started;
+    }
+
+    static void WriteReport(const FRun& Run)
+    {
+        TArray<FString> Lines;
+        Lines.Add(TEXT("Backend,Pawns,AsyncPhysics,Frames,Traversals,AvgGameThreadMs,P95GameThreadMs,MaxGameThreadMs"));
+
+        for (const FBackendResult& Result : Run.Results)
+        {
+            TArray<double> Sorted = Result.GameThreadMs;
+            Sorted.Sort();
+
+            double Total = 0.0;
+            for (double Ms : Sorted) Total += Ms;
+
+            const double Avg = Sorted.Num() > 0 ? Total / Sorted.Num() : 0.0;
+            const double P95 = Sorted.Num() > 0 ? Sorted[FMath::Min(Sorted.Num() - 1, FMath::FloorToInt(Sorted.Num() * 0.95f))] : 0.0;
+            const double Max = Sorted.Num() > 0 ? Sorted.Last() : 0.0;
+
+            Lines.Add(FString::Printf(TEXT("%s,%d,%d,%d,%d,%.4f,%.4f,%.4f"), *Result.Name, Result.Pawns,
+                UParkourMoverComponent::UsesAsyncPhysics() ? 1 : 0, Result.Frames, Result.Traversals, Avg, P95, Max));
+
+            UE_LOG(LogParkourCharacter, Log, TEXT("[BackendCompare] %-18s pawns %3d  frames %5d  traversals %5d  game thread avg %.3f ms  p95 %.3f ms  max %.3f ms"),
+                *Result.Name, Result.Pawns, Result.Frames, Result.Traversals, Avg, P95, Max);
+        }
+
+        const FString ReportPath = FPaths::ProjectSavedDir() / TEXT("TraversalHarness/BackendCompare.csv");
+        FFileHelper::SaveStringArrayToFile(Lines, *ReportPath);
+        UE_LOG(LogParkourCharacter, Log, TEXT("[BackendCompare] Report written to %s"), *ReportPath);
+    }
+
+    static bool Tick(TSharedRef<FRun> Run, float DeltaTime)
+    {
+        UWorld* World = Run->World.Get();
+        if (!World)
+        {
+            return false;
+        }
+
+        FBackendResult& Result = Run->Results.Last();
+        Result.Traversals += DrivePawns(*Run);
+
+        // GGameThreadTime is the last full frame, which includes all pawn ticks
+        if (++Run->Frame > WarmupFrames)
+        {
+            Result.GameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+            ++Result.Frames;
+            Run->Elapsed += DeltaTime;
+        }
+
+        if (Run->Elapsed < Run->Seconds)
+        {
+            return true;
+        }
+
+        DestroyPawns(*Run);
+        Run->Frame = 0;
+        Run->Elapsed = 0.f;
+
+        if (++Run->Backend < 2)
+        {
+            SpawnPawns(*Run, World);
+            return true;
+        }
+
+        if (Run->Floor.IsValid()) Run->Floor->Destroy();
+        WriteReport(*Run);
+        return false;
+    }
+
+    static void Start(UWorld* World, int32 PawnCount, float Seconds)
+    {
+        UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+        if (!Cube)
+        {
+            UE_LOG(LogParkourCharacter, Error, TEXT("[BackendCompare] Engine cube mesh missing"));
+            return;
+        }
+
+        TSharedRef<FRun> Run = MakeShared<FRun>();
+        Run->World = World;
+        Run->PawnCount = PawnCount;
+        Run->Seconds = Seconds;
+
+        // One floor under every lane, top face at the lane origin minus the capsule half height
+        const FVector FloorSize(2000.f, PawnCount * PawnSpacing, 50.f);
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(TestOrigin + FVector(0.f, FloorSize.Y * 0.5f - PawnSpacing * 0.5f, -96.f - FloorSize.Z * 0.5f), FRotator::ZeroRotator, Params);
+        Floor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+        Floor->GetStaticMeshComponent()->SetStaticMesh(Cube);
+        Floor->SetActorScale3D(FloorSize / 100.f);
+        Run->Floor = Floor;
+
+        SpawnPawns(*Run, World);
+
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Run](float DeltaTime)
+            {
+                return Tick(Run, DeltaTime);
+            }));
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs BackendCompareCommand(
+        TEXT("Parkour.BackendCompare"),
+        TEXT("Keeps N pawns vaulting on the CharacterMovement backend, then on the Mover backend, and writes average game-thread time to Saved/TraversalHarness/BackendCompare.csv. Args: [Pawns=16] [Seconds=5]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                if (World && World->IsGameWorld())
+                {
+                    const int32 Pawns = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 64) : 16;
+                    const float Seconds = Args.Num() > 1 ? FMath::Max(1.f, FCString::Atof(*Args[1])) : 5.f;
+                    Start(World, Pawns, Seconds);
+                }
+            }));
+}
@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/ParkourArmsAnimInstance.h"
+#include "KiwiJam2025.h"
+#include "Animation/AnimNodeBase.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimationPoseData.h"
+#include "AnimationRuntime.h"
+#include "GameFramework/Pawn.h"
+
+DECLARE_CYCLE_STAT(TEXT("Arms Anim Update"), STAT_ParkourArmsUpdate, STATGROUP_KiwiJam);
+DECLARE_CYCLE_STAT(TEXT("Arms Anim Evaluate"), STAT_ParkourArmsEvaluate, STATGROUP_KiwiJam);
+
+UParkourArmsAnimInstance::UParkourArmsAnimInstance()
+{
+	// Phase names of the default climb and vault built by UParkourMovementComponent
+	PhasePoses.Add(TEXT("Approach"), EParkourArmsPose::Grab);
+	PhasePoses.Add(TEXT("Grab"), EParkourArmsPose::Grab);
+	PhasePoses.Add(TEXT("PullUp"), EParkourArmsPose::PullUp);
+	PhasePoses.Add(TEXT("Arc"), EParkourArmsPose::VaultPlant);
+}
+
+FAnimInstanceProxy* UParkourArmsAnimInstance::CreateAnimInstanceProxy()
+{
+    return new FParkourArmsAnimInstanceProxy(this);
+}
+
+void UParkourArmsAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+    delete static_cast<FParkourArmsAnimInstanceProxy*>(InProxy);
+}
+
+float UParkourArmsAnimInstance::GetPoseWeight(EParkourArmsPose Pose) const
+{
+    const int32 Index = (int32)Pose;
+    if (Index <= 0 || Index >= FParkourArmsAnimInstanceProxy::NumPoses) return 0.f;
+
+    return GetProxyOnAnyThread<FParkourArmsAnimInstanceProxy>().PoseWeights[Index];
+}
+
+void FParkourArmsAnimInstanceProxy::Initialize(UAnimInstance* InAnimInstance)
+{
+    FAnimInstanceProxy::Initialize(InAnimInstance);
+
+    const UParkourArmsAnimInstance* Arms = CastChecked<UParkourArmsAnimInstance>(InAnimInstance);
+    IdleSequence = Arms->IdleSequence;
+    MoveSequence = Arms->MoveSequence;
+    PoseSequences[(int32)EParkourArmsPose::Grab] = Arms->GrabSequence;
+    PoseSequences[(int32)EParkourArmsPose::VaultPlant] = Arms->VaultPlantSequence;
+    PoseSequences[(int32)EParkourArmsPose::PullUp] = Arms->PullUpSequence;
+    PhasePoses = Arms->PhasePoses;
+    MoveBlendSpeed = FMath::Max(Arms->MoveBlendSpeed, 1.f);
+    BlendInTime = Arms->BlendInTime;
+    BlendOutTime = Arms->BlendOutTime;
+    VaultPlantRelease = Arms->VaultPlantRelease;
+
+    const APawn* Pawn = InAnimInstance->TryGetPawnOwner();
+    Movement = Pawn ? Pawn->FindComponentByClass<UParkourMovementComponent>() : nullptr;
+}
+
+void FParkourArmsAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+    FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+    // The only game thread work: one small copy
+    if (const UParkourMovementComponent* MovementComponent = Movement.Get())
+    {
+        MovementComponent->GetArmsState(State);
+    }
+    else
+    {
+        State = FParkourArmsState();
+    }
+}
+
+EParkourArmsPose FParkourArmsAnimInstanceProxy::GetTargetPose() const
+{
+    switch (State.Action)
+    {
+    case EParkourArmsAction::Hang:
+        return EParkourArmsPose::Grab;
+
+    case EParkourArmsAction::Climb:
+    case EParkourArmsAction::Vault:
+    {
+        const EParkourArmsPose* Pose = PhasePoses.Find(State.PhaseName);
+        if (!Pose)
+        {
+            // Unmapped phase of an authored action, still show something sensible
+            return State.Action == EParkourArmsAction::Vault ? EParkourArmsPose::VaultPlant : EParkourArmsPose::Grab;
+        }
+
+        // The hand leaves the obstacle partway over
+        if (*Pose == EParkourArmsPose::VaultPlant && State.ActionAlpha > VaultPlantRelease)
+        {
+            return EParkourArmsPose::None;
+        }
+        return *Pose;
+    }
+
+    default:
+        return EParkourArmsPose::None;
+    }
+}
+
+void FParkourArmsAnimInstanceProxy::Update(float DeltaSeconds)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ParkourArmsUpdate);
+
+    FAnimInstanceProxy::Update(DeltaSeconds);
+
+    const EParkourArmsPose Target = GetTargetPose();
+    const float InRate = BlendInTime > 0.f ? 1.f / BlendInTime : BIG_NUMBER;
+    const float OutRate = BlendOutTime > 0.f ? 1.f / BlendOutTime : BIG_NUMBER;
+
+    for (int32 Index = 1; Index < NumPoses; ++Index)
+    {
+        const bool bTarget = Index == (int32)Target;
+        PoseWeights[Index] = FMath::FInterpConstantTo(PoseWeights[Index], bTarget ? 1.f : 0.f, DeltaSeconds, bTarget ? InRate : OutRate);
+
+        // The active pose tracks the phase; poses blending out hold their last frame
+        const UAnimSequence* Sequence = PoseSequences[Index];
+        if (bTarget && Sequence)
+        {
+            PoseTimes[Index] = State.PhaseAlpha * Sequence->GetPlayLength();
+        }
+    }
+
+    // Locomotion, the arms drop out of it while airborne
+    const float TargetMoveAlpha = State.bFalling ? 0.f : FMath::Clamp(State.Speed / MoveBlendSpeed, 0.f, 1.f);
+    MoveAlpha = FMath::FInterpTo(MoveAlpha, TargetMoveAlpha, DeltaSeconds, 10.f);
+
+    if (MoveSequence && MoveSequence->GetPlayLength() > 0.f)
+    {
+        MoveTime = FMath::Fmod(MoveTime + DeltaSeconds * FMath::Max(MoveAlpha, 0.25f), MoveSequence->GetPlayLength());
+    }
+    if (IdleSequence && IdleSequence->GetPlayLength() > 0.f)
+    {
+        IdleTime = FMath::Fmod(IdleTime + DeltaSeconds, IdleSequence->GetPlayLength());
+    }
+}
+
+bool FParkourArmsAnimInstanceProxy::Evaluate(FPoseContext& Output)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ParkourArmsEvaluate);
+
+    // Idle, move and the three traversal poses at most
+    constexpr int32 MaxSources = 2 + NumPoses - 1;
+    TArray<FCompactPose, TInlineAllocator<MaxSources>> Poses;
+    TArray<FBlendedCurve, TInlineAllocator<MaxSources>> Curves;
+    TArray<UE::Anim::FStackAttributeContainer, TInlineAllocator<MaxSources>> Attributes;
+    TArray<float, TInlineAllocator<MaxSources>> Weights;
+
+    auto AddSource = [&](const UAnimSequence* Sequence, float Time, float Weight)
+        {
+            if (!Sequence || Weight <= ZERO_ANIMWEIGHT_THRESH) return;
+
+            FCompactPose& Pose = Poses.AddDefaulted_GetRef();
+            Pose.SetBoneContainer(&Output.Pose.GetBoneContainer());
+            FBlendedCurve& Curve = Curves.AddDefaulted_GetRef();
+            Curve.InitFrom(Output.Curve);
+            UE::Anim::FStackAttributeContainer& Attribute = Attributes.AddDefaulted_GetRef();
+
+            FAnimationPoseData PoseData(Pose, Curve, Attribute);
+            Sequence->GetAnimationPose(PoseData, FAnimExtractContext((double)Time));
+            Weights.Add(Weight);
+        };
+
+    // Traversal poses on top, locomotion fills whatever weight is left
+    float TraversalWeight = 0.f;
+    for (int32 Index = 1; Index < NumPoses; ++Index)
+    {
+        if (PoseSequences[Index])
+        {
+            TraversalWeight += PoseWeights[Index];
+        }
+    }
+    const float Scale = TraversalWeight > 1.f ? 1.f / TraversalWeight : 1.f;
+    const float LocomotionWeight = FMath::Max(0.f, 1.f - TraversalWeight);
+
+    for (int32 Index = 1; Index < NumPoses; ++Index)
+    {
+        AddSource(PoseSequences[Index], PoseTimes[Index], PoseWeights[Index] * Scale);
+    }
+    AddSource(IdleSequence, IdleTime, LocomotionWeight * (MoveSequence ? 1.f - MoveAlpha : 1.f));
+    AddSource(MoveSequence, MoveTime, LocomotionWeight * (IdleSequence ? MoveAlpha : 1.f));
+
+    if (Poses.Num() == 0)
+    {
+        Output.ResetToRefPose();
+        return true;
+    }
+
+    // Weights left short by a missing sequence are spread over the rest
+    float TotalWeight = 0.f;
+    for (float Weight : Weights)
+    {
+        TotalWeight += Weight;
+    }
+    for (float& Weight : Weights)
+    {
+        Weight /= TotalWeight;
+    }
+
+    FAnimationPoseData OutputData(Output);
+    FAnimationRuntime::BlendPosesTogether(Poses, Curves, Attributes, Weights, OutputData);
+    return true;
+}
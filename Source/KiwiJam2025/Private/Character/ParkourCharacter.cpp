@@ -9,9 +9,13 @@
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
 #include "Engine/LocalPlayer.h"
-#include "Blueprint/UserWidget.h"
-#include "UI/WorldMapWidget.h"
+#include "UI/ParkourUIDelegates.h"
 #include "GameFramework/PlayerController.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Core/ParkourEventBus.h"
+#include "Telemetry/InputReplay.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
 
 DEFINE_LOG_CATEGORY(LogParkourCharacter);
 
@@ -24,6 +28,8 @@ AParkourCharacter::AParkourCharacter(const FObjectInitializer& ObjectInitializer
 
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
+	// Floor hits carry their physical material, for landing sounds
+	GetCapsuleComponent()->bReturnMaterialOnMove = true;
 
 	// Create a CameraComponent	
 	FirstPersonCameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("FirstPersonCamera"));
@@ -35,21 +41,29 @@ AParkourCharacter::AParkourCharacter(const FObjectInitializer& ObjectInitializer
 	ClimbableDetectorComponent->SetOwnerCharacter(this);
 	//ClimbableDetectorComponent->RegisterComponent();
 
-	bMapOpen = false;
-
 }
 
 // Called when the game starts or when spawned
 void AParkourCharacter::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	InputRecorder = GetWorld()->GetSubsystem<UInputReplaySubsystem>();
+
+#if !UE_SERVER
+	// Usually already resident from the pawn data UI bundle; remote clients have no game mode to load it, so stream it here
+	if (!WorldMapWidgetClass.IsNull() && !WorldMapWidgetClass.Get())
+	{
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(WorldMapWidgetClass.ToSoftObjectPath());
+	}
+#endif
 }
 
 void AParkourCharacter::Move(const FInputActionValue& Value)
 {
 	// input is a Vector2D
 	FVector2D MovementVector = Value.Get<FVector2D>();
+	if (InputRecorder) InputRecorder->Record(EReplayInput::Move, MovementVector);
 
 	if (Controller != nullptr)
 	{
@@ -63,6 +77,7 @@ void AParkourCharacter::Look(const FInputActionValue& Value)
 {
 	// input is a Vector2D
 	FVector2D LookAxisVector = Value.Get<FVector2D>();
+	if (InputRecorder) InputRecorder->Record(EReplayInput::Look, LookAxisVector);
 
 	if (Controller != nullptr)
 	{
@@ -74,18 +89,78 @@ void AParkourCharacter::Look(const FInputActionValue& Value)
 
 void AParkourCharacter::BeginJump(const FInputActionValue& Value)
 {
+	if (InputRecorder) InputRecorder->Record(EReplayInput::BeginJump);
+	TryTraverse();
+}
+
+void AParkourCharacter::EndJump(const FInputActionValue& Value)
+{
+	if (InputRecorder) InputRecorder->Record(EReplayInput::EndJump);
+	StopJumping();
+}
+
+void AParkourCharacter::ApplyReplayInput(EReplayInput Input, const FVector2D& Value)
+{
+	switch (Input)
+	{
+	case EReplayInput::Move: Move(FInputActionValue(Value)); break;
+	case EReplayInput::Look: Look(FInputActionValue(Value)); break;
+	case EReplayInput::BeginJump: BeginJump(FInputActionValue(true)); break;
+	case EReplayInput::EndJump: EndJump(FInputActionValue(false)); break;
+	case EReplayInput::ToggleMap: ToggleMap(FInputActionValue(true)); break;
+	case EReplayInput::BeginSlide: BeginSlide(FInputActionValue(true)); break;
+	case EReplayInput::EndSlide: EndSlide(FInputActionValue(false)); break;
+	default: break;
+	}
+}
+
+void AParkourCharacter::TryTraverse()
+{
+	UParkourMovementComponent* ParkourMovement = Cast<UParkourMovementComponent>(GetCharacterMovement());
+
+	// Jump while hanging pulls up onto the ledge
+	if (ParkourMovement && ParkourMovement->IsHanging())
+	{
+		ParkourMovement->PullUpFromHang();
+		return;
+	}
+
+	if (ParkourMovement && ParkourMovement->IsOnRail())
+	{
+		ParkourMovement->JumpOffRail();
+		return;
+	}
+
 	if (ClimbableDetectorComponent)
 	{
+		// Rails in reach take the jump before anything the traces found
+		FRailAttachment Rail;
+		if (ParkourMovement && ClimbableDetectorComponent->DetectRail(Rail) && ParkourMovement->BeginRail(Rail))
+		{
+			return;
+		}
+
 		FClimbableSurfaceResult Result;
-		FClimbableSurfaceResult VaultResult;
 
-		if (ClimbableDetectorComponent->CheckVaultSurface(VaultResult) && VaultResult.SurfaceType == EClimbableSurfaceType::Vaultable)
+		// The affordance scan has usually probed this spot already; only trace again if it's stale
+		if (!ClimbableDetectorComponent->ConsumeAffordance(Result))
 		{
-			Cast<UParkourMovementComponent>(GetCharacterMovement())->BeginVault(VaultResult);
+			if (!ClimbableDetectorComponent->CheckVaultSurface(Result))
+			{
+				ClimbableDetectorComponent->DetectClimbableSurface(Result);
+			}
 		}
-		else if (ClimbableDetectorComponent->DetectClimbableSurface(Result) && Result.SurfaceType == EClimbableSurfaceType::Ledge)
+
+		if (Result.bIsValid && Result.SurfaceType == EClimbableSurfaceType::Vaultable)
+		{
+			ParkourMovement->BeginVault(Result);
+		}
+		else if (Result.bIsValid && Result.SurfaceType == EClimbableSurfaceType::Ledge)
 		{
-			Cast<UParkourMovementComponent>(GetCharacterMovement())->BeginClimb(Result);
+			if (!ParkourMovement->ShouldHang(Result) || !ParkourMovement->BeginHang(Result))
+			{
+				ParkourMovement->BeginClimb(Result);
+			}
 		}
 		else
 		{
@@ -95,6 +170,24 @@ void AParkourCharacter::BeginJump(const FInputActionValue& Value)
 
 }
 
+void AParkourCharacter::BeginSlide(const FInputActionValue& Value)
+{
+	if (InputRecorder) InputRecorder->Record(EReplayInput::BeginSlide);
+	if (UParkourMovementComponent* ParkourMovement = Cast<UParkourMovementComponent>(GetCharacterMovement()))
+	{
+		ParkourMovement->SetWantsToSlide(true);
+	}
+}
+
+void AParkourCharacter::EndSlide(const FInputActionValue& Value)
+{
+	if (InputRecorder) InputRecorder->Record(EReplayInput::EndSlide);
+	if (UParkourMovementComponent* ParkourMovement = Cast<UParkourMovementComponent>(GetCharacterMovement()))
+	{
+		ParkourMovement->SetWantsToSlide(false);
+	}
+}
+
 void AParkourCharacter::SetCameraRotation()
 {
 	FirstPersonCameraComponent->SetWorldRotation(GetControlRotation() + AdditionalCameraRotation);
@@ -103,33 +196,22 @@ void AParkourCharacter::SetCameraRotation()
 
 void AParkourCharacter::ToggleMap(const FInputActionValue& Value)
 {
-	APlayerController* PC = Cast<APlayerController>(GetController()); 
-	if (!PC || !WorldMapWidgetClass) return; 
+	if (InputRecorder) InputRecorder->Record(EReplayInput::ToggleMap);
 
-	if (!bMapOpen)
-	{
-		// Create and display map
-		if (!WorldMapWidget) 
-		{
-			WorldMapWidget = CreateWidget<UWorldMapWidget>(PC, WorldMapWidgetClass); 
-			if (!WorldMapWidget) return;
-
-			// Example: Set world bounds before showing
-			FBox MapBounds(FVector(-2000, -2000, 0), FVector(2000, 2000, 0));
-			WorldMapWidget->SetWorldBounds(MapBounds);  
-		}
+	// The HUD module opens or closes the map; nothing is bound on a server
+	FParkourUIDelegates::OnToggleMap.Broadcast(*this);
+}
 
-		WorldMapWidget->AddToViewport();
-		bMapOpen = true;
-	}
-	else
-	{
-		if (WorldMapWidget)
-		{
-			WorldMapWidget->RemoveFromParent();
-		}
-		bMapOpen = false;
-	}
+void AParkourCharacter::Landed(const FHitResult& Hit)
+{
+	Super::Landed(Hit);
+
+	FParkourLandedEvent Event;
+	Event.Location = FVector3f(Hit.ImpactPoint);
+	Event.FallSpeed = -GetCharacterMovement()->Velocity.Z;
+	Event.Surface = UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get());
+	Event.Pawn = this;
+	UParkourEventBus::Publish(GetWorld(), Event);
 }
 
 // Called every frame
@@ -137,6 +219,12 @@ void AParkourCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (BotDriver && Controller && IsLocallyControlled())
+	{
+		BotDriver->Tick(*this, DeltaTime);
+		Controller->SetControlRotation(FRotator(0.f, (BotDriver->GetTarget() - GetActorLocation()).Rotation().Yaw, 0.f));
+	}
+
 	SetCameraRotation();
 }
 
@@ -152,6 +240,20 @@ void AParkourCharacter::NotifyControllerChanged()
 			Subsystem->AddMappingContext(DefaultMappingContext, 0); 
 		}
 	}
+
+	// The HUD module puts the traversal prompt up for it
+	if (IsLocallyControlled() && Cast<APlayerController>(Controller))
+	{
+		FParkourUIDelegates::OnLocalCharacterReady.Broadcast(*this);
+	}
+
+	// Load test client: runs the course like a server bot, but through a real connection
+	BotDriver.Reset();
+	if (FParkourBotDriver::IsBotClient() && IsLocallyControlled() && Cast<APlayerController>(Controller))
+	{
+		BotDriver.Emplace();
+		BotDriver->Start(*this, FPlatformProcess::GetCurrentProcessId());
+	}
 }
 
 // Called to bind functionality to input
@@ -163,7 +265,7 @@ void AParkourCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	{
 		// Jumping
 		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &AParkourCharacter::BeginJump);
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &AParkourCharacter::EndJump);
 
 		// Moving
 		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AParkourCharacter::Move);
@@ -171,6 +273,13 @@ void AParkourCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 		// Looking
 		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &AParkourCharacter::Look);
 
+		// Sliding
+		if (SlideAction)
+		{
+			EnhancedInputComponent->BindAction(SlideAction, ETriggerEvent::Started, this, &AParkourCharacter::BeginSlide);
+			EnhancedInputComponent->BindAction(SlideAction, ETriggerEvent::Completed, this, &AParkourCharacter::EndSlide);
+		}
+
 		//Map
 		EnhancedInputComponent->BindAction(MapAction, ETriggerEvent::Triggered, this, &AParkourCharacter::ToggleMap);
 	}
@@ -184,9 +293,3 @@ void AParkourCharacter::AddCameraRotation(FRotator Rotation)
 {
 	AdditionalCameraRotation += Rotation;
 }
-
-UWorldMapWidget* AParkourCharacter::GetWorldMapWidget()
-{
-	return WorldMapWidget;
-}
-
@@ -5,30 +5,209 @@
 #include "Character/ClimbableDetectorComponent.h"
 #include "GameFramework/Character.h" 
 #include "Components/CapsuleComponent.h"
+#include "Curves/CurveFloat.h"
 #include "Curves/CurveVector.h"
 #include "Camera/CameraComponent.h"
 #include "Character/ParkourCharacter.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "KiwiJam2025.h"
+#include "Telemetry/TraversalTelemetry.h"
+#include "Core/ParkourEventBus.h"
+
+DECLARE_CYCLE_STAT(TEXT("CMC Traversal Tick"), STAT_ParkourCMCTraversal, STATGROUP_KiwiJam);
+DECLARE_CYCLE_STAT(TEXT("CMC Rail Tick"), STAT_ParkourCMCRail, STATGROUP_KiwiJam);
 
 UParkourMovementComponent::UParkourMovementComponent()
 {
     PrimaryComponentTick.bCanEverTick = true;
+
+    // Slide runs on the crouched capsule
+    NavAgentProps.bCanCrouch = true;
 }
 
-void UParkourMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UParkourMovementComponent::BeginPlay()
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    Super::BeginPlay();
+
+    Telemetry = GetWorld()->GetSubsystem<UTraversalTelemetrySubsystem>();
+    Events = GetWorld()->GetSubsystem<UParkourEventBus>();
+
+    ResolveTraversalCurves();
+
+    if (LoadedClimbProgressCurve && LoadedVaultCurve && LoadedVaultCameraTiltCurve && (LoadedTraversalActions || TraversalActions.IsNull()))
+        return;
+
+    // Stream in whatever isn't resident yet
+    TArray<FSoftObjectPath> Missing;
+    if (!ClimbProgressCurve.IsNull() && !LoadedClimbProgressCurve) Missing.Add(ClimbProgressCurve.ToSoftObjectPath());
+    if (!VaultCurve.IsNull() && !LoadedVaultCurve) Missing.Add(VaultCurve.ToSoftObjectPath());
+    if (!VaultCameraTiltCurve.IsNull() && !LoadedVaultCameraTiltCurve) Missing.Add(VaultCameraTiltCurve.ToSoftObjectPath());
+    if (!TraversalActions.IsNull() && !LoadedTraversalActions) Missing.Add(TraversalActions.ToSoftObjectPath());
+
+    if (Missing.Num() > 0)
+    {
+        UAssetManager::GetStreamableManager().RequestAsyncLoad(Missing,
+            FStreamableDelegate::CreateUObject(this, &UParkourMovementComponent::ResolveTraversalCurves));
+    }
+}
+
+void UParkourMovementComponent::LoadTraversalCurvesBlocking()
+{
+    ClimbProgressCurve.LoadSynchronous();
+    VaultCurve.LoadSynchronous();
+    VaultCameraTiltCurve.LoadSynchronous();
+    TraversalActions.LoadSynchronous();
+    ResolveTraversalCurves();
+}
+
+void UParkourMovementComponent::ResolveTraversalCurves()
+{
+    LoadedClimbProgressCurve = ClimbProgressCurve.Get();
+    LoadedVaultCurve = VaultCurve.Get();
+    LoadedVaultCameraTiltCurve = VaultCameraTiltCurve.Get();
+    LoadedTraversalActions = TraversalActions.Get();
+
+    // Don't swap tables under a running move
+    if (IsTraversing())
+    {
+        bTableRebuildPending = true;
+        return;
+    }
+    bTableRebuildPending = false;
+
+    if (LoadedTraversalActions)
+    {
+        ActiveTable = &LoadedTraversalActions->GetTable();
+    }
+    else
+    {
+        BuildDefaultTraversalTable(DefaultTable);
+        ActiveTable = &DefaultTable;
+    }
+}
+
+void UParkourMovementComponent::ResolvePendingTraversalTable()
+{
+    if (bTableRebuildPending && !IsTraversing())
+    {
+        ResolveTraversalCurves();
+    }
+}
 
-    if (bShouldApplyPostVaultVelocity && MovementMode == MOVE_Walking)
+void UParkourMovementComponent::GetTraversalCurvePaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+    if (!ClimbProgressCurve.IsNull()) OutPaths.Add(ClimbProgressCurve.ToSoftObjectPath());
+    if (!VaultCurve.IsNull()) OutPaths.Add(VaultCurve.ToSoftObjectPath());
+    if (!VaultCameraTiltCurve.IsNull()) OutPaths.Add(VaultCameraTiltCurve.ToSoftObjectPath());
+}
+
+void UParkourMovementComponent::BuildDefaultTraversalTable(FTraversalActionTable& OutTable) const
+{
+    OutTable.Reset();
+
+    // Get() rather than the Loaded* members, so a class default can build the table too
+    UCurveFloat* ClimbCurve = ClimbProgressCurve.Get();
+    UCurveVector* VaultPathCurve = VaultCurve.Get();
+
+    // Climb: approach under the ledge, rise to the top, pull over
     {
-        Launch(PendingPostVaultVelocity);
-        bShouldApplyPostVaultVelocity = false;
+        FTraversalActionDef Climb;
+        Climb.Name = ClimbActionName;
+
+        FTraversalPhaseDef& Approach = Climb.Phases.AddDefaulted_GetRef();
+        Approach.Name = TEXT("Approach");
+        Approach.Duration = ApproachTime;
+        Approach.TargetOffset = FVector(-50.f, 0.f, -40.f);
+        Approach.AlphaCurve = ClimbCurve;
+        Approach.CameraPolicy = ETraversalCameraPolicy::FaceSurface;
+        Approach.CameraPitch = ClimbTargetPitch;
+        Approach.CameraInterpSpeed = 6.f;
+        Approach.CameraYawInterpSpeed = 8.f;
+
+        FTraversalPhaseDef& Grab = Climb.Phases.AddDefaulted_GetRef();
+        Grab.Name = TEXT("Grab");
+        Grab.Duration = GrabTime;
+        Grab.TargetOffset = FVector(-50.f, 0.f, 120.f);
+        Grab.AlphaCurve = ClimbCurve;
+        Grab.CameraPolicy = ETraversalCameraPolicy::Pitch;
+        Grab.CameraPitch = -0.5f * ClimbTargetPitch;
+        Grab.CameraInterpSpeed = 4.f;
+
+        FTraversalPhaseDef& PullUp = Climb.Phases.AddDefaulted_GetRef();
+        PullUp.Name = TEXT("PullUp");
+        PullUp.Duration = PullUpTime;
+        PullUp.TargetOffset = FVector(30.f, 0.f, 120.f);
+        PullUp.AlphaCurve = ClimbCurve;
+
+        OutTable.Compile(Climb);
     }
 
-    if (VaultCameraTiltCurve && bVaulting) 
+    // Vault: one curve-driven arc over the obstacle, keeping momentum
+    if (VaultPathCurve)
     {
-        float Alpha = FMath::Clamp(VaultElapsed / VaultTime, 0.f, 1.f);
-        float CurveValue = VaultCameraTiltCurve->GetFloatValue(Alpha);
-        CurrentVaultTilt = CurveValue * MaxCameraTilt;
+        FTraversalActionDef Vault;
+        Vault.Name = VaultActionName;
+        Vault.bCarryEntryVelocity = true;
+        Vault.ExitForwardSpeed = VaultForwardDistance;
+
+        FTraversalPhaseDef& Arc = Vault.Phases.AddDefaulted_GetRef();
+        Arc.Name = TEXT("Arc");
+        Arc.Duration = VaultTime;
+        Arc.PathMode = ETraversalPathMode::CurveOffset;
+        Arc.PathCurve = VaultPathCurve;
+        Arc.PathScale = FVector(VaultForwardDistance, 1.f, 1.f);
+        Arc.bScalePathZBySurfaceHeight = true;
+        Arc.TargetOffset = FVector(0.f, 0.f, 50.f);
+        Arc.CameraRollCurve = VaultCameraTiltCurve.Get();
+        Arc.MaxCameraRoll = MaxCameraTilt;
+
+        OutTable.Compile(Vault);
+    }
+}
+
+void UParkourMovementComponent::GetArmsState(FParkourArmsState& OutState) const
+{
+    OutState = FParkourArmsState();
+    OutState.Speed = Velocity.Size2D();
+    OutState.bFalling = IsFalling();
+    OutState.bSliding = bIsSliding;
+
+    // Ziplines hang from the hands like a ledge does
+    const URideRailComponent* Rail = IsOnRail() ? RailAttachment.Rail.Get() : nullptr;
+    if (IsHanging() || (Rail && Rail->Type == ERideRailType::Zipline))
+    {
+        OutState.Action = EParkourArmsAction::Hang;
+        return;
+    }
+
+    const FTraversalCompiledPhase* Phase = ActiveTable ? ActiveTable->GetCurrentPhase(TraversalState) : nullptr;
+    if (!Phase) return;
+
+    OutState.Action = CustomMovementMode == MOVE_Vault ? EParkourArmsAction::Vault : EParkourArmsAction::Climb;
+    OutState.PhaseName = Phase->Name;
+    OutState.PhaseAlpha = FMath::Clamp(TraversalState.PhaseElapsed * Phase->InvDuration, 0.f, 1.f);
+
+    // Earlier phases are done, so the action so far is their durations plus this one's elapsed
+    const FTraversalCompiledAction& Action = ActiveTable->Actions[TraversalState.ActionIndex];
+    float Elapsed = TraversalState.PhaseElapsed;
+    for (int32 i = 0; i < TraversalState.PhaseIndex; ++i)
+    {
+        Elapsed += ActiveTable->Phases[Action.FirstPhase + i].Duration;
+    }
+    const float Duration = ActiveTable->GetActionDuration(TraversalState.ActionIndex);
+    OutState.ActionAlpha = Duration > 0.f ? FMath::Clamp(Elapsed / Duration, 0.f, 1.f) : 0.f;
+}
+
+void UParkourMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    const FTraversalCompiledPhase* Phase = ActiveTable ? ActiveTable->GetCurrentPhase(TraversalState) : nullptr;
+    if (Phase && Phase->CameraRollCurve)
+    {
+        float Alpha = FMath::Clamp(TraversalState.PhaseElapsed * Phase->InvDuration, 0.f, 1.f);
+        CurrentVaultTilt = Phase->CameraRollCurve->Eval(Alpha) * Phase->MaxCameraRoll;
     }
     else
     {
@@ -50,13 +229,17 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
     switch (CustomMovementMode)
     {
     case MOVE_Climb:
-        PhysClimb(deltaTime, Iterations);
+    case MOVE_Vault:
+        PhysTraversal(deltaTime, Iterations);
         break;
     case MOVE_WallRun:
         PhysWallRun(deltaTime, Iterations);
         break;
-    case MOVE_Vault:
-        PhysVault(deltaTime, Iterations);
+    case MOVE_Hang:
+        PhysHang(deltaTime, Iterations);
+        break;
+    case MOVE_Rail:
+        PhysRail(deltaTime, Iterations);
         break;
     default:
         Super::PhysCustom(deltaTime, Iterations); 
@@ -66,216 +249,591 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 
 void UParkourMovementComponent::BeginClimb(const FClimbableSurfaceResult& Surface)
 {
-    if (!CharacterOwner) return;
-
+    BeginTraversal(ClimbActionName, Surface, MOVE_Climb);
+}
 
-    ClimbPhase = EClimbPhase::Approach;
-    ClimbElapsed = 0.f;
-    bClimbActive = true;
+void UParkourMovementComponent::BeginVault(const FClimbableSurfaceResult& Surface)
+{
+    BeginTraversal(VaultActionName, Surface, MOVE_Vault);
+}
 
-    // Start = current position
-    ClimbStartLocation = CharacterOwner->GetActorLocation();
+bool UParkourMovementComponent::BeginTraversal(FName ActionName, const FClimbableSurfaceResult& Surface, uint8 CustomMode)
+{
+    if (!CharacterOwner || !ActiveTable) return false;
+
+    const int32 ActionIndex = ActiveTable->FindAction(ActionName);
+    if (ActionIndex == INDEX_NONE) return false;
+
+    TraversalState = FTraversalRunState();
+    TraversalState.ActionIndex = ActionIndex;
+    TraversalState.SurfacePoint = Surface.ImpactPoint;
+    TraversalState.SurfaceForward = Surface.SurfaceForward.GetSafeNormal2D();
+    TraversalState.SurfaceHeight = Surface.SurfaceHeight;
+    TraversalState.PhaseStart = CharacterOwner->GetActorLocation();
+    TraversalState.EntryVelocity = Velocity;
+
+    // Face the surface
+    DesiredFacingRotation = TraversalState.SurfaceForward.Rotation();
+    DesiredFacingRotation.Pitch = 0.f;
+    DesiredFacingRotation.Roll = 0.f;
+
+    // Platforms and lifts: run the move in the surface's frame so it lands where the ledge is now,
+    // not where it was at the jump. Static geometry stays in world space.
+    TraversalBaseFrame = FTransform::Identity;
+    if (Surface.HitComponent && MovementBaseUtility::IsDynamicBase(Surface.HitComponent))
+    {
+        TraversalState.Base = Surface.HitComponent;
+        UpdateTraversalBaseFrame();
+        TraversalState.SurfacePoint = TraversalBaseFrame.InverseTransformPositionNoScale(TraversalState.SurfacePoint);
+        TraversalState.SurfaceForward = TraversalBaseFrame.InverseTransformVectorNoScale(TraversalState.SurfaceForward);
+        TraversalState.PhaseStart = TraversalBaseFrame.InverseTransformPositionNoScale(TraversalState.PhaseStart);
+
+        // Base moves before we sample it, like walking on it
+        MovementBaseUtility::AddTickDependency(PrimaryComponentTick, Surface.HitComponent);
+    }
 
-    ClimbMidLocation = Surface.ImpactPoint + Surface.SurfaceForward * -50.f + FVector(0.f, 0.f, -40.f); // adjust Z for ledge grab
-    // End = up and over
-    ClimbTargetLocation = Surface.ImpactPoint + Surface.SurfaceForward * 30.f + FVector(0.f, 0.f, 120.f);
+    SetMovementMode(MOVE_Custom, CustomMode);
 
-    SetMovementMode(MOVE_Custom, MOVE_Climb);
+    if (Telemetry)
+    {
+        Telemetry->Record(ETraversalTelemetryEvent::TraversalStart, CharacterOwner->GetActorLocation());
+    }
 
-    // Face the ledge
-    DesiredClimbFacingRotation = Surface.SurfaceForward.Rotation();
-    DesiredClimbFacingRotation.Pitch = 0.f;
-    DesiredClimbFacingRotation.Roll = 0.f;
+    if (Events && CustomMode == MOVE_Vault)
+    {
+        FParkourVaultEvent Event;
+        Event.Location = FVector3f(Surface.ImpactPoint);
+        Event.Height = Surface.SurfaceHeight;
+        Event.Speed = Velocity.Size2D();
+        Event.Surface = Surface.PhysicalSurface;
+        Event.Pawn = CharacterOwner;
+        Events->Publish(Event);
+    }
+    else if (Events)
+    {
+        FParkourClimbEvent Event;
+        Event.Location = FVector3f(Surface.ImpactPoint);
+        Event.Height = Surface.SurfaceHeight;
+        Event.Surface = Surface.PhysicalSurface;
+        Event.Pawn = CharacterOwner;
+        Events->Publish(Event);
+    }
 
     if (bDebugDraw)
     {
-        DrawDebugSphere(GetWorld(), ClimbStartLocation, 8.f, 8, FColor::Blue, false, 5.f);
-        DrawDebugSphere(GetWorld(), ClimbMidLocation, 8.f, 8, FColor::Yellow, false, 5.f);
-        DrawDebugSphere(GetWorld(), ClimbTargetLocation, 8.f, 8, FColor::Green, false, 5.f);
+        const FTraversalCompiledAction& Action = ActiveTable->Actions[ActionIndex];
+        FTraversalRunState Preview = TraversalState;
+        DrawDebugSphere(GetWorld(), TraversalBaseFrame.TransformPositionNoScale(Preview.PhaseStart), 8.f, 8, FColor::Blue, false, 5.f);
+        for (int32 i = 0; i < Action.NumPhases; ++i)
+        {
+            const FVector PhaseEnd = ActiveTable->EvaluatePhase(ActiveTable->Phases[Action.FirstPhase + i], Preview, 1.f);
+            DrawDebugSphere(GetWorld(), TraversalBaseFrame.TransformPositionNoScale(PhaseEnd), 8.f, 8, i == Action.NumPhases - 1 ? FColor::Green : FColor::Yellow, false, 5.f);
+            Preview.PhaseStart = PhaseEnd;
+        }
     }
 
+    return true;
 }
 
-void UParkourMovementComponent::BeginVault(const FClimbableSurfaceResult& Surface)
+void UParkourMovementComponent::UpdateTraversalBaseFrame()
 {
-    if (!VaultCurve || !CharacterOwner) return;
-
-    VaultStart = CharacterOwner->GetActorLocation();
-    VaultTarget = Surface.ImpactPoint + (Surface.ImpactNormal * 100.f);
-    VaultHeight = Surface.SurfaceHeight;
-    // Direction for vault curve X axis
-    VaultDirection = Surface.SurfaceForward;
+    if (const UPrimitiveComponent* Base = TraversalState.Base.Get())
+    {
+        const FQuat Yaw(FVector::UpVector, Base->GetComponentQuat().GetTwistAngle(FVector::UpVector));
+        TraversalBaseFrame = FTransform(Yaw, Base->GetComponentLocation());
+    }
+}
 
-    VaultMomentumVelocity = Velocity;
+void UParkourMovementComponent::PhysTraversal(float deltaTime, int32 Iterations)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ParkourCMCTraversal);
 
-    VaultElapsed = 0.f;
-    bVaulting = true;
+    if (!CharacterOwner || !ActiveTable || !TraversalState.IsActive())
+    {
+        SetMovementMode(MOVE_Walking);
+        return;
+    }
 
-    SetMovementMode(MOVE_Custom, MOVE_Vault); // 1 = Vault
-}
+    FVector NewLocation;
+    const bool bStillRunning = ActiveTable->Evaluate(TraversalState, deltaTime, NewLocation);
 
-void UParkourMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
-{
-    if (!bClimbActive || !CharacterOwner) return;
+    // Resolved against the base as it is this step, from its transform alone, no traces
+    if (TraversalState.HasBase())
+    {
+        UpdateTraversalBaseFrame();
+        NewLocation = TraversalBaseFrame.TransformPositionNoScale(NewLocation);
+        DesiredFacingRotation.Yaw = TraversalBaseFrame.TransformVectorNoScale(TraversalState.SurfaceForward).Rotation().Yaw;
+    }
 
-    ClimbElapsed += deltaTime; 
+    // Collision for the phase we're in before moving, so the sweep can't catch the obstacle being crossed.
+    // The last step of a move keeps the collision of the phase it ends.
+    const FTraversalCompiledPhase* Phase = bStillRunning ? ActiveTable->GetCurrentPhase(TraversalState) : nullptr;
+    UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+    if (Phase && Capsule)
+    {
+        const ECollisionEnabled::Type Wanted = Phase->bDisableCollision ? ECollisionEnabled::NoCollision : ECollisionEnabled::QueryAndPhysics;
+        if (Capsule->GetCollisionEnabled() != Wanted)
+        {
+            Capsule->SetCollisionEnabled(Wanted);
+        }
+    }
 
-    float CurrentPhaseDuration = 0.f; 
-    FVector PhaseStart, PhaseEnd; 
+    FHitResult Hit;
+    SafeMoveUpdatedComponent(NewLocation - CharacterOwner->GetActorLocation(), CharacterOwner->GetActorRotation(), true, Hit);
 
-    switch (ClimbPhase)
+    if (!Phase)
     {
-    case EClimbPhase::Approach:
-        CurrentPhaseDuration = ApproachTime;
-        PhaseStart = ClimbStartLocation;
-        PhaseEnd = ClimbMidLocation;
-        break;
-    case EClimbPhase::Grab:
-        CurrentPhaseDuration = GrabTime;
-        PhaseStart = ClimbMidLocation;
-        PhaseEnd = FVector(ClimbMidLocation.X, ClimbMidLocation.Y, ClimbTargetLocation.Z ); // ledge top hold
-        break;
-    case EClimbPhase::PullUp:
-        CurrentPhaseDuration = PullUpTime;
-        PhaseStart = FVector(ClimbMidLocation.X, ClimbMidLocation.Y, ClimbTargetLocation.Z);
-        PhaseEnd = ClimbTargetLocation;
-        break;
-    default:
+        EndTraversal();
         return;
     }
 
-    if (ClimbPhase == EClimbPhase::Approach )
+    if (Phase->CameraPolicy != ETraversalCameraPolicy::None)
     {
         if (AController* Controller = CharacterOwner->GetController())
         {
-            FRotator Current = Controller->GetControlRotation();
-            FRotator Smoothed = FMath::RInterpTo(Current, DesiredClimbFacingRotation, deltaTime, 8.f);
-            Controller->SetControlRotation(Smoothed);
+            const FRotator Current = Controller->GetControlRotation();
+            FRotator Desired = Current;
+            Desired.Pitch = Phase->CameraPitch;
 
-            FRotator DesiredRotation = Current;
-            DesiredRotation.Pitch = ClimbTargetPitch;
-            FRotator NewPitch = FMath::RInterpTo(Current, DesiredRotation, deltaTime, 6.f);
-            Current = NewPitch;
+            FRotator NewRotation = FMath::RInterpTo(Current, Desired, deltaTime, Phase->CameraInterpSpeed);
+            if (Phase->CameraPolicy == ETraversalCameraPolicy::FaceSurface)
+            {
+                // Turns at its own speed, usually quicker than the pitch
+                Desired.Yaw = DesiredFacingRotation.Yaw;
+                NewRotation.Yaw = FMath::RInterpTo(Current, Desired, deltaTime, Phase->CameraYawInterpSpeed).Yaw;
+            }
 
-            Controller->SetControlRotation(Current);
+            Controller->SetControlRotation(NewRotation);
         }
-    
+    }
+}
+
+void UParkourMovementComponent::EndTraversal()
+{
+    const FTraversalCompiledAction& Action = ActiveTable->Actions[TraversalState.ActionIndex];
+    const bool bHasExitVelocity = Action.bCarryEntryVelocity || Action.ExitForwardSpeed != 0.f;
 
+    if (bHasExitVelocity)
+    {
+        PendingPostVaultVelocity = TraversalBaseFrame.TransformVectorNoScale(TraversalState.SurfaceForward) * Action.ExitForwardSpeed
+            + (Action.bCarryEntryVelocity ? TraversalState.EntryVelocity : FVector::ZeroVector);
     }
 
-    if (ClimbPhase == EClimbPhase::Grab)
+    UPrimitiveComponent* Base = TraversalState.Base.Get();
+    if (Base)
     {
-        if (AController* Controller = CharacterOwner->GetController())
+        MovementBaseUtility::RemoveTickDependency(PrimaryComponentTick, Base);
+    }
+
+    TraversalState = FTraversalRunState();
+    TraversalBaseFrame = FTransform::Identity;
+
+    if (Telemetry)
+    {
+        Telemetry->Record(ETraversalTelemetryEvent::TraversalEnd, CharacterOwner->GetActorLocation());
+    }
+
+    if (CharacterOwner->GetCapsuleComponent())
+    {
+        CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    }
+
+    if (bHasExitVelocity)
+    {
+        // Hand momentum straight over this frame; landing re-enters walking (or a slide if still held).
+        // Based on the platform for the switch, so falling picks up its velocity the way stepping off it would.
+        Velocity = PendingPostVaultVelocity;
+        if (Base)
         {
-            FRotator Current = Controller->GetControlRotation();
-            FRotator DesiredRotation = Current;
-            DesiredRotation.Pitch = -1.0f * (ClimbTargetPitch * 0.5f);
-            FRotator NewPitch = FMath::RInterpTo(Controller->GetControlRotation(), DesiredRotation, deltaTime, 4.f);
-            Current = NewPitch;
+            SetBase(Base);
+        }
+        SetMovementMode(MOVE_Falling);
+    }
+    else
+    {
+        // Walking finds the floor and bases on it as it starts, the platform top after a climb
+        SetMovementMode(MOVE_Walking);
+    }
+
+    // Pick up curves or a table that finished loading mid-move
+    ResolvePendingTraversalTable();
+}
+
+void UParkourMovementComponent::PhysWallRun(float deltaTime, int32 Iterations)
+{
+}
 
-            Controller->SetControlRotation(Current); 
+bool UParkourMovementComponent::ShouldHang(const FClimbableSurfaceResult& Surface) const
+{
+    return bEnableLedgeHang && Surface.SurfaceHeight >= HangMinLedgeHeight;
+}
+
+bool UParkourMovementComponent::BeginHang(const FClimbableSurfaceResult& Surface)
+{
+    if (!CharacterOwner) return false;
+
+    UClimbableDetectorComponent* Detector = CharacterOwner->FindComponentByClass<UClimbableDetectorComponent>();
+    if (!Detector || !Detector->ExtractLedge(Surface.ImpactPoint, Surface.SurfaceForward, LedgeCache))
+        return false;
+
+    LedgeDetector = Detector;
+
+    // Start at the cache point nearest the grab
+    LedgeDistance = 0.f;
+    float BestDistSq = TNumericLimits<float>::Max();
+    for (int32 i = 0; i < LedgeCache.Points.Num(); ++i)
+    {
+        const float DistSq = FVector::DistSquared(LedgeCache.Points[i], Surface.ImpactPoint);
+        if (DistSq < BestDistSq)
+        {
+            BestDistSq = DistSq;
+            LedgeDistance = LedgeCache.Distances[i];
         }
     }
 
+    HangEnterStart = CharacterOwner->GetActorLocation();
+    HangEnterAlpha = 0.f;
+    Velocity = FVector::ZeroVector;
+
     if (CharacterOwner->GetCapsuleComponent())
     {
         CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
     }
 
-    float Alpha = FMath::Clamp(ClimbElapsed / CurrentPhaseDuration, 0.f, 1.f);
-    float CurveAlpha = ClimbProgressCurve ? ClimbProgressCurve->GetFloatValue(Alpha) : Alpha;
-    FVector NewLocation = FMath::Lerp(PhaseStart, PhaseEnd, CurveAlpha);
+    SetMovementMode(MOVE_Custom, MOVE_Hang);
+    if (Events)
+    {
+        FParkourClimbEvent Event;
+        Event.Location = FVector3f(Surface.ImpactPoint);
+        Event.Height = Surface.SurfaceHeight;
+        Event.bHang = true;
+        Event.Surface = Surface.PhysicalSurface;
+        Event.Pawn = CharacterOwner;
+        Events->Publish(Event);
+    }
 
+    if (bDebugDraw)
+    {
+        for (int32 i = 1; i < LedgeCache.Points.Num(); ++i)
+        {
+            DrawDebugLine(GetWorld(), LedgeCache.Points[i - 1], LedgeCache.Points[i], FColor::Magenta, false, 5.f, 0, 2.f);
+        }
+    }
 
-    FVector DeltaMove = NewLocation - CharacterOwner->GetActorLocation();
-    FHitResult Hit;
-    SafeMoveUpdatedComponent(DeltaMove, CharacterOwner->GetActorRotation(), true, Hit);
+    return true;
+}
+
+void UParkourMovementComponent::PullUpFromHang()
+{
+    if (!IsHanging() || !LedgeCache.IsValid()) return;
+
+    FVector Point, Normal;
+    LedgeCache.Sample(LedgeDistance, Point, Normal);
+
+    FClimbableSurfaceResult Surface;
+    Surface.bIsValid = true;
+    Surface.ImpactPoint = Point;
+    Surface.ImpactNormal = Normal;
+    Surface.SurfaceForward = -Normal;
+    Surface.SurfaceHeight = Point.Z - CharacterOwner->GetActorLocation().Z;
+    Surface.SurfaceType = EClimbableSurfaceType::Ledge;
+
+    LedgeCache.Reset();
+    BeginClimb(Surface);
+}
+
+void UParkourMovementComponent::DropFromHang()
+{
+    FVector Point, Normal = FVector::ZeroVector;
+    if (LedgeCache.IsValid())
+    {
+        LedgeCache.Sample(LedgeDistance, Point, Normal);
+    }
+    LedgeCache.Reset();
+
+    if (CharacterOwner && CharacterOwner->GetCapsuleComponent())
+    {
+        CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    }
 
-    if (Alpha >= 1.f)
+    // Push off the wall a little so we don't catch it on the way down
+    Velocity = Normal * 100.f;
+    SetMovementMode(MOVE_Falling);
+
+    ResolvePendingTraversalTable();
+}
+
+void UParkourMovementComponent::PhysHang(float deltaTime, int32 Iterations)
+{
+    if (!CharacterOwner || !LedgeCache.IsValid())
     {
-        ClimbElapsed = 0.f;
+        DropFromHang();
+        return;
+    }
+
+    FVector Point, Normal;
+    LedgeCache.Sample(LedgeDistance, Point, Normal);
 
-        switch (ClimbPhase)
+    const FVector Tangent = FVector::CrossProduct(FVector::UpVector, -Normal);
+    const FVector Input = Acceleration.GetSafeNormal2D();
+
+    // Pulling away from the wall lets go
+    if (FVector::DotProduct(Input, Normal) > 0.7f)
+    {
+        DropFromHang();
+        return;
+    }
+
+    const float Along = FVector::DotProduct(Input, Tangent);
+    if (HangEnterAlpha >= 1.f && !FMath::IsNearlyZero(Along))
+    {
+        float NewDistance = LedgeDistance + Along * ShimmySpeed * deltaTime;
+
+        // Only trace again when running off the end of the cached segment
+        const float Margin = CharacterOwner->GetCapsuleComponent() ? CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() : 50.f;
+        if (UClimbableDetectorComponent* Detector = LedgeDetector.Get())
         {
-        case EClimbPhase::Approach:
-            ClimbPhase = EClimbPhase::Grab;
-            break;
-        case EClimbPhase::Grab:
-            ClimbPhase = EClimbPhase::PullUp;
-            break;
-        case EClimbPhase::PullUp:
-            bClimbActive = false;
-            ClimbPhase = EClimbPhase::None;
-            SetMovementMode(MOVE_Walking);
-            if (CharacterOwner->GetCapsuleComponent())
+            if (Along > 0.f && NewDistance > LedgeCache.GetLength() - Margin)
+            {
+                Detector->ExtendLedge(LedgeCache, true);
+            }
+            else if (Along < 0.f && NewDistance < Margin)
             {
-                CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+                const float OldLength = LedgeCache.GetLength();
+                if (Detector->ExtendLedge(LedgeCache, false))
+                {
+                    // Prepended samples shift everything along
+                    const float Added = LedgeCache.GetLength() - OldLength;
+                    LedgeDistance += Added;
+                    NewDistance += Added;
+                }
             }
-            break;
-        default:
-            break;
         }
+
+        // Keep the capsule on the ledge at closed ends
+        LedgeDistance = FMath::Clamp(NewDistance, FMath::Min(Margin, LedgeCache.GetLength() * 0.5f), FMath::Max(LedgeCache.GetLength() - Margin, LedgeCache.GetLength() * 0.5f));
+        LedgeCache.Sample(LedgeDistance, Point, Normal);
     }
 
+    FVector Target = Point + Normal * HangWallOffset + FVector(0.f, 0.f, HangHeightOffset);
+    if (HangEnterAlpha < 1.f)
+    {
+        HangEnterAlpha = FMath::Min(HangEnterAlpha + deltaTime / FMath::Max(HangEnterTime, UE_KINDA_SMALL_NUMBER), 1.f);
+        Target = FMath::Lerp(HangEnterStart, Target, HangEnterAlpha);
+    }
+
+    const FVector Delta = Target - CharacterOwner->GetActorLocation();
+    Velocity = deltaTime > 0.f ? Delta / deltaTime : FVector::ZeroVector;
+
+    FHitResult Hit;
+    SafeMoveUpdatedComponent(Delta, (-Normal).Rotation(), true, Hit);
 }
 
-void UParkourMovementComponent::PhysWallRun(float deltaTime, int32 Iterations)
+bool UParkourMovementComponent::BeginRail(const FRailAttachment& Attachment)
+{
+    URideRailComponent* Rail = Attachment.Rail.Get();
+    if (!CharacterOwner || !Rail || !Rail->GetTable().IsValid()) return false;
+
+    if (RailLeftTime >= 0.0 && GetWorld()->GetTimeSeconds() - RailLeftTime < RailRegrabDelay) return false;
+
+    FVector Point, LocalTangent;
+    Rail->GetTable().Sample(Attachment.Distance, Point, LocalTangent);
+    RailTangent = Rail->GetRailTransform().TransformVectorNoScale(LocalTangent);
+
+    // Keep whatever momentum runs along the rail, in whichever direction it runs
+    RailAttachment = Attachment;
+    RailSpeed = FVector::DotProduct(Velocity, RailTangent);
+    if (FMath::Abs(RailSpeed) < Rail->MinAttachSpeed)
+    {
+        const float Direction = RailSpeed != 0.f ? FMath::Sign(RailSpeed) : (FVector::DotProduct(CharacterOwner->GetActorForwardVector(), RailTangent) >= 0.f ? 1.f : -1.f);
+        RailSpeed = Direction * Rail->MinAttachSpeed;
+    }
+
+    RailEnterStart = CharacterOwner->GetActorLocation();
+    RailEnterAlpha = 0.f;
+
+    if (CharacterOwner->GetCapsuleComponent())
+    {
+        CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    }
+
+    SetMovementMode(MOVE_Custom, MOVE_Rail);
+
+    if (Telemetry)
+    {
+        Telemetry->Record(ETraversalTelemetryEvent::TraversalStart, RailEnterStart);
+    }
+    return true;
+}
+
+void UParkourMovementComponent::JumpOffRail()
 {
+    if (!IsOnRail()) return;
+
+    DetachFromRail(FVector(0.f, 0.f, JumpZVelocity));
 }
 
-void UParkourMovementComponent::PhysVault(float deltaTime, int32 Iterations)
+void UParkourMovementComponent::DetachFromRail(const FVector& ExtraVelocity)
 {
-    if (!VaultCurve || !CharacterOwner || !bVaulting)
+    RailAttachment = FRailAttachment();
+    RailLeftTime = GetWorld()->GetTimeSeconds();
+
+    if (Telemetry && CharacterOwner)
     {
-        SetMovementMode(MOVE_Walking);
+        Telemetry->Record(ETraversalTelemetryEvent::TraversalEnd, CharacterOwner->GetActorLocation());
+    }
+
+    if (CharacterOwner && CharacterOwner->GetCapsuleComponent())
+    {
+        CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    }
+
+    Velocity = RailTangent * RailSpeed + ExtraVelocity;
+    SetMovementMode(MOVE_Falling);
+
+    ResolvePendingTraversalTable();
+}
+
+void UParkourMovementComponent::PhysRail(float deltaTime, int32 Iterations)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ParkourCMCRail);
+
+    const URideRailComponent* Rail = RailAttachment.Rail.Get();
+    if (!CharacterOwner || !Rail || !Rail->GetTable().IsValid())
+    {
+        DetachFromRail(FVector::ZeroVector);
         return;
     }
 
-    VaultElapsed += deltaTime;
-    float Time = FMath::Clamp(VaultElapsed / VaultTime, 0.f, 1.f);;
-    if (CharacterOwner->GetCapsuleComponent())
+    // Everything comes from the table: one sample for the slope, one for the new position
+    const FRailArcTable& Table = Rail->GetTable();
+    const FTransform ToWorld = Rail->GetRailTransform();
+    const float InvScale = 1.f / FMath::Max(ToWorld.GetMaximumAxisScale(), UE_KINDA_SMALL_NUMBER);
+
+    FVector Point, LocalTangent;
+    Table.Sample(RailAttachment.Distance, Point, LocalTangent);
+    RailTangent = ToWorld.TransformVectorNoScale(LocalTangent);
+
+    // Gravity along the rail, a pump from input, then friction and drag against the motion
+    const float Input = FVector::DotProduct(Acceleration.GetSafeNormal(), RailTangent);
+    RailSpeed += (GetGravityZ() * RailTangent.Z * Rail->GravityScale + Input * Rail->PumpAcceleration) * deltaTime;
+
+    const float Speed = FMath::Abs(RailSpeed);
+    const float Loss = (Rail->Friction + Rail->Drag * Speed * Speed) * deltaTime;
+    RailSpeed = FMath::Sign(RailSpeed) * FMath::Clamp(Speed - Loss, 0.f, Rail->MaxSpeed);
+
+    const float NewDistance = RailAttachment.Distance + RailSpeed * InvScale * deltaTime;
+    if (!Table.bClosedLoop && (NewDistance < 0.f || NewDistance > Table.Length))
     {
-        CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        // Off the end, fly on at rail speed
+        DetachFromRail(FVector::ZeroVector);
+        return;
     }
+    RailAttachment.Distance = Table.ClampDistance(NewDistance);
 
+    Table.Sample(RailAttachment.Distance, Point, LocalTangent);
+    RailTangent = ToWorld.TransformVectorNoScale(LocalTangent);
 
-    if (Time >= 1.0f)
+    const float HalfHeight = CharacterOwner->GetCapsuleComponent() ? CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : 0.f;
+    FVector Target = ToWorld.TransformPosition(Point) + Rail->GetRiderOffset(HalfHeight);
+    if (RailEnterAlpha < 1.f)
     {
-        // End vault
-          // Estimate forward velocity from final curve direction
-        float CurveDelta = VaultForwardDistance;
-        FVector ForwardWorldDelta = VaultDirection * CurveDelta;
+        RailEnterAlpha = FMath::Min(RailEnterAlpha + deltaTime / FMath::Max(RailEnterTime, UE_KINDA_SMALL_NUMBER), 1.f);
+        Target = FMath::Lerp(RailEnterStart, Target, RailEnterAlpha);
+    }
 
-        // Capture velocity to apply next frame
-        PendingPostVaultVelocity = ForwardWorldDelta + VaultMomentum + VaultMomentumVelocity;
-        bShouldApplyPostVaultVelocity = true;
+    Velocity = RailTangent * RailSpeed;
 
-        bVaulting = false;
-        SetMovementMode(MOVE_Walking);
-        if (CharacterOwner->GetCapsuleComponent())
+    FRotator Facing = (RailTangent * FMath::Sign(RailSpeed)).Rotation();
+    Facing.Pitch = 0.f;
+    Facing.Roll = 0.f;
+
+    FHitResult Hit;
+    SafeMoveUpdatedComponent(Target - CharacterOwner->GetActorLocation(), RailSpeed != 0.f ? Facing : CharacterOwner->GetActorRotation(), true, Hit);
+}
+
+void UParkourMovementComponent::SetWantsToSlide(bool bWants)
+{
+    bWantsToSlide = bWants;
+}
+
+bool UParkourMovementComponent::CanStartSlide() const
+{
+    return IsMovingOnGround() && Velocity.SizeSquared2D() >= FMath::Square(SlideMinStartSpeed);
+}
+
+void UParkourMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+    // Everything here reads existing state, no scene queries
+    if (!bIsSliding && bWantsToSlide && CanStartSlide())
+    {
+        bIsSliding = true;
+        bWantsToCrouch = true;
+
+        if (!bSlideBoostSpent)
+        {
+            bSlideBoostSpent = true;
+            const float Speed = Velocity.Size2D();
+            const float BoostedSpeed = FMath::Max(Speed, FMath::Min(Speed + SlideEnterBoost, SlideMaxSpeed));
+            Velocity += Velocity.GetSafeNormal2D() * (BoostedSpeed - Speed);
+        }
+    }
+    else if (bIsSliding)
+    {
+        const bool bTooSlow = Velocity.SizeSquared2D() < FMath::Square(SlideMinSpeed);
+        if (!bWantsToSlide || (IsMovingOnGround() && bTooSlow) || (MovementMode == MOVE_Custom))
         {
-            CharacterOwner->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+            bIsSliding = false;
+            bWantsToCrouch = false;
         }
+    }
 
-        return;
+    // The boost comes back once slide is let go on the ground, not on every landing out of a vault
+    if (!bWantsToSlide && !bIsSliding && IsMovingOnGround())
+    {
+        bSlideBoostSpent = false;
+    }
+
+    Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+}
+
+float UParkourMovementComponent::GetMaxSpeed() const
+{
+    if (bIsSliding && IsMovingOnGround())
+    {
+        return SlideMaxSpeed;
     }
+    return Super::GetMaxSpeed();
+}
 
-    // Get relative vault offset from curve
-    FVector LocalOffset = VaultCurve->GetVectorValue(Time);
+void UParkourMovementComponent::CalcVelocity(float DeltaTime, float Friction, bool bFluid, float BrakingDeceleration)
+{
+    if (!bIsSliding || !IsMovingOnGround())
+    {
+        Super::CalcVelocity(DeltaTime, Friction, bFluid, BrakingDeceleration);
+        return;
+    }
 
-    // Build world-space offset using vault direction as X
-    FVector Right = FVector::CrossProduct(FVector::UpVector, VaultDirection);
-    FVector Up = FVector::UpVector;
+    // Slope response from the floor PhysWalking already found last iteration
+    const FVector FloorNormal = CurrentFloor.IsWalkableFloor() ? CurrentFloor.HitResult.ImpactNormal : FVector::UpVector;
+    const FVector Gravity(0.f, 0.f, GetGravityZ());
+    const FVector SlopeGravity = Gravity - FloorNormal * FVector::DotProduct(Gravity, FloorNormal);
 
-    FVector WorldOffset =
-        VaultDirection * (LocalOffset.X * VaultForwardDistance) +
-        Right * LocalOffset.Y +
-        Up * (LocalOffset.Z * VaultHeight + 50.f);
+    Velocity += SlopeGravity * SlideGravityScale * DeltaTime;
 
-    FVector NewLocation = VaultStart + WorldOffset;
+    // Input only steers sideways, it can't push or brake the slide
+    const FVector Dir = Velocity.GetSafeNormal2D();
+    const FVector Input = Acceleration.GetSafeNormal2D();
+    const FVector Steer = Input - Dir * FVector::DotProduct(Input, Dir);
+    Velocity += Steer * SlideSteerAcceleration * DeltaTime;
 
-    // Move character
-    FHitResult Hit;
-    SafeMoveUpdatedComponent(NewLocation - CharacterOwner->GetActorLocation(), CharacterOwner->GetActorRotation(), true, Hit);
+    // Constant kinetic friction
+    const float Speed = Velocity.Size();
+    if (Speed > UE_KINDA_SMALL_NUMBER)
+    {
+        const float NewSpeed = FMath::Max(Speed - SlideFriction * DeltaTime, 0.f);
+        Velocity *= NewSpeed / Speed;
+    }
 
+    Velocity = Velocity.GetClampedToMaxSize(SlideMaxSpeed);
 }
@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/TraversalActionData.h"
+#include "Curves/CurveFloat.h"
+#include "Curves/CurveVector.h"
+
+void FTraversalActionTable::Reset()
+{
+    Phases.Reset();
+    Actions.Reset();
+}
+
+int32 FTraversalActionTable::Compile(const FTraversalActionDef& Def)
+{
+    FTraversalCompiledAction& Action = Actions.AddDefaulted_GetRef();
+    Action.Name = Def.Name;
+    Action.FirstPhase = Phases.Num();
+    Action.NumPhases = Def.Phases.Num();
+    Action.ExitForwardSpeed = Def.ExitForwardSpeed;
+    Action.bCarryEntryVelocity = Def.bCarryEntryVelocity;
+
+    for (const FTraversalPhaseDef& PhaseDef : Def.Phases)
+    {
+        FTraversalCompiledPhase& Phase = Phases.AddDefaulted_GetRef();
+        Phase.Name = PhaseDef.Name;
+        Phase.Duration = FMath::Max(PhaseDef.Duration, UE_KINDA_SMALL_NUMBER);
+        Phase.InvDuration = 1.f / Phase.Duration;
+        Phase.TargetOffset = FVector3f(PhaseDef.TargetOffset);
+        Phase.PathScale = FVector3f(PhaseDef.PathScale);
+        Phase.CameraPitch = PhaseDef.CameraPitch;
+        Phase.CameraInterpSpeed = PhaseDef.CameraInterpSpeed;
+        Phase.CameraYawInterpSpeed = PhaseDef.CameraYawInterpSpeed;
+        Phase.MaxCameraRoll = PhaseDef.MaxCameraRoll;
+        Phase.PathMode = PhaseDef.PathMode;
+        Phase.CameraPolicy = PhaseDef.CameraPolicy;
+        Phase.bDisableCollision = PhaseDef.bDisableCollision;
+        Phase.bScalePathZBySurfaceHeight = PhaseDef.bScalePathZBySurfaceHeight;
+
+        // Point straight at the rich curves, the owning asset keeps the UObjects alive
+        Phase.AlphaCurve = PhaseDef.AlphaCurve ? &PhaseDef.AlphaCurve->FloatCurve : nullptr;
+        Phase.CameraRollCurve = PhaseDef.CameraRollCurve ? &PhaseDef.CameraRollCurve->FloatCurve : nullptr;
+        if (PhaseDef.PathCurve)
+        {
+            for (int32 Axis = 0; Axis < 3; ++Axis)
+            {
+                Phase.PathCurve[Axis] = &PhaseDef.PathCurve->FloatCurves[Axis];
+            }
+        }
+    }
+
+    return Actions.Num() - 1;
+}
+
+int32 FTraversalActionTable::FindAction(FName Name) const
+{
+    return Actions.IndexOfByPredicate([Name](const FTraversalCompiledAction& Action) { return Action.Name == Name; });
+}
+
+float FTraversalActionTable::GetActionDuration(int32 ActionIndex) const
+{
+    if (!Actions.IsValidIndex(ActionIndex)) return 0.f;
+
+    const FTraversalCompiledAction& Action = Actions[ActionIndex];
+    float Duration = 0.f;
+    for (int32 i = 0; i < Action.NumPhases; ++i)
+    {
+        Duration += Phases[Action.FirstPhase + i].Duration;
+    }
+    return Duration;
+}
+
+const FTraversalCompiledPhase* FTraversalActionTable::GetCurrentPhase(const FTraversalRunState& State) const
+{
+    if (!Actions.IsValidIndex(State.ActionIndex)) return nullptr;
+
+    const FTraversalCompiledAction& Action = Actions[State.ActionIndex];
+    if (State.PhaseIndex >= Action.NumPhases) return nullptr;
+
+    return &Phases[Action.FirstPhase + State.PhaseIndex];
+}
+
+FVector FTraversalActionTable::EvaluatePhase(const FTraversalCompiledPhase& Phase, const FTraversalRunState& State, float Alpha) const
+{
+    const FVector Forward = State.SurfaceForward;
+    const FVector Right = FVector::CrossProduct(FVector::UpVector, Forward);
+    const FVector Up = FVector::UpVector;
+
+    if (Phase.PathMode == ETraversalPathMode::CurveOffset)
+    {
+        const float CX = Phase.PathCurve[0] ? Phase.PathCurve[0]->Eval(Alpha) : 0.f;
+        const float CY = Phase.PathCurve[1] ? Phase.PathCurve[1]->Eval(Alpha) : 0.f;
+        const float CZ = Phase.PathCurve[2] ? Phase.PathCurve[2]->Eval(Alpha) : 0.f;
+        const float ScaleZ = Phase.bScalePathZBySurfaceHeight ? State.SurfaceHeight : Phase.PathScale.Z;
+
+        return State.PhaseStart
+            + Forward * (CX * Phase.PathScale.X + Phase.TargetOffset.X)
+            + Right * (CY * Phase.PathScale.Y + Phase.TargetOffset.Y)
+            + Up * (CZ * ScaleZ + Phase.TargetOffset.Z);
+    }
+
+    const FVector Target = State.SurfacePoint
+        + Forward * Phase.TargetOffset.X
+        + Right * Phase.TargetOffset.Y
+        + Up * Phase.TargetOffset.Z;
+
+    const float CurveAlpha = Phase.AlphaCurve ? Phase.AlphaCurve->Eval(Alpha) : Alpha;
+    return FMath::Lerp(State.PhaseStart, Target, CurveAlpha);
+}
+
+bool FTraversalActionTable::Evaluate(FTraversalRunState& State, float DeltaTime, FVector& OutLocation) const
+{
+    if (!Actions.IsValidIndex(State.ActionIndex)) return false;
+
+    const FTraversalCompiledAction& Action = Actions[State.ActionIndex];
+    State.PhaseElapsed += DeltaTime;
+
+    while (State.PhaseIndex < Action.NumPhases)
+    {
+        const FTraversalCompiledPhase& Phase = Phases[Action.FirstPhase + State.PhaseIndex];
+        const float Alpha = FMath::Min(State.PhaseElapsed * Phase.InvDuration, 1.f);
+
+        OutLocation = EvaluatePhase(Phase, State, Alpha);
+        if (Alpha < 1.f)
+        {
+            return true;
+        }
+
+        // Carry leftover time into the next phase so long frames don't stretch the move
+        State.PhaseElapsed -= Phase.Duration;
+        State.PhaseStart = OutLocation;
+        ++State.PhaseIndex;
+    }
+
+    return false;
+}
+
+void UTraversalActionData::PostLoad()
+{
+    Super::PostLoad();
+
+    CompileTable();
+}
+
+#if WITH_EDITOR
+void UTraversalActionData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    CompileTable();
+}
+#endif
+
+void UTraversalActionData::CompileTable()
+{
+    Table.Reset();
+    for (const FTraversalActionDef& Def : Actions)
+    {
+        Table.Compile(Def);
+    }
+}
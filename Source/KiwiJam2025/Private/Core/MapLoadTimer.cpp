@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/MapLoadTimer.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY(LogMapLoad);
+
+void UMapLoadTimer::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // PIE worlds never go through PreLoadMap, they start timing from the game instance
+    LoadStartTime = FPlatformTime::Seconds();
+    PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UMapLoadTimer::HandlePreLoadMap);
+}
+
+void UMapLoadTimer::Deinitialize()
+{
+    FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+
+    Super::Deinitialize();
+}
+
+void UMapLoadTimer::HandlePreLoadMap(const FString& MapName)
+{
+    LoadStartTime = FPlatformTime::Seconds();
+    UE_LOG(LogMapLoad, Log, TEXT("Loading %s"), *MapName);
+}
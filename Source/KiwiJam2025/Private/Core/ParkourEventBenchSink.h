@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "ParkourEventBenchSink.generated.h"
+
+/** Dynamic delegate target for Parkour.EventBusBench, the baseline the bus is measured against */
+UCLASS(Transient)
+class UParkourEventBenchSink : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void HandleGoalReached(AActor* GoalActor);
+
+	int64 Count = 0;
+};
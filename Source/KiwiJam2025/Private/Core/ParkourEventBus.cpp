@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/ParkourEventBus.h"
+#include "ParkourEventBenchSink.h"
+#include "KiwiJam2025.h"
+#include "GoalPoint.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY(LogParkourEvents);
+
+DECLARE_CYCLE_STAT(TEXT("Event Bus Dispatch"), STAT_ParkourEventDispatch, STATGROUP_KiwiJam);
+
+// Events per type a frame can hold before its array grows; it keeps the bigger size after that
+static TAutoConsoleVariable<int32> CVarEventCapacity(
+    TEXT("Parkour.Events.Capacity"),
+    64,
+    TEXT("Events of each type reserved per frame by a world's event bus, read when the world starts"));
+
+void UParkourEventBus::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    const int32 Capacity = FMath::Max(1, CVarEventCapacity.GetValueOnGameThread());
+    Channels[(int32)EParkourEventType::GoalReached] = MakeUnique<TParkourEventChannel<FParkourGoalReachedEvent>>(Capacity);
+    Channels[(int32)EParkourEventType::Vault] = MakeUnique<TParkourEventChannel<FParkourVaultEvent>>(Capacity);
+    Channels[(int32)EParkourEventType::Climb] = MakeUnique<TParkourEventChannel<FParkourClimbEvent>>(Capacity);
+    Channels[(int32)EParkourEventType::Landed] = MakeUnique<TParkourEventChannel<FParkourLandedEvent>>(Capacity);
+
+    BackgroundPipe = MakeUnique<UE::Tasks::FPipe>(TEXT("ParkourEventBus"));
+
+    PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UParkourEventBus::OnPreActorTick);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UParkourEventBus::OnPostActorTick);
+}
+
+void UParkourEventBus::Deinitialize()
+{
+    FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    // Nothing dispatches from here on. The channels stay for late unbinds and go with the bus.
+    for (TUniquePtr<FParkourEventChannelBase>& Channel : Channels)
+    {
+        if (Channel)
+        {
+            Channel->WaitForBackground();
+        }
+    }
+
+    Super::Deinitialize();
+}
+
+void UParkourEventBus::OnPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World == GetWorld())
+    {
+        Dispatch(EParkourEventPhase::FrameStart);
+    }
+}
+
+void UParkourEventBus::OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World == GetWorld())
+    {
+        Dispatch(EParkourEventPhase::FrameEnd);
+    }
+}
+
+void UParkourEventBus::Dispatch(EParkourEventPhase Phase)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ParkourEventDispatch);
+
+    for (TUniquePtr<FParkourEventChannelBase>& Channel : Channels)
+    {
+        if (Channel)
+        {
+            Channel->Dispatch(Phase, BackgroundPipe.Get());
+        }
+    }
+}
+
+void UParkourEventBenchSink::HandleGoalReached(AActor* GoalActor)
+{
+    Count += GoalActor ? 1 : 0;
+}
+
+namespace ParkourEvents
+{
+    static void RunBench(int32 NumEvents, int32 NumSubscribers, int32 NumFrames)
+    {
+        AActor* GoalActor = GetMutableDefault<AGoalPoint>();
+        const int32 EventsPerFrame = FMath::Max(1, NumEvents / NumFrames);
+
+        // Baseline: what a goal's OnGoalReached costs with native code bound to it through UFUNCTIONs
+        FOnGoalReached Dynamic;
+        TArray<UParkourEventBenchSink*> Sinks;
+        for (int32 s = 0; s < NumSubscribers; ++s)
+        {
+            UParkourEventBenchSink* Sink = NewObject<UParkourEventBenchSink>(GetTransientPackage());
+            Sink->AddToRoot();
+            Dynamic.AddDynamic(Sink, &UParkourEventBenchSink::HandleGoalReached);
+            Sinks.Add(Sink);
+        }
+
+        const double DynamicStart = FPlatformTime::Seconds();
+        for (int32 f = 0; f < NumFrames; ++f)
+        {
+            for (int32 i = 0; i < EventsPerFrame; ++i)
+            {
+                Dynamic.Broadcast(GoalActor);
+            }
+        }
+        const double DynamicSeconds = FPlatformTime::Seconds() - DynamicStart;
+
+        int64 DynamicCount = 0;
+        for (UParkourEventBenchSink* Sink : Sinks)
+        {
+            DynamicCount += Sink->Count;
+            Sink->RemoveFromRoot();
+        }
+
+        // The bus: publish into the frame's batch, then one dispatch per frame hands each subscriber the batch
+        TParkourEventChannel<FParkourGoalReachedEvent> Channel(CVarEventCapacity.GetValueOnGameThread());
+        TSharedRef<int64> BusCount = MakeShared<int64>(0);
+        for (int32 s = 0; s < NumSubscribers; ++s)
+        {
+            Channel.Subscribers[(int32)EParkourEventPhase::FrameEnd].AddLambda([BusCount](TConstArrayView<FParkourGoalReachedEvent> Batch)
+                {
+                    for (const FParkourGoalReachedEvent& Event : Batch)
+                    {
+                        *BusCount += Event.Goal.IsExplicitlyNull() ? 0 : 1;
+                    }
+                });
+        }
+
+        FParkourGoalReachedEvent Event;
+        Event.Goal = GoalActor;
+
+        double PublishSeconds = 0.0;
+        double DispatchSeconds = 0.0;
+        for (int32 f = 0; f < NumFrames; ++f)
+        {
+            const double PublishStart = FPlatformTime::Seconds();
+            for (int32 i = 0; i < EventsPerFrame; ++i)
+            {
+                Event.Split = i;
+                Channel.Publish(Event);
+            }
+            const double DispatchStart = FPlatformTime::Seconds();
+            Channel.Dispatch(EParkourEventPhase::FrameStart, nullptr);
+            Channel.Dispatch(EParkourEventPhase::FrameEnd, nullptr);
+            PublishSeconds += DispatchStart - PublishStart;
+            DispatchSeconds += FPlatformTime::Seconds() - DispatchStart;
+        }
+
+        const double Events = double(EventsPerFrame) * NumFrames;
+        const double DynamicNs = DynamicSeconds * 1e9 / Events;
+        const double BusNs = (PublishSeconds + DispatchSeconds) * 1e9 / Events;
+        UE_LOG(LogParkourEvents, Log, TEXT("[EventBusBench] %d events/frame x %d frames, %d subscribers: dynamic broadcast %.1f ns/event, bus %.1f ns/event (publish %.1f + dispatch %.1f), %.1fx. Delivered %lld / %lld"),
+            EventsPerFrame, NumFrames, NumSubscribers, DynamicNs, BusNs, PublishSeconds * 1e9 / Events, DispatchSeconds * 1e9 / Events,
+            DynamicNs / FMath::Max(BusNs, UE_SMALL_NUMBER), *BusCount, DynamicCount);
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs EventBusBenchCommand(
+        TEXT("Parkour.EventBusBench"),
+        TEXT("Times delivering goal events through a dynamic multicast delegate and through the event bus. Args: [Events=200000] [Subscribers=4] [Frames=100]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                RunBench(
+                    Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 200000,
+                    Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 4,
+                    Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 100);
+            }));
+}
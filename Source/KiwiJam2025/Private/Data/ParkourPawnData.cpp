@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/ParkourPawnData.h"
+#include "Engine/World.h"
+
+const FPrimaryAssetType UParkourPawnData::PrimaryAssetType = TEXT("ParkourPawnData");
+
+const FName UParkourPawnData::GameBundle = TEXT("Game");
+const FName UParkourPawnData::UIBundle = TEXT("UI");
+
+TArray<FName> UParkourPawnData::GetBundlesFor(const UWorld* World)
+{
+    if (World && World->GetNetMode() == NM_DedicatedServer)
+    {
+        return { GameBundle };
+    }
+    return { GameBundle, UIBundle };
+}
+
+FPrimaryAssetId UParkourPawnData::GetPrimaryAssetId() const
+{
+    return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GoalManifest.h"
+#include "GoalPoint.h"
+#include "EngineUtils.h"
+
+#if WITH_EDITOR
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionHelpers.h"
+#endif
+
+AGoalManifest::AGoalManifest()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+#if WITH_EDITORONLY_DATA
+	// Must stay resident regardless of which cells are streamed in
+	bIsSpatiallyLoaded = false;
+#endif
+}
+
+#if WITH_EDITOR
+void AGoalManifest::RebuildManifest()
+{
+    UWorld* World = GetWorld();
+    if (!World) return;
+
+    Modify();
+    Entries.Reset();
+
+    int32 NumAssigned = 0;
+    auto AddGoal = [this, &NumAssigned](AGoalPoint* Goal)
+        {
+            if (!Goal) return;
+
+            // Goals placed before ids existed
+            NumAssigned += Goal->EnsureGoalId() ? 1 : 0;
+
+            FGoalManifestEntry& Entry = Entries.AddDefaulted_GetRef();
+            Entry.GoalId = Goal->GetGoalId();
+            Entry.Location = FVector3f(Goal->GetGoalLocation());
+            Entry.bStartsActive = Goal->IsGoalActive();
+
+            if (MarkerClass.IsNull() && Goal->GetMarkerClass())
+            {
+                MarkerClass = Goal->GetMarkerClass();
+            }
+        };
+
+    if (UWorldPartition* WorldPartition = World->GetWorldPartition())
+    {
+        FWorldPartitionHelpers::FForEachActorWithLoadingParams Params;
+        Params.ActorClasses = { AGoalPoint::StaticClass() };
+        // Goals given an id above stay loaded, dirty, until the level is saved
+        Params.bKeepReferences = true;
+
+        FWorldPartitionHelpers::ForEachActorWithLoading(WorldPartition, [&AddGoal](const FWorldPartitionActorDescInstance* ActorDescInstance)
+            {
+                AddGoal(Cast<AGoalPoint>(ActorDescInstance->GetActor()));
+                return true;
+            }, Params);
+    }
+    else
+    {
+        for (TActorIterator<AGoalPoint> It(World); It; ++It)
+        {
+            AddGoal(*It);
+        }
+    }
+
+    // Stable order so rebuilds diff cleanly
+    Entries.Sort([](const FGoalManifestEntry& A, const FGoalManifestEntry& B) { return A.GoalId < B.GoalId; });
+
+    UE_LOG(LogTemp, Log, TEXT("Goal manifest rebuilt with %d goals"), Entries.Num());
+    if (NumAssigned > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%d goals had no id and were given one, save the level to keep them"), NumAssigned);
+    }
+}
+#endif
@@ -0,0 +1,332 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GoalManifestSubsystem.h"
+#include "GoalPoint.h"
+#include "EngineUtils.h"
+#include "Save/ParkourSave.h"
+#include "Engine/GameInstance.h"
+#include "Player/ParkourPlayerState.h"
+#include "World/CourseGoalTimes.h"
+#include "World/CourseRouteSolver.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+
+static TAutoConsoleVariable<float> CVarRouteBudgetMs(
+    TEXT("Parkour.Route.BudgetMs"),
+    100.f,
+    TEXT("Time the goal route solver keeps improving before showing its route."));
+
+void UGoalManifestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    for (TActorIterator<AGoalManifest> It(&InWorld); It; ++It)
+    {
+        const AGoalManifest* Manifest = *It;
+
+        Goals.Reserve(Goals.Num() + Manifest->GetEntries().Num());
+        for (const FGoalManifestEntry& Entry : Manifest->GetEntries())
+        {
+            const int32 Index = FindOrAddGoal(Entry.GoalId, FVector(Entry.Location));
+            Goals[Index].bActive = Entry.bStartsActive;
+        }
+
+        // Only a path here, the map loads it when it opens
+        if (MarkerClass.IsNull())
+        {
+            MarkerClass = Manifest->GetMarkerClass();
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Goal manifest loaded with %d goals"), Goals.Num());
+
+    LevelStartTime = InWorld.GetTimeSeconds();
+
+    // Routes go by distance until this lands, or for good if the commandlet hasn't been run
+    TWeakObjectPtr<UGoalManifestSubsystem> WeakThis(this);
+    const FString MapName = UWorld::RemovePIEPrefix(InWorld.GetMapName());
+    UE::Tasks::Launch(TEXT("CourseGoalTimesLoad"), [WeakThis, MapName]()
+        {
+            TSharedPtr<FCourseGoalTimes, ESPMode::ThreadSafe> Times = MakeShared<FCourseGoalTimes, ESPMode::ThreadSafe>();
+            if (!Times->LoadFromFile(FCourseGoalTimes::GetDefaultPath(MapName)))
+            {
+                return;
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Times]()
+                {
+                    if (UGoalManifestSubsystem* This = WeakThis.Get())
+                    {
+                        This->GoalTimes = Times;
+                    }
+                });
+        }, UE::Tasks::ETaskPriority::BackgroundNormal);
+
+    if (UGameInstance* GameInstance = InWorld.GetGameInstance())
+    {
+        if (UParkourSaveSubsystem* Saves = GameInstance->GetSubsystem<UParkourSaveSubsystem>())
+        {
+            Saves->ApplyWhenLoaded(this);
+        }
+    }
+}
+
+void UGoalManifestSubsystem::Deinitialize()
+{
+    if (RouteSolver)
+    {
+        RouteSolver->Cancel();
+        RouteSolver.Reset();
+    }
+
+    Super::Deinitialize();
+}
+
+void UGoalManifestSubsystem::BindGoal(AGoalPoint* Goal)
+{
+    if (!Goal) return;
+
+    // Goals missing from the manifest (not rebuilt yet) still work, they just appear once loaded
+    const int32 Index = FindOrAddGoal(Goal->GetGoalId(), Goal->GetGoalLocation());
+    FGoalRuntimeState& State = Goals[Index];
+    State.Actor = Goal;
+    State.Location = Goal->GetGoalLocation();
+
+    // Cell reloaded after the goal was reached
+    Goal->SetGoalActive(State.bActive);
+
+    if (MarkerClass.IsNull() && Goal->GetMarkerClass())
+    {
+        MarkerClass = Goal->GetMarkerClass();
+    }
+
+    OnGoalsChanged.Broadcast();
+}
+
+void UGoalManifestSubsystem::UnbindGoal(AGoalPoint* Goal)
+{
+    if (!Goal) return;
+
+    if (const int32* Index = GoalIndexById.Find(Goal->GetGoalId()))
+    {
+        Goals[*Index].Actor.Reset();
+    }
+}
+
+void UGoalManifestSubsystem::NotifyGoalReached(AGoalPoint* Goal)
+{
+    if (Goal)
+    {
+        NotifyGoalReached(Goal->GetGoalId(), GetLevelTime());
+    }
+}
+
+float UGoalManifestSubsystem::GetLevelTime() const
+{
+    return GetWorld()->GetTimeSeconds() - LevelStartTime;
+}
+
+void UGoalManifestSubsystem::ResumeRun(float RunTime)
+{
+    bRunCountsForBests = RunTime >= 0.f;
+    LevelStartTime = GetWorld()->GetTimeSeconds() - FMath::Max(RunTime, 0.f);
+    UE_LOG(LogTemp, Log, TEXT("Resumed run at %.2f s%s"), FMath::Max(RunTime, 0.f), bRunCountsForBests ? TEXT("") : TEXT(", run time unknown so splits won't count as bests"));
+}
+
+void UGoalManifestSubsystem::NotifyGoalReached(const FGuid& GoalId, float Split)
+{
+    const int32* Index = GoalIndexById.Find(GoalId);
+    if (!Index) return;
+
+    FGoalRuntimeState& State = Goals[*Index];
+
+    // Already reached (restored from the save) and no faster, nothing to show or save
+    const bool bFaster = bRunCountsForBests && (State.BestSplit <= 0.f || Split < State.BestSplit);
+    if (!State.bActive && !bFaster) return;
+
+    State.bActive = false;
+    if (bFaster)
+    {
+        State.BestSplit = Split;
+    }
+
+    CheckpointIndex = *Index;
+    CheckpointRunTime = bRunCountsForBests ? Split : -1.f;
+    if (AGoalPoint* Goal = State.Actor.Get())
+    {
+        CheckpointYaw = Goal->GetActorRotation().Yaw;
+        Goal->SetGoalActive(false);
+    }
+
+    OnGoalsChanged.Broadcast();
+
+    // Re-plan from here while the map is up, otherwise the next open does it
+    ClearRoute();
+    if (bMapOpen)
+    {
+        RequestRoute(State.Location, RouteFallbackSpeed);
+    }
+
+    if (UParkourSaveSubsystem* Saves = GetWorld()->GetGameInstance() ? GetWorld()->GetGameInstance()->GetSubsystem<UParkourSaveSubsystem>() : nullptr)
+    {
+        Saves->RequestSave(GetWorld());
+    }
+}
+
+void UGoalManifestSubsystem::GatherProgress(FParkourSaveData& OutData) const
+{
+    BuildSaveData(Goals, CheckpointIndex, CheckpointYaw, CheckpointRunTime, OutData);
+}
+
+void UGoalManifestSubsystem::BuildSaveData(TConstArrayView<FGoalRuntimeState> InGoals, int32 InCheckpointIndex, float InCheckpointYaw, float InCheckpointRunTime, FParkourSaveData& OutData)
+{
+    OutData.Goals.Reset();
+    for (const FGoalRuntimeState& State : InGoals)
+    {
+        if (!State.bActive || State.BestSplit > 0.f)
+        {
+            OutData.Goals.Add({ State.GoalId, !State.bActive, State.BestSplit });
+        }
+    }
+
+    OutData.bHasCheckpoint = InGoals.IsValidIndex(InCheckpointIndex);
+    if (OutData.bHasCheckpoint)
+    {
+        OutData.CheckpointGoalId = InGoals[InCheckpointIndex].GoalId;
+        OutData.CheckpointLocation = FVector3f(InGoals[InCheckpointIndex].Location);
+        OutData.CheckpointYaw = InCheckpointYaw;
+        OutData.CheckpointRunTime = InCheckpointRunTime;
+    }
+}
+
+void UGoalManifestSubsystem::ApplySavedProgress(const FParkourSaveData& Data)
+{
+    for (const FParkourGoalProgress& Progress : Data.Goals)
+    {
+        const int32* Index = GoalIndexById.Find(Progress.GoalId);
+        if (!Index) continue;
+
+        FGoalRuntimeState& State = Goals[*Index];
+        State.BestSplit = Progress.BestSplit;
+
+        if (Progress.bReached && State.bActive)
+        {
+            State.bActive = false;
+            if (AGoalPoint* Goal = State.Actor.Get())
+            {
+                Goal->SetGoalActive(false);
+            }
+        }
+    }
+    OnGoalsChanged.Broadcast();
+
+    if (Data.bHasCheckpoint)
+    {
+        if (const int32* Index = GoalIndexById.Find(Data.CheckpointGoalId))
+        {
+            CheckpointIndex = *Index;
+            CheckpointYaw = Data.CheckpointYaw;
+            CheckpointRunTime = Data.CheckpointRunTime;
+        }
+    }
+
+    // Standalone or listen host: the local player state shouldn't award these again
+    if (APlayerController* PC = GetWorld()->GetGameInstance() ? GetWorld()->GetGameInstance()->GetFirstLocalPlayerController(GetWorld()) : nullptr)
+    {
+        if (AParkourPlayerState* PlayerState = PC->GetPlayerState<AParkourPlayerState>())
+        {
+            PlayerState->SeedFromManifest();
+        }
+    }
+}
+
+bool UGoalManifestSubsystem::IsGoalActive(const FGuid& GoalId) const
+{
+    const int32* Index = GoalIndexById.Find(GoalId);
+    return Index ? Goals[*Index].bActive : false;
+}
+
+void UGoalManifestSubsystem::RequestRoute(const FVector& FromLocation, float FallbackSpeed)
+{
+    // Only the newest request gets shown
+    if (RouteSolver)
+    {
+        RouteSolver->Cancel();
+    }
+    const uint32 Request = ++RouteRequest;
+    RouteFallbackSpeed = FallbackSpeed;
+
+    // The game thread only copies the remaining goals, the cost matrix is built on the solver's task
+    FCourseRouteInput Input;
+    Input.Start = FromLocation;
+    Input.GoalTimes = GoalTimes;
+    Input.FallbackSpeed = FallbackSpeed;
+    for (const FGoalRuntimeState& State : Goals)
+    {
+        if (State.bActive)
+        {
+            Input.GoalIds.Add(State.GoalId);
+            Input.GoalLocations.Add(State.Location);
+        }
+    }
+
+    if (Input.GoalIds.Num() == 0)
+    {
+        ClearRoute();
+        return;
+    }
+
+    TSharedRef<FCourseRouteSolver, ESPMode::ThreadSafe> Solver = MakeShared<FCourseRouteSolver, ESPMode::ThreadSafe>();
+    RouteSolver = Solver;
+
+    TWeakObjectPtr<UGoalManifestSubsystem> WeakThis(this);
+    Solver->OnFinished = [WeakThis, Request, FromLocation, GoalLocations = Input.GoalLocations](const FCourseRouteSolver& Finished)
+        {
+            FCourseRouteSolver::FResult Result;
+            if (!Finished.GetBest(Result)) return;
+
+            TArray<FVector> Points;
+            Points.Reserve(Result.Order.Num() + 1);
+            Points.Add(FromLocation);
+            for (int32 Goal : Result.Order)
+            {
+                Points.Add(GoalLocations[Goal]);
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Request, Points = MoveTemp(Points), Result = MoveTemp(Result)]() mutable
+                {
+                    UGoalManifestSubsystem* This = WeakThis.Get();
+                    if (!This || Request != This->RouteRequest) return;
+
+                    UE_LOG(LogCourseRoute, Log, TEXT("Route through %d goals: %.1f s estimated (greedy %.1f s), %d workers, %.1f ms"),
+                        Result.Order.Num(), Result.Cost, Result.SeedCost, Result.NumWorkers, Result.TotalMs);
+
+                    This->RouteSolver.Reset();
+                    This->Route = MoveTemp(Points);
+                    This->OnRouteChanged.Broadcast();
+                });
+        };
+
+    Solver->Start(MoveTemp(Input), CVarRouteBudgetMs.GetValueOnGameThread() / 1000.0);
+}
+
+void UGoalManifestSubsystem::ClearRoute()
+{
+    Route.Reset();
+    OnRouteChanged.Broadcast();
+}
+
+int32 UGoalManifestSubsystem::FindOrAddGoal(const FGuid& GoalId, const FVector& Location)
+{
+    if (const int32* Existing = GoalIndexById.Find(GoalId))
+    {
+        return *Existing;
+    }
+
+    const int32 Index = Goals.AddDefaulted();
+    Goals[Index].GoalId = GoalId;
+    Goals[Index].Location = Location;
+    GoalIndexById.Add(GoalId, Index);
+    return Index;
+}
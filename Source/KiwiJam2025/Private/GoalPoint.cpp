@@ -2,18 +2,25 @@
 
 
 #include "GoalPoint.h"
-#include "GoalPoint.h"
+#include "GoalManifestSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/BillboardComponent.h"
 #include "GameFramework/Character.h"
-#include "Character/ParkourCharacter.h"
-#include "UI/WorldMapWidget.h"
+#include "Player/ParkourPlayerState.h"
+#include "Core/ParkourEventBus.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
+
+static TAutoConsoleVariable<bool> CVarGoalNaiveReplication(
+    TEXT("Parkour.Goals.NaiveReplication"),
+    false,
+    TEXT("Replicate bIsActive on every goal actor instead of per-player state, as a bandwidth baseline. Read at BeginPlay."));
 
 // Sets default values
 AGoalPoint::AGoalPoint()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Markers are owned by the goal manifest subsystem, nothing to do per frame
+	PrimaryActorTick.bCanEverTick = false;
 
     CollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionSphere"));
     CollisionSphere->InitSphereRadius(100.f);
@@ -35,64 +42,128 @@ void AGoalPoint::BeginPlay()
 	Super::BeginPlay();
 
     CollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AGoalPoint::OnOverlapBegin); 
-	
- 
+
+    if (HasAuthority() && CVarGoalNaiveReplication.GetValueOnGameThread())
+    {
+        SetReplicates(true);
+    }
+
+    if (UGoalManifestSubsystem* Manifest = GetWorld()->GetSubsystem<UGoalManifestSubsystem>())
+    {
+        Manifest->BindGoal(this);
+    }
+}
+
+void AGoalPoint::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UGoalManifestSubsystem* Manifest = GetWorld()->GetSubsystem<UGoalManifestSubsystem>())
+    {
+        Manifest->UnbindGoal(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AGoalPoint::PostActorCreated()
+{
+    Super::PostActorCreated();
+
+#if WITH_EDITOR
+    // Placed in the editor. Goals spawned at runtime aren't in the manifest or the save.
+    if (!GetWorld() || !GetWorld()->IsGameWorld())
+    {
+        EnsureGoalId();
+    }
+#endif
+}
+
+void AGoalPoint::PostLoad()
+{
+    Super::PostLoad();
+
+    // Ids are only assigned in the editor; a new one here would change on every load
+    if (!GoalId.IsValid() && !IsTemplate())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s has no goal id, rebuild the goal manifest and save the level"), *GetPathName());
+    }
+}
+
+#if WITH_EDITOR
+void AGoalPoint::PostDuplicate(EDuplicateMode::Type DuplicateMode)
+{
+    Super::PostDuplicate(DuplicateMode);
+
+    // Copy-pasted goals need their own id, PIE copies keep the original
+    if (DuplicateMode != EDuplicateMode::PIE)
+    {
+        EnsureGoalId();
+    }
+}
+
+bool AGoalPoint::EnsureGoalId()
+{
+    if (GoalId.IsValid() || IsTemplate()) return false;
+
+    Modify();
+    GoalId = FGuid::NewGuid();
+    MarkPackageDirty();
+    return true;
+}
+#endif
+
+void AGoalPoint::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    // Only sent in the naive baseline, goal actors don't replicate otherwise
+    DOREPLIFETIME(AGoalPoint, bIsActive);
 }
 
 void AGoalPoint::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-    if (OtherActor && OtherActor->IsA(ACharacter::StaticClass()) && bIsActive)
+    if (!OtherActor || !OtherActor->IsA(ACharacter::StaticClass())) return;
+
+    // Per-player state is the server's to change; the owning client hears back through replication
+    if (AParkourPlayerState* PlayerState = Cast<APawn>(OtherActor)->GetPlayerState<AParkourPlayerState>())
     {
-        OnGoalReached.Broadcast(this);
+        UGoalManifestSubsystem* Manifest = GetWorld()->GetSubsystem<UGoalManifestSubsystem>();
+        const float Split = Manifest ? Manifest->GetLevelTime() : 0.f;
+        if (HasAuthority() && PlayerState->MarkGoalReached(GoalId, Split))
+        {
+            PublishGoalReached(Cast<APawn>(OtherActor), Split);
+        }
+        return;
+    }
+
+    // Game mode without the parkour player state: one shared flag, as before
+    if (bIsActive)
+    {
+        UGoalManifestSubsystem* Manifest = GetWorld()->GetSubsystem<UGoalManifestSubsystem>();
+        PublishGoalReached(Cast<APawn>(OtherActor), Manifest ? Manifest->GetLevelTime() : 0.f);
         bIsActive = false;
 
-        if (GoalMarkerWidget)
+        // Clears the map marker
+        if (Manifest)
         {
-            if (APlayerController* PC = GetWorld()->GetFirstPlayerController())
-            {
-                PlayerChar = Cast<AParkourCharacter>(PC->GetPawn());
-                if (PlayerChar) 
-                {
-                    if (PlayerChar->GetWorldMapWidget())
-                    {
-                        PlayerChar->GetWorldMapWidget()->RemoveMarker(GoalMarkerWidget);
-                    }
-                }
-            }
-
-            GoalMarkerWidget = nullptr; // Clear reference
+            Manifest->NotifyGoalReached(this);
         }
     }
 }
 
-void AGoalPoint::Tick(float DeltaTime)
+void AGoalPoint::PublishGoalReached(APawn* Racer, float Split)
 {
-    // Create marker and register with map
-    if (GoalMarkerClass && !bMarkerAdded)
+    FParkourGoalReachedEvent Event;
+    Event.GoalId = GoalId;
+    Event.Location = FVector3f(GetActorLocation());
+    Event.Split = Split;
+    Event.Racer = Racer;
+    Event.Goal = this;
+    UParkourEventBus::Publish(GetWorld(), Event);
+
+    // Reflected call per listener, only paid when a Blueprint actually bound one
+    if (OnGoalReached.IsBound())
     {
-        UE_LOG(LogTemp, Warning, TEXT("Attempting to add marker"));
-        if (APlayerController* PC = GetWorld()->GetFirstPlayerController())
-        {
-            GoalMarkerWidget = CreateWidget<UUserWidget>(PC, GoalMarkerClass);
-
-
-            if (GoalMarkerWidget)
-            {
-                // Find the player's map widget and register
-                if (APawn* PlayerPawn = PC->GetPawn())
-                {
-                    PlayerChar = Cast<AParkourCharacter>(PlayerPawn);
-                    if (PlayerChar)
-                    {
-                        if (PlayerChar->GetWorldMapWidget())
-                        {
-                            PlayerChar->GetWorldMapWidget()->AddMarkerPersistent(GoalMarkerWidget, GetGoalLocation());
-                            bMarkerAdded = true;
-                        }
-                    }
-                }
-            }
-        }
+        OnGoalReached.Broadcast(this);
     }
 }
 
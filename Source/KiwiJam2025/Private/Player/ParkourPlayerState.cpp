@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/ParkourPlayerState.h"
+#include "GoalManifestSubsystem.h"
+#include "GoalPoint.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Containers/Ticker.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogParkourPlayerState, Log, All);
+
+void FGoalCompletionItem::PostReplicatedAdd(const FGoalCompletionArray& InArraySerializer)
+{
+    // Owner-only property, so any client receiving items is the local player
+    if (InArraySerializer.Owner)
+    {
+        InArraySerializer.Owner->HandleGoalCompleted(*this, true);
+    }
+}
+
+AParkourPlayerState::AParkourPlayerState()
+{
+    GoalCompletion.Owner = this;
+}
+
+void AParkourPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    // Push model: nothing is compared until MarkGoalReached dirties it
+    FDoRepLifetimeParams OwnerParams;
+    OwnerParams.bIsPushBased = true;
+    OwnerParams.Condition = COND_OwnerOnly;
+    DOREPLIFETIME_WITH_PARAMS_FAST(AParkourPlayerState, GoalCompletion, OwnerParams);
+
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(AParkourPlayerState, NumGoalsReached, Params);
+}
+
+void AParkourPlayerState::BeginPlay()
+{
+    Super::BeginPlay();
+
+    SeedFromManifest();
+}
+
+bool AParkourPlayerState::MarkGoalReached(const FGuid& GoalId, float Split)
+{
+    if (!HasAuthority() || ReachedGoals.Contains(GoalId)) return false;
+
+    FGoalCompletionItem& Item = GoalCompletion.Items.AddDefaulted_GetRef();
+    Item.GoalId = GoalId;
+    Item.Split = Split;
+    GoalCompletion.MarkItemDirty(Item);
+    MARK_PROPERTY_DIRTY_FROM_NAME(AParkourPlayerState, GoalCompletion, this);
+
+    ++NumGoalsReached;
+    MARK_PROPERTY_DIRTY_FROM_NAME(AParkourPlayerState, NumGoalsReached, this);
+
+    // Player states update rarely by default, don't wait a second for the next one
+    ForceNetUpdate();
+
+    HandleGoalCompleted(Item, IsLocalPlayerState());
+    return true;
+}
+
+void AParkourPlayerState::SeedFromManifest()
+{
+    if (!HasAuthority() || !IsLocalPlayerState()) return;
+
+    const UGoalManifestSubsystem* Manifest = GetWorld()->GetSubsystem<UGoalManifestSubsystem>();
+    if (!Manifest) return;
+
+    for (const FGoalRuntimeState& State : Manifest->GetGoals())
+    {
+        if (!State.bActive && !ReachedGoals.Contains(State.GoalId))
+        {
+            FGoalCompletionItem& Item = GoalCompletion.Items.AddDefaulted_GetRef();
+            Item.GoalId = State.GoalId;
+            Item.Split = State.BestSplit;
+            GoalCompletion.MarkItemDirty(Item);
+            HandleGoalCompleted(Item, false);
+            ++NumGoalsReached;
+        }
+    }
+
+    MARK_PROPERTY_DIRTY_FROM_NAME(AParkourPlayerState, GoalCompletion, this);
+    MARK_PROPERTY_DIRTY_FROM_NAME(AParkourPlayerState, NumGoalsReached, this);
+}
+
+void AParkourPlayerState::HandleGoalCompleted(const FGoalCompletionItem& Item, bool bNotifyManifest)
+{
+    ReachedGoals.Add(Item.GoalId);
+
+    if (bNotifyManifest)
+    {
+        if (UGoalManifestSubsystem* Manifest = GetWorld()->GetSubsystem<UGoalManifestSubsystem>())
+        {
+            Manifest->NotifyGoalReached(Item.GoalId, Item.Split);
+        }
+    }
+}
+
+bool AParkourPlayerState::IsLocalPlayerState() const
+{
+    const APlayerController* PC = GetPlayerController();
+    return PC && PC->IsLocalController();
+}
+
+namespace GoalReplicationBench
+{
+    static FTSTicker::FDelegateHandle TickHandle;
+
+    // Completes random goals for random players at a fixed rate and logs what the net driver
+    // sent. Run once with Parkour.Goals.NaiveReplication 0 and once with 1 (set before the
+    // map loads) to compare the fast array against a replicated bool on every goal actor.
+    static void Run(UWorld* World, float Seconds, float PerSecond)
+    {
+        UNetDriver* NetDriver = World->GetNetDriver();
+        if (!NetDriver || World->GetNetMode() == NM_Client || !World->GetGameState())
+        {
+            UE_LOG(LogParkourPlayerState, Warning, TEXT("[GoalRepBench] Run on a listen or dedicated server"));
+            return;
+        }
+
+        UGoalManifestSubsystem* Manifest = World->GetSubsystem<UGoalManifestSubsystem>();
+        const IConsoleVariable* NaiveVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Parkour.Goals.NaiveReplication"));
+        const bool bNaive = NaiveVar && NaiveVar->GetBool();
+        if (!Manifest || Manifest->GetGoals().Num() == 0) return;
+
+        FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+        const int64 StartBytes = (int64)NetDriver->OutTotalBytes;
+        const double StartTime = FPlatformTime::Seconds();
+        TSharedRef<double> Budget = MakeShared<double>(0.0);
+        TSharedRef<int32> Completions = MakeShared<int32>(0);
+        TWeakObjectPtr<UWorld> WeakWorld(World);
+        FRandomStream Random(1234);
+
+        TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+            [WeakWorld, bNaive, Seconds, PerSecond, StartBytes, StartTime, Budget, Completions, Random](float DeltaTime) mutable
+            {
+                UWorld* World = WeakWorld.Get();
+                UGoalManifestSubsystem* Manifest = World ? World->GetSubsystem<UGoalManifestSubsystem>() : nullptr;
+                UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+                if (!Manifest || !NetDriver || !World->GetGameState()) return false;
+
+                const TArray<TObjectPtr<APlayerState>>& Players = World->GetGameState()->PlayerArray;
+                const TArray<FGoalRuntimeState>& Goals = Manifest->GetGoals();
+
+                for (*Budget += DeltaTime * PerSecond; *Budget >= 1.0 && Players.Num() > 0; *Budget -= 1.0)
+                {
+                    const FGoalRuntimeState& Goal = Goals[Random.RandHelper(Goals.Num())];
+                    if (bNaive)
+                    {
+                        // Baseline: one global bool per goal actor
+                        if (AGoalPoint* GoalActor = Goal.Actor.Get())
+                        {
+                            GoalActor->SetGoalActive(!GoalActor->IsGoalActive());
+                            ++*Completions;
+                        }
+                    }
+                    else if (AParkourPlayerState* Player = Cast<AParkourPlayerState>(Players[Random.RandHelper(Players.Num())]))
+                    {
+                        *Completions += Player->MarkGoalReached(Goal.GoalId, Manifest->GetLevelTime()) ? 1 : 0;
+                    }
+                }
+
+                const double Elapsed = FPlatformTime::Seconds() - StartTime;
+                if (Elapsed < Seconds) return true;
+
+                const int64 Bytes = (int64)NetDriver->OutTotalBytes - StartBytes;
+                const int32 Connections = FMath::Max(1, NetDriver->ClientConnections.Num());
+                UE_LOG(LogParkourPlayerState, Log, TEXT("[GoalRepBench] %s: %d players, %d goals, %d changes in %.1fs -> %lld bytes out, %.1f B/s, %.1f B/s per connection"),
+                    bNaive ? TEXT("per-actor bool") : TEXT("fast array"), Players.Num(), Goals.Num(), *Completions, Elapsed,
+                    Bytes, Bytes / Elapsed, Bytes / Elapsed / Connections);
+                return false;
+            }));
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs BenchCommand(
+        TEXT("Parkour.GoalRepBench"),
+        TEXT("Server: completes random goals for random players and logs bytes sent. Args: [Seconds=10] [ChangesPerSecond=32]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                if (World)
+                {
+                    Run(World,
+                        Args.Num() > 0 ? FMath::Max(1.f, FCString::Atof(*Args[0])) : 10.f,
+                        Args.Num() > 1 ? FMath::Max(0.1f, FCString::Atof(*Args[1])) : 32.f);
+                }
+            }));
+}
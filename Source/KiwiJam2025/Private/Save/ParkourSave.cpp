@@ -0,0 +1,437 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Save/ParkourSave.h"
+#include "GoalManifestSubsystem.h"
+#include "KiwiJam2025.h"
+#include "Async/Async.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Controller.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY(LogParkourSave);
+
+DECLARE_CYCLE_STAT(TEXT("Save Snapshot"), STAT_ParkourSaveSnapshot, STATGROUP_KiwiJam);
+
+namespace ParkourSave
+{
+    // Magic, version, raw size, compressed size, CRC of the raw payload
+    static constexpr int32 HeaderSize = sizeof(uint32) + sizeof(uint16) + 3 * sizeof(uint32);
+
+    static const FName CompressionFormat = NAME_Oodle;
+}
+
+void FParkourSaveData::SerializePayload(FArchive& Ar, uint16 Version)
+{
+    Ar << MapName;
+
+    int32 NumGoals = Goals.Num();
+    Ar << NumGoals;
+    if (Ar.IsLoading())
+    {
+        if (NumGoals < 0 || NumGoals > Ar.TotalSize() / (int64)sizeof(FGuid))
+        {
+            Ar.SetError();
+            return;
+        }
+        Goals.SetNum(NumGoals);
+    }
+
+    // Ids together, then reached bits, then splits, so each run compresses on its own terms
+    for (FParkourGoalProgress& Goal : Goals)
+    {
+        Ar << Goal.GoalId;
+    }
+
+    TArray<uint8> ReachedBits;
+    ReachedBits.SetNumZeroed((NumGoals + 7) / 8);
+    if (Ar.IsSaving())
+    {
+        for (int32 i = 0; i < NumGoals; ++i)
+        {
+            ReachedBits[i >> 3] |= Goals[i].bReached ? (1 << (i & 7)) : 0;
+        }
+    }
+    Ar.Serialize(ReachedBits.GetData(), ReachedBits.Num());
+
+    for (int32 i = 0; i < NumGoals; ++i)
+    {
+        FParkourGoalProgress& Goal = Goals[i];
+        if (Ar.IsLoading())
+        {
+            Goal.bReached = (ReachedBits[i >> 3] & (1 << (i & 7))) != 0;
+        }
+
+        // Whole milliseconds, varint packed: most splits fit in three bytes
+        uint32 SplitMs = Ar.IsSaving() ? (uint32)FMath::RoundToInt(FMath::Max(Goal.BestSplit, 0.f) * 1000.f) : 0;
+        Ar.SerializeIntPacked(SplitMs);
+        if (Ar.IsLoading())
+        {
+            Goal.BestSplit = SplitMs * 0.001f;
+        }
+    }
+
+    Ar << bHasCheckpoint;
+    if (bHasCheckpoint)
+    {
+        Ar << CheckpointGoalId << CheckpointLocation << CheckpointYaw;
+        if (Version >= CheckpointTimeVersion)
+        {
+            Ar << CheckpointRunTime;
+        }
+    }
+
+    // Mostly long runs of empty or full words, which is what Oodle is best at
+    if (Version >= ExplorationVersion && !Exploration.Serialize(Ar))
+    {
+        Ar.SetError();
+    }
+}
+
+bool FParkourSaveData::SaveToBytes(TArray<uint8>& OutBytes) const
+{
+    TArray<uint8> Payload;
+    FMemoryWriter PayloadWriter(Payload);
+    // Only reads the data when saving
+    const_cast<FParkourSaveData*>(this)->SerializePayload(PayloadWriter, LatestVersion);
+
+    int32 CompressedSize = FCompression::CompressMemoryBound(ParkourSave::CompressionFormat, Payload.Num());
+    OutBytes.SetNumUninitialized(ParkourSave::HeaderSize + CompressedSize);
+    if (!FCompression::CompressMemory(ParkourSave::CompressionFormat, OutBytes.GetData() + ParkourSave::HeaderSize, CompressedSize, Payload.GetData(), Payload.Num()))
+    {
+        return false;
+    }
+    OutBytes.SetNum(ParkourSave::HeaderSize + CompressedSize, EAllowShrinking::No);
+
+    uint32 FileMagic = Magic;
+    uint16 FileVersion = LatestVersion;
+    uint32 RawSize = Payload.Num();
+    uint32 FileCompressedSize = CompressedSize;
+    uint32 Crc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+    FMemoryWriter HeaderWriter(OutBytes);
+    HeaderWriter << FileMagic << FileVersion << RawSize << FileCompressedSize << Crc;
+    return true;
+}
+
+bool FParkourSaveData::LoadFromBytes(const TArray<uint8>& Bytes)
+{
+    if (Bytes.Num() < ParkourSave::HeaderSize)
+    {
+        return false;
+    }
+
+    uint32 FileMagic = 0;
+    uint16 FileVersion = 0;
+    uint32 RawSize = 0;
+    uint32 CompressedSize = 0;
+    uint32 Crc = 0;
+
+    FMemoryReader HeaderReader(Bytes);
+    HeaderReader << FileMagic << FileVersion << RawSize << CompressedSize << Crc;
+
+    if (FileMagic != Magic || FileVersion == 0 || FileVersion > LatestVersion
+        || (int64)CompressedSize != Bytes.Num() - ParkourSave::HeaderSize)
+    {
+        return false;
+    }
+
+    TArray<uint8> Payload;
+    Payload.SetNumUninitialized(RawSize);
+    if (!FCompression::UncompressMemory(ParkourSave::CompressionFormat, Payload.GetData(), RawSize, Bytes.GetData() + ParkourSave::HeaderSize, CompressedSize)
+        || FCrc::MemCrc32(Payload.GetData(), Payload.Num()) != Crc)
+    {
+        return false;
+    }
+
+    FMemoryReader PayloadReader(Payload);
+    SerializePayload(PayloadReader, FileVersion);
+    return !PayloadReader.IsError();
+}
+
+bool FParkourSaveData::SaveToFile(const FString& Path) const
+{
+    TArray<uint8> Bytes;
+    if (!SaveToBytes(Bytes))
+    {
+        return false;
+    }
+
+    const FString TempPath = Path + TEXT(".tmp");
+    if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath))
+    {
+        return false;
+    }
+    return IFileManager::Get().Move(*Path, *TempPath, true, true);
+}
+
+bool FParkourSaveData::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    return FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent) && LoadFromBytes(Bytes);
+}
+
+FString FParkourSaveData::GetSavePath(const FString& MapName)
+{
+    return FPaths::ProjectSavedDir() / TEXT("SaveGames") / (MapName + TEXT(".kasv"));
+}
+
+void UParkourSaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // Start reading as soon as the transition begins, it overlaps the level load
+    PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UParkourSaveSubsystem::HandlePreLoadMap);
+
+    GetGameInstance()->GetOnPawnControllerChanged().AddDynamic(this, &UParkourSaveSubsystem::HandlePawnControllerChanged);
+}
+
+void UParkourSaveSubsystem::Deinitialize()
+{
+    FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+    GetGameInstance()->GetOnPawnControllerChanged().RemoveDynamic(this, &UParkourSaveSubsystem::HandlePawnControllerChanged);
+
+    // Don't lose the last save on quit
+    Flush();
+
+    Super::Deinitialize();
+}
+
+void UParkourSaveSubsystem::HandlePreLoadMap(const FString& MapName)
+{
+    StartLoad(FPackageName::GetShortName(MapName));
+}
+
+void UParkourSaveSubsystem::StartLoad(const FString& MapName)
+{
+    LoadingMap = MapName;
+    bLoadFinished = false;
+    LoadedData.Reset();
+
+    // On the pipe, so a load never starts before an earlier save of the same map is written
+    TWeakObjectPtr<UParkourSaveSubsystem> WeakThis(this);
+    IOPipe.Launch(TEXT("ParkourSaveLoad"), [WeakThis, MapName]()
+        {
+            TSharedPtr<FParkourSaveData> Data = MakeShared<FParkourSaveData>();
+            if (!Data->LoadFromFile(FParkourSaveData::GetSavePath(MapName)))
+            {
+                Data.Reset();
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, MapName, Data]()
+                {
+                    if (UParkourSaveSubsystem* This = WeakThis.Get())
+                    {
+                        This->OnLoadFinished(MapName, Data);
+                    }
+                });
+        });
+}
+
+void UParkourSaveSubsystem::OnLoadFinished(const FString& MapName, TSharedPtr<FParkourSaveData> Data)
+{
+    // Superseded by a later transition
+    if (MapName != LoadingMap) return;
+
+    bLoadFinished = true;
+    LoadedData = Data;
+
+    UE_LOG(LogParkourSave, Log, TEXT("Loaded progress for %s: %d goals"), *MapName, Data ? Data->Goals.Num() : 0);
+
+    if (UGoalManifestSubsystem* Manifest = PendingManifest.Get())
+    {
+        PendingManifest.Reset();
+        if (LoadedData)
+        {
+            Apply(Manifest, *LoadedData);
+        }
+    }
+}
+
+void UParkourSaveSubsystem::ApplyWhenLoaded(UGoalManifestSubsystem* Manifest)
+{
+    if (!Manifest) return;
+
+    const FString MapName = UWorld::RemovePIEPrefix(Manifest->GetWorld()->GetMapName());
+
+    // First map of the session (or PIE) never went through PreLoadMap
+    if (MapName != LoadingMap)
+    {
+        StartLoad(MapName);
+    }
+
+    if (!bLoadFinished)
+    {
+        PendingManifest = Manifest;
+        return;
+    }
+
+    if (LoadedData)
+    {
+        Apply(Manifest, *LoadedData);
+    }
+}
+
+void UParkourSaveSubsystem::Apply(UGoalManifestSubsystem* Manifest, const FParkourSaveData& Data)
+{
+    Manifest->ApplySavedProgress(Data);
+    if (UExplorationSubsystem* Exploration = Manifest->GetWorld()->GetSubsystem<UExplorationSubsystem>())
+    {
+        Exploration->ApplySavedProgress(Data);
+    }
+
+    if (Data.bHasCheckpoint)
+    {
+        bPendingCheckpoint = true;
+        PendingCheckpointLocation = FVector(Data.CheckpointLocation);
+        PendingCheckpointYaw = Data.CheckpointYaw;
+        PendingCheckpointRunTime = Data.CheckpointRunTime;
+
+        // Player may already be in
+        if (APlayerController* PC = GetGameInstance()->GetFirstLocalPlayerController(Manifest->GetWorld()))
+        {
+            HandlePawnControllerChanged(PC->GetPawn(), PC);
+        }
+    }
+}
+
+void UParkourSaveSubsystem::HandlePawnControllerChanged(APawn* Pawn, AController* Controller)
+{
+    if (!bPendingCheckpoint || !Pawn || !Controller || !Controller->IsLocalPlayerController()) return;
+
+    bPendingCheckpoint = false;
+
+    const FRotator Rotation(0.f, PendingCheckpointYaw, 0.f);
+    Pawn->TeleportTo(PendingCheckpointLocation, Rotation);
+    Controller->SetControlRotation(Rotation);
+
+    // The run carries on from the checkpoint, not from the level start
+    if (UGoalManifestSubsystem* Manifest = Pawn->GetWorld()->GetSubsystem<UGoalManifestSubsystem>())
+    {
+        Manifest->ResumeRun(PendingCheckpointRunTime);
+    }
+}
+
+void UParkourSaveSubsystem::RequestSave(UWorld* World)
+{
+    UGoalManifestSubsystem* Manifest = World ? World->GetSubsystem<UGoalManifestSubsystem>() : nullptr;
+    if (!Manifest) return;
+
+    FParkourSaveData Data;
+    {
+        SCOPE_CYCLE_COUNTER(STAT_ParkourSaveSnapshot);
+        const double StartTime = FPlatformTime::Seconds();
+
+        Data.MapName = UWorld::RemovePIEPrefix(World->GetMapName());
+        Manifest->GatherProgress(Data);
+        if (const UExplorationSubsystem* Exploration = World->GetSubsystem<UExplorationSubsystem>())
+        {
+            Exploration->GatherProgress(Data);
+        }
+
+        LastSnapshotMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    }
+
+    SubmitSave(MoveTemp(Data));
+}
+
+void UParkourSaveSubsystem::SubmitSave(FParkourSaveData&& Data, TFunction<void(bool, int64, double)> OnWritten)
+{
+    IOPipe.Launch(TEXT("ParkourSaveWrite"), [Data = MoveTemp(Data), OnWritten = MoveTemp(OnWritten)]()
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            const FString Path = FParkourSaveData::GetSavePath(Data.MapName);
+            const bool bSuccess = Data.SaveToFile(Path);
+            const double WorkerMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            if (!bSuccess)
+            {
+                UE_LOG(LogParkourSave, Warning, TEXT("Failed to write %s"), *Path);
+            }
+
+            if (OnWritten)
+            {
+                const int64 Bytes = bSuccess ? IFileManager::Get().FileSize(*Path) : 0;
+                AsyncTask(ENamedThreads::GameThread, [OnWritten, bSuccess, Bytes, WorkerMs]()
+                    {
+                        OnWritten(bSuccess, Bytes, WorkerMs);
+                    });
+            }
+        });
+}
+
+void UParkourSaveSubsystem::Flush()
+{
+    IOPipe.WaitUntilEmpty();
+}
+
+namespace ParkourSave
+{
+    // Synthetic goals through the same snapshot and write path as a real save
+    static void RunBench(UWorld* World, int32 NumGoals, int32 NumSaves)
+    {
+        UParkourSaveSubsystem* Saves = World->GetGameInstance() ? World->GetGameInstance()->GetSubsystem<UParkourSaveSubsystem>() : nullptr;
+        if (!Saves) return;
+
+        TArray<FGoalRuntimeState> Goals;
+        Goals.SetNum(NumGoals);
+        FRandomStream Random(NumGoals);
+        for (int32 i = 0; i < NumGoals; ++i)
+        {
+            Goals[i].GoalId = FGuid::NewGuid();
+            Goals[i].bActive = Random.FRand() < 0.5f;
+            Goals[i].BestSplit = Goals[i].bActive ? 0.f : Random.FRandRange(5.f, 1800.f);
+        }
+
+        double TotalSnapshotMs = 0.0;
+        double MaxSnapshotMs = 0.0;
+        for (int32 Save = 0; Save < NumSaves; ++Save)
+        {
+            const double StartTime = FPlatformTime::Seconds();
+
+            FParkourSaveData Data;
+            Data.MapName = TEXT("SaveBench");
+            UGoalManifestSubsystem::BuildSaveData(Goals, INDEX_NONE, 0.f, 0.f, Data);
+
+            const bool bLast = Save == NumSaves - 1;
+            Saves->SubmitSave(MoveTemp(Data), [NumGoals, bLast](bool bSuccess, int64 Bytes, double WorkerMs)
+                {
+                    if (bLast)
+                    {
+                        UE_LOG(LogParkourSave, Log, TEXT("[SaveBench] %d goals: %lld bytes on disk, %.2f ms on the worker (serialize + compress + write)%s"),
+                            NumGoals, Bytes, WorkerMs, bSuccess ? TEXT("") : TEXT(" FAILED"));
+                    }
+                });
+
+            const double Ms = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+            TotalSnapshotMs += Ms;
+            MaxSnapshotMs = FMath::Max(MaxSnapshotMs, Ms);
+        }
+
+        UE_LOG(LogParkourSave, Log, TEXT("[SaveBench] %d goals x %d saves: game thread %.3f ms avg, %.3f ms max per save"),
+            NumGoals, NumSaves, TotalSnapshotMs / FMath::Max(1, NumSaves), MaxSnapshotMs);
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs SaveBenchCommand(
+        TEXT("Parkour.SaveBench"),
+        TEXT("Times the game thread part of a progress save with synthetic goals. Args: [Goals=5000] [Saves=20]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                if (World)
+                {
+                    RunBench(World,
+                        Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 5000,
+                        Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 20);
+                }
+            }));
+}
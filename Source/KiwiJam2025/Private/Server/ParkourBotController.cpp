@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Server/ParkourBotController.h"
+#include "Character/ParkourCharacter.h"
+
+AParkourBotController::AParkourBotController()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Shows up in the game state's player array like a connected racer
+	bWantsPlayerState = true;
+}
+
+void AParkourBotController::OnPossess(APawn* InPawn)
+{
+    Super::OnPossess(InPawn);
+
+    if (const AParkourCharacter* Character = Cast<AParkourCharacter>(InPawn))
+    {
+        Driver.AcceptRadius = AcceptRadius;
+        Driver.WanderRadius = WanderRadius;
+        Driver.StallSpeed = StallSpeed;
+        Driver.TargetTimeout = TargetTimeout;
+        Driver.Start(*Character, GetUniqueID());
+        SetFocalPoint(Driver.GetTarget());
+    }
+}
+
+void AParkourBotController::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    AParkourCharacter* Character = Cast<AParkourCharacter>(GetPawn());
+    if (!Character) return;
+
+    if (Driver.Tick(*Character, DeltaTime))
+    {
+        SetFocalPoint(Driver.GetTarget());
+    }
+}
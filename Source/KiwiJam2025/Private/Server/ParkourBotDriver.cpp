@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Server/ParkourBotDriver.h"
+#include "Character/ParkourCharacter.h"
+#include "GoalManifestSubsystem.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Misc/CommandLine.h"
+
+void FParkourBotDriver::Start(const AParkourCharacter& Character, int32 Seed)
+{
+    Random.Initialize(Seed);
+    Home = Character.GetActorLocation();
+    PickTarget(Character.GetWorld());
+}
+
+void FParkourBotDriver::PickTarget(const UWorld* World)
+{
+    TargetAge = 0.f;
+    StallTime = 0.f;
+
+    const UGoalManifestSubsystem* Manifest = World ? World->GetSubsystem<UGoalManifestSubsystem>() : nullptr;
+    if (Manifest && Manifest->GetGoals().Num() > 0)
+    {
+        const TArray<FGoalRuntimeState>& Goals = Manifest->GetGoals();
+        Target = Goals[Random.RandHelper(Goals.Num())].Location;
+    }
+    else
+    {
+        const FVector2D Offset = FVector2D(Random.GetUnitVector()) * Random.FRandRange(0.f, WanderRadius);
+        Target = Home + FVector(Offset, 0.f);
+    }
+}
+
+bool FParkourBotDriver::Tick(AParkourCharacter& Character, float DeltaTime)
+{
+    TargetAge += DeltaTime;
+    const FVector ToTarget = Target - Character.GetActorLocation();
+    if (ToTarget.Size2D() < AcceptRadius || TargetAge > TargetTimeout)
+    {
+        PickTarget(Character.GetWorld());
+        return true;
+    }
+
+    Character.AddMovementInput(ToTarget.GetSafeNormal2D(), 1.f);
+
+    // Blocked by something: let the character decide between vault, climb and a plain jump
+    const UCharacterMovementComponent* Movement = Character.GetCharacterMovement();
+    const bool bStalled = Movement && Movement->IsMovingOnGround() && Movement->Velocity.Size2D() < StallSpeed;
+    StallTime = bStalled ? StallTime + DeltaTime : 0.f;
+    if (StallTime > 0.25f)
+    {
+        StallTime = 0.f;
+        Character.TryTraverse();
+    }
+    return false;
+}
+
+bool FParkourBotDriver::IsBotClient()
+{
+    static const bool bBotClient = FParse::Param(FCommandLine::Get(), TEXT("ParkourBotClient"));
+    return bBotClient;
+}
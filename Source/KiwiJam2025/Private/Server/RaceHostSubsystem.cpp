@@ -0,0 +1,361 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Server/RaceHostSubsystem.h"
+#include "Server/ParkourBotController.h"
+#include "Template/KiwiJam2025GameMode.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameMapsSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/PackageName.h"
+#include "UObject/LinkerInstancingContext.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY(LogRaceHost);
+
+void URaceHostSubsystem::Deinitialize()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(BotTickHandle);
+    StopAllRaces();
+
+    Super::Deinitialize();
+}
+
+int32 URaceHostSubsystem::StartRace(const FString& MapPackage, int32 Port, int32 NumBots)
+{
+    if (!FPackageName::DoesPackageExist(MapPackage))
+    {
+        UE_LOG(LogRaceHost, Error, TEXT("No map package %s"), *MapPackage);
+        return INDEX_NONE;
+    }
+
+    const int32 RaceId = NextRaceId++;
+    const FString InstanceName = FString::Printf(TEXT("%s_Race%d"), *MapPackage, RaceId);
+
+    // Same trick as level instances: the map loads again under a new package name so its
+    // actors aren't the ones the default world (or another race) already owns
+    FLinkerInstancingContext Instancing;
+    Instancing.AddPackageMapping(FName(*MapPackage), FName(*InstanceName));
+    UPackage* Package = LoadPackage(CreatePackage(*InstanceName), *MapPackage, LOAD_None, nullptr, &Instancing);
+    if (!Package || !UWorld::FindWorldInPackage(Package))
+    {
+        UE_LOG(LogRaceHost, Error, TEXT("Couldn't load %s as %s"), *MapPackage, *InstanceName);
+        return INDEX_NONE;
+    }
+
+    UClass* GameInstanceClass = GetDefault<UGameMapsSettings>()->GameInstanceClass.TryLoadClass<UGameInstance>();
+    UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine, GameInstanceClass ? GameInstanceClass : UGameInstance::StaticClass());
+    GameInstance->InitializeStandalone(*FString::Printf(TEXT("RaceHost%d"), RaceId));
+
+    FURL URL(nullptr, *InstanceName, TRAVEL_Absolute);
+    URL.AddOption(TEXT("listen"));
+    URL.Port = Port;
+
+    // Rooted through the browse, which collects garbage before it finds the package again
+    Package->AddToRoot();
+    FString Error;
+    const EBrowseReturnVal::Type Result = GEngine->Browse(*GameInstance->GetWorldContext(), URL, Error);
+    Package->RemoveFromRoot();
+
+    if (Result != EBrowseReturnVal::Success)
+    {
+        UE_LOG(LogRaceHost, Error, TEXT("Race %d failed to start: %s"), RaceId, *Error);
+        ShutdownGameInstance(GameInstance);
+        return INDEX_NONE;
+    }
+
+    FHostedRace& Race = Races.AddDefaulted_GetRef();
+    Race.Id = RaceId;
+    Race.Port = Port;
+    Race.PackageName = InstanceName;
+    Race.GameInstance = GameInstance;
+    Race.PendingBots = NumBots;
+
+    if (NumBots > 0 && !BotTickHandle.IsValid())
+    {
+        BotTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &URaceHostSubsystem::TickPendingBots), 0.25f);
+    }
+
+    UE_LOG(LogRaceHost, Log, TEXT("Race %d: %s listening on %d"), RaceId, *InstanceName, Port);
+    return RaceId;
+}
+
+void URaceHostSubsystem::StopRace(int32 RaceId)
+{
+    const int32 Index = Races.IndexOfByPredicate([RaceId](const FHostedRace& Race) { return Race.Id == RaceId; });
+    if (Index == INDEX_NONE) return;
+
+    UGameInstance* GameInstance = Races[Index].GameInstance;
+    Races.RemoveAt(Index);
+    if (GameInstance)
+    {
+        ShutdownGameInstance(GameInstance);
+    }
+
+    UE_LOG(LogRaceHost, Log, TEXT("Race %d stopped"), RaceId);
+}
+
+void URaceHostSubsystem::ShutdownGameInstance(UGameInstance* GameInstance)
+{
+    // Same order the engine shuts a PIE instance down in
+    UWorld* World = GameInstance->GetWorld();
+    if (World)
+    {
+        World->BeginTearingDown();
+    }
+    GameInstance->Shutdown();
+    if (World)
+    {
+        World->DestroyWorld(true);
+        GEngine->DestroyWorldContext(World);
+    }
+}
+
+void URaceHostSubsystem::StopAllRaces()
+{
+    while (Races.Num() > 0)
+    {
+        StopRace(Races.Last().Id);
+    }
+}
+
+int32 URaceHostSubsystem::SpawnBots(UWorld* World, int32 NumBots)
+{
+    AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+    if (!GameMode || !World->HasBegunPlay()) return 0;
+
+    // The pawn class isn't final until it has streamed in
+    const AKiwiJam2025GameMode* KiwiGameMode = Cast<AKiwiJam2025GameMode>(GameMode);
+    if (KiwiGameMode && !KiwiGameMode->IsPawnClassReady()) return 0;
+
+    int32 Spawned = 0;
+    for (int32 Index = 0; Index < NumBots; ++Index)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        AParkourBotController* Bot = World->SpawnActor<AParkourBotController>(SpawnParams);
+        if (!Bot) continue;
+
+        GameMode->RestartPlayer(Bot);
+        Spawned += Bot->GetPawn() ? 1 : 0;
+    }
+    return Spawned;
+}
+
+bool URaceHostSubsystem::TickPendingBots(float DeltaTime)
+{
+    bool bAnyPending = false;
+    for (FHostedRace& Race : Races)
+    {
+        if (Race.PendingBots <= 0 || !Race.GameInstance) continue;
+
+        UWorld* World = Race.GameInstance->GetWorld();
+        if (SpawnBots(World, Race.PendingBots) > 0)
+        {
+            Race.PendingBots = 0;
+        }
+        bAnyPending |= Race.PendingBots > 0;
+    }
+
+    if (!bAnyPending)
+    {
+        BotTickHandle.Reset();
+    }
+    return bAnyPending;
+}
+
+namespace RaceHost
+{
+    static FTSTicker::FDelegateHandle TickHandle;
+
+    // Bot client processes of the current run
+    static TArray<FProcHandle> Clients;
+
+    struct FStep
+    {
+        int32 Races = 0;
+        double BusyMs = 0.0;
+        double UsedMB = 0.0;
+    };
+
+    static double GetUsedMB()
+    {
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        return FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+    }
+
+    // Headless game clients on this machine that connect to Port and run the course with
+    // FParkourBotDriver. The game build is used unless -BotClientExe= names another.
+    static void LaunchBotClients(int32 Port, int32 Count, TArray<FProcHandle>& OutClients)
+    {
+        FString Exe;
+        if (!FParse::Value(FCommandLine::Get(), TEXT("BotClientExe="), Exe))
+        {
+            Exe = FPlatformProcess::GenerateApplicationPath(FApp::GetProjectName(), FApp::GetBuildConfiguration());
+        }
+
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const FString Params = FString::Printf(TEXT("127.0.0.1:%d -nullrhi -nosound -unattended -ParkourBotClient -log=BotClient_%d_%d.log"), Port, Port, Index);
+            FProcHandle Handle = FPlatformProcess::CreateProc(*Exe, *Params, true, true, true, nullptr, 0, nullptr, nullptr);
+            if (Handle.IsValid())
+            {
+                OutClients.Add(Handle);
+            }
+            else
+            {
+                UE_LOG(LogRaceHost, Warning, TEXT("[RaceBench] Couldn't start bot client %s"), *Exe);
+            }
+        }
+    }
+
+    static void StopBotClients(TArray<FProcHandle>& Clients)
+    {
+        for (FProcHandle& Handle : Clients)
+        {
+            FPlatformProcess::TerminateProc(Handle, true);
+            FPlatformProcess::CloseProc(Handle);
+        }
+        Clients.Reset();
+    }
+
+    /**
+     * Adds races one at a time up to MaxRaces, each with BotsPerRace racers, and measures
+     * game thread busy time (frame minus idle) and process memory at every step. With
+     * bClients the racers are local bot client processes, so replication to real
+     * connections is in the numbers; otherwise they are AI controllers on the server.
+     */
+    static void Run(UWorld* World, int32 MaxRaces, int32 BotsPerRace, float SettleSeconds, float MeasureSeconds, int32 BasePort, bool bClients)
+    {
+        URaceHostSubsystem* Host = GEngine ? GEngine->GetEngineSubsystem<URaceHostSubsystem>() : nullptr;
+        if (!Host || World->GetNetMode() != NM_DedicatedServer)
+        {
+            UE_LOG(LogRaceHost, Warning, TEXT("[RaceBench] Run on a dedicated server"));
+            return;
+        }
+
+        FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+        StopBotClients(Clients);
+        Host->StopAllRaces();
+
+        // Race 0 is the default world
+        if (bClients)
+        {
+            LaunchBotClients(World->URL.Port, BotsPerRace, Clients);
+        }
+        else
+        {
+            URaceHostSubsystem::SpawnBots(World, BotsPerRace);
+        }
+
+        const FString MapPackage = World->GetOutermost()->GetName();
+        TSharedRef<TArray<FStep>> Steps = MakeShared<TArray<FStep>>();
+        Steps->Add({ 1, 0.0, 0.0 });
+
+        TSharedRef<double> StageStart = MakeShared<double>(FPlatformTime::Seconds());
+        TSharedRef<double> BusySum = MakeShared<double>(0.0);
+        TSharedRef<int32> BusyFrames = MakeShared<int32>(0);
+
+        TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+            [MapPackage, MaxRaces, BotsPerRace, SettleSeconds, MeasureSeconds, BasePort, bClients, Steps, StageStart, BusySum, BusyFrames](float DeltaTime)
+            {
+                URaceHostSubsystem* Host = GEngine->GetEngineSubsystem<URaceHostSubsystem>();
+                const double Elapsed = FPlatformTime::Seconds() - *StageStart;
+                if (Elapsed < SettleSeconds) return true;
+
+                *BusySum += FMath::Max(0.0, FApp::GetDeltaTime() - FApp::GetIdleTime()) * 1000.0;
+                ++*BusyFrames;
+                if (Elapsed < SettleSeconds + MeasureSeconds) return true;
+
+                // Memory once the race has settled with its bots in
+                Steps->Last().BusyMs = *BusySum / FMath::Max(1, *BusyFrames);
+                Steps->Last().UsedMB = GetUsedMB();
+                UE_LOG(LogRaceHost, Log, TEXT("[RaceBench] %d races: %.2f ms game thread per frame, %.1f MB used"),
+                    Steps->Last().Races, Steps->Last().BusyMs, Steps->Last().UsedMB);
+
+                const int32 Port = BasePort + Steps->Num();
+                if (Steps->Num() < MaxRaces && Host->StartRace(MapPackage, Port, bClients ? 0 : BotsPerRace) != INDEX_NONE)
+                {
+                    if (bClients)
+                    {
+                        LaunchBotClients(Port, BotsPerRace, Clients);
+                    }
+                    Steps->Add({ Steps->Num() + 1, 0.0, 0.0 });
+                    *StageStart = FPlatformTime::Seconds();
+                    *BusySum = 0.0;
+                    *BusyFrames = 0;
+                    return true;
+                }
+
+                // Least squares slope of busy time against race count
+                const int32 N = Steps->Num();
+                double SumX = 0.0, SumY = 0.0, SumXY = 0.0, SumXX = 0.0;
+                for (const FStep& Step : *Steps)
+                {
+                    SumX += Step.Races;
+                    SumY += Step.BusyMs;
+                    SumXY += Step.Races * Step.BusyMs;
+                    SumXX += Step.Races * Step.Races;
+                }
+                const double Denominator = N * SumXX - SumX * SumX;
+                const double MsPerRace = N > 1 && Denominator > 0.0 ? (N * SumXY - SumX * SumY) / Denominator : Steps->Last().BusyMs;
+                const double MBPerRace = N > 1 ? (Steps->Last().UsedMB - (*Steps)[0].UsedMB) / (N - 1) : 0.0;
+
+                const float TickRate = GEngine->GetMaxTickRate(0.f, false);
+                const double FrameBudgetMs = 1000.0 / (TickRate > 0.f ? TickRate : 30.f);
+
+                UE_LOG(LogRaceHost, Log, TEXT("[RaceBench] %d %s per race: %.2f ms and %.1f MB per extra race, %.1f races per core at %.0f Hz"),
+                    BotsPerRace, bClients ? TEXT("bot clients") : TEXT("server bots"), MsPerRace, MBPerRace, MsPerRace > 0.0 ? FrameBudgetMs / MsPerRace : 0.0, 1000.0 / FrameBudgetMs);
+
+                StopBotClients(Clients);
+                return false;
+            }));
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs StartCommand(
+        TEXT("Parkour.RaceHost.Start"),
+        TEXT("Dedicated server: hosts another race of this map. Args: Port [Bots=0]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                URaceHostSubsystem* Host = GEngine ? GEngine->GetEngineSubsystem<URaceHostSubsystem>() : nullptr;
+                if (Host && World && Args.Num() > 0)
+                {
+                    Host->StartRace(World->GetOutermost()->GetName(), FCString::Atoi(*Args[0]), Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 0);
+                }
+            }));
+
+    static FAutoConsoleCommand StopCommand(
+        TEXT("Parkour.RaceHost.StopAll"),
+        TEXT("Stops every hosted race except the default world"),
+        FConsoleCommandDelegate::CreateLambda([]()
+            {
+                if (URaceHostSubsystem* Host = GEngine ? GEngine->GetEngineSubsystem<URaceHostSubsystem>() : nullptr)
+                {
+                    Host->StopAllRaces();
+                }
+            }));
+
+    static FAutoConsoleCommandWithWorldAndArgs BenchCommand(
+        TEXT("Parkour.RaceHost.Bench"),
+        TEXT("Dedicated server: adds bot-filled races one at a time and logs game thread ms and MB per race and races per core. Clients=1 starts the bots as local client processes instead of server AI. Args: [Races=4] [BotsPerRace=16] [SettleSeconds=5] [MeasureSeconds=10] [BasePort=7800] [Clients=1]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                if (World)
+                {
+                    Run(World,
+                        Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 4,
+                        Args.Num() > 1 ? FMath::Max(0, FCString::Atoi(*Args[1])) : 16,
+                        Args.Num() > 2 ? FMath::Max(0.f, FCString::Atof(*Args[2])) : 5.f,
+                        Args.Num() > 3 ? FMath::Max(1.f, FCString::Atof(*Args[3])) : 10.f,
+                        Args.Num() > 4 ? FCString::Atoi(*Args[4]) : 7800,
+                        Args.Num() > 5 ? FCString::Atoi(*Args[5]) != 0 : true);
+                }
+            }));
+}
@@ -0,0 +1,411 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/InputReplay.h"
+#include "Character/ParkourCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY(LogInputReplay);
+
+static bool HasAxisValue(EReplayInput Input)
+{
+    return Input == EReplayInput::Move || Input == EReplayInput::Look;
+}
+
+bool FInputRecording::Serialize(FArchive& Ar)
+{
+    uint32 FileMagic = Magic;
+    uint16 FileVersion = Version;
+    Ar << FileMagic << FileVersion;
+
+    if (FileMagic != Magic || FileVersion != Version)
+    {
+        return false;
+    }
+
+    Ar << MapName << StartLocation << StartRotation << StartControlRotation << StartVelocity << StartMovementMode;
+    Ar << FrameDeltas;
+
+    int32 NumEvents = Events.Num();
+    Ar << NumEvents;
+    if (Ar.IsLoading())
+    {
+        if (NumEvents < 0 || NumEvents > Ar.TotalSize())
+        {
+            return false;
+        }
+        Events.SetNum(NumEvents);
+    }
+
+    // Frames go as the gap from the previous event, nearly always 0 or 1 so a single byte.
+    // Buttons carry no value, the axes two floats.
+    uint32 PrevFrame = 0;
+    for (FEvent& Event : Events)
+    {
+        uint32 Gap = Event.Frame - PrevFrame;
+        Ar.SerializeIntPacked(Gap);
+        Event.Frame = PrevFrame + Gap;
+        PrevFrame = Event.Frame;
+
+        uint8 InputByte = (uint8)Event.Input;
+        Ar << InputByte;
+        if (InputByte >= (uint8)EReplayInput::Count || Event.Frame >= (uint32)FrameDeltas.Num())
+        {
+            return false;
+        }
+        Event.Input = (EReplayInput)InputByte;
+
+        if (HasAxisValue(Event.Input))
+        {
+            Ar << Event.Value.X << Event.Value.Y;
+        }
+    }
+
+    return !Ar.IsError();
+}
+
+bool FInputRecording::SaveToFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    if (!Serialize(Writer))
+    {
+        return false;
+    }
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FInputRecording::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    return Serialize(Reader);
+}
+
+FString FInputRecording::ResolvePath(const FString& NameOrPath)
+{
+    if (NameOrPath.Contains(TEXT("/")) || NameOrPath.Contains(TEXT("\\")) || FPaths::GetExtension(NameOrPath) == TEXT("kinp"))
+    {
+        return NameOrPath;
+    }
+    return FPaths::ProjectSavedDir() / TEXT("InputRecordings") / (NameOrPath + TEXT(".kinp"));
+}
+
+void UInputReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UInputReplaySubsystem::OnPreActorTick);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UInputReplaySubsystem::OnPostActorTick);
+}
+
+void UInputReplaySubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    // World torn down mid-replay, e.g. a map change. Keep what ran and give the engine its clock back.
+    if (bReplaying)
+    {
+        FinishReplay();
+    }
+
+    Super::Deinitialize();
+}
+
+AParkourCharacter* UInputReplaySubsystem::GetLocalCharacter() const
+{
+    const APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    return PC ? Cast<AParkourCharacter>(PC->GetPawn()) : nullptr;
+}
+
+bool UInputReplaySubsystem::StartRecording()
+{
+    if (bReplaying || bRecording || bRecordPending)
+    {
+        return false;
+    }
+
+    Recording = FInputRecording();
+    bRecordPending = true;
+    return true;
+}
+
+FString UInputReplaySubsystem::StopRecording(const FString& Name)
+{
+    const bool bWasRecording = bRecording;
+    bRecordPending = false;
+    bRecording = false;
+    if (!bWasRecording)
+    {
+        return FString();
+    }
+
+    const FString Path = FInputRecording::ResolvePath(Name.IsEmpty()
+        ? FString::Printf(TEXT("%s-%s"), *Recording.MapName, *FDateTime::Now().ToString())
+        : Name);
+    if (!Recording.SaveToFile(Path))
+    {
+        UE_LOG(LogInputReplay, Error, TEXT("Couldn't write input recording to %s"), *Path);
+        return FString();
+    }
+
+    UE_LOG(LogInputReplay, Log, TEXT("Recorded %d frames, %d input events to %s"), Recording.FrameDeltas.Num(), Recording.Events.Num(), *Path);
+    Recording = FInputRecording();
+    return Path;
+}
+
+bool UInputReplaySubsystem::StartReplay(FInputRecording&& InRecording, const FString& CsvPath, float FixedDelta, bool bExitWhenDone)
+{
+    if (bReplaying || bRecording || bRecordPending || InRecording.FrameDeltas.Num() == 0)
+    {
+        return false;
+    }
+
+    const FString WorldMap = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+    if (InRecording.MapName != WorldMap)
+    {
+        UE_LOG(LogInputReplay, Warning, TEXT("Replaying a recording from %s in %s, it will likely diverge"), *InRecording.MapName, *WorldMap);
+    }
+
+    Recording = MoveTemp(InRecording);
+    ReplayCsvPath = CsvPath;
+    ReplayFixedDelta = FixedDelta;
+    bExitAfterReplay = bExitWhenDone;
+    ReplayFrame = 0;
+    NextReplayEvent = 0;
+    PendingRow = FReplayRow();
+
+    ReplayCsv.Reset(Recording.FrameDeltas.Num() + 1);
+    ReplayCsv.Add(TEXT("Frame,DeltaMs,FrameMs,WorldTickMs,Events,X,Y,Z,Speed,Mode"));
+
+    // The frame this is called from already has its delta, so the first replayed frame is the one after next
+    bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+    SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+    FApp::SetUseFixedTimeStep(true);
+    FApp::SetFixedDeltaTime(GetReplayDelta(0));
+    ReplayWarmupFrames = 1;
+
+    bReplaying = true;
+    UE_LOG(LogInputReplay, Log, TEXT("Replaying %d frames, %d input events"), Recording.FrameDeltas.Num(), Recording.Events.Num());
+    return true;
+}
+
+float UInputReplaySubsystem::GetReplayDelta(int32 Frame) const
+{
+    if (ReplayFixedDelta > 0.f)
+    {
+        return ReplayFixedDelta;
+    }
+    return Recording.FrameDeltas[FMath::Clamp(Frame, 0, Recording.FrameDeltas.Num() - 1)];
+}
+
+void UInputReplaySubsystem::OnPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World != GetWorld())
+    {
+        return;
+    }
+
+    if (bRecordPending)
+    {
+        if (const AParkourCharacter* Character = GetLocalCharacter())
+        {
+            Recording.MapName = UWorld::RemovePIEPrefix(World->GetMapName());
+            Recording.StartLocation = Character->GetActorLocation();
+            Recording.StartRotation = Character->GetActorRotation();
+            Recording.StartControlRotation = Character->GetControlRotation();
+            Recording.StartVelocity = Character->GetCharacterMovement()->Velocity;
+            Recording.StartMovementMode = Character->GetCharacterMovement()->MovementMode;
+            bRecordPending = false;
+            bRecording = true;
+            UE_LOG(LogInputReplay, Log, TEXT("Recording input"));
+        }
+    }
+
+    // Events from this frame's handlers land against the delta added here
+    if (bRecording)
+    {
+        Recording.FrameDeltas.Add(DeltaSeconds);
+        return;
+    }
+
+    if (!bReplaying)
+    {
+        return;
+    }
+
+    const uint64 NowCycles = FPlatformTime::Cycles64();
+    FlushRow(NowCycles);
+
+    if (ReplayWarmupFrames > 0)
+    {
+        --ReplayWarmupFrames;
+        return;
+    }
+
+    AParkourCharacter* Character = GetLocalCharacter();
+    if (!Character)
+    {
+        // Still spawning; the time step stays on frame 0's until it's there
+        return;
+    }
+
+    // Inputs go in before the controller ticks, where its own input processing would add them
+    if (ReplayFrame == 0)
+    {
+        Character->TeleportTo(Recording.StartLocation, Recording.StartRotation, false, true);
+        Character->GetController()->SetControlRotation(Recording.StartControlRotation);
+        Character->GetCharacterMovement()->Velocity = Recording.StartVelocity;
+        Character->GetCharacterMovement()->SetMovementMode((EMovementMode)Recording.StartMovementMode);
+    }
+
+    int32 NumEvents = 0;
+    while (Recording.Events.IsValidIndex(NextReplayEvent) && Recording.Events[NextReplayEvent].Frame == (uint32)ReplayFrame)
+    {
+        const FInputRecording::FEvent& Event = Recording.Events[NextReplayEvent++];
+        Character->ApplyReplayInput(Event.Input, FVector2D(Event.Value));
+        ++NumEvents;
+    }
+
+    FrameStartCycles = NowCycles;
+    PendingRow.Frame = ReplayFrame;
+    PendingRow.DeltaSeconds = DeltaSeconds;
+    PendingRow.NumEvents = NumEvents;
+}
+
+void UInputReplaySubsystem::OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World != GetWorld() || !bReplaying || PendingRow.Frame != ReplayFrame)
+    {
+        return;
+    }
+
+    PendingRow.WorldTickMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FrameStartCycles);
+    if (const AParkourCharacter* Character = GetLocalCharacter())
+    {
+        const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+        PendingRow.Location = Character->GetActorLocation();
+        PendingRow.Speed = Movement->Velocity.Size();
+        PendingRow.MovementMode = Movement->MovementMode;
+        PendingRow.CustomMode = Movement->CustomMovementMode;
+    }
+
+    ++ReplayFrame;
+    if (ReplayFrame >= Recording.FrameDeltas.Num())
+    {
+        FinishReplay();
+        return;
+    }
+    FApp::SetFixedDeltaTime(GetReplayDelta(ReplayFrame));
+}
+
+void UInputReplaySubsystem::FlushRow(uint64 NowCycles)
+{
+    if (PendingRow.Frame == INDEX_NONE)
+    {
+        return;
+    }
+
+    // Start of this frame to start of the next: the world tick plus rendering, slate and the rest of the loop
+    const double FrameMs = FrameStartCycles ? FPlatformTime::ToMilliseconds64(NowCycles - FrameStartCycles) : 0.0;
+    ReplayCsv.Add(FString::Printf(TEXT("%d,%.3f,%.3f,%.3f,%d,%.2f,%.2f,%.2f,%.1f,%d"),
+        PendingRow.Frame, PendingRow.DeltaSeconds * 1000.f, FrameMs, PendingRow.WorldTickMs, PendingRow.NumEvents,
+        PendingRow.Location.X, PendingRow.Location.Y, PendingRow.Location.Z, PendingRow.Speed,
+        PendingRow.MovementMode == MOVE_Custom ? 100 + PendingRow.CustomMode : PendingRow.MovementMode));
+    PendingRow = FReplayRow();
+}
+
+void UInputReplaySubsystem::FinishReplay()
+{
+    // The last frame's loop cost isn't known yet, close it at the world tick
+    FlushRow(FrameStartCycles ? FPlatformTime::Cycles64() : 0);
+    FrameStartCycles = 0;
+
+    bReplaying = false;
+    FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+    FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+
+    if (FFileHelper::SaveStringArrayToFile(ReplayCsv, *ReplayCsvPath))
+    {
+        UE_LOG(LogInputReplay, Log, TEXT("Replay done, %d frames, report written to %s"), ReplayCsv.Num() - 1, *ReplayCsvPath);
+    }
+    else
+    {
+        UE_LOG(LogInputReplay, Error, TEXT("Couldn't write replay report to %s"), *ReplayCsvPath);
+    }
+    ReplayCsv.Empty();
+    Recording = FInputRecording();
+
+    if (bExitAfterReplay)
+    {
+        FPlatformMisc::RequestExit(false, TEXT("InputReplay"));
+    }
+}
+
+namespace InputReplay
+{
+    static FAutoConsoleCommandWithWorldAndArgs RecordCommand(
+        TEXT("Parkour.Input.Record"),
+        TEXT("Records the local character's input. Args: start | stop [Name], unnamed recordings go to Saved/InputRecordings/<Map>-<Time>.kinp"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                UInputReplaySubsystem* Replay = World ? World->GetSubsystem<UInputReplaySubsystem>() : nullptr;
+                if (!Replay || Args.Num() == 0)
+                {
+                    return;
+                }
+
+                if (Args[0] == TEXT("start"))
+                {
+                    if (!Replay->StartRecording())
+                    {
+                        UE_LOG(LogInputReplay, Warning, TEXT("Already recording or replaying"));
+                    }
+                }
+                else if (Args[0] == TEXT("stop"))
+                {
+                    Replay->StopRecording(Args.Num() > 1 ? Args[1] : FString());
+                }
+            }));
+
+    static FAutoConsoleCommandWithWorldAndArgs ReplayCommand(
+        TEXT("Parkour.Input.Replay"),
+        TEXT("Replays a recording into the local character and writes per-frame cost to <Recording>.csv. Args: <NameOrPath> [FixedDelta=0, 0 uses the recorded deltas] [exit]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                UInputReplaySubsystem* Replay = World ? World->GetSubsystem<UInputReplaySubsystem>() : nullptr;
+                if (!Replay || Args.Num() == 0)
+                {
+                    return;
+                }
+
+                const FString Path = FInputRecording::ResolvePath(Args[0]);
+                FInputRecording Loaded;
+                if (!Loaded.LoadFromFile(Path))
+                {
+                    UE_LOG(LogInputReplay, Error, TEXT("Couldn't load input recording %s"), *Path);
+                    return;
+                }
+
+                const float FixedDelta = Args.Num() > 1 ? FMath::Max(0.f, FCString::Atof(*Args[1])) : 0.f;
+                const bool bExit = Args.Num() > 2 && Args[2] == TEXT("exit");
+                if (!Replay->StartReplay(MoveTemp(Loaded), FPaths::ChangeExtension(Path, TEXT("csv")), FixedDelta, bExit))
+                {
+                    UE_LOG(LogInputReplay, Warning, TEXT("Can't replay %s while recording or replaying"), *Path);
+                }
+            }));
+}
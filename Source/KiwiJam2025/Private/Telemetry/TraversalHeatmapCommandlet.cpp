@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/TraversalHeatmapCommandlet.h"
+#include "Telemetry/TraversalTelemetry.h"
+#include "HAL/FileManager.h"
+#include "ImageCore.h"
+#include "ImageUtils.h"
+#include "Misc/Paths.h"
+#include "Async/ParallelFor.h"
+
+namespace TraversalHeatmap
+{
+    // Black -> red -> yellow -> white
+    static FColor Ramp(float T)
+    {
+        T = FMath::Clamp(T, 0.f, 1.f);
+        const uint8 R = (uint8)(255.f * FMath::Clamp(T * 3.f, 0.f, 1.f));
+        const uint8 G = (uint8)(255.f * FMath::Clamp(T * 3.f - 1.f, 0.f, 1.f));
+        const uint8 B = (uint8)(255.f * FMath::Clamp(T * 3.f - 2.f, 0.f, 1.f));
+        return FColor(R, G, B, 255);
+    }
+
+    // Type INDEX_NONE sums every event type
+    static uint32 CellCount(const FTraversalHeatmapData::FCell& Cell, int32 Type)
+    {
+        if (Type != INDEX_NONE)
+        {
+            return Cell.Counts[Type];
+        }
+
+        uint32 Total = 0;
+        for (uint32 Count : Cell.Counts) Total += Count;
+        return Total;
+    }
+
+    static bool Rasterize(const FTraversalHeatmapData& Data, int32 Type, int32 PixelsPerCell, const FString& OutPath)
+    {
+        FIntPoint Min(MAX_int32, MAX_int32);
+        FIntPoint Max(MIN_int32, MIN_int32);
+        uint32 MaxCount = 0;
+
+        for (const TPair<FIntPoint, FTraversalHeatmapData::FCell>& Pair : Data.Cells)
+        {
+            const uint32 Total = CellCount(Pair.Value, Type);
+            if (Total == 0) continue;
+
+            Min = Min.ComponentMin(Pair.Key);
+            Max = Max.ComponentMax(Pair.Key);
+            MaxCount = FMath::Max(MaxCount, Total);
+        }
+
+        if (MaxCount == 0)
+        {
+            return false;
+        }
+
+        // One cell per PixelsPerCell square, +X up the image like the world map
+        const int32 CellsX = Max.X - Min.X + 1;
+        const int32 CellsY = Max.Y - Min.Y + 1;
+        const int32 Width = CellsY * PixelsPerCell;
+        const int32 Height = CellsX * PixelsPerCell;
+
+        // Dense count grid first, so the pixel pass is a flat parallel loop
+        TArray<uint32> Grid;
+        Grid.SetNumZeroed(CellsX * CellsY);
+        for (const TPair<FIntPoint, FTraversalHeatmapData::FCell>& Pair : Data.Cells)
+        {
+            if (const uint32 Total = CellCount(Pair.Value, Type))
+            {
+                Grid[(Pair.Key.X - Min.X) * CellsY + (Pair.Key.Y - Min.Y)] = Total;
+            }
+        }
+
+        // Log scale so a few hot corners don't wash everything else out
+        const float InvLogMax = 1.f / FMath::Loge(1.f + MaxCount);
+
+        FImage Image(Width, Height, ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+        TArrayView64<FColor> Pixels = Image.AsBGRA8();
+
+        ParallelFor(Height, [&](int32 Row)
+            {
+                const int32 CellX = CellsX - 1 - Row / PixelsPerCell;
+                for (int32 Column = 0; Column < Width; ++Column)
+                {
+                    const uint32 Count = Grid[CellX * CellsY + Column / PixelsPerCell];
+                    Pixels[(int64)Row * Width + Column] = Count > 0 ? Ramp(FMath::Loge(1.f + Count) * InvLogMax) : FColor::Black;
+                }
+            });
+
+        return FImageUtils::SaveImageByExtension(*OutPath, Image);
+    }
+}
+
+UTraversalHeatmapCommandlet::UTraversalHeatmapCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UTraversalHeatmapCommandlet::Main(const FString& Params)
+{
+    FString InPath = FPaths::ProjectSavedDir() / TEXT("Telemetry");
+    FString OutDir = FPaths::ProjectSavedDir() / TEXT("Telemetry/Heatmaps");
+    int32 PixelsPerCell = 4;
+
+    FParse::Value(*Params, TEXT("In="), InPath);
+    FParse::Value(*Params, TEXT("Out="), OutDir);
+    FParse::Value(*Params, TEXT("PixelsPerCell="), PixelsPerCell);
+    PixelsPerCell = FMath::Clamp(PixelsPerCell, 1, 64);
+
+    TArray<FString> Files;
+    if (IFileManager::Get().DirectoryExists(*InPath))
+    {
+        IFileManager::Get().FindFiles(Files, *(InPath / TEXT("*.ktrt")), true, false);
+        for (FString& File : Files)
+        {
+            File = InPath / File;
+        }
+    }
+    else
+    {
+        Files.Add(InPath);
+    }
+
+    // Merge runs of the same map, keyed by map and cell size since cells only add up at equal size
+    TMap<FString, FTraversalHeatmapData> ByMap;
+    for (const FString& File : Files)
+    {
+        FTraversalHeatmapData Data;
+        if (!Data.LoadFromFile(File))
+        {
+            UE_LOG(LogTraversalTelemetry, Warning, TEXT("Skipping %s, not a telemetry file or wrong version"), *File);
+            continue;
+        }
+
+        const FString Key = FString::Printf(TEXT("%s_%dcm"), *Data.MapName, FMath::RoundToInt(Data.CellSize));
+        FTraversalHeatmapData* Merged = ByMap.Find(Key);
+        if (Merged)
+        {
+            Merged->Merge(Data);
+        }
+        else
+        {
+            ByMap.Add(Key, MoveTemp(Data));
+        }
+    }
+
+    if (ByMap.Num() == 0)
+    {
+        UE_LOG(LogTraversalTelemetry, Error, TEXT("No telemetry found at %s"), *InPath);
+        return 1;
+    }
+
+    int32 Written = 0;
+    for (const TPair<FString, FTraversalHeatmapData>& Pair : ByMap)
+    {
+        const FTraversalHeatmapData& Data = Pair.Value;
+
+        // INDEX_NONE is every event type combined
+        for (int32 Type = INDEX_NONE; Type < FTraversalHeatmapData::NumTypes; ++Type)
+        {
+            const TCHAR* TypeName = Type == INDEX_NONE ? TEXT("All") : LexToString((ETraversalTelemetryEvent)Type);
+            const FString OutPath = OutDir / FString::Printf(TEXT("%s_%s.png"), *Pair.Key, TypeName);
+
+            if (TraversalHeatmap::Rasterize(Data, Type, PixelsPerCell, OutPath))
+            {
+                ++Written;
+            }
+        }
+
+        UE_LOG(LogTraversalTelemetry, Display, TEXT("%s: %d cells, %u dropped events"), *Pair.Key, Data.Cells.Num(), Data.DroppedEvents);
+    }
+
+    UE_LOG(LogTraversalTelemetry, Display, TEXT("Wrote %d heatmaps to %s"), Written, *OutDir);
+    return 0;
+}
@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/TraversalTelemetry.h"
+#include "Engine/World.h"
+#include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY(LogTraversalTelemetry);
+
+static TAutoConsoleVariable<bool> CVarTraversalTelemetryEnabled(
+    TEXT("Parkour.Telemetry.Enabled"), !UE_BUILD_SHIPPING,
+    TEXT("Record traversal probe outcomes into per-level heatmap files (read when a world starts)"));
+
+static TAutoConsoleVariable<float> CVarTraversalTelemetryCellSize(
+    TEXT("Parkour.Telemetry.CellSize"), 200.f,
+    TEXT("Heatmap cell size in uu (read when a world starts)"));
+
+// Power of two, about 130KB. At a few probes per player per frame the worker keeps it near empty.
+static constexpr uint32 TelemetryQueueCapacity = 8192;
+
+const TCHAR* LexToString(ETraversalTelemetryEvent Event)
+{
+    switch (Event)
+    {
+    case ETraversalTelemetryEvent::ProbeSuccess: return TEXT("ProbeSuccess");
+    case ETraversalTelemetryEvent::ProbeHeadBlocked: return TEXT("ProbeHeadBlocked");
+    case ETraversalTelemetryEvent::ProbeHeightOutOfRange: return TEXT("ProbeHeightOutOfRange");
+    case ETraversalTelemetryEvent::ProbeLandingBlocked: return TEXT("ProbeLandingBlocked");
+    case ETraversalTelemetryEvent::TraversalStart: return TEXT("TraversalStart");
+    case ETraversalTelemetryEvent::TraversalEnd: return TEXT("TraversalEnd");
+    default: return TEXT("Unknown");
+    }
+}
+
+void FTraversalHeatmapData::Add(const FTraversalTelemetryEvent& Event)
+{
+    const FIntPoint Key(FMath::FloorToInt32(Event.Location.X / CellSize), FMath::FloorToInt32(Event.Location.Y / CellSize));
+    ++Cells.FindOrAdd(Key).Counts[(int32)Event.Type];
+}
+
+void FTraversalHeatmapData::Merge(const FTraversalHeatmapData& Other)
+{
+    DroppedEvents += Other.DroppedEvents;
+    for (const TPair<FIntPoint, FCell>& Pair : Other.Cells)
+    {
+        FCell& Cell = Cells.FindOrAdd(Pair.Key);
+        for (int32 Type = 0; Type < NumTypes; ++Type)
+        {
+            Cell.Counts[Type] += Pair.Value.Counts[Type];
+        }
+    }
+}
+
+bool FTraversalHeatmapData::Serialize(FArchive& Ar)
+{
+    uint32 FileMagic = Magic;
+    uint16 FileVersion = Version;
+    uint16 FileNumTypes = NumTypes;
+    Ar << FileMagic << FileVersion << FileNumTypes;
+
+    if (FileMagic != Magic || FileVersion != Version || FileNumTypes != NumTypes)
+    {
+        return false;
+    }
+
+    Ar << MapName << CellSize << DroppedEvents;
+
+    int32 NumCells = Cells.Num();
+    Ar << NumCells;
+
+    if (Ar.IsLoading())
+    {
+        Cells.Reset();
+        Cells.Reserve(NumCells);
+        for (int32 i = 0; i < NumCells && !Ar.IsError(); ++i)
+        {
+            FIntPoint Key;
+            Ar << Key.X << Key.Y;
+
+            FCell& Cell = Cells.Add(Key);
+            for (int32 Type = 0; Type < NumTypes; ++Type)
+            {
+                Ar.SerializeIntPacked(Cell.Counts[Type]);
+            }
+        }
+    }
+    else
+    {
+        for (TPair<FIntPoint, FCell>& Pair : Cells)
+        {
+            Ar << Pair.Key.X << Pair.Key.Y;
+            // Most cells only see one or two event types, packed zeros are a byte each
+            for (int32 Type = 0; Type < NumTypes; ++Type)
+            {
+                Ar.SerializeIntPacked(Pair.Value.Counts[Type]);
+            }
+        }
+    }
+
+    return !Ar.IsError();
+}
+
+bool FTraversalHeatmapData::SaveToFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    if (!Serialize(Writer))
+    {
+        return false;
+    }
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FTraversalHeatmapData::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    return Serialize(Reader);
+}
+
+/** Drains the ring into the histogram and writes it out when stopped */
+class FTraversalTelemetryWorker : public FRunnable
+{
+public:
+    FTraversalTelemetryWorker(UTraversalTelemetrySubsystem& InOwner, const FString& InMapName, float InCellSize)
+        : Owner(InOwner)
+    {
+        Data.MapName = InMapName;
+        Data.CellSize = InCellSize;
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+    }
+
+    virtual ~FTraversalTelemetryWorker() override
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    }
+
+    virtual uint32 Run() override
+    {
+        while (!bStopping.load(std::memory_order_acquire))
+        {
+            // Nothing on the game thread signals us, polling keeps Record to a single push
+            WakeEvent->Wait(50);
+            Drain();
+        }
+
+        Drain();
+        Write();
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        bStopping.store(true, std::memory_order_release);
+        WakeEvent->Trigger();
+    }
+
+private:
+    void Drain()
+    {
+        FTraversalTelemetryEvent Event;
+        while (Owner.Queue->Dequeue(Event))
+        {
+            Data.Add(Event);
+        }
+    }
+
+    void Write()
+    {
+        Data.DroppedEvents = Owner.DroppedEvents.load(std::memory_order_relaxed);
+        if (Data.Cells.Num() == 0)
+        {
+            return;
+        }
+
+        const FString Path = FPaths::ProjectSavedDir() / TEXT("Telemetry")
+            / FString::Printf(TEXT("%s-%s.ktrt"), *Data.MapName, *FDateTime::Now().ToString());
+
+        if (Data.SaveToFile(Path))
+        {
+            UE_LOG(LogTraversalTelemetry, Log, TEXT("Wrote %d cells (%u dropped events) to %s"), Data.Cells.Num(), Data.DroppedEvents, *Path);
+        }
+        else
+        {
+            UE_LOG(LogTraversalTelemetry, Warning, TEXT("Failed to write %s"), *Path);
+        }
+    }
+
+    UTraversalTelemetrySubsystem& Owner;
+    FTraversalHeatmapData Data;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bStopping { false };
+};
+
+UTraversalTelemetrySubsystem::~UTraversalTelemetrySubsystem() = default;
+
+bool UTraversalTelemetrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && CVarTraversalTelemetryEnabled.GetValueOnGameThread() && FPlatformProcess::SupportsMultithreading();
+}
+
+void UTraversalTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    Queue = MakeUnique<TCircularQueue<FTraversalTelemetryEvent>>(TelemetryQueueCapacity);
+
+    const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+    Worker = MakeUnique<FTraversalTelemetryWorker>(*this, MapName, FMath::Max(1.f, CVarTraversalTelemetryCellSize.GetValueOnGameThread()));
+    WorkerThread.Reset(FRunnableThread::Create(Worker.Get(), TEXT("TraversalTelemetry"), 0, TPri_BelowNormal));
+}
+
+void UTraversalTelemetrySubsystem::Deinitialize()
+{
+    // Kill stops the worker and waits, it drains and writes on the way out
+    if (WorkerThread)
+    {
+        WorkerThread->Kill(true);
+        WorkerThread.Reset();
+    }
+    Worker.Reset();
+    Queue.Reset();
+
+    Super::Deinitialize();
+}
+
+void UTraversalTelemetrySubsystem::Record(const UWorld* World, ETraversalTelemetryEvent Type, const FVector& Location)
+{
+    if (UTraversalTelemetrySubsystem* Telemetry = World ? World->GetSubsystem<UTraversalTelemetrySubsystem>() : nullptr)
+    {
+        Telemetry->Record(Type, Location);
+    }
+}
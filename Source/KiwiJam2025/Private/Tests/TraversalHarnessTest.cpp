@@ -0,0 +1,434 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Frame-rate scaling regression test for climb and vault.
+// Run headless with: -nullrhi -ExecCmds="Automation RunTests KiwiJam.Traversal.FrameRateScaling; Quit"
+// Add -UpdateTraversalGoldens to rewrite the goldens in Tests/TraversalHarness, then commit them.
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Character/ParkourCharacter.h"
+#include "Character/ParkourMovementComponent.h"
+#include "Character/ClimbableDetectorComponent.h"
+#include "World/TraversalProxyComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace TraversalHarness
+{
+    static TAutoConsoleVariable<float> CVarPositionTolerance(
+        TEXT("Parkour.TraversalHarness.PositionTolerance"), 5.f,
+        TEXT("Max distance (uu) a sampled trajectory may drift from its golden"));
+
+    static TAutoConsoleVariable<float> CVarVelocityTolerance(
+        TEXT("Parkour.TraversalHarness.VelocityTolerance"), 10.f,
+        TEXT("Max difference (uu/s) of the final post-vault velocity from its golden"));
+
+    static TAutoConsoleVariable<float> CVarEndTolerance(
+        TEXT("Parkour.TraversalHarness.EndTolerance"), 10.f,
+        TEXT("Max distance (uu) a move may finish from where the 360Hz run of it finishes"));
+
+    // Blueprint pawn carries the configured curves and tuning, the native class is the fallback
+    static const TCHAR* PawnClassPath = TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter.BP_FirstPersonCharacter_C");
+
+    // Far from any level geometry
+    static const FVector TestOrigin(0.f, 0.f, 50000.f);
+    static const float MaxSimSeconds = 5.f;
+
+    struct FSample
+    {
+        float Time = 0.f;
+        FVector Location = FVector::ZeroVector;
+    };
+
+    struct FCase
+    {
+        FString Name;
+        bool bVault = false;
+        float Rate = 60.f;
+
+        // Step that gets a long frame instead of 1/Rate, INDEX_NONE for none
+        int32 HitchStep = INDEX_NONE;
+        float HitchSeconds = 0.f;
+    };
+
+    struct FResult
+    {
+        FCase Case;
+        bool bStarted = false;
+        TArray<FSample> Samples;
+        FVector FinalVelocity = FVector::ZeroVector;
+        int32 Steps = 0;
+        double TotalMs = 0.0;
+
+        // Filled by comparison
+        float MaxDriftVsGolden = 0.f;
+        float DriftTimeVsGolden = 0.f;
+        float MaxDriftVsReference = 0.f;
+        float DriftTimeVsReference = 0.f;
+        float VelocityError = 0.f;
+        float EndErrorVsReference = 0.f;
+        bool bHasGolden = false;
+    };
+
+    static TArray<FCase> BuildCases()
+    {
+        static const float Rates[] = { 30.f, 60.f, 120.f, 144.f, 240.f, 360.f };
+
+        TArray<FCase> Cases;
+        for (int32 Type = 0; Type < 2; ++Type)
+        {
+            const bool bVault = Type == 0;
+            const TCHAR* TypeName = bVault ? TEXT("Vault") : TEXT("Climb");
+
+            for (float Rate : Rates)
+            {
+                FCase& Case = Cases.AddDefaulted_GetRef();
+                Case.Name = FString::Printf(TEXT("%s_%dHz"), TypeName, FMath::RoundToInt(Rate));
+                Case.bVault = bVault;
+                Case.Rate = Rate;
+            }
+
+            // Injected hitches at 60Hz, mid traversal
+            for (float Hitch : { 0.1f, 0.25f })
+            {
+                FCase& Case = Cases.AddDefaulted_GetRef();
+                Case.Name = FString::Printf(TEXT("%s_60Hz_Hitch%dms"), TypeName, FMath::RoundToInt(Hitch * 1000.f));
+                Case.bVault = bVault;
+                Case.Rate = 60.f;
+                Case.HitchStep = 10;
+                Case.HitchSeconds = Hitch;
+            }
+        }
+        return Cases;
+    }
+
+    static AStaticMeshActor* SpawnBox(UWorld* World, UStaticMesh* Cube, const FVector& Center, const FVector& Size)
+    {
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        AStaticMeshActor* Box = World->SpawnActor<AStaticMeshActor>(Center, FRotator::ZeroRotator, Params);
+        Box->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+        Box->GetStaticMeshComponent()->SetStaticMesh(Cube);
+        // Engine cube is 100uu
+        Box->SetActorScale3D(Size / 100.f);
+
+        // The harness detector queries proxies only, so give the cube a matching one
+        UTraversalProxyComponent* Proxy = NewObject<UTraversalProxyComponent>(Box);
+        Proxy->SetupAttachment(Box->GetRootComponent());
+        Proxy->SetMobility(EComponentMobility::Movable);
+        Proxy->SetLedgeCapable(true);
+        Proxy->SetBoxes({ FKBoxElem(100.f) });
+        Proxy->RegisterComponent();
+        return Box;
+    }
+
+    static FVector SampleAt(const TArray<FSample>& Samples, float Time)
+    {
+        if (Samples.Num() == 0) return FVector::ZeroVector;
+        if (Time <= Samples[0].Time) return Samples[0].Location;
+
+        for (int32 i = 1; i < Samples.Num(); ++i)
+        {
+            if (Samples[i].Time >= Time)
+            {
+                const FSample& A = Samples[i - 1];
+                const FSample& B = Samples[i];
+                const float Span = B.Time - A.Time;
+                const float Alpha = Span > UE_KINDA_SMALL_NUMBER ? (Time - A.Time) / Span : 1.f;
+                return FMath::Lerp(A.Location, B.Location, Alpha);
+            }
+        }
+        return Samples.Last().Location;
+    }
+
+    // Largest distance from Reference over the run's samples, and when it happened
+    static void MeasureDrift(const TArray<FSample>& Run, const TArray<FSample>& Reference, float& OutMaxDrift, float& OutDriftTime)
+    {
+        OutMaxDrift = 0.f;
+        OutDriftTime = 0.f;
+        for (const FSample& Sample : Run)
+        {
+            const float Drift = FVector::Dist(Sample.Location, SampleAt(Reference, Sample.Time));
+            if (Drift > OutMaxDrift)
+            {
+                OutMaxDrift = Drift;
+                OutDriftTime = Sample.Time;
+            }
+        }
+    }
+
+    static FString GoldenPath(const FCase& Case)
+    {
+        // Checked in next to the project, not generated on first run
+        return FPaths::ProjectDir() / TEXT("Tests/TraversalHarness") / (Case.Name + TEXT(".csv"));
+    }
+
+    static void SaveGolden(const FResult& Result)
+    {
+        TArray<FString> Lines;
+        Lines.Reserve(Result.Samples.Num() + 2);
+        Lines.Add(TEXT("Time,X,Y,Z"));
+        for (const FSample& Sample : Result.Samples)
+        {
+            Lines.Add(FString::Printf(TEXT("%.6f,%.4f,%.4f,%.4f"), Sample.Time, Sample.Location.X, Sample.Location.Y, Sample.Location.Z));
+        }
+        Lines.Add(FString::Printf(TEXT("Velocity,%.4f,%.4f,%.4f"), Result.FinalVelocity.X, Result.FinalVelocity.Y, Result.FinalVelocity.Z));
+
+        FFileHelper::SaveStringArrayToFile(Lines, *GoldenPath(Result.Case));
+    }
+
+    static bool LoadGolden(const FCase& Case, TArray<FSample>& OutSamples, FVector& OutVelocity)
+    {
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *GoldenPath(Case)))
+            return false;
+
+        for (int32 i = 1; i < Lines.Num(); ++i)
+        {
+            TArray<FString> Cells;
+            Lines[i].ParseIntoArray(Cells, TEXT(","));
+            if (Cells.Num() != 4) continue;
+
+            const FVector Value(FCString::Atof(*Cells[1]), FCString::Atof(*Cells[2]), FCString::Atof(*Cells[3]));
+            if (Cells[0] == TEXT("Velocity"))
+            {
+                OutVelocity = Value;
+            }
+            else
+            {
+                OutSamples.Add({ FCString::Atof(*Cells[0]), Value });
+            }
+        }
+        return OutSamples.Num() > 0;
+    }
+
+    // Samples are recorded relative to LaneOrigin so goldens don't depend on where the lane is
+    static FResult RunCase(AParkourCharacter* Character, const FCase& Case, const FVector& LaneOrigin)
+    {
+        FResult Result;
+        Result.Case = Case;
+
+        UParkourMovementComponent* MoveComp = Cast<UParkourMovementComponent>(Character->GetCharacterMovement());
+        UClimbableDetectorComponent* Detector = Character->FindComponentByClass<UClimbableDetectorComponent>();
+        if (!MoveComp || !Detector) return Result;
+
+        // Exercise the proxy path; without a TraversalProxy profile it falls back to Visibility and hits the cube
+        Detector->SetUseTraversalChannel(true);
+
+        // Same start every run, facing +X and running at the obstacle
+        MoveComp->SetMovementMode(MOVE_Walking);
+        Character->SetActorLocationAndRotation(LaneOrigin, FRotator::ZeroRotator, false, nullptr, ETeleportType::ResetPhysics);
+        MoveComp->Velocity = FVector(400.f, 0.f, 0.f);
+
+        FClimbableSurfaceResult Surface;
+        if (Case.bVault)
+        {
+            Result.bStarted = Detector->CheckVaultSurface(Surface);
+            if (Result.bStarted) MoveComp->BeginVault(Surface);
+        }
+        else
+        {
+            Result.bStarted = Detector->DetectClimbableSurface(Surface);
+            if (Result.bStarted) MoveComp->BeginClimb(Surface);
+        }
+
+        if (!Result.bStarted || !MoveComp->IsTraversing())
+        {
+            Result.bStarted = false;
+            return Result;
+        }
+
+        float SimTime = 0.f;
+        Result.Samples.Add({ 0.f, Character->GetActorLocation() - LaneOrigin });
+
+        while (MoveComp->IsTraversing() && SimTime < MaxSimSeconds)
+        {
+            const float DeltaTime = (Result.Steps == Case.HitchStep) ? Case.HitchSeconds : 1.f / Case.Rate;
+
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            MoveComp->StartNewPhysics(DeltaTime, 0);
+            Result.TotalMs += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+            SimTime += DeltaTime;
+            ++Result.Steps;
+            Result.Samples.Add({ SimTime, Character->GetActorLocation() - LaneOrigin });
+        }
+
+        Result.FinalVelocity = Case.bVault ? MoveComp->GetPendingPostVaultVelocity() : MoveComp->Velocity;
+        return Result;
+    }
+
+    static void WriteReport(const TArray<FResult>& Results)
+    {
+        TArray<FString> Lines;
+        Lines.Add(TEXT("Case,Rate,HitchMs,Started,Steps,TotalUs,UsPerStep,FinalVelX,FinalVelY,FinalVelZ,DriftVsGolden,DriftTimeVsGolden,DriftVs360Hz,DriftTimeVs360Hz,EndErrorVs360Hz,VelocityError"));
+
+        for (const FResult& Result : Results)
+        {
+            const double TotalUs = Result.TotalMs * 1000.0;
+            Lines.Add(FString::Printf(TEXT("%s,%.0f,%.0f,%d,%d,%.2f,%.3f,%.2f,%.2f,%.2f,%.3f,%.4f,%.3f,%.4f,%.3f,%.3f"),
+                *Result.Case.Name, Result.Case.Rate, Result.Case.HitchSeconds * 1000.f, Result.bStarted ? 1 : 0, Result.Steps,
+                TotalUs, Result.Steps > 0 ? TotalUs / Result.Steps : 0.0,
+                Result.FinalVelocity.X, Result.FinalVelocity.Y, Result.FinalVelocity.Z,
+                Result.MaxDriftVsGolden, Result.DriftTimeVsGolden, Result.MaxDriftVsReference, Result.DriftTimeVsReference,
+                Result.EndErrorVsReference, Result.VelocityError));
+
+            UE_LOG(LogParkourCharacter, Log, TEXT("[TraversalHarness] %-24s steps %3d  cost %8.2f us  drift golden %6.2f @%.3fs  drift 360Hz %6.2f @%.3fs"),
+                *Result.Case.Name, Result.Steps, TotalUs, Result.MaxDriftVsGolden, Result.DriftTimeVsGolden,
+                Result.MaxDriftVsReference, Result.DriftTimeVsReference);
+        }
+
+        const FString ReportPath = FPaths::ProjectSavedDir() / TEXT("TraversalHarness/Report.csv");
+        FFileHelper::SaveStringArrayToFile(Lines, *ReportPath);
+        UE_LOG(LogParkourCharacter, Log, TEXT("[TraversalHarness] Report written to %s"), *ReportPath);
+    }
+
+    // Spawns the pawn and obstacles, runs every case and diffs them. Physics needs one world tick to see the obstacles.
+    static TArray<FResult> Run(UWorld* World, bool bUpdateGolden, FAutomationTestBase& Test)
+    {
+        TArray<FResult> Results;
+
+        UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+        if (!Cube)
+        {
+            Test.AddError(TEXT("Engine cube mesh missing"));
+            return Results;
+        }
+
+        UClass* PawnClass = LoadClass<AParkourCharacter>(nullptr, PawnClassPath);
+        if (!PawnClass)
+        {
+            Test.AddWarning(FString::Printf(TEXT("%s not found, testing the native pawn without its curves"), PawnClassPath));
+            PawnClass = AParkourCharacter::StaticClass();
+        }
+
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        AParkourCharacter* Character = World->SpawnActor<AParkourCharacter>(PawnClass, TestOrigin, FRotator::ZeroRotator, Params);
+        if (!Character)
+        {
+            Test.AddError(TEXT("Couldn't spawn the parkour pawn"));
+            return Results;
+        }
+
+        if (UParkourMovementComponent* MoveComp = Cast<UParkourMovementComponent>(Character->GetCharacterMovement()))
+        {
+            MoveComp->LoadTraversalCurvesBlocking();
+        }
+
+        // Fixed obstacles, relative to the capsule centre the detector measures from.
+        // Vault: 60 deep box topping out 70 up. Climb: deep block topping out 110 up.
+        SpawnBox(World, Cube, TestOrigin + FVector(100.f, 0.f, 70.f - 80.f), FVector(60.f, 400.f, 160.f));
+
+        // Climb obstacles live in a separate lane so the vault box is never hit
+        const FVector ClimbOffset(0.f, 2000.f, 0.f);
+        SpawnBox(World, Cube, TestOrigin + ClimbOffset + FVector(300.f, 0.f, 110.f - 200.f), FVector(400.f, 400.f, 400.f));
+
+        World->Tick(LEVELTICK_All, 1.f / 60.f);
+
+        for (const FCase& Case : BuildCases())
+        {
+            // Climb and vault run in separate lanes so they never see each other's obstacle
+            const FVector LaneOrigin = Case.bVault ? TestOrigin : TestOrigin + ClimbOffset;
+            Results.Add(RunCase(Character, Case, LaneOrigin));
+        }
+
+        // Drift against the 360Hz run of the same move, and against the checked-in golden
+        for (FResult& Result : Results)
+        {
+            const FString ReferenceName = Result.Case.bVault ? TEXT("Vault_360Hz") : TEXT("Climb_360Hz");
+            const FResult* Reference = Results.FindByPredicate([&ReferenceName](const FResult& Other) { return Other.Case.Name == ReferenceName; });
+            if (Reference && Reference->Samples.Num() > 0 && Result.Samples.Num() > 0)
+            {
+                MeasureDrift(Result.Samples, Reference->Samples, Result.MaxDriftVsReference, Result.DriftTimeVsReference);
+                Result.EndErrorVsReference = FVector::Dist(Result.Samples.Last().Location, Reference->Samples.Last().Location);
+            }
+
+            if (bUpdateGolden)
+            {
+                if (Result.bStarted)
+                {
+                    SaveGolden(Result);
+                }
+                continue;
+            }
+
+            TArray<FSample> Golden;
+            FVector GoldenVelocity = FVector::ZeroVector;
+            if (LoadGolden(Result.Case, Golden, GoldenVelocity))
+            {
+                Result.bHasGolden = true;
+                MeasureDrift(Result.Samples, Golden, Result.MaxDriftVsGolden, Result.DriftTimeVsGolden);
+                Result.VelocityError = FVector::Dist(Result.FinalVelocity, GoldenVelocity);
+            }
+        }
+
+        WriteReport(Results);
+        return Results;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTraversalFrameRateScalingTest, "KiwiJam.Traversal.FrameRateScaling",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FTraversalFrameRateScalingTest::RunTest(const FString& Parameters)
+{
+    using namespace TraversalHarness;
+
+    // A throwaway game world, so nothing in the loaded level gets in the way
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("TraversalHarness"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+    World->InitializeActorsForPlay(FURL());
+    World->BeginPlay();
+
+    const bool bUpdateGolden = FParse::Param(FCommandLine::Get(), TEXT("UpdateTraversalGoldens"));
+    const TArray<FResult> Results = Run(World, bUpdateGolden, *this);
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+
+    if (bUpdateGolden)
+    {
+        AddInfo(TEXT("Goldens rewritten, commit Tests/TraversalHarness"));
+        return true;
+    }
+
+    const float PosTolerance = CVarPositionTolerance.GetValueOnGameThread();
+    const float VelTolerance = CVarVelocityTolerance.GetValueOnGameThread();
+    const float EndTolerance = CVarEndTolerance.GetValueOnGameThread();
+
+    for (const FResult& Result : Results)
+    {
+        const FString& Name = Result.Case.Name;
+        if (!TestTrue(FString::Printf(TEXT("%s starts"), *Name), Result.bStarted)) continue;
+
+        TestTrue(FString::Printf(TEXT("%s finishes within %.0fs"), *Name, MaxSimSeconds), Result.Samples.Last().Time < MaxSimSeconds);
+        TestTrue(FString::Printf(TEXT("%s ends within %.1fuu of 360Hz (%.2f)"), *Name, EndTolerance, Result.EndErrorVsReference),
+            Result.EndErrorVsReference <= EndTolerance);
+
+        if (!Result.bHasGolden)
+        {
+            // The 360Hz end check above is the hard gate until goldens are recorded for this build
+            AddWarning(FString::Printf(TEXT("%s has no golden, run with -UpdateTraversalGoldens and commit Tests/TraversalHarness"), *Name));
+            continue;
+        }
+        TestTrue(FString::Printf(TEXT("%s within %.1fuu of golden (%.2f at %.3fs)"), *Name, PosTolerance, Result.MaxDriftVsGolden, Result.DriftTimeVsGolden),
+            Result.MaxDriftVsGolden <= PosTolerance);
+        TestTrue(FString::Printf(TEXT("%s final velocity within %.1fuu/s of golden (%.2f)"), *Name, VelTolerance, Result.VelocityError),
+            Result.VelocityError <= VelTolerance);
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
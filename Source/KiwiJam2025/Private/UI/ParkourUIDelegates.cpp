@@ -0,0 +1,7 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/ParkourUIDelegates.h"
+
+FParkourUIDelegates::FOnCharacterEvent FParkourUIDelegates::OnLocalCharacterReady;
+FParkourUIDelegates::FOnCharacterEvent FParkourUIDelegates::OnToggleMap;
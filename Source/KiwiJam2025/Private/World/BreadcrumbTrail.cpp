@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/BreadcrumbTrail.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+void FBreadcrumbTrail::Reset(float InTolerance, int32 InMaxPoints)
+{
+    ActiveTolerance = FMath::Max(InTolerance, 1.f);
+    ErrorBound = ActiveTolerance;
+    MaxPoints = FMath::Max(InMaxPoints, 8);
+
+    Points.Reset(MaxPoints + 1);
+    Scratch.Reset(MaxPoints + 2);
+    bHasHead = false;
+    bConeOpen = false;
+}
+
+void FBreadcrumbTrail::AddSample(const FVector& Location, float Time)
+{
+    Push({ FVector3f(Location), Time });
+
+    if (Points.Num() > MaxPoints)
+    {
+        Coarsen();
+    }
+}
+
+void FBreadcrumbTrail::Push(const FBreadcrumbPoint& Point)
+{
+    if (Points.Num() == 0)
+    {
+        Points.Add(Point);
+        return;
+    }
+
+    const FVector2f ToPoint = FVector2f(Point.Location.X, Point.Location.Y) - FVector2f(Points.Last().Location.X, Points.Last().Location.Y);
+    const float Distance = ToPoint.Size();
+
+    // Already within tolerance of the last vertex, whichever way the segment ends up going
+    if (Distance <= ActiveTolerance) return;
+
+    const float Angle = FMath::Atan2(ToPoint.Y, ToPoint.X);
+    if (!bConeOpen)
+    {
+        bConeOpen = true;
+        ConeReference = Angle;
+        ConeMin = -UE_PI;
+        ConeMax = UE_PI;
+    }
+
+    const float Offset = FMath::UnwindRadians(Angle - ConeReference);
+    if (Offset < ConeMin || Offset > ConeMax)
+    {
+        // No line from the vertex reaches here and stays close to the samples before it: the last
+        // one that fit becomes a vertex and this sample starts the next segment from it
+        Points.Add(Head);
+        bHasHead = false;
+        bConeOpen = false;
+        Push(Point);
+        return;
+    }
+
+    const float HalfAngle = FMath::Asin(ActiveTolerance / Distance);
+    ConeMin = FMath::Max(ConeMin, Offset - HalfAngle);
+    ConeMax = FMath::Min(ConeMax, Offset + HalfAngle);
+
+    Head = Point;
+    bHasHead = true;
+}
+
+void FBreadcrumbTrail::Coarsen()
+{
+    // Vertices were within ErrorBound of the samples, the rerun keeps them within the new tolerance
+    Scratch.Reset();
+    Scratch.Append(Points);
+    if (bHasHead)
+    {
+        Scratch.Add(Head);
+    }
+
+    const float PreviousBound = ErrorBound;
+    do
+    {
+        ActiveTolerance *= 2.f;
+        Points.Reset();
+        bHasHead = false;
+        bConeOpen = false;
+        for (const FBreadcrumbPoint& Point : Scratch)
+        {
+            Push(Point);
+        }
+    } while (Points.Num() > MaxPoints * 3 / 4);
+
+    ErrorBound = PreviousBound + ActiveTolerance;
+}
+
+void FBreadcrumbTrail::Finish()
+{
+    if (bHasHead)
+    {
+        Points.Add(Head);
+        bHasHead = false;
+        bConeOpen = false;
+    }
+}
+
+FVector FBreadcrumbTrail::SampleAtTime(float Time) const
+{
+    const int32 Count = Num();
+    if (Count == 0) return FVector::ZeroVector;
+
+    // Points are in time order; the first one after Time and the one before it
+    int32 Next = Algo::UpperBoundBy(Points, Time, &FBreadcrumbPoint::Time);
+    if (Next == Points.Num() && bHasHead && Head.Time <= Time)
+    {
+        Next = Count;
+    }
+    if (Next <= 0) return FVector(GetPoint(0).Location);
+    if (Next >= Count) return FVector(GetPoint(Count - 1).Location);
+
+    const FBreadcrumbPoint& From = GetPoint(Next - 1);
+    const FBreadcrumbPoint& To = GetPoint(Next);
+    const float Alpha = To.Time > From.Time ? (Time - From.Time) / (To.Time - From.Time) : 1.f;
+    return FVector(FMath::Lerp(From.Location, To.Location, Alpha));
+}
+
+bool FBreadcrumbTrail::Serialize(FArchive& Ar)
+{
+    uint32 FileMagic = Magic;
+    uint16 FileVersion = Version;
+    Ar << FileMagic << FileVersion;
+
+    if (FileMagic != Magic || FileVersion != Version)
+    {
+        return false;
+    }
+
+    // Saved trails are finished, the head is already a vertex
+    if (Ar.IsSaving())
+    {
+        Finish();
+    }
+
+    Ar << MapName << ActiveTolerance << ErrorBound << Points;
+
+    if (Ar.IsLoading())
+    {
+        bHasHead = false;
+        bConeOpen = false;
+        MaxPoints = FMath::Max(MaxPoints, Points.Num());
+    }
+    return !Ar.IsError();
+}
+
+bool FBreadcrumbTrail::SaveToFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    if (!Serialize(Writer))
+    {
+        return false;
+    }
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FBreadcrumbTrail::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    return Serialize(Reader);
+}
+
+FString FBreadcrumbTrail::ResolvePath(const FString& NameOrPath)
+{
+    if (NameOrPath.Contains(TEXT("/")) || NameOrPath.Contains(TEXT("\\")) || FPaths::GetExtension(NameOrPath) == TEXT("ktrl"))
+    {
+        return NameOrPath;
+    }
+    return FPaths::ProjectSavedDir() / TEXT("Trails") / (NameOrPath + TEXT(".ktrl"));
+}
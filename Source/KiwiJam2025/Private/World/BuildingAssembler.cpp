@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/BuildingAssembler.h"
+#include "World/BuildingCollisionComponent.h"
+#include "World/TraversalProxyComponent.h"
+#include "KiwiJam2025.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "EngineUtils.h"
+
+DECLARE_CYCLE_STAT(TEXT("Building Assemble"), STAT_BuildingAssemble, STATGROUP_KiwiJam);
+
+ABuildingAssembler::ABuildingAssembler()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+}
+
+void ABuildingAssembler::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	Assemble();
+}
+
+bool ABuildingAssembler::ParseModule(TCHAR Char, EBuildingModule& OutModule)
+{
+    switch (Char)
+    {
+    case '1': OutModule = EBuildingModule::Wall1; return true;
+    case '2': OutModule = EBuildingModule::Wall2; return true;
+    case '3': OutModule = EBuildingModule::Wall3; return true;
+    case 'b': OutModule = EBuildingModule::BlankWall; return true;
+    case 'd': OutModule = EBuildingModule::Door; return true;
+    default: return false;
+    }
+}
+
+void ABuildingAssembler::Assemble()
+{
+    SCOPE_CYCLE_COUNTER(STAT_BuildingAssemble);
+    const double StartTime = FPlatformTime::Seconds();
+
+    ModuleComponents.Reset();
+    CollisionComponents.Reset();
+    TraversalProxyComponents.Reset();
+
+    // Gather every module transform first so each HISM gets one batched add
+    TMap<EBuildingModule, TArray<FTransform>> InstancesByModule;
+
+    // Sides walked counter-clockwise from the min corner: direction along the side, outward yaw
+    static const FVector2D SideDirs[4] = { FVector2D(1, 0), FVector2D(0, 1), FVector2D(-1, 0), FVector2D(0, -1) };
+    static const float SideYaw[4] = { -90.f, 0.f, 90.f, 180.f };
+
+    const float W = ModuleSize.X;
+    const float H = ModuleSize.Y;
+
+    for (int32 BuildingIndex = 0; BuildingIndex < Buildings.Num(); ++BuildingIndex)
+    {
+        const FBuildingLayout& Layout = Buildings[BuildingIndex];
+        if (Layout.Facade.IsEmpty() || Layout.Footprint.X <= 0 || Layout.Footprint.Y <= 0) continue;
+
+        const FVector Origin(Layout.Cell.X * CellSize, Layout.Cell.Y * CellSize, 0.f);
+        const FVector2D Size(Layout.Footprint.X * W, Layout.Footprint.Y * W);
+
+        TArray<FKBoxElem> Boxes;
+        int32 FacadeIndex = 0;
+
+        for (int32 Side = 0; Side < 4; ++Side)
+        {
+            const int32 SideCount = (Side % 2 == 0) ? Layout.Footprint.X : Layout.Footprint.Y;
+            const FVector2D Dir = SideDirs[Side];
+            const FRotator Rot(0.f, SideYaw[Side] + MeshYawOffset, 0.f);
+
+            // Corner each side starts from
+            FVector2D Corner = FVector2D::ZeroVector;
+            if (Side == 1) Corner = FVector2D(Size.X, 0.f);
+            if (Side == 2) Corner = Size;
+            if (Side == 3) Corner = FVector2D(0.f, Size.Y);
+
+            auto AddBox = [&](int32 FirstCell, int32 NumCells, float BottomZ, float Height)
+                {
+                    const FVector2D Mid2D = Corner + Dir * (W * (FirstCell + NumCells * 0.5f));
+                    FKBoxElem& Box = Boxes.Emplace_GetRef(W * NumCells, WallThickness, Height);
+                    Box.Center = Origin + FVector(Mid2D.X, Mid2D.Y, BottomZ + Height * 0.5f);
+                    Box.Rotation = FRotator(0.f, Side * 90.f, 0.f);
+                };
+
+            int32 RunStart = INDEX_NONE;
+            for (int32 i = 0; i < SideCount; ++i)
+            {
+                EBuildingModule Module;
+                if (!ParseModule(Layout.Facade[FacadeIndex++ % Layout.Facade.Len()], Module))
+                {
+                    Module = EBuildingModule::BlankWall;
+                }
+
+                const FVector2D Pos2D = Corner + Dir * (W * (i + 0.5f));
+                for (int32 Floor = 0; Floor < Layout.Floors; ++Floor)
+                {
+                    const EBuildingModule FloorModule = (Floor > 0 && Module == EBuildingModule::Door) ? EBuildingModule::BlankWall : Module;
+                    InstancesByModule.FindOrAdd(FloorModule).Emplace(Rot, Origin + FVector(Pos2D.X, Pos2D.Y, Floor * H));
+                }
+
+                // Ground floor collision runs, broken by doors
+                const bool bSolid = Module != EBuildingModule::Door;
+                if (bSolid && RunStart == INDEX_NONE)
+                {
+                    RunStart = i;
+                }
+                if (RunStart != INDEX_NONE && (!bSolid || i == SideCount - 1))
+                {
+                    const int32 RunEnd = bSolid ? i + 1 : i;
+                    AddBox(RunStart, RunEnd - RunStart, 0.f, H);
+                    RunStart = INDEX_NONE;
+                }
+            }
+
+            // Upper floors have no doors, one box for the whole side
+            if (Layout.Floors > 1)
+            {
+                AddBox(0, SideCount, H, H * (Layout.Floors - 1));
+            }
+        }
+
+        if (bGenerateTraversalProxies)
+        {
+            // Walls only occlude within their own building, upper floor boxes cover the ground floor tops
+            TArray<FKBoxElem> Ledge, Blocking;
+            UTraversalProxyComponent::SplitLedgeBoxes(Boxes, Boxes, FTraversalLedgeRules(), Ledge, Blocking);
+            AddTraversalProxy(MoveTemp(Ledge), true);
+            AddTraversalProxy(MoveTemp(Blocking), false);
+        }
+
+        UBuildingCollisionComponent* Collision = NewObject<UBuildingCollisionComponent>(this);
+        Collision->CreationMethod = EComponentCreationMethod::UserConstructionScript;
+        Collision->SetupAttachment(RootComponent);
+        Collision->SetMobility(EComponentMobility::Static);
+        Collision->SetBoxes(MoveTemp(Boxes));
+        Collision->RegisterComponent();
+        CollisionComponents.Add(Collision);
+    }
+
+    for (TPair<EBuildingModule, TArray<FTransform>>& Pair : InstancesByModule)
+    {
+        const TObjectPtr<UStaticMesh>* Mesh = ModuleMeshes.Find(Pair.Key);
+        if (!Mesh || !*Mesh) continue;
+
+        UHierarchicalInstancedStaticMeshComponent* HISM = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+        HISM->CreationMethod = EComponentCreationMethod::UserConstructionScript;
+        HISM->SetupAttachment(RootComponent);
+        HISM->SetMobility(EComponentMobility::Static);
+        HISM->SetStaticMesh(*Mesh);
+        // Collision lives on the merged per-building bodies
+        HISM->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        HISM->SetCanEverAffectNavigation(false);
+        HISM->RegisterComponent();
+        HISM->AddInstances(Pair.Value, false);
+        ModuleComponents.Add(Pair.Key, HISM);
+    }
+
+    LastSetupMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+void ABuildingAssembler::AddTraversalProxy(TArray<FKBoxElem>&& Boxes, bool bLedgeCapable)
+{
+    if (Boxes.Num() == 0) return;
+
+    UTraversalProxyComponent* Proxy = NewObject<UTraversalProxyComponent>(this);
+    Proxy->CreationMethod = EComponentCreationMethod::UserConstructionScript;
+    Proxy->SetupAttachment(RootComponent);
+    Proxy->SetMobility(EComponentMobility::Static);
+    Proxy->SetLedgeCapable(bLedgeCapable);
+    Proxy->SetBoxes(MoveTemp(Boxes));
+    Proxy->RegisterComponent();
+    TraversalProxyComponents.Add(Proxy);
+}
+
+#if WITH_EDITOR
+void ABuildingAssembler::LogDistrictStats()
+{
+    // After: this actor
+    int32 NumInstances = 0;
+    for (const TPair<EBuildingModule, TObjectPtr<UHierarchicalInstancedStaticMeshComponent>>& Pair : ModuleComponents)
+    {
+        NumInstances += Pair.Value ? Pair.Value->GetInstanceCount() : 0;
+    }
+
+    int32 NumShapes = 0;
+    for (const UBuildingCollisionComponent* Collision : CollisionComponents)
+    {
+        NumShapes += Collision ? Collision->GetNumBoxes() : 0;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Assembler %s: %d buildings, %d module instances, %d components (%d HISM + %d collision + %d traversal proxy), %d collision bodies (%d boxes), game thread setup %.2f ms"),
+        *GetName(), Buildings.Num(), NumInstances, ModuleComponents.Num() + CollisionComponents.Num() + TraversalProxyComponents.Num(), ModuleComponents.Num(),
+        CollisionComponents.Num(), TraversalProxyComponents.Num(), CollisionComponents.Num(), NumShapes, LastSetupMs);
+
+    // Before: loose actors placed with the same meshes
+    TSet<const UStaticMesh*> Meshes;
+    for (const TPair<EBuildingModule, TObjectPtr<UStaticMesh>>& Pair : ModuleMeshes)
+    {
+        Meshes.Add(Pair.Value);
+    }
+
+    int32 LooseActors = 0;
+    int32 LooseBodies = 0;
+    for (TActorIterator<AStaticMeshActor> It(GetWorld()); It; ++It)
+    {
+        const UStaticMeshComponent* Comp = It->GetStaticMeshComponent();
+        if (Comp && Meshes.Contains(Comp->GetStaticMesh()))
+        {
+            ++LooseActors;
+            LooseBodies += Comp->IsCollisionEnabled() ? 1 : 0;
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Loose module actors in level: %d components, %d collision bodies (use 'stat KiwiJam' / 'stat scenerendering' for thread cost)"),
+        LooseActors, LooseBodies);
+}
+
+void ABuildingAssembler::GenerateTestDistrict()
+{
+    Modify();
+    Buildings.Reset(TestDistrictSize);
+
+    static const TCHAR* Facades[] = { TEXT("1d23"), TEXT("b1b2"), TEXT("3d1b2"), TEXT("12"), TEXT("d3b") };
+
+    FRandomStream Random(1234);
+    const int32 Columns = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt(static_cast<float>(TestDistrictSize))));
+    for (int32 i = 0; i < TestDistrictSize; ++i)
+    {
+        FBuildingLayout& Layout = Buildings.AddDefaulted_GetRef();
+        Layout.Cell = FIntPoint((i % Columns) * 6, (i / Columns) * 6);
+        Layout.Footprint = FIntPoint(Random.RandRange(2, 4), Random.RandRange(2, 4));
+        Layout.Floors = Random.RandRange(1, 3);
+        Layout.Facade = Facades[Random.RandRange(0, UE_ARRAY_COUNT(Facades) - 1)];
+    }
+
+    RerunConstructionScripts();
+}
+#endif
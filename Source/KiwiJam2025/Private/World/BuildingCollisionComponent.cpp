@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/BuildingCollisionComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Engine/CollisionProfile.h"
+#include "World/TraversalMeshInfo.h"
+
+UBuildingCollisionComponent::UBuildingCollisionComponent(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    PrimaryComponentTick.bCanEverTick = false;
+
+    SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+    SetGenerateOverlapEvents(false);
+    bHiddenInGame = true;
+    bCanEverAffectNavigation = true;
+}
+
+void UBuildingCollisionComponent::SetBoxes(TArray<FKBoxElem>&& InBoxes)
+{
+    Boxes = MoveTemp(InBoxes);
+    RebuildBodySetup();
+
+    UpdateBounds();
+    if (IsRegistered())
+    {
+        RecreatePhysicsState();
+    }
+}
+
+void UBuildingCollisionComponent::OnRegister()
+{
+    // Loaded with boxes but no transient body yet
+    if (!ShapeBodySetup && Boxes.Num() > 0)
+    {
+        RebuildBodySetup();
+    }
+
+    Super::OnRegister();
+}
+
+void UBuildingCollisionComponent::RebuildBodySetup()
+{
+    if (!ShapeBodySetup)
+    {
+        ShapeBodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+        ShapeBodySetup->BodySetupGuid = FGuid::NewGuid();
+        ShapeBodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+        ShapeBodySetup->bNeverNeedsCookedCollisionData = true;
+    }
+
+    ShapeBodySetup->InvalidatePhysicsData();
+    ShapeBodySetup->AggGeom.BoxElems = Boxes;
+    FTraversalMeshInfo::Invalidate(ShapeBodySetup);
+    ShapeBodySetup->CreatePhysicsMeshes();
+}
+
+UBodySetup* UBuildingCollisionComponent::GetBodySetup()
+{
+    return ShapeBodySetup;
+}
+
+FBoxSphereBounds UBuildingCollisionComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+    if (Boxes.Num() == 0)
+    {
+        return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+    }
+
+    FBox LocalBox(ForceInit);
+    for (const FKBoxElem& Box : Boxes)
+    {
+        LocalBox += Box.CalcAABB(FTransform::Identity, 1.f);
+    }
+    return FBoxSphereBounds(LocalBox.TransformBy(LocalToWorld));
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/CourseGoalTimes.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+bool FCourseGoalTimes::Serialize(FArchive& Ar)
+{
+    uint32 FileMagic = Magic;
+    uint16 FileVersion = Version;
+    Ar << FileMagic << FileVersion;
+
+    if (FileMagic != Magic || FileVersion != Version)
+    {
+        return false;
+    }
+
+    Ar << MapName << GoalIds << GoalLocations << Times << ReachableFromStart;
+
+    // Matrix must match the goal count
+    const int32 NumGoals = GoalIds.Num();
+    return !Ar.IsError() && GoalLocations.Num() == NumGoals && Times.Num() == NumGoals * NumGoals && ReachableFromStart.Num() == NumGoals;
+}
+
+bool FCourseGoalTimes::SaveToFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    if (!Serialize(Writer))
+    {
+        return false;
+    }
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FCourseGoalTimes::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    return Serialize(Reader);
+}
+
+FString FCourseGoalTimes::GetDefaultPath(const FString& MapName)
+{
+    return FPaths::ProjectSavedDir() / TEXT("Reachability") / (MapName + TEXT(".kcgt"));
+}
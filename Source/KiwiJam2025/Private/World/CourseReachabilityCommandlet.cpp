@@ -0,0 +1,759 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/CourseReachabilityCommandlet.h"
+#include "World/CourseGoalTimes.h"
+#include "World/TraversalMeshInfo.h"
+#include "World/TraversalProxyComponent.h"
+#include "Character/ParkourCharacter.h"
+#include "Character/ParkourMovementComponent.h"
+#include "Character/ClimbableDetectorComponent.h"
+#include "GoalManifest.h"
+#include "GoalPoint.h"
+#include "Algo/Count.h"
+#include "Async/ParallelFor.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCourseReachability, Log, All);
+
+namespace CourseReachability
+{
+    enum class EMove : uint8
+    {
+        Walk,
+        Jump,
+        Drop,
+        Vault,
+        Climb,
+
+        Count
+    };
+
+    static const TCHAR* MoveNames[(int32)EMove::Count] = { TEXT("walk"), TEXT("jump"), TEXT("drop"), TEXT("vault"), TEXT("climb") };
+
+    struct FEdge
+    {
+        int32 To = INDEX_NONE;
+        float Time = 0.f;
+        EMove Move = EMove::Walk;
+    };
+
+    // Everything taken from the pawn, so the graph follows the same limits as the game
+    struct FRules
+    {
+        FTraversalReachLimits Limits;
+        float CapsuleRadius = 55.f;
+        float CapsuleHalfHeight = 96.f;
+        float MaxStepHeight = 45.f;
+        float WalkableFloorZ = 0.71f;
+        float MaxWalkSpeed = 600.f;
+        float JumpZVelocity = 420.f;
+        float Gravity = 980.f;
+        float ClimbTime = 1.f;
+        float VaultTime = 0.8f;
+
+        float GetJumpApex() const { return JumpZVelocity * JumpZVelocity / (2.f * Gravity); }
+
+        // Time in the air for a jump that lands DeltaZ above the take-off, negative if it can't get there
+        float GetJumpAirTime(float DeltaZ) const
+        {
+            const float Discriminant = JumpZVelocity * JumpZVelocity - 2.f * Gravity * DeltaZ;
+            return Discriminant >= 0.f ? (JumpZVelocity + FMath::Sqrt(Discriminant)) / Gravity : -1.f;
+        }
+    };
+
+    /**
+     * Walkable sample points on a grid, several per column for stacked floors, linked by moves.
+     * Every build phase is a ParallelFor with no shared writes, so it scales with cores.
+     */
+    class FGraph
+    {
+    public:
+        FGraph(UWorld* InWorld, const FRules& InRules, float InSpacing, EParallelForFlags InFlags)
+            : World(InWorld), Rules(InRules), Spacing(InSpacing), Flags(InFlags)
+        {
+            QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(CourseReachability));
+        }
+
+        void BuildNodes(const FBox& Bounds);
+        void BuildEdges();
+
+        // Nearest node to a feet location within MaxDistance, INDEX_NONE if none
+        int32 FindNode(const FVector& Location, float MaxDistance) const;
+
+        // Dijkstra in seconds from any of Sources, MAX_flt where unreached
+        void ShortestTimes(TConstArrayView<int32> Sources, TArray<float>& OutTimes) const;
+
+        int32 NumNodes() const { return Nodes.Num(); }
+        int32 NumEdges() const { return Edges.Num(); }
+        int32 CountMoves(EMove Move) const { return Algo::CountIf(Edges, [Move](const FEdge& Edge) { return Edge.Move == Move; }); }
+
+    private:
+        static constexpr int32 MaxLayersPerColumn = 8;
+        static constexpr int32 NumDirections = 8;
+
+        int32 ColumnIndex(int32 X, int32 Y) const { return Y * GridSize.X + X; }
+        FIntPoint ColumnOf(const FVector& Location) const;
+
+        // Anything the capsule collides with
+        bool TraceWorld(FHitResult& Hit, const FVector& Start, const FVector& End) const
+        {
+            return World->LineTraceSingleByChannel(Hit, Start, End, ECC_Pawn, QueryParams);
+        }
+
+        // Same choice as UClimbableDetectorComponent::TraceLine
+        bool TraceTraversal(FHitResult& Hit, const FVector& Start, const FVector& End) const
+        {
+            if (Rules.Limits.bUseTraversalChannel)
+            {
+                return World->LineTraceSingleByObjectType(Hit, Start, End, FCollisionObjectQueryParams(Rules.Limits.TraversalObjectType), QueryParams);
+            }
+            return World->LineTraceSingleByChannel(Hit, Start, End, Rules.Limits.TraceChannel, QueryParams);
+        }
+
+        bool CapsuleFits(const FVector& Feet) const;
+
+        void LinkWalk(int32 Index, TArray<FEdge>& OutEdges) const;
+        void LinkJumps(int32 Index, TArray<FEdge>& OutEdges) const;
+        void LinkVaultAndClimb(int32 Index, TArray<FEdge>& OutEdges) const;
+
+        template <typename FuncType>
+        void ForEachNodeNear(const FVector& Location, int32 RadiusCells, FuncType&& Func) const;
+
+        UWorld* World = nullptr;
+        FRules Rules;
+        float Spacing = 100.f;
+        EParallelForFlags Flags = EParallelForFlags::None;
+        FCollisionQueryParams QueryParams;
+
+        FIntPoint GridMin = FIntPoint::ZeroValue;
+        FIntPoint GridSize = FIntPoint::ZeroValue;
+
+        // Feet locations. Nodes of a column are contiguous: ColumnStart[c] .. ColumnStart[c + 1]
+        TArray<FVector3f> Nodes;
+        TArray<int32> ColumnStart;
+
+        // Nodes with fewer walk links than neighbours sit at an edge; only they try the other moves
+        TBitArray<> bBoundary;
+
+        // CSR adjacency: EdgeStart[n] .. EdgeStart[n + 1]
+        TArray<int32> EdgeStart;
+        TArray<FEdge> Edges;
+    };
+
+    FIntPoint FGraph::ColumnOf(const FVector& Location) const
+    {
+        return FIntPoint(FMath::FloorToInt32(Location.X / Spacing) - GridMin.X, FMath::FloorToInt32(Location.Y / Spacing) - GridMin.Y);
+    }
+
+    template <typename FuncType>
+    void FGraph::ForEachNodeNear(const FVector& Location, int32 RadiusCells, FuncType&& Func) const
+    {
+        const FIntPoint Center = ColumnOf(Location);
+        for (int32 Y = FMath::Max(0, Center.Y - RadiusCells); Y <= FMath::Min(GridSize.Y - 1, Center.Y + RadiusCells); ++Y)
+        {
+            for (int32 X = FMath::Max(0, Center.X - RadiusCells); X <= FMath::Min(GridSize.X - 1, Center.X + RadiusCells); ++X)
+            {
+                const int32 Column = ColumnIndex(X, Y);
+                for (int32 Node = ColumnStart[Column]; Node < ColumnStart[Column + 1]; ++Node)
+                {
+                    Func(Node);
+                }
+            }
+        }
+    }
+
+    bool FGraph::CapsuleFits(const FVector& Feet) const
+    {
+        // Slightly shrunk so touching a wall doesn't count as blocked
+        const FCollisionShape Capsule = FCollisionShape::MakeCapsule(Rules.CapsuleRadius * 0.9f, Rules.CapsuleHalfHeight * 0.95f);
+        return !World->OverlapBlockingTestByChannel(Feet + FVector(0.f, 0.f, Rules.CapsuleHalfHeight + 2.f), FQuat::Identity, ECC_Pawn, Capsule, QueryParams);
+    }
+
+    void FGraph::BuildNodes(const FBox& Bounds)
+    {
+        GridMin = FIntPoint(FMath::FloorToInt32(Bounds.Min.X / Spacing), FMath::FloorToInt32(Bounds.Min.Y / Spacing));
+        GridSize = FIntPoint(FMath::FloorToInt32(Bounds.Max.X / Spacing), FMath::FloorToInt32(Bounds.Max.Y / Spacing)) - GridMin + FIntPoint(1, 1);
+
+        // One row per task; each writes only its own arrays
+        TArray<TArray<FVector3f>> RowNodes;
+        TArray<TArray<uint8>> RowCounts;
+        RowNodes.SetNum(GridSize.Y);
+        RowCounts.SetNum(GridSize.Y);
+
+        ParallelFor(GridSize.Y, [&](int32 Row)
+            {
+                TArray<uint8>& Counts = RowCounts[Row];
+                Counts.SetNumZeroed(GridSize.X);
+
+                for (int32 Column = 0; Column < GridSize.X; ++Column)
+                {
+                    const float X = (GridMin.X + Column + 0.5f) * Spacing;
+                    const float Y = (GridMin.Y + Row + 0.5f) * Spacing;
+
+                    // Walk down the column, one floor per hit
+                    float TopZ = Bounds.Max.Z + 10.f;
+                    for (int32 Layer = 0; Layer < MaxLayersPerColumn && TopZ > Bounds.Min.Z; ++Layer)
+                    {
+                        FHitResult Hit;
+                        if (!TraceWorld(Hit, FVector(X, Y, TopZ), FVector(X, Y, Bounds.Min.Z - 10.f)))
+                            break;
+
+                        if (Hit.ImpactNormal.Z >= Rules.WalkableFloorZ && CapsuleFits(Hit.ImpactPoint))
+                        {
+                            RowNodes[Row].Add(FVector3f(Hit.ImpactPoint));
+                            ++Counts[Column];
+                        }
+
+                        // Anything standing below needs a full capsule of room under this surface
+                        TopZ = Hit.ImpactPoint.Z - Rules.CapsuleHalfHeight * 2.f;
+                    }
+                }
+            }, Flags);
+
+        ColumnStart.SetNumUninitialized(GridSize.X * GridSize.Y + 1);
+        int32 Total = 0;
+        for (int32 Row = 0; Row < GridSize.Y; ++Row)
+        {
+            for (int32 Column = 0; Column < GridSize.X; ++Column)
+            {
+                ColumnStart[ColumnIndex(Column, Row)] = Total;
+                Total += RowCounts[Row][Column];
+            }
+        }
+        ColumnStart.Last() = Total;
+
+        Nodes.Reserve(Total);
+        for (TArray<FVector3f>& Row : RowNodes)
+        {
+            Nodes.Append(MoveTemp(Row));
+        }
+    }
+
+    void FGraph::LinkWalk(int32 Index, TArray<FEdge>& OutEdges) const
+    {
+        const FVector A(Nodes[Index]);
+        const float MaxSlope = FMath::Sqrt(1.f - FMath::Square(Rules.WalkableFloorZ)) / FMath::Max(Rules.WalkableFloorZ, UE_KINDA_SMALL_NUMBER);
+
+        ForEachNodeNear(A, 1, [&](int32 Other)
+            {
+                if (Other == Index) return;
+
+                const FVector B(Nodes[Other]);
+                const float DeltaZ = B.Z - A.Z;
+                const float Distance2D = FVector::Dist2D(A, B);
+                if (Distance2D < UE_KINDA_SMALL_NUMBER || FMath::Abs(DeltaZ) > Rules.MaxStepHeight + Distance2D * MaxSlope)
+                    return;
+
+                // Clear at knee height, above anything we'd step over
+                const FVector Knee(0.f, 0.f, Rules.MaxStepHeight + 5.f);
+                FHitResult Hit;
+                if (TraceWorld(Hit, A + Knee, B + Knee))
+                    return;
+
+                OutEdges.Add({ Other, FVector::Dist(A, B) / Rules.MaxWalkSpeed, EMove::Walk });
+            });
+    }
+
+    void FGraph::LinkJumps(int32 Index, TArray<FEdge>& OutEdges) const
+    {
+        const FVector A(Nodes[Index]);
+        const float Apex = Rules.GetJumpApex();
+
+        // Furthest a flat jump carries, drops reach a bit further
+        const float FlatReach = Rules.MaxWalkSpeed * Rules.GetJumpAirTime(0.f);
+        const int32 RadiusCells = FMath::Clamp(FMath::CeilToInt32(FlatReach * 1.5f / Spacing), 2, 8);
+        const FVector Center(0.f, 0.f, Rules.CapsuleHalfHeight);
+
+        ForEachNodeNear(A, RadiusCells, [&](int32 Other)
+            {
+                if (Other == Index) return;
+
+                // Walk already covers this pair
+                if (OutEdges.ContainsByPredicate([Other](const FEdge& Edge) { return Edge.To == Other; }))
+                    return;
+
+                const FVector B(Nodes[Other]);
+                const float DeltaZ = B.Z - A.Z;
+                const float Distance2D = FVector::Dist2D(A, B);
+                if (DeltaZ > Apex - 10.f)
+                    return;
+
+                const float AirTime = Rules.GetJumpAirTime(DeltaZ);
+                if (AirTime <= 0.f || Distance2D > Rules.MaxWalkSpeed * AirTime)
+                    return;
+
+                // Two legs through the top of the arc, at capsule centre height
+                const FVector Peak = FMath::Lerp(A, B, 0.5f) + FVector(0.f, 0.f, FMath::Max(0.f, DeltaZ) + Apex * 0.5f);
+                FHitResult Hit;
+                if (TraceWorld(Hit, A + Center, Peak + Center) || TraceWorld(Hit, Peak + Center, B + Center))
+                    return;
+
+                OutEdges.Add({ Other, AirTime, DeltaZ < -Rules.MaxStepHeight ? EMove::Drop : EMove::Jump });
+            });
+    }
+
+    void FGraph::LinkVaultAndClimb(int32 Index, TArray<FEdge>& OutEdges) const
+    {
+        const FTraversalReachLimits& Limits = Rules.Limits;
+        const FVector Feet(Nodes[Index]);
+
+        // Where the detector's actor location would be
+        const FVector Origin = Feet + FVector(0.f, 0.f, Rules.CapsuleHalfHeight);
+
+        for (int32 Direction = 0; Direction < NumDirections; ++Direction)
+        {
+            const float Angle = 2.f * UE_PI * Direction / NumDirections;
+            const FVector Forward(FMath::Cos(Angle), FMath::Sin(Angle), 0.f);
+            FHitResult Hit;
+
+            FVector Start, End;
+
+            // Vault, as CheckVaultSurface: obstacle ahead, top within range, nothing at the landing
+            UClimbableDetectorComponent::GetProbeSegment(Limits, EAffordanceProbe::VaultForward, Origin, Forward, FVector::ZeroVector, Start, End);
+            if (TraceTraversal(Hit, Start, End))
+            {
+                bool bRejected = false;
+                const float Height = UClimbableDetectorComponent::GetVaultObstacleTopZ(Limits, Origin, Hit, Forward, bRejected) - Origin.Z;
+                if (!bRejected && Height >= Limits.VaultObstacleHeightMin && Height <= Limits.VaultObstacleHeightMax)
+                {
+                    FVector LandingStart, LandingEnd;
+                    UClimbableDetectorComponent::GetProbeSegment(Limits, EAffordanceProbe::VaultLanding, Origin, Forward, Hit.ImpactPoint, LandingStart, LandingEnd);
+                    FHitResult LandingHit;
+                    if (!TraceTraversal(LandingHit, LandingStart, LandingEnd))
+                    {
+                        const int32 Landing = FindNode(FVector(LandingStart.X, LandingStart.Y, Feet.Z), Spacing * 1.5f);
+                        if (Landing != INDEX_NONE && Landing != Index)
+                        {
+                            OutEdges.Add({ Landing, Rules.VaultTime, EMove::Vault });
+                        }
+                    }
+                }
+            }
+
+            // Climb, as DetectClimbableSurface: head clear, wall ahead, ledge top within range
+            UClimbableDetectorComponent::GetProbeSegment(Limits, EAffordanceProbe::Head, Origin, Forward, FVector::ZeroVector, Start, End);
+            if (TraceTraversal(Hit, Start, End))
+                continue;
+            UClimbableDetectorComponent::GetProbeSegment(Limits, EAffordanceProbe::ClimbForward, Origin, Forward, FVector::ZeroVector, Start, End);
+            if (!TraceTraversal(Hit, Start, End))
+                continue;
+
+            FHitResult TopHit;
+            UClimbableDetectorComponent::GetProbeSegment(Limits, EAffordanceProbe::LedgeTop, Origin, Forward, Hit.ImpactPoint - Hit.ImpactNormal * 20.f, Start, End);
+            if (!TraceTraversal(TopHit, Start, End))
+                continue;
+
+            const UTraversalProxyComponent* Proxy = Limits.bUseTraversalChannel ? Cast<UTraversalProxyComponent>(TopHit.GetComponent()) : nullptr;
+            if (Proxy && !Proxy->IsLedgeCapable())
+                continue;
+
+            const float Height = TopHit.ImpactPoint.Z - Origin.Z;
+            if (Height < Limits.MinLedgeHeight || Height > Limits.MaxLedgeHeight)
+                continue;
+
+            // Stand on the top, a capsule radius in from the edge
+            const FVector Top = TopHit.ImpactPoint - FVector(Hit.ImpactNormal.X, Hit.ImpactNormal.Y, 0.f).GetSafeNormal() * Rules.CapsuleRadius;
+            const int32 Target = FindNode(Top, Spacing * 1.5f);
+            if (Target != INDEX_NONE && Target != Index)
+            {
+                OutEdges.Add({ Target, Rules.ClimbTime, EMove::Climb });
+            }
+        }
+    }
+
+    void FGraph::BuildEdges()
+    {
+        TArray<TArray<FEdge>> NodeEdges;
+        NodeEdges.SetNum(Nodes.Num());
+
+        // Pass 1: walking, and which nodes sit at the edge of their floor
+        bBoundary.Init(false, Nodes.Num());
+        TArray<uint8> Boundary;
+        Boundary.SetNumZeroed(Nodes.Num());
+
+        ParallelFor(Nodes.Num(), [&](int32 Index)
+            {
+                LinkWalk(Index, NodeEdges[Index]);
+                Boundary[Index] = NodeEdges[Index].Num() < 8 ? 1 : 0;
+            }, Flags);
+
+        for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+        {
+            bBoundary[Index] = Boundary[Index] != 0;
+        }
+
+        // Pass 2: the expensive moves, only from edges. Inside a floor, walking gets there first.
+        ParallelFor(Nodes.Num(), [&](int32 Index)
+            {
+                if (!bBoundary[Index]) return;
+
+                LinkJumps(Index, NodeEdges[Index]);
+                LinkVaultAndClimb(Index, NodeEdges[Index]);
+            }, Flags);
+
+        EdgeStart.SetNumUninitialized(Nodes.Num() + 1);
+        int32 Total = 0;
+        for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+        {
+            EdgeStart[Index] = Total;
+            Total += NodeEdges[Index].Num();
+        }
+        EdgeStart.Last() = Total;
+
+        Edges.Reserve(Total);
+        for (TArray<FEdge>& List : NodeEdges)
+        {
+            Edges.Append(MoveTemp(List));
+        }
+    }
+
+    int32 FGraph::FindNode(const FVector& Location, float MaxDistance) const
+    {
+        int32 Best = INDEX_NONE;
+        float BestDistSq = FMath::Square(MaxDistance);
+
+        ForEachNodeNear(Location, FMath::Max(1, FMath::CeilToInt32(MaxDistance / Spacing)), [&](int32 Node)
+            {
+                const float DistSq = FVector::DistSquared(Location, FVector(Nodes[Node]));
+                if (DistSq < BestDistSq)
+                {
+                    BestDistSq = DistSq;
+                    Best = Node;
+                }
+            });
+        return Best;
+    }
+
+    void FGraph::ShortestTimes(TConstArrayView<int32> Sources, TArray<float>& OutTimes) const
+    {
+        OutTimes.Init(MAX_flt, Nodes.Num());
+
+        using FEntry = TPair<float, int32>;
+        auto Less = [](const FEntry& A, const FEntry& B) { return A.Key < B.Key; };
+
+        TArray<FEntry> Open;
+        for (int32 Source : Sources)
+        {
+            if (Nodes.IsValidIndex(Source))
+            {
+                OutTimes[Source] = 0.f;
+                Open.HeapPush(FEntry(0.f, Source), Less);
+            }
+        }
+
+        while (Open.Num() > 0)
+        {
+            FEntry Current;
+            Open.HeapPop(Current, Less, EAllowShrinking::No);
+            if (Current.Key > OutTimes[Current.Value]) continue;
+
+            for (int32 EdgeIndex = EdgeStart[Current.Value]; EdgeIndex < EdgeStart[Current.Value + 1]; ++EdgeIndex)
+            {
+                const FEdge& Edge = Edges[EdgeIndex];
+                const float Time = Current.Key + Edge.Time;
+                if (Time < OutTimes[Edge.To])
+                {
+                    OutTimes[Edge.To] = Time;
+                    Open.HeapPush(FEntry(Time, Edge.To), Less);
+                }
+            }
+        }
+    }
+
+    static bool GatherRules(UWorld* World, TSubclassOf<ACharacter> PawnClass, FRules& OutRules)
+    {
+        const ACharacter* PawnCDO = PawnClass ? PawnClass->GetDefaultObject<ACharacter>() : nullptr;
+        const UParkourMovementComponent* MovementCDO = PawnCDO ? Cast<UParkourMovementComponent>(PawnCDO->GetCharacterMovement()) : nullptr;
+        if (!MovementCDO)
+        {
+            return false;
+        }
+
+        const UClimbableDetectorComponent* Detector = Cast<UClimbableDetectorComponent>(PawnCDO->GetDefaultSubobjectByName(TEXT("ClimbableDetector")));
+        OutRules.Limits = (Detector ? Detector : GetDefault<UClimbableDetectorComponent>())->GetReachLimits();
+
+        OutRules.CapsuleRadius = PawnCDO->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+        OutRules.CapsuleHalfHeight = PawnCDO->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+        OutRules.MaxStepHeight = MovementCDO->MaxStepHeight;
+        OutRules.WalkableFloorZ = MovementCDO->GetWalkableFloorZ();
+        OutRules.MaxWalkSpeed = MovementCDO->MaxWalkSpeed;
+        OutRules.JumpZVelocity = MovementCDO->JumpZVelocity;
+        OutRules.Gravity = FMath::Max(1.f, -World->GetGravityZ() * MovementCDO->GravityScale);
+
+        // Move durations from the action table, built on a copy so the CDO stays untouched
+        UParkourMovementComponent* Movement = DuplicateObject<UParkourMovementComponent>(MovementCDO, GetTransientPackage());
+        Movement->LoadTraversalCurvesBlocking();
+        if (const FTraversalActionTable* Table = Movement->GetTraversalTable())
+        {
+            // Missing actions keep the defaults rather than becoming free moves
+            const float ClimbDuration = Table->GetActionDuration(Table->FindAction(Movement->GetClimbActionName()));
+            const float VaultDuration = Table->GetActionDuration(Table->FindAction(Movement->GetVaultActionName()));
+            OutRules.ClimbTime = ClimbDuration > 0.f ? ClimbDuration : OutRules.ClimbTime;
+            OutRules.VaultTime = VaultDuration > 0.f ? VaultDuration : OutRules.VaultTime;
+        }
+        return true;
+    }
+
+    // Static collision only, skipping anything huge like sky spheres. Builds the traversal mesh
+    // info of every shape on the way, the vault checks only read it from the worker threads.
+    static FBox GatherLevelBounds(UWorld* World)
+    {
+        FBox Bounds(ForceInit);
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            It->ForEachComponent<UPrimitiveComponent>(false, [&Bounds](UPrimitiveComponent* Primitive)
+                {
+                    if (!Primitive->IsRegistered() || !Primitive->IsCollisionEnabled() || Primitive->Mobility != EComponentMobility::Static)
+                        return;
+
+                    // Traversal proxies too, which ignore pawns
+                    FTraversalMeshInfo::Get(Primitive->GetBodySetup());
+
+                    if (Primitive->GetCollisionResponseToChannel(ECC_Pawn) == ECR_Block && Primitive->Bounds.SphereRadius < 1e6f)
+                    {
+                        Bounds += Primitive->Bounds.GetBox();
+                    }
+                });
+        }
+        return Bounds;
+    }
+
+    struct FGoalInfo
+    {
+        FGuid GoalId;
+        FVector Location = FVector::ZeroVector;
+        FString Name;
+    };
+
+    static void GatherGoals(UWorld* World, TArray<FGoalInfo>& OutGoals)
+    {
+        // Manifest first: it lists goals in cells that aren't loaded
+        TSet<FGuid> Seen;
+        for (TActorIterator<AGoalManifest> It(World); It; ++It)
+        {
+            for (const FGoalManifestEntry& Entry : It->GetEntries())
+            {
+                if (!Seen.Contains(Entry.GoalId))
+                {
+                    Seen.Add(Entry.GoalId);
+                    OutGoals.Add({ Entry.GoalId, FVector(Entry.Location), Entry.GoalId.ToString() });
+                }
+            }
+        }
+
+        for (TActorIterator<AGoalPoint> It(World); It; ++It)
+        {
+            if (FGoalInfo* Existing = OutGoals.FindByPredicate([&It](const FGoalInfo& Goal) { return Goal.GoalId == It->GetGoalId(); }))
+            {
+                Existing->Name = It->GetActorNameOrLabel();
+            }
+            else
+            {
+                OutGoals.Add({ It->GetGoalId(), It->GetGoalLocation(), It->GetActorNameOrLabel() });
+            }
+        }
+    }
+}
+
+UCourseReachabilityCommandlet::UCourseReachabilityCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UCourseReachabilityCommandlet::Main(const FString& Params)
+{
+    using namespace CourseReachability;
+
+    FString MapPath;
+    if (!FParse::Value(*Params, TEXT("Map="), MapPath))
+    {
+        UE_LOG(LogCourseReachability, Error, TEXT("Usage: -run=CourseReachability -Map=/Game/Maps/MyMap [-Pawn=<class path>] [-Spacing=100] [-SingleThread]"));
+        return 1;
+    }
+
+    float Spacing = 100.f;
+    FParse::Value(*Params, TEXT("Spacing="), Spacing);
+    Spacing = FMath::Clamp(Spacing, 25.f, 1000.f);
+
+    const EParallelForFlags Flags = FParse::Param(*Params, TEXT("SingleThread")) ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+
+    TSubclassOf<ACharacter> PawnClass = AParkourCharacter::StaticClass();
+    FString PawnPath;
+    if (FParse::Value(*Params, TEXT("Pawn="), PawnPath))
+    {
+        PawnClass = LoadClass<ACharacter>(nullptr, *PawnPath);
+    }
+
+    UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+    UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogCourseReachability, Error, TEXT("Could not load map %s"), *MapPath);
+        return 1;
+    }
+
+    World->WorldType = EWorldType::Editor;
+    World->AddToRoot();
+    if (!World->bIsWorldInitialized)
+    {
+        UWorld::InitializationValues IVS;
+        IVS.RequiresHitProxies(false)
+            .ShouldSimulatePhysics(false)
+            .EnableTraceCollision(true)
+            .CreateNavigation(false)
+            .CreateAISystem(false)
+            .AllowAudioPlayback(false)
+            .CreatePhysicsScene(true);
+        World->InitWorld(IVS);
+    }
+    World->UpdateWorldComponents(true, false);
+
+    FRules Rules;
+    if (!GatherRules(World, PawnClass, Rules))
+    {
+        UE_LOG(LogCourseReachability, Error, TEXT("Pawn %s has no UParkourMovementComponent"), *GetNameSafe(PawnClass));
+        World->RemoveFromRoot();
+        return 1;
+    }
+
+    const FBox Bounds = GatherLevelBounds(World);
+    if (!Bounds.IsValid)
+    {
+        UE_LOG(LogCourseReachability, Error, TEXT("No static collision in %s"), *MapPath);
+        World->RemoveFromRoot();
+        return 1;
+    }
+
+    const int32 NumThreads = Flags == EParallelForFlags::ForceSingleThread ? 1 : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    UE_LOG(LogCourseReachability, Display, TEXT("%s: bounds %s, spacing %.0f, %d threads"), *MapPath, *Bounds.ToString(), Spacing, NumThreads);
+
+    FGraph Graph(World, Rules, Spacing, Flags);
+
+    double PhaseStart = FPlatformTime::Seconds();
+    Graph.BuildNodes(Bounds);
+    const double NodesSeconds = FPlatformTime::Seconds() - PhaseStart;
+
+    PhaseStart = FPlatformTime::Seconds();
+    Graph.BuildEdges();
+    const double EdgesSeconds = FPlatformTime::Seconds() - PhaseStart;
+
+    UE_LOG(LogCourseReachability, Display, TEXT("Graph: %d nodes (%.2fs), %d edges (%.2fs): %d walk, %d jump, %d drop, %d vault, %d climb"),
+        Graph.NumNodes(), NodesSeconds, Graph.NumEdges(), EdgesSeconds,
+        Graph.CountMoves(EMove::Walk), Graph.CountMoves(EMove::Jump), Graph.CountMoves(EMove::Drop), Graph.CountMoves(EMove::Vault), Graph.CountMoves(EMove::Climb));
+
+    // Goals and starts onto the graph. Player starts are at capsule centre.
+    TArray<FGoalInfo> Goals;
+    GatherGoals(World, Goals);
+
+    TArray<int32> GoalNodes;
+    for (const FGoalInfo& Goal : Goals)
+    {
+        GoalNodes.Add(Graph.FindNode(Goal.Location, 300.f));
+    }
+
+    TArray<int32> StartNodes;
+    for (TActorIterator<APlayerStart> It(World); It; ++It)
+    {
+        const int32 Node = Graph.FindNode(It->GetActorLocation() - FVector(0.f, 0.f, Rules.CapsuleHalfHeight), 300.f);
+        if (Node != INDEX_NONE)
+        {
+            StartNodes.Add(Node);
+        }
+    }
+
+    PhaseStart = FPlatformTime::Seconds();
+
+    TArray<float> FromStart;
+    Graph.ShortestTimes(StartNodes, FromStart);
+
+    // One Dijkstra per goal, independent, so goals go wide
+    const int32 NumGoals = Goals.Num();
+    FCourseGoalTimes GoalTimes;
+    GoalTimes.MapName = FPackageName::GetShortName(MapPath);
+    GoalTimes.Times.Init(-1.f, NumGoals * NumGoals);
+    GoalTimes.ReachableFromStart.Init(false, NumGoals);
+
+    ParallelFor(NumGoals, [&](int32 From)
+        {
+            if (GoalNodes[From] == INDEX_NONE) return;
+
+            TArray<float> Times;
+            Graph.ShortestTimes(MakeArrayView(&GoalNodes[From], 1), Times);
+            for (int32 To = 0; To < NumGoals; ++To)
+            {
+                if (GoalNodes[To] != INDEX_NONE && Times[GoalNodes[To]] < MAX_flt)
+                {
+                    GoalTimes.Times[From * NumGoals + To] = Times[GoalNodes[To]];
+                }
+            }
+        }, Flags);
+
+    const double PathsSeconds = FPlatformTime::Seconds() - PhaseStart;
+
+    int32 NumUnreachable = 0;
+    for (int32 Index = 0; Index < NumGoals; ++Index)
+    {
+        const FGoalInfo& Goal = Goals[Index];
+        GoalTimes.GoalIds.Add(Goal.GoalId);
+        GoalTimes.GoalLocations.Add(FVector3f(Goal.Location));
+
+        const int32 Node = GoalNodes[Index];
+        const bool bReachable = Node != INDEX_NONE && (StartNodes.Num() == 0 || FromStart[Node] < MAX_flt);
+        GoalTimes.ReachableFromStart[Index] = bReachable;
+        if (bReachable) continue;
+
+        ++NumUnreachable;
+        UE_LOG(LogCourseReachability, Warning, TEXT("Unreachable goal %s at %s%s"), *Goal.Name, *Goal.Location.ToCompactString(),
+            Node == INDEX_NONE ? TEXT(" (no standable ground near it)") : TEXT(""));
+    }
+
+    if (StartNodes.Num() == 0)
+    {
+        UE_LOG(LogCourseReachability, Warning, TEXT("No player start on walkable ground, only goals off the graph are reported"));
+    }
+
+    UE_LOG(LogCourseReachability, Display, TEXT("%d goals, %d unreachable. Shortest paths %.2fs. Total %.2fs on %d threads"),
+        NumGoals, NumUnreachable, PathsSeconds, NodesSeconds + EdgesSeconds + PathsSeconds, NumThreads);
+
+    // Binary for tools and the route planner, CSV for people
+    const FString OutPath = FCourseGoalTimes::GetDefaultPath(GoalTimes.MapName);
+    if (!GoalTimes.SaveToFile(OutPath))
+    {
+        UE_LOG(LogCourseReachability, Error, TEXT("Failed to write %s"), *OutPath);
+    }
+
+    FString Csv = TEXT("From\\To");
+    for (const FGoalInfo& Goal : Goals)
+    {
+        Csv += TEXT(",") + Goal.Name;
+    }
+    Csv += LINE_TERMINATOR;
+    for (int32 From = 0; From < NumGoals; ++From)
+    {
+        Csv += Goals[From].Name;
+        for (int32 To = 0; To < NumGoals; ++To)
+        {
+            const float Time = GoalTimes.GetTime(From, To);
+            Csv += Time >= 0.f ? FString::Printf(TEXT(",%.2f"), Time) : FString(TEXT(","));
+        }
+        Csv += LINE_TERMINATOR;
+    }
+    FFileHelper::SaveStringToFile(Csv, *(FPaths::GetPath(OutPath) / (GoalTimes.MapName + TEXT("_GoalTimes.csv"))));
+
+    UE_LOG(LogCourseReachability, Display, TEXT("Wrote %s"), *OutPath);
+
+    World->DestroyWorld(false);
+    World->RemoveFromRoot();
+    return 0;
+}
@@ -0,0 +1,446 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/CourseRouteSolver.h"
+#include "World/CourseGoalTimes.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Algo/Reverse.h"
+#include "Engine/World.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY(LogCourseRoute);
+
+namespace CourseRoute
+{
+    // A goal the commandlet couldn't reach still gets visited, just as late as possible
+    static constexpr float UnreachablePenalty = 600.f;
+
+    // Improvements smaller than this are float noise
+    static constexpr float MinGain = 1e-3f;
+
+    // Kicks only rearrange a stretch this long, so the local search repairs them quickly
+    static constexpr int32 MaxKickSpan = 50;
+
+    struct FCostView
+    {
+        const float* Data = nullptr;
+        int32 NumNodes = 0;
+
+        float operator()(int32 From, int32 To) const { return Data[From * NumNodes + To]; }
+    };
+
+    /**
+     * Open path from node 0 with positions and running costs both ways, so a 2-opt move on
+     * asymmetric costs is priced in O(1): a reversed stretch costs the backward sum.
+     */
+    struct FTour
+    {
+        TArray<int32> Nodes;
+        TArray<int32> Pos;
+
+        // Cost of Nodes[0..k] walked forwards, and walked backwards
+        TArray<float> Fwd;
+        TArray<float> Bwd;
+
+        int32 Num() const { return Nodes.Num(); }
+        float Total() const { return Fwd.Last(); }
+
+        void Rebuild(const FCostView& Cost)
+        {
+            const int32 N = Nodes.Num();
+            Pos.SetNumUninitialized(N);
+            Fwd.SetNumUninitialized(N);
+            Bwd.SetNumUninitialized(N);
+
+            Fwd[0] = 0.f;
+            Bwd[0] = 0.f;
+            Pos[Nodes[0]] = 0;
+            for (int32 k = 1; k < N; ++k)
+            {
+                Pos[Nodes[k]] = k;
+                Fwd[k] = Fwd[k - 1] + Cost(Nodes[k - 1], Nodes[k]);
+                Bwd[k] = Bwd[k - 1] + Cost(Nodes[k], Nodes[k - 1]);
+            }
+        }
+    };
+
+    // Nearest neighbour from the start. Jitter > 0 sometimes takes the second nearest, for varied seeds.
+    static void BuildSeed(const FCostView& Cost, FRandomStream& Random, float Jitter, FTour& OutTour)
+    {
+        const int32 N = Cost.NumNodes;
+        TBitArray<> Visited(false, N);
+        Visited[0] = true;
+
+        OutTour.Nodes.Reset(N);
+        OutTour.Nodes.Add(0);
+
+        int32 Current = 0;
+        for (int32 Step = 1; Step < N; ++Step)
+        {
+            int32 Nearest = INDEX_NONE;
+            int32 Second = INDEX_NONE;
+            for (int32 Node = 1; Node < N; ++Node)
+            {
+                if (Visited[Node]) continue;
+
+                if (Nearest == INDEX_NONE || Cost(Current, Node) < Cost(Current, Nearest))
+                {
+                    Second = Nearest;
+                    Nearest = Node;
+                }
+                else if (Second == INDEX_NONE || Cost(Current, Node) < Cost(Current, Second))
+                {
+                    Second = Node;
+                }
+            }
+
+            Current = (Second != INDEX_NONE && Random.FRand() < Jitter) ? Second : Nearest;
+            Visited[Current] = true;
+            OutTour.Nodes.Add(Current);
+        }
+
+        OutTour.Rebuild(Cost);
+    }
+
+    /**
+     * First-improvement descent over two move types, candidates only:
+     * 2-opt, reverse Nodes[i+1..j] so Nodes[i] goes straight to a close node;
+     * or-opt, move a run of up to three goals next to a close node.
+     */
+    template <typename StopFuncType>
+    static void LocalSearch(const FCostView& Cost, TConstArrayView<int32> Candidates, int32 NumCandidates, FTour& Tour, StopFuncType&& ShouldStop)
+    {
+        const int32 N = Tour.Num();
+        TArray<int32> Segment;
+
+        bool bImproved = true;
+        while (bImproved)
+        {
+            bImproved = false;
+
+            for (int32 i = 0; i + 2 < N; ++i)
+            {
+                if (ShouldStop()) return;
+
+                const int32 A = Tour.Nodes[i];
+                const int32 B = Tour.Nodes[i + 1];
+                for (int32 c = 0; c < NumCandidates; ++c)
+                {
+                    const int32 C = Candidates[A * NumCandidates + c];
+                    const int32 j = Tour.Pos[C];
+                    if (j < i + 2) continue;
+
+                    const int32 D = j + 1 < N ? Tour.Nodes[j + 1] : INDEX_NONE;
+                    const float Inner = (Tour.Bwd[j] - Tour.Bwd[i + 1]) - (Tour.Fwd[j] - Tour.Fwd[i + 1]);
+                    const float Outer = Cost(A, C) - Cost(A, B) + (D != INDEX_NONE ? Cost(B, D) - Cost(C, D) : 0.f);
+                    if (Inner + Outer < -MinGain)
+                    {
+                        Algo::Reverse(Tour.Nodes.GetData() + i + 1, j - i);
+                        Tour.Rebuild(Cost);
+                        bImproved = true;
+                        break;
+                    }
+                }
+            }
+
+            for (int32 s = 1; s < N; ++s)
+            {
+                if (ShouldStop()) return;
+
+                for (int32 Length = 1; Length <= 3 && s + Length <= N; ++Length)
+                {
+                    const int32 P = Tour.Nodes[s - 1];
+                    const int32 F = Tour.Nodes[s];
+                    const int32 L = Tour.Nodes[s + Length - 1];
+                    const int32 Next = s + Length < N ? Tour.Nodes[s + Length] : INDEX_NONE;
+                    const float Removed = Cost(P, F) + (Next != INDEX_NONE ? Cost(L, Next) - Cost(P, Next) : 0.f);
+
+                    int32 BestAfter = INDEX_NONE;
+                    float BestDelta = -MinGain;
+                    for (int32 c = 0; c < NumCandidates; ++c)
+                    {
+                        // Insert right after the candidate, or right before it
+                        const int32 CandidatePos = Tour.Pos[Candidates[F * NumCandidates + c]];
+                        for (int32 k = CandidatePos - 1; k <= CandidatePos; ++k)
+                        {
+                            if (k < 0 || (k >= s - 1 && k < s + Length)) continue;
+
+                            const int32 Before = Tour.Nodes[k];
+                            const int32 After = k + 1 < N ? Tour.Nodes[k + 1] : INDEX_NONE;
+                            const float Added = Cost(Before, F) + (After != INDEX_NONE ? Cost(L, After) - Cost(Before, After) : 0.f);
+                            if (Added - Removed < BestDelta)
+                            {
+                                BestDelta = Added - Removed;
+                                BestAfter = k;
+                            }
+                        }
+                    }
+
+                    if (BestAfter != INDEX_NONE)
+                    {
+                        Segment.Reset();
+                        Segment.Append(Tour.Nodes.GetData() + s, Length);
+                        Tour.Nodes.RemoveAt(s, Length, EAllowShrinking::No);
+                        Tour.Nodes.Insert(Segment, BestAfter < s ? BestAfter + 1 : BestAfter + 1 - Length);
+                        Tour.Rebuild(Cost);
+                        bImproved = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Double bridge on a short stretch: A B C D becomes A C B D. Local search can't undo it in one move.
+    static void Kick(const FCostView& Cost, FRandomStream& Random, FTour& Tour)
+    {
+        const int32 N = Tour.Num();
+        const int32 First = Random.RandRange(1, N - 3);
+        const int32 Second = FMath::Min(First + 1 + Random.RandHelper(MaxKickSpan), N - 2);
+        const int32 Third = FMath::Min(Second + 1 + Random.RandHelper(MaxKickSpan), N - 1);
+
+        TArray<int32> Moved;
+        Moved.Append(Tour.Nodes.GetData() + Second, Third - Second);
+        Moved.Append(Tour.Nodes.GetData() + First, Second - First);
+        FMemory::Memcpy(Tour.Nodes.GetData() + First, Moved.GetData(), Moved.Num() * sizeof(int32));
+
+        Tour.Rebuild(Cost);
+    }
+}
+
+void FCourseRouteSolver::Start(FCourseRouteInput&& Input, double BudgetSeconds, int32 MaxWorkers)
+{
+    StartTime = FPlatformTime::Seconds();
+    Deadline = StartTime + BudgetSeconds;
+
+    const int32 NumWorkers = MaxWorkers > 0 ? MaxWorkers : FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+    Best.NumWorkers = NumWorkers;
+
+    TSharedRef<FCourseRouteSolver, ESPMode::ThreadSafe> This = AsShared();
+
+    UE::Tasks::FTask Prepared = UE::Tasks::Launch(TEXT("CourseRoutePrepare"), [This, Input = MoveTemp(Input)]() mutable
+        {
+            This->Prepare(MoveTemp(Input));
+        }, UE::Tasks::ETaskPriority::BackgroundHigh);
+
+    // Background priority, the game's own tasks come first
+    TArray<UE::Tasks::FTask> Workers;
+    for (int32 WorkerIndex = 0; WorkerIndex < NumWorkers; ++WorkerIndex)
+    {
+        Workers.Add(UE::Tasks::Launch(TEXT("CourseRouteWorker"), [This, WorkerIndex]()
+            {
+                This->RunWorker(WorkerIndex);
+            }, UE::Tasks::Prerequisites(Prepared), UE::Tasks::ETaskPriority::BackgroundNormal));
+    }
+
+    FinishedTask = UE::Tasks::Launch(TEXT("CourseRouteFinished"), [This]()
+        {
+            {
+                FScopeLock Lock(&This->BestLock);
+                This->Best.TotalMs = (FPlatformTime::Seconds() - This->StartTime) * 1000.0;
+            }
+            This->bDone.store(true, std::memory_order_release);
+
+            if (This->OnFinished)
+            {
+                This->OnFinished(*This);
+            }
+        }, Workers, UE::Tasks::ETaskPriority::BackgroundHigh);
+}
+
+void FCourseRouteSolver::Prepare(FCourseRouteInput&& Input)
+{
+    const int32 NumGoals = Input.GoalLocations.Num();
+    const float InvSpeed = 1.f / FMath::Max(Input.FallbackSpeed, 1.f);
+    NumNodes = NumGoals + 1;
+
+    // Where each goal sits in the commandlet's matrix, if it's there at all
+    TArray<int32> TimesIndex;
+    TimesIndex.Init(INDEX_NONE, NumGoals);
+    if (const FCourseGoalTimes* Times = Input.GoalTimes.Get())
+    {
+        TMap<FGuid, int32> IndexById;
+        IndexById.Reserve(Times->Num());
+        for (int32 Index = 0; Index < Times->Num(); ++Index)
+        {
+            IndexById.Add(Times->GoalIds[Index], Index);
+        }
+        for (int32 Goal = 0; Goal < NumGoals && Goal < Input.GoalIds.Num(); ++Goal)
+        {
+            if (const int32* Found = IndexById.Find(Input.GoalIds[Goal]))
+            {
+                TimesIndex[Goal] = *Found;
+            }
+        }
+    }
+
+    // Nothing ever goes back to the start, so the column into node 0 stays zero
+    Costs.SetNumZeroed(NumNodes * NumNodes);
+    ParallelFor(NumNodes, [&](int32 From)
+        {
+            const FVector FromLocation = From == 0 ? Input.Start : Input.GoalLocations[From - 1];
+            const int32 FromTimes = From == 0 ? INDEX_NONE : TimesIndex[From - 1];
+            float* Row = Costs.GetData() + From * NumNodes;
+
+            for (int32 To = 1; To < NumNodes; ++To)
+            {
+                const float Direct = FVector::Dist(FromLocation, Input.GoalLocations[To - 1]) * InvSpeed;
+                const int32 ToTimes = TimesIndex[To - 1];
+                if (FromTimes == INDEX_NONE || ToTimes == INDEX_NONE)
+                {
+                    Row[To] = Direct;
+                    continue;
+                }
+
+                const float Time = Input.GoalTimes->GetTime(FromTimes, ToTimes);
+                Row[To] = Time >= 0.f ? Time : UnreachablePenalty + Direct;
+            }
+            Row[From] = MAX_flt;
+        });
+
+    // Candidates by round trip, so the same list serves moves in both directions
+    const int32 NumCands = FMath::Min(NumCandidates, FMath::Max(NumNodes - 1, 1));
+    Candidates.SetNumUninitialized(NumNodes * NumCands);
+    ParallelFor(NumNodes, [&](int32 Node)
+        {
+            // Closest few by insertion, the lists are short
+            TArray<TPair<float, int32>, TInlineAllocator<NumCandidates + 1>> Closest;
+            for (int32 Other = 0; Other < NumNodes; ++Other)
+            {
+                if (Other == Node) continue;
+
+                const float RoundTrip = Other == 0 ? 2.f * Cost(0, Node) : Node == 0 ? 2.f * Cost(0, Other) : Cost(Node, Other) + Cost(Other, Node);
+                if (Closest.Num() == NumCands && RoundTrip >= Closest.Last().Key) continue;
+
+                int32 Insert = Closest.Num();
+                while (Insert > 0 && Closest[Insert - 1].Key > RoundTrip) --Insert;
+                Closest.Insert(TPair<float, int32>(RoundTrip, Other), Insert);
+                if (Closest.Num() > NumCands) Closest.Pop(EAllowShrinking::No);
+            }
+
+            // Short lists (tiny courses) point at the node itself, every move skips that
+            for (int32 c = 0; c < NumCands; ++c)
+            {
+                Candidates[Node * NumCands + c] = Closest.IsValidIndex(c) ? Closest[c].Value : Node;
+            }
+        });
+}
+
+void FCourseRouteSolver::RunWorker(int32 WorkerIndex)
+{
+    using namespace CourseRoute;
+
+    const FCostView CostView{ Costs.GetData(), NumNodes };
+    const int32 NumCands = NumNodes > 0 ? Candidates.Num() / NumNodes : 0;
+    auto ShouldStop = [this]()
+        {
+            return bCancelled.load(std::memory_order_relaxed) || FPlatformTime::Seconds() >= Deadline;
+        };
+
+    FRandomStream Random(WorkerIndex * 7919 + 17);
+
+    // Worker 0 keeps the plain greedy seed, so there's always a sane answer even with no time
+    FTour Current;
+    BuildSeed(CostView, Random, WorkerIndex == 0 ? 0.f : 0.3f, Current);
+    if (WorkerIndex == 0)
+    {
+        FScopeLock Lock(&BestLock);
+        Best.SeedCost = Current.Total();
+    }
+    Publish(Current.Nodes, Current.Total());
+
+    LocalSearch(CostView, Candidates, NumCands, Current, ShouldStop);
+    Publish(Current.Nodes, Current.Total());
+
+    // Too small to kick, the descent already found it
+    if (NumNodes < 5) return;
+
+    int32 NumKicks = 0;
+    FTour Trial;
+    while (!ShouldStop())
+    {
+        Trial = Current;
+        Kick(CostView, Random, Trial);
+        LocalSearch(CostView, Candidates, NumCands, Trial, ShouldStop);
+        ++NumKicks;
+
+        if (Trial.Total() < Current.Total() - MinGain)
+        {
+            Swap(Current, Trial);
+            Publish(Current.Nodes, Current.Total());
+        }
+    }
+
+    FScopeLock Lock(&BestLock);
+    Best.NumKicks += NumKicks;
+}
+
+void FCourseRouteSolver::Publish(TConstArrayView<int32> Tour, float TourCost)
+{
+    FScopeLock Lock(&BestLock);
+    if (!BestTour.IsEmpty() && TourCost >= Best.Cost) return;
+
+    if (BestTour.IsEmpty())
+    {
+        Best.FirstResultMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    }
+    BestTour.Reset();
+    BestTour.Append(Tour.GetData(), Tour.Num());
+    Best.Cost = TourCost;
+}
+
+bool FCourseRouteSolver::GetBest(FResult& OutResult) const
+{
+    FScopeLock Lock(&BestLock);
+    if (BestTour.IsEmpty()) return false;
+
+    OutResult = Best;
+    OutResult.Order.Reset(BestTour.Num() - 1);
+    for (int32 k = 1; k < BestTour.Num(); ++k)
+    {
+        OutResult.Order.Add(BestTour[k] - 1);
+    }
+    return true;
+}
+
+namespace CourseRoute
+{
+    // Random goals over a square, the shape of a big open course
+    static void RunBench(int32 NumGoals, float BudgetMs, int32 MaxWorkers)
+    {
+        FCourseRouteInput Input;
+        FRandomStream Random(NumGoals);
+        for (int32 i = 0; i < NumGoals; ++i)
+        {
+            Input.GoalIds.Add(FGuid::NewGuid());
+            Input.GoalLocations.Add(FVector(Random.FRandRange(-100000.f, 100000.f), Random.FRandRange(-100000.f, 100000.f), Random.FRandRange(0.f, 3000.f)));
+        }
+
+        const double LaunchStart = FPlatformTime::Seconds();
+        TSharedRef<FCourseRouteSolver, ESPMode::ThreadSafe> Solver = MakeShared<FCourseRouteSolver, ESPMode::ThreadSafe>();
+        Solver->Start(MoveTemp(Input), BudgetMs / 1000.f, MaxWorkers);
+        const double LaunchMs = (FPlatformTime::Seconds() - LaunchStart) * 1000.0;
+
+        Solver->Wait();
+
+        FCourseRouteSolver::FResult Result;
+        if (Solver->GetBest(Result))
+        {
+            UE_LOG(LogCourseRoute, Log, TEXT("[RouteBench] %d goals, %d workers, %.0f ms budget: greedy %.1f s -> %.1f s (%.1f%% shorter), first route after %.2f ms, done after %.2f ms, %d kicks. Game thread %.3f ms"),
+                NumGoals, Result.NumWorkers, BudgetMs, Result.SeedCost, Result.Cost, 100.f * (1.f - Result.Cost / FMath::Max(Result.SeedCost, UE_KINDA_SMALL_NUMBER)),
+                Result.FirstResultMs, Result.TotalMs, Result.NumKicks, LaunchMs);
+        }
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs RouteBenchCommand(
+        TEXT("Parkour.RouteBench"),
+        TEXT("Solves a goal route over random goals and logs quality and timing. Workers=1 for the single core baseline. Args: [Goals=500] [BudgetMs=100] [Workers=0]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                RunBench(
+                    Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 500,
+                    Args.Num() > 1 ? FMath::Max(1.f, FCString::Atof(*Args[1])) : 100.f,
+                    Args.Num() > 2 ? FMath::Max(0, FCString::Atoi(*Args[2])) : 0);
+            }));
+}
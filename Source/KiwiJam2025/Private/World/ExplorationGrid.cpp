@@ -0,0 +1,499 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/ExplorationGrid.h"
+#include "KiwiJam2025.h"
+#include "Save/ParkourSave.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/LevelBounds.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Compression.h"
+#include "Misc/DateTime.h"
+#include "WorldPartition/WorldPartition.h"
+
+DEFINE_LOG_CATEGORY(LogExploration);
+
+DECLARE_CYCLE_STAT(TEXT("Exploration Update"), STAT_ExplorationUpdate, STATGROUP_KiwiJam);
+
+static_assert(FExplorationGrid::TileCells == 32, "A tile row is one word of the grid");
+
+static TAutoConsoleVariable<float> CVarFogCellSize(
+    TEXT("Parkour.Fog.CellSize"),
+    100.f,
+    TEXT("Exploration cell size in cm, read when the map bounds are set"));
+
+static TAutoConsoleVariable<float> CVarFogMaxMapSize(
+    TEXT("Parkour.Fog.MaxMapSize"),
+    1000000.f,
+    TEXT("Largest map side in cm exploration covers, centred on the world's bounds. Keeps a stray far-off actor from blowing up the grid."));
+
+static TAutoConsoleVariable<float> CVarFogUpdateRate(
+    TEXT("Parkour.Fog.UpdateRate"),
+    10.f,
+    TEXT("Times a second exploration is revealed around the player"));
+
+static TAutoConsoleVariable<float> CVarFogRevealRadius(
+    TEXT("Parkour.Fog.RevealRadius"),
+    2000.f,
+    TEXT("Radius in cm revealed around the player"));
+
+static TAutoConsoleVariable<int32> CVarFogMaskDownsample(
+    TEXT("Parkour.Fog.MaskDownsample"),
+    2,
+    TEXT("Exploration cells per fog mask texel on each axis: 1, 2, 4 or 8. Read when the map creates its mask."));
+
+static TAutoConsoleVariable<float> CVarFogSaveInterval(
+    TEXT("Parkour.Fog.SaveInterval"),
+    30.f,
+    TEXT("Seconds between course saves while new ground is being explored"));
+
+static TAutoConsoleVariable<float> CVarTrailTolerance(
+    TEXT("Parkour.Trail.Tolerance"),
+    50.f,
+    TEXT("How far in cm the simplified breadcrumb trail may stray from the sampled path, read when a map starts"));
+
+static TAutoConsoleVariable<int32> CVarTrailMaxPoints(
+    TEXT("Parkour.Trail.MaxPoints"),
+    1024,
+    TEXT("Vertices the breadcrumb trail keeps before it coarsens, read when a map starts"));
+
+// Used until begin play, and for worlds with nothing in them
+static const FBox DefaultMapBounds(FVector(-2000, -2000, 0), FVector(2000, 2000, 0));
+
+void FExplorationGrid::Init(const FBox& Bounds, float InCellSize)
+{
+    CellSize = FMath::Max(InCellSize, 1.f);
+    Origin = FVector2D(Bounds.Min);
+
+    const FVector Size = Bounds.GetSize();
+    const int32 CellsX = FMath::Max(1, FMath::CeilToInt(Size.X / CellSize));
+    const int32 CellsY = FMath::Max(1, FMath::CeilToInt(Size.Y / CellSize));
+    Width = FMath::DivideAndRoundUp(CellsX, TileCells) * TileCells;
+    Height = FMath::DivideAndRoundUp(CellsY, TileCells) * TileCells;
+
+    Words.Reset();
+    Words.SetNumZeroed(GetWordsPerRow() * Height);
+    DirtyTiles.Init(false, GetTilesX() * GetTilesY());
+}
+
+int32 FExplorationGrid::RevealCircle(const FVector& Location, float Radius)
+{
+    if (!IsValid()) return 0;
+
+    const double InvCellSize = 1.0 / CellSize;
+    const double CenterX = (Location.X - Origin.X) * InvCellSize;
+    const double CenterY = (Location.Y - Origin.Y) * InvCellSize;
+    const double CellRadius = Radius * InvCellSize;
+
+    const int32 MinY = FMath::Max(0, FMath::FloorToInt(CenterY - CellRadius));
+    const int32 MaxY = FMath::Min(Height - 1, FMath::FloorToInt(CenterY + CellRadius));
+    const int32 WordsPerRow = GetWordsPerRow();
+
+    int32 NewCells = 0;
+    for (int32 Y = MinY; Y <= MaxY; ++Y)
+    {
+        // Span of cell centres inside the circle on this row
+        const double DY = Y + 0.5 - CenterY;
+        const double HalfSq = CellRadius * CellRadius - DY * DY;
+        if (HalfSq < 0.0) continue;
+
+        const double Half = FMath::Sqrt(HalfSq);
+        const int32 MinX = FMath::Max(0, FMath::CeilToInt(CenterX - Half - 0.5));
+        const int32 MaxX = FMath::Min(Width - 1, FMath::FloorToInt(CenterX + Half - 0.5));
+        if (MinX > MaxX) continue;
+
+        uint32* Row = Words.GetData() + Y * WordsPerRow;
+        for (int32 Word = MinX >> 5; Word <= MaxX >> 5; ++Word)
+        {
+            const int32 Lo = FMath::Max(MinX - Word * 32, 0);
+            const int32 Hi = FMath::Min(MaxX - Word * 32, 31);
+            const uint32 Mask = (Hi == 31 ? ~0u : (1u << (Hi + 1)) - 1) & (~0u << Lo);
+
+            const uint32 Revealed = Mask & ~Row[Word];
+            if (Revealed)
+            {
+                Row[Word] |= Revealed;
+                NewCells += FMath::CountBits(Revealed);
+                DirtyTiles[(Y / TileCells) * WordsPerRow + Word] = true;
+            }
+        }
+    }
+    return NewCells;
+}
+
+bool FExplorationGrid::Merge(const FExplorationGrid& Other)
+{
+    if (!IsValid() || !HasSameLayout(Other) || Other.Words.Num() != Words.Num()) return false;
+
+    for (int32 i = 0; i < Words.Num(); ++i)
+    {
+        Words[i] |= Other.Words[i];
+    }
+    MarkAllDirty();
+    return true;
+}
+
+int32 FExplorationGrid::CountExplored() const
+{
+    int32 Count = 0;
+    for (uint32 Word : Words)
+    {
+        Count += FMath::CountBits(Word);
+    }
+    return Count;
+}
+
+void FExplorationGrid::MarkAllDirty()
+{
+    DirtyTiles.Init(true, GetTilesX() * GetTilesY());
+}
+
+void FExplorationGrid::BuildMaskTile(int32 TileX, int32 TileY, int32 Downsample, uint8* Dest, int32 DestPitch) const
+{
+    const int32 TileTexels = TileCells / Downsample;
+    const uint32 TexelMask = (1u << Downsample) - 1;
+    const int32 CellsPerTexel = Downsample * Downsample;
+    const int32 WordsPerRow = GetWordsPerRow();
+
+    for (int32 TY = 0; TY < TileTexels; ++TY)
+    {
+        const uint32* Rows = Words.GetData() + (TileY * TileCells + TY * Downsample) * WordsPerRow + TileX;
+        uint8* DestRow = Dest + TY * DestPitch;
+        for (int32 TX = 0; TX < TileTexels; ++TX)
+        {
+            int32 Explored = 0;
+            for (int32 DY = 0; DY < Downsample; ++DY)
+            {
+                Explored += FMath::CountBits((Rows[DY * WordsPerRow] >> (TX * Downsample)) & TexelMask);
+            }
+            DestRow[TX] = (uint8)(255 - Explored * 255 / CellsPerTexel);
+        }
+    }
+}
+
+bool FExplorationGrid::Serialize(FArchive& Ar)
+{
+    Ar << Origin << CellSize << Width << Height;
+
+    if (Ar.IsLoading())
+    {
+        // Empty grids are fine, anything else must be whole tiles and fit in what's left
+        const bool bEmpty = Width == 0 && Height == 0;
+        if (!bEmpty && (Width <= 0 || Height <= 0 || Width % TileCells != 0 || Height % TileCells != 0
+            || (int64)GetWordsPerRow() * Height > Ar.TotalSize() / (int64)sizeof(uint32) || CellSize < 1.f))
+        {
+            return false;
+        }
+    }
+
+    Ar << Words;
+
+    if (Ar.IsLoading())
+    {
+        if (Words.Num() != GetWordsPerRow() * Height)
+        {
+            return false;
+        }
+        MarkAllDirty();
+    }
+    return !Ar.IsError();
+}
+
+bool UExplorationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Nothing to show on a server
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UExplorationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SetMapBounds(DefaultMapBounds);
+
+    Trail.Reset(CVarTrailTolerance.GetValueOnGameThread(), CVarTrailMaxPoints.GetValueOnGameThread());
+    Trail.MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UExplorationSubsystem::OnPostActorTick);
+}
+
+void UExplorationSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    Super::Deinitialize();
+}
+
+void UExplorationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    SetMapBounds(ComputeWorldMapBounds(InWorld));
+    bHasWorldBounds = true;
+    UE_LOG(LogExploration, Log, TEXT("Map bounds %s, %d x %d cells"), *MapBounds.ToString(), Grid.Width, Grid.Height);
+
+    if (PendingSaved.IsValid())
+    {
+        MergeSaved(PendingSaved);
+        PendingSaved = FExplorationGrid();
+    }
+}
+
+FBox UExplorationSubsystem::ComputeWorldMapBounds(const UWorld& World)
+{
+    FBox Bounds(ForceInit);
+    if (const UWorldPartition* WorldPartition = World.GetWorldPartition())
+    {
+        // Every cell, streamed in or not
+        Bounds = WorldPartition->GetRuntimeWorldBounds();
+    }
+    else
+    {
+        for (ULevel* Level : World.GetLevels())
+        {
+            if (Level && Level->bIsVisible)
+            {
+                Bounds += ALevelBounds::CalculateLevelBounds(Level);
+            }
+        }
+    }
+
+    if (!Bounds.IsValid || Bounds.GetSize().X <= 0.f || Bounds.GetSize().Y <= 0.f)
+    {
+        return DefaultMapBounds;
+    }
+
+    const float MaxSize = FMath::Max(CVarFogMaxMapSize.GetValueOnGameThread(), 1000.f);
+    const FVector Center = Bounds.GetCenter();
+    const FVector Extent = Bounds.GetExtent();
+    const FVector2D HalfSize(FMath::Min(Extent.X, MaxSize * 0.5f), FMath::Min(Extent.Y, MaxSize * 0.5f));
+    return FBox(FVector(Center.X - HalfSize.X, Center.Y - HalfSize.Y, 0.f), FVector(Center.X + HalfSize.X, Center.Y + HalfSize.Y, 0.f));
+}
+
+void UExplorationSubsystem::SetMapBounds(const FBox& Bounds)
+{
+    MapBounds = Bounds;
+    Grid.Init(Bounds, CVarFogCellSize.GetValueOnGameThread());
+    LastRevealLocation = FVector(UE_BIG_NUMBER);
+}
+
+void UExplorationSubsystem::TakeDirtyTiles(TBitArray<>& OutTiles)
+{
+    OutTiles = Grid.DirtyTiles;
+    Grid.DirtyTiles.SetRange(0, Grid.DirtyTiles.Num(), false);
+}
+
+int32 UExplorationSubsystem::GetMaskDownsample() const
+{
+    const int32 Wanted = FMath::Clamp(CVarFogMaskDownsample.GetValueOnGameThread(), 1, 8);
+    return (int32)FMath::RoundDownToPowerOfTwo((uint32)Wanted);
+}
+
+void UExplorationSubsystem::GatherProgress(FParkourSaveData& Data) const
+{
+    // Saving before begin play keeps what was loaded rather than the placeholder grid
+    if (!bHasWorldBounds && PendingSaved.IsValid())
+    {
+        Data.Exploration = PendingSaved;
+        return;
+    }
+
+    Data.Exploration.Origin = Grid.Origin;
+    Data.Exploration.CellSize = Grid.CellSize;
+    Data.Exploration.Width = Grid.Width;
+    Data.Exploration.Height = Grid.Height;
+    Data.Exploration.Words = Grid.Words;
+}
+
+void UExplorationSubsystem::ApplySavedProgress(const FParkourSaveData& Data)
+{
+    if (!Data.Exploration.IsValid()) return;
+
+    if (!bHasWorldBounds)
+    {
+        PendingSaved = Data.Exploration;
+        return;
+    }
+    MergeSaved(Data.Exploration);
+}
+
+void UExplorationSubsystem::MergeSaved(const FExplorationGrid& Saved)
+{
+    if (Grid.Merge(Saved))
+    {
+        UE_LOG(LogExploration, Log, TEXT("Restored exploration, %d cells"), Grid.CountExplored());
+    }
+    else
+    {
+        UE_LOG(LogExploration, Warning, TEXT("Saved exploration was made for other map bounds or cell size, starting over"));
+    }
+}
+
+void UExplorationSubsystem::OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World != GetWorld()) return;
+
+    // Fixed rate, at most one reveal a frame; a long hitch doesn't queue up catch-up work
+    const float Interval = 1.f / FMath::Max(CVarFogUpdateRate.GetValueOnGameThread(), 0.1f);
+    UpdateAccumulator += DeltaSeconds;
+    if (UpdateAccumulator >= Interval)
+    {
+        UpdateAccumulator = FMath::Min(UpdateAccumulator - Interval, Interval);
+        Update();
+    }
+
+    if (Ghost.Num() >= 2)
+    {
+        GhostTime = FMath::Min(GhostTime + DeltaSeconds * GhostSpeed, Ghost.GetPoint(Ghost.Num() - 1).Time);
+    }
+
+    SaveAccumulator += DeltaSeconds;
+    if (bUnsavedReveals && SaveAccumulator >= CVarFogSaveInterval.GetValueOnGameThread())
+    {
+        SaveAccumulator = 0.f;
+        bUnsavedReveals = false;
+        if (UParkourSaveSubsystem* Saves = World->GetGameInstance() ? World->GetGameInstance()->GetSubsystem<UParkourSaveSubsystem>() : nullptr)
+        {
+            Saves->RequestSave(World);
+        }
+    }
+}
+
+void UExplorationSubsystem::Update()
+{
+    SCOPE_CYCLE_COUNTER(STAT_ExplorationUpdate);
+
+    const APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    const APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+    if (!Pawn || !Grid.IsValid()) return;
+
+    const FVector Location = Pawn->GetActorLocation();
+    if (FVector::DistSquared2D(Location, LastRevealLocation) < FMath::Square(Grid.CellSize * 0.5f)) return;
+    LastRevealLocation = Location;
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    if (Grid.RevealCircle(Location, CVarFogRevealRadius.GetValueOnGameThread()) > 0)
+    {
+        bUnsavedReveals = true;
+    }
+    Trail.AddSample(Location, GetWorld()->GetTimeSeconds());
+    LastUpdateMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+}
+
+FString UExplorationSubsystem::ExportTrail(const FString& Name) const
+{
+    const FString Path = FBreadcrumbTrail::ResolvePath(Name.IsEmpty()
+        ? FString::Printf(TEXT("%s-%s"), *Trail.MapName, *FDateTime::Now().ToString())
+        : Name);
+
+    // A copy, so finishing it for the file doesn't cut the live segment short
+    FBreadcrumbTrail Finished = Trail;
+    if (!Finished.SaveToFile(Path))
+    {
+        UE_LOG(LogExploration, Error, TEXT("Couldn't write trail to %s"), *Path);
+        return FString();
+    }
+
+    UE_LOG(LogExploration, Log, TEXT("Wrote %d trail points, within %.0f cm of the path, to %s"), Finished.Num(), Finished.GetErrorBound(), *Path);
+    return Path;
+}
+
+void UExplorationSubsystem::StartGhost(FBreadcrumbTrail&& InGhost, float Speed)
+{
+    Ghost = MoveTemp(InGhost);
+    GhostSpeed = FMath::Max(Speed, 0.01f);
+    GhostTime = Ghost.Num() > 0 ? Ghost.GetPoint(0).Time : 0.f;
+}
+
+namespace Exploration
+{
+    static void RunBench(float MapMeters, int32 NumUpdates, float RadiusMeters)
+    {
+        FExplorationGrid Grid;
+        Grid.Init(FBox(FVector::ZeroVector, FVector(MapMeters * 100.f, MapMeters * 100.f, 0.f)), 100.f);
+
+        // A run across the map at sprint speed, sampled at the update rate
+        FRandomStream Random(1234);
+        FVector Location(MapMeters * 50.f, MapMeters * 50.f, 0.f);
+        float Heading = 0.f;
+        const float Step = 1000.f / FMath::Max(CVarFogUpdateRate.GetValueOnGameThread(), 0.1f);
+
+        double TotalMs = 0.0;
+        double MaxMs = 0.0;
+        for (int32 i = 0; i < NumUpdates; ++i)
+        {
+            Heading += Random.FRandRange(-0.3f, 0.3f);
+            Location += FVector(FMath::Cos(Heading), FMath::Sin(Heading), 0.f) * Step;
+            Location.X = FMath::Clamp(Location.X, 0.f, MapMeters * 100.f);
+            Location.Y = FMath::Clamp(Location.Y, 0.f, MapMeters * 100.f);
+
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            Grid.RevealCircle(Location, RadiusMeters * 100.f);
+            const double Ms = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+            TotalMs += Ms;
+            MaxMs = FMath::Max(MaxMs, Ms);
+        }
+
+        // What the save stores, through the same compressor
+        const int32 RawBytes = Grid.Words.Num() * Grid.Words.GetTypeSize();
+        int32 CompressedBytes = FCompression::CompressMemoryBound(NAME_Oodle, RawBytes);
+        TArray<uint8> Compressed;
+        Compressed.SetNumUninitialized(CompressedBytes);
+        if (!FCompression::CompressMemory(NAME_Oodle, Compressed.GetData(), CompressedBytes, Grid.Words.GetData(), RawBytes))
+        {
+            CompressedBytes = RawBytes;
+        }
+
+        const int32 NumCells = Grid.Width * Grid.Height;
+        UE_LOG(LogExploration, Log, TEXT("[FogBench] %d x %d cells, %.1f KB. %d updates of %.0f m: avg %.4f ms, max %.4f ms. %.1f%% explored, saved as %.1f KB"),
+            Grid.Width, Grid.Height, (RawBytes + Grid.DirtyTiles.GetAllocatedSize()) / 1024.0, NumUpdates, RadiusMeters,
+            TotalMs / NumUpdates, MaxMs, 100.0 * Grid.CountExplored() / NumCells, CompressedBytes / 1024.0);
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs TrailExportCommand(
+        TEXT("Parkour.Trail.Export"),
+        TEXT("Writes this run's breadcrumb trail. Args: [Name], unnamed trails go to Saved/Trails/<Map>-<Time>.ktrl"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                if (UExplorationSubsystem* Exploration = World ? World->GetSubsystem<UExplorationSubsystem>() : nullptr)
+                {
+                    Exploration->ExportTrail(Args.Num() > 0 ? Args[0] : FString());
+                }
+            }));
+
+    static FAutoConsoleCommandWithWorldAndArgs TrailReplayCommand(
+        TEXT("Parkour.Trail.Replay"),
+        TEXT("Plays a saved breadcrumb trail back on the world map. Args: <NameOrPath> [Speed=1]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                UExplorationSubsystem* Exploration = World ? World->GetSubsystem<UExplorationSubsystem>() : nullptr;
+                if (!Exploration || Args.Num() == 0) return;
+
+                const FString Path = FBreadcrumbTrail::ResolvePath(Args[0]);
+                FBreadcrumbTrail Loaded;
+                if (!Loaded.LoadFromFile(Path))
+                {
+                    UE_LOG(LogExploration, Error, TEXT("Couldn't load trail %s"), *Path);
+                    return;
+                }
+                if (Loaded.MapName != Exploration->GetTrail().MapName)
+                {
+                    UE_LOG(LogExploration, Warning, TEXT("Trail %s was recorded in %s"), *Path, *Loaded.MapName);
+                }
+                Exploration->StartGhost(MoveTemp(Loaded), Args.Num() > 1 ? FCString::Atof(*Args[1]) : 1.f);
+            }));
+
+    static FAutoConsoleCommandWithWorldAndArgs FogBenchCommand(
+        TEXT("Parkour.FogBench"),
+        TEXT("Times revealing exploration along a random run on a square map at 1 m cells. Args: [MapMeters=2000] [Updates=20000] [RadiusMeters=20]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                RunBench(
+                    Args.Num() > 0 ? FMath::Max(1.f, FCString::Atof(*Args[0])) : 2000.f,
+                    Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 20000,
+                    Args.Num() > 2 ? FMath::Max(0.f, FCString::Atof(*Args[2])) : 20.f);
+            }));
+}
@@ -0,0 +1,288 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/RideRailComponent.h"
+#include "KiwiJam2025.h"
+#include "Character/ParkourCharacter.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rail Table Build"), STAT_RailTableBuild, STATGROUP_KiwiJam);
+DECLARE_CYCLE_STAT(TEXT("Rail Find"), STAT_RailFind, STATGROUP_KiwiJam);
+
+void FRailArcTable::Build(const USplineComponent& Spline, float DesiredSpacing)
+{
+    SCOPE_CYCLE_COUNTER(STAT_RailTableBuild);
+
+    Points.Reset();
+    Tangents.Reset();
+    Chunks.Reset();
+
+    Length = Spline.GetSplineLength();
+    bClosedLoop = Spline.IsClosedLoop();
+    if (Length <= UE_KINDA_SMALL_NUMBER) return;
+
+    // Even steps that land exactly on both ends
+    const int32 NumSamples = FMath::CeilToInt32(Length / FMath::Max(DesiredSpacing, 1.f)) + 1;
+    Spacing = Length / (NumSamples - 1);
+    InvSpacing = 1.f / Spacing;
+
+    // The spline's own reparam table does the distance to key mapping, once per sample here
+    Points.SetNumUninitialized(NumSamples);
+    Tangents.SetNumUninitialized(NumSamples);
+    for (int32 i = 0; i < NumSamples; ++i)
+    {
+        const float Distance = FMath::Min(i * Spacing, Length);
+        Points[i] = FVector3f(Spline.GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local));
+        Tangents[i] = FVector3f(Spline.GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local));
+    }
+
+    // Chunks share their end sample with the next one so no segment falls between two
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumSamples - 1, ChunkSize);
+    Chunks.SetNumUninitialized(NumChunks);
+    for (int32 c = 0; c < NumChunks; ++c)
+    {
+        const int32 First = c * ChunkSize;
+        const int32 Last = FMath::Min(First + ChunkSize, NumSamples - 1);
+
+        FBox3f Box(ForceInit);
+        for (int32 i = First; i <= Last; ++i)
+        {
+            Box += Points[i];
+        }
+        Chunks[c].Center = Box.GetCenter();
+        Chunks[c].Radius = Box.GetExtent().Size();
+    }
+}
+
+float FRailArcTable::ClampDistance(float Distance) const
+{
+    if (bClosedLoop)
+    {
+        Distance = FMath::Fmod(Distance, Length);
+        return Distance < 0.f ? Distance + Length : Distance;
+    }
+    return FMath::Clamp(Distance, 0.f, Length);
+}
+
+void FRailArcTable::Sample(float Distance, FVector& OutPoint, FVector& OutTangent) const
+{
+    const float Scaled = ClampDistance(Distance) * InvSpacing;
+    const int32 Index = FMath::Min((int32)Scaled, Points.Num() - 2);
+    const float Alpha = Scaled - Index;
+
+    OutPoint = FVector(FMath::Lerp(Points[Index], Points[Index + 1], Alpha));
+    OutTangent = FVector(FMath::Lerp(Tangents[Index], Tangents[Index + 1], Alpha)).GetSafeNormal();
+}
+
+bool FRailArcTable::FindNearest(const FVector& Point, float Radius, float& OutDistance, float& OutDistSq) const
+{
+    const FVector3f P(Point);
+    OutDistSq = FMath::Square(Radius);
+    bool bFound = false;
+
+    for (int32 c = 0; c < Chunks.Num(); ++c)
+    {
+        if (FVector3f::DistSquared(P, Chunks[c].Center) > FMath::Square(Chunks[c].Radius + Radius)) continue;
+
+        const int32 First = c * ChunkSize;
+        const int32 Last = FMath::Min(First + ChunkSize, Points.Num() - 1);
+        for (int32 i = First; i < Last; ++i)
+        {
+            const FVector3f Segment = Points[i + 1] - Points[i];
+            const float T = FMath::Clamp(((P - Points[i]) | Segment) / FMath::Max(Segment.SizeSquared(), UE_SMALL_NUMBER), 0.f, 1.f);
+            const float DistSq = FVector3f::DistSquared(P, Points[i] + Segment * T);
+            if (DistSq < OutDistSq)
+            {
+                OutDistSq = DistSq;
+                OutDistance = (i + T) * Spacing;
+                bFound = true;
+            }
+        }
+    }
+    return bFound;
+}
+
+URideRailComponent::URideRailComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void URideRailComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    Spline = GetOwner()->FindComponentByClass<USplineComponent>();
+    if (!Spline)
+    {
+        UE_LOG(LogParkourCharacter, Warning, TEXT("[Rail] %s has no spline to ride"), *GetOwner()->GetName());
+        return;
+    }
+
+    Table.Build(*Spline, SampleSpacing);
+
+    if (URideRailSubsystem* Rails = GetWorld()->GetSubsystem<URideRailSubsystem>())
+    {
+        Rails->RegisterRail(this);
+    }
+}
+
+void URideRailComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (URideRailSubsystem* Rails = GetWorld()->GetSubsystem<URideRailSubsystem>())
+    {
+        Rails->UnregisterRail(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+FTransform URideRailComponent::GetRailTransform() const
+{
+    return Spline ? Spline->GetComponentTransform() : FTransform::Identity;
+}
+
+FVector URideRailComponent::GetRiderOffset(float CapsuleHalfHeight) const
+{
+    return Type == ERideRailType::Zipline ? FVector(0.f, 0.f, -RiderOffset) : FVector(0.f, 0.f, RiderOffset + CapsuleHalfHeight);
+}
+
+void URideRailSubsystem::RegisterRail(URideRailComponent* Rail)
+{
+    Rails.AddUnique(Rail);
+}
+
+void URideRailSubsystem::UnregisterRail(URideRailComponent* Rail)
+{
+    Rails.RemoveSwap(Rail);
+}
+
+bool URideRailSubsystem::FindRail(const FVector& Location, float Radius, FRailAttachment& OutAttachment) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_RailFind);
+
+    float BestDistSq = TNumericLimits<float>::Max();
+    for (const TWeakObjectPtr<URideRailComponent>& WeakRail : Rails)
+    {
+        URideRailComponent* Rail = WeakRail.Get();
+        if (!Rail || !Rail->GetSpline() || !Rail->GetTable().IsValid()) continue;
+
+        const FBoxSphereBounds& Bounds = Rail->GetSpline()->Bounds;
+        if (FVector::DistSquared(Location, Bounds.Origin) > FMath::Square(Bounds.SphereRadius + Radius)) continue;
+
+        const FTransform ToWorld = Rail->GetRailTransform();
+        const float Scale = ToWorld.GetMaximumAxisScale();
+
+        float Distance, DistSq;
+        if (Rail->GetTable().FindNearest(ToWorld.InverseTransformPosition(Location), Radius / Scale, Distance, DistSq))
+        {
+            DistSq *= FMath::Square(Scale);
+            if (DistSq < BestDistSq)
+            {
+                BestDistSq = DistSq;
+                OutAttachment.Rail = Rail;
+                OutAttachment.Distance = Distance;
+            }
+        }
+    }
+    return BestDistSq < TNumericLimits<float>::Max();
+}
+
+namespace RideRail
+{
+    // A long winding rail, the worst case for a closest-point search
+    static USplineComponent* MakeBenchSpline(int32 NumPoints)
+    {
+        USplineComponent* Spline = NewObject<USplineComponent>(GetTransientPackage());
+        Spline->ClearSplinePoints(false);
+        for (int32 i = 0; i < NumPoints; ++i)
+        {
+            const float Angle = i * 0.4f;
+            Spline->AddSplinePoint(FVector(FMath::Cos(Angle) * (2000.f + i * 50.f), FMath::Sin(Angle) * (2000.f + i * 50.f), -i * 40.f), ESplineCoordinateSpace::Local, false);
+        }
+        Spline->UpdateSpline();
+        return Spline;
+    }
+
+    static void RunBench(int32 NumRiders, int32 NumFrames)
+    {
+        USplineComponent* Spline = MakeBenchSpline(64);
+
+        const double BuildStart = FPlatformTime::Seconds();
+        FRailArcTable Table;
+        Table.Build(*Spline, 25.f);
+        const double BuildMs = (FPlatformTime::Seconds() - BuildStart) * 1000.0;
+
+        TArray<float> Distances;
+        for (int32 r = 0; r < NumRiders; ++r)
+        {
+            Distances.Add(Table.Length * r / NumRiders);
+        }
+        const float Step = 1200.f / 60.f;
+        FVector Sink = FVector::ZeroVector;
+
+        // What riding costs from the table
+        TArray<float> Riders = Distances;
+        const double TableStart = FPlatformTime::Seconds();
+        for (int32 f = 0; f < NumFrames; ++f)
+        {
+            for (float& Distance : Riders)
+            {
+                FVector Point, Tangent;
+                Table.Sample(Distance, Point, Tangent);
+                Sink += Point + Tangent;
+                Distance = Table.ClampDistance(Distance + Step);
+            }
+        }
+        const double TableUs = (FPlatformTime::Seconds() - TableStart) * 1e6;
+
+        // Evaluating the spline by distance instead, its reparam search plus two curve evals
+        Riders = Distances;
+        const double SplineStart = FPlatformTime::Seconds();
+        for (int32 f = 0; f < NumFrames; ++f)
+        {
+            for (float& Distance : Riders)
+            {
+                Sink += Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local)
+                    + Spline->GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local);
+                Distance = FMath::Min(Distance + Step, Table.Length);
+            }
+        }
+        const double SplineUs = (FPlatformTime::Seconds() - SplineStart) * 1e6;
+
+        // And re-finding the rider on the spline each frame, fewer frames since it's slow
+        const int32 ClosestFrames = FMath::Max(1, NumFrames / 10);
+        Riders = Distances;
+        const double ClosestStart = FPlatformTime::Seconds();
+        for (int32 f = 0; f < ClosestFrames; ++f)
+        {
+            for (float& Distance : Riders)
+            {
+                const FVector Guess = Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local) + FVector(0.f, 0.f, 10.f);
+                Sink += Spline->FindLocationClosestToWorldLocation(Guess, ESplineCoordinateSpace::Local);
+                Distance = FMath::Min(Distance + Step, Table.Length);
+            }
+        }
+        const double ClosestUs = (FPlatformTime::Seconds() - ClosestStart) * 1e6;
+
+        const double Steps = double(NumRiders) * NumFrames;
+        UE_LOG(LogParkourCharacter, Log, TEXT("[RailBench] %.0f m rail, %d samples (%.1f KB) built in %.2f ms. %d riders x %d frames: table %.3f us/step (%.3f ms/frame), spline by distance %.3f us/step, closest point %.3f us/step (%.0f)"),
+            Table.Length / 100.f, Table.Points.Num(), Table.GetAllocatedSize() / 1024.0, BuildMs, NumRiders, NumFrames,
+            TableUs / Steps, TableUs / 1000.0 / NumFrames, SplineUs / Steps, ClosestUs / (double(NumRiders) * ClosestFrames), Sink.X);
+
+        Spline->MarkAsGarbage();
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs RailBenchCommand(
+        TEXT("Parkour.RailBench"),
+        TEXT("Steps riders along a long synthetic rail from the arc length table and from the spline, and logs the cost per step. Args: [Riders=64] [Frames=600]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                RunBench(
+                    Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 64,
+                    Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 600);
+            }));
+}
@@ -0,0 +1,280 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/TraversalMeshInfo.h"
+#include "KiwiJam2025.h"
+#include "Character/ParkourCharacter.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/HitResult.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Traversal Mesh Info Query"), STAT_TraversalMeshInfoQuery, STATGROUP_KiwiJam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traversal Mesh Info Builds"), STAT_TraversalMeshInfoBuilds, STATGROUP_KiwiJam);
+
+// Flatter than this counts as a top you can stand on, as the proxy generator's default
+static const float FlatTopMinUpDot = FMath::Cos(FMath::DegreesToRadians(10.f));
+
+// How far into the hit face the column and depth are measured from
+static constexpr float HitInset = 2.f;
+
+namespace TraversalMeshInfo
+{
+    static TMap<TObjectKey<UBodySetup>, TUniquePtr<FTraversalMeshInfo>>& GetCache()
+    {
+        static TMap<TObjectKey<UBodySetup>, TUniquePtr<FTraversalMeshInfo>> Cache;
+        return Cache;
+    }
+
+    static int32 BuildsSincePrune = 0;
+
+    // Body setups of unloaded meshes leave entries nothing can look up again
+    static void PruneStale()
+    {
+        for (auto It = GetCache().CreateIterator(); It; ++It)
+        {
+            if (!It->Key.ResolveObjectPtr())
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+}
+
+const FTraversalMeshInfo* FTraversalMeshInfo::FindForHit(const FHitResult& Hit, FTransform& OutToWorld)
+{
+    UPrimitiveComponent* Component = Hit.GetComponent();
+    if (!Component) return nullptr;
+
+    // Instances share the mesh's body setup, only the transform differs
+    const UInstancedStaticMeshComponent* Instanced = Cast<UInstancedStaticMeshComponent>(Component);
+    if (!Instanced || !Instanced->GetInstanceTransform(Hit.Item, OutToWorld, true))
+    {
+        OutToWorld = Component->GetComponentTransform();
+    }
+    return IsInGameThread() ? Get(Component->GetBodySetup()) : Find(Component->GetBodySetup());
+}
+
+const FTraversalMeshInfo* FTraversalMeshInfo::Find(const UBodySetup* BodySetup)
+{
+    const TUniquePtr<FTraversalMeshInfo>* Entry = BodySetup ? TraversalMeshInfo::GetCache().Find(BodySetup) : nullptr;
+    return Entry ? Entry->Get() : nullptr;
+}
+
+const FTraversalMeshInfo* FTraversalMeshInfo::Get(const UBodySetup* BodySetup)
+{
+    check(IsInGameThread());
+    if (!BodySetup) return nullptr;
+
+    TUniquePtr<FTraversalMeshInfo>& Entry = TraversalMeshInfo::GetCache().FindOrAdd(BodySetup);
+    if (!Entry)
+    {
+        Entry = MakeUnique<FTraversalMeshInfo>();
+        Entry->Build(*BodySetup);
+        INC_DWORD_STAT(STAT_TraversalMeshInfoBuilds);
+
+        if (++TraversalMeshInfo::BuildsSincePrune >= 64)
+        {
+            TraversalMeshInfo::BuildsSincePrune = 0;
+            const FTraversalMeshInfo* Built = Entry.Get();
+            TraversalMeshInfo::PruneStale();
+            return Built;
+        }
+    }
+    return Entry.Get();
+}
+
+void FTraversalMeshInfo::Invalidate(const UBodySetup* BodySetup)
+{
+    if (BodySetup)
+    {
+        TraversalMeshInfo::GetCache().Remove(BodySetup);
+    }
+}
+
+void FTraversalMeshInfo::Reset()
+{
+    TraversalMeshInfo::GetCache().Reset();
+}
+
+void FTraversalMeshInfo::Build(const UBodySetup& BodySetup)
+{
+    const FKAggregateGeom& Geom = BodySetup.AggGeom;
+    Boxes.Reserve(Geom.BoxElems.Num() + Geom.ConvexElems.Num() + Geom.SphereElems.Num() + Geom.SphylElems.Num());
+
+    auto AddBox = [this](const FVector& Center, const FQuat& Rotation, const FVector& Extent)
+        {
+            FShapeBox& Box = Boxes.AddDefaulted_GetRef();
+            Box.Center = Center;
+            Box.InvRotation = Rotation.Inverse();
+            Box.Extent = Extent.GetAbs();
+
+            const FVector Axes[3] = { Rotation.GetAxisX(), Rotation.GetAxisY(), Rotation.GetAxisZ() };
+            int32 UpAxis = 0;
+            for (int32 Axis = 1; Axis < 3; ++Axis)
+            {
+                if (FMath::Abs(Axes[Axis].Z) > FMath::Abs(Axes[UpAxis].Z)) UpAxis = Axis;
+            }
+            Box.UpAxis = Axes[UpAxis].Z < 0.f ? -Axes[UpAxis] : Axes[UpAxis];
+        };
+
+    for (const FKBoxElem& Elem : Geom.BoxElems)
+    {
+        AddBox(Elem.Center, Elem.Rotation.Quaternion(), FVector(Elem.X, Elem.Y, Elem.Z) * 0.5f);
+    }
+
+    // Hulls become their bounding box, like the proxy generator does
+    for (const FKConvexElem& Elem : Geom.ConvexElems)
+    {
+        if (!Elem.ElemBox.IsValid) continue;
+
+        const FTransform ElemTransform = Elem.GetTransform();
+        AddBox(ElemTransform.TransformPosition(Elem.ElemBox.GetCenter()), ElemTransform.GetRotation(), Elem.ElemBox.GetExtent());
+    }
+
+    for (const FKSphereElem& Elem : Geom.SphereElems)
+    {
+        AddBox(Elem.Center, FQuat::Identity, FVector(Elem.Radius));
+    }
+
+    for (const FKSphylElem& Elem : Geom.SphylElems)
+    {
+        AddBox(Elem.Center, Elem.Rotation.Quaternion(), FVector(Elem.Radius, Elem.Radius, Elem.Length * 0.5f + Elem.Radius));
+    }
+
+    // No simple collision, fall back to the mesh's bounds
+    if (Boxes.Num() == 0)
+    {
+        if (const UStaticMesh* Mesh = Cast<UStaticMesh>(BodySetup.GetOuter()))
+        {
+            const FBox Bounds = Mesh->GetBoundingBox();
+            AddBox(Bounds.GetCenter(), FQuat::Identity, Bounds.GetExtent());
+        }
+    }
+
+    Boxes.Shrink();
+}
+
+void FTraversalMeshInfo::GetIntervals(const FTransform& ToWorld, const FVector& Start, const FVector& End, FIntervalArray& OutIntervals) const
+{
+    // Segment fractions survive the affine map to body space, so scale and shear need no special case
+    const FVector LocalStart = ToWorld.InverseTransformPosition(Start);
+    const FVector LocalEnd = ToWorld.InverseTransformPosition(End);
+
+    for (int32 Index = 0; Index < Boxes.Num(); ++Index)
+    {
+        const FShapeBox& Box = Boxes[Index];
+        const FVector A = Box.InvRotation.RotateVector(LocalStart - Box.Center);
+        const FVector D = Box.InvRotation.RotateVector(LocalEnd - Box.Center) - A;
+
+        float Enter = 0.f;
+        float Exit = 1.f;
+        for (int32 Axis = 0; Axis < 3 && Enter <= Exit; ++Axis)
+        {
+            if (FMath::Abs(D[Axis]) < UE_SMALL_NUMBER)
+            {
+                if (FMath::Abs(A[Axis]) > Box.Extent[Axis]) Exit = -1.f;
+                continue;
+            }
+
+            const float InvD = 1.f / D[Axis];
+            float T0 = (-Box.Extent[Axis] - A[Axis]) * InvD;
+            float T1 = (Box.Extent[Axis] - A[Axis]) * InvD;
+            if (T0 > T1) Swap(T0, T1);
+            Enter = FMath::Max(Enter, T0);
+            Exit = FMath::Min(Exit, T1);
+        }
+
+        if (Enter <= Exit)
+        {
+            OutIntervals.Add({ Enter, Exit, Index });
+        }
+    }
+
+    OutIntervals.Sort([](const FInterval& A, const FInterval& B) { return A.Enter < B.Enter; });
+}
+
+float FTraversalMeshInfo::GetSolidRunEnd(const FIntervalArray& Intervals, float Tolerance, int32& OutLastBox)
+{
+    // Overlapping or touching boxes are one solid, e.g. a stack of steps in one mesh
+    float End = -1.f;
+    OutLastBox = INDEX_NONE;
+    for (const FInterval& Interval : Intervals)
+    {
+        if (Interval.Enter > FMath::Max(End, 0.f) + Tolerance) break;
+        if (Interval.Exit > End)
+        {
+            End = Interval.Exit;
+            OutLastBox = Interval.Box;
+        }
+    }
+    return End;
+}
+
+bool FTraversalMeshInfo::QueryObstacle(const FTransform& ToWorld, const FVector& ImpactPoint, const FVector& Forward, float MaxRise, float MaxDepth, float MaxVaultDepth, FTraversalObstacle& Out) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_TraversalMeshInfoQuery);
+
+    if (Boxes.Num() == 0 || MaxRise <= 0.f || MaxDepth <= 0.f) return false;
+
+    const FVector Inside = ImpactPoint + Forward * HitInset;
+    FIntervalArray Intervals;
+
+    // Straight up from just inside the face to where the solid stops
+    GetIntervals(ToWorld, Inside, Inside + FVector(0.f, 0.f, MaxRise), Intervals);
+    int32 TopBox = INDEX_NONE;
+    const float Rise = GetSolidRunEnd(Intervals, HitInset / MaxRise, TopBox);
+    if (Rise < 0.f || Rise >= 1.f) return false;
+
+    Out.TopZ = Inside.Z + Rise * MaxRise;
+    Out.bFlatTop = FMath::Abs(ToWorld.TransformVectorNoScale(Boxes[TopBox].UpAxis).Z) >= FlatTopMinUpDot;
+
+    // Across, just under the top
+    const FVector UnderTop(Inside.X, Inside.Y, Out.TopZ - HitInset);
+    Intervals.Reset();
+    GetIntervals(ToWorld, UnderTop, UnderTop + Forward * MaxDepth, Intervals);
+    int32 LastBox = INDEX_NONE;
+    const float Across = GetSolidRunEnd(Intervals, HitInset / MaxDepth, LastBox);
+    Out.Depth = Across < 0.f ? 0.f : Across >= 1.f ? MaxDepth : Across * MaxDepth + HitInset;
+
+    if (Out.Depth <= MaxVaultDepth)
+    {
+        Out.SurfaceType = EClimbableSurfaceType::Vaultable;
+    }
+    else
+    {
+        Out.SurfaceType = Out.bFlatTop ? EClimbableSurfaceType::Ledge : EClimbableSurfaceType::Wall;
+    }
+    return true;
+}
+
+bool FTraversalMeshInfo::IntersectsSegment(const FTransform& ToWorld, const FVector& Start, const FVector& End) const
+{
+    FIntervalArray Intervals;
+    GetIntervals(ToWorld, Start, End, Intervals);
+    return Intervals.Num() > 0;
+}
+
+namespace TraversalMeshInfo
+{
+    static FAutoConsoleCommand DumpCommand(
+        TEXT("Parkour.MeshInfo.Dump"),
+        TEXT("Logs the cached traversal shapes: entries, boxes and memory"),
+        FConsoleCommandDelegate::CreateLambda([]()
+            {
+                int32 NumBoxes = 0;
+                SIZE_T Bytes = GetCache().GetAllocatedSize();
+                for (const TPair<TObjectKey<UBodySetup>, TUniquePtr<FTraversalMeshInfo>>& Pair : GetCache())
+                {
+                    NumBoxes += Pair.Value->Boxes.Num();
+                    Bytes += sizeof(FTraversalMeshInfo) + Pair.Value->GetAllocatedSize();
+                }
+                UE_LOG(LogParkourCharacter, Log, TEXT("[MeshInfo] %d shapes, %d boxes, %.1f KB"), GetCache().Num(), NumBoxes, Bytes / 1024.0);
+            }));
+
+    static FAutoConsoleCommand ResetCommand(
+        TEXT("Parkour.MeshInfo.Reset"),
+        TEXT("Drops every cached traversal shape, e.g. after editing a mesh's simple collision"),
+        FConsoleCommandDelegate::CreateStatic(&FTraversalMeshInfo::Reset));
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/TraversalProxyComponent.h"
+#include "Engine/CollisionProfile.h"
+
+static const FName TraversalProxyProfileName(TEXT("TraversalProxy"));
+
+UTraversalProxyComponent::UTraversalProxyComponent(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+    // Traversal object type, ignored by every other channel
+    SetCollisionProfileName(TraversalProxyProfileName);
+    bCanEverAffectNavigation = false;
+}
+
+ECollisionChannel UTraversalProxyComponent::GetProxyObjectType()
+{
+    static const ECollisionChannel ObjectType = []()
+        {
+            FCollisionResponseTemplate Template;
+            if (UCollisionProfile::Get()->GetProfileTemplate(TraversalProxyProfileName, Template))
+            {
+                return Template.ObjectType;
+            }
+            UE_LOG(LogTemp, Warning, TEXT("No %s collision profile, traversal proxy queries will find nothing"), *TraversalProxyProfileName.ToString());
+            return ECC_MAX;
+        }();
+    return ObjectType;
+}
+
+void UTraversalProxyComponent::SplitLedgeBoxes(const TArray<FKBoxElem>& Boxes, const TArray<FKBoxElem>& Occluders, const FTraversalLedgeRules& Rules,
+    TArray<FKBoxElem>& OutLedge, TArray<FKBoxElem>& OutBlocking)
+{
+    const float MinUpDot = FMath::Cos(FMath::DegreesToRadians(Rules.MaxTopTiltDegrees));
+
+    // AABBs once, the headroom test compares every pair
+    TArray<FBox> OccluderBounds;
+    OccluderBounds.Reserve(Occluders.Num());
+    for (const FKBoxElem& Occluder : Occluders)
+    {
+        OccluderBounds.Add(Occluder.CalcAABB(FTransform::Identity, 1.f));
+    }
+
+    for (int32 i = 0; i < Boxes.Num(); ++i)
+    {
+        const FKBoxElem& Box = Boxes[i];
+        const FQuat Rotation = Box.Rotation.Quaternion();
+
+        // Whichever box axis points up gives the top face, the other two its size
+        const FVector Axes[3] = { Rotation.GetAxisX(), Rotation.GetAxisY(), Rotation.GetAxisZ() };
+        const float Sizes[3] = { Box.X, Box.Y, Box.Z };
+
+        int32 UpAxis = 0;
+        for (int32 Axis = 1; Axis < 3; ++Axis)
+        {
+            if (FMath::Abs(Axes[Axis].Z) > FMath::Abs(Axes[UpAxis].Z)) UpAxis = Axis;
+        }
+
+        const float TopDepth = FMath::Min(Sizes[(UpAxis + 1) % 3], Sizes[(UpAxis + 2) % 3]);
+        bool bLedge = FMath::Abs(Axes[UpAxis].Z) >= MinUpDot && TopDepth >= Rules.MinTopDepth;
+
+        if (bLedge)
+        {
+            const FBox Bounds = Box.CalcAABB(FTransform::Identity, 1.f);
+            const float TopZ = Bounds.Max.Z;
+            const FBox2D TopArea(FVector2D(Bounds.Min), FVector2D(Bounds.Max));
+
+            for (int32 j = 0; j < OccluderBounds.Num() && bLedge; ++j)
+            {
+                // Something starting just above the top, over the same area, leaves no room to climb onto it.
+                // A box never starts above its own top, so Boxes may be passed in Occluders too.
+                const FBox& Other = OccluderBounds[j];
+                const FBox2D OtherArea(FVector2D(Other.Min), FVector2D(Other.Max));
+                const bool bAbove = Other.Min.Z >= TopZ - 1.f && Other.Min.Z < TopZ + Rules.MinHeadroom;
+                if (bAbove && TopArea.Intersect(OtherArea))
+                {
+                    bLedge = false;
+                }
+            }
+        }
+
+        (bLedge ? OutLedge : OutBlocking).Add(Box);
+    }
+}
@@ -0,0 +1,250 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/TraversalProxyGenerator.h"
+#include "Character/ParkourCharacter.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "PhysicsEngine/BodySetup.h"
+
+ATraversalProxyGenerator::ATraversalProxyGenerator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+
+	SourceMeshFolders.Add({ TEXT("/Game/LevelPrototyping") });
+}
+
+int32 ATraversalProxyGenerator::GetNumProxyBoxes() const
+{
+    int32 NumBoxes = 0;
+    for (const UTraversalProxyComponent* Proxy : ProxyComponents)
+    {
+        NumBoxes += Proxy ? Proxy->GetNumBoxes() : 0;
+    }
+    return NumBoxes;
+}
+
+#if WITH_EDITOR
+bool ATraversalProxyGenerator::IsSource(const AStaticMeshActor* Actor) const
+{
+    const UStaticMeshComponent* MeshComp = Actor->GetStaticMeshComponent();
+    const UStaticMesh* Mesh = MeshComp ? MeshComp->GetStaticMesh() : nullptr;
+    if (!Mesh || !MeshComp->IsCollisionEnabled()) return false;
+
+    if (!SourceTag.IsNone() && Actor->ActorHasTag(SourceTag)) return true;
+
+    const FString MeshPath = Mesh->GetPathName();
+    for (const FDirectoryPath& Folder : SourceMeshFolders)
+    {
+        if (!Folder.Path.IsEmpty() && MeshPath.StartsWith(Folder.Path / TEXT("")))
+            return true;
+    }
+    return false;
+}
+
+void ATraversalProxyGenerator::GatherBoxes(const AStaticMeshActor* Actor, TArray<FKBoxElem>& OutBoxes) const
+{
+    const UStaticMeshComponent* MeshComp = Actor->GetStaticMeshComponent();
+    const UStaticMesh* Mesh = MeshComp->GetStaticMesh();
+    const FTransform& MeshToWorld = MeshComp->GetComponentTransform();
+    const FVector Scale = MeshToWorld.GetScale3D().GetAbs();
+
+    auto AddWorldBox = [&](const FTransform& ElemToMesh, const FVector& Size)
+        {
+            const FTransform ElemToWorld = ElemToMesh * MeshToWorld;
+            FKBoxElem& Box = OutBoxes.Emplace_GetRef(Size.X * Scale.X, Size.Y * Scale.Y, Size.Z * Scale.Z);
+            Box.Center = ElemToWorld.GetLocation();
+            Box.Rotation = ElemToWorld.Rotator();
+        };
+
+    const UBodySetup* BodySetup = Mesh->GetBodySetup();
+    const int32 NumBefore = OutBoxes.Num();
+
+    if (BodySetup)
+    {
+        for (const FKBoxElem& Elem : BodySetup->AggGeom.BoxElems)
+        {
+            AddWorldBox(Elem.GetTransform(), FVector(Elem.X, Elem.Y, Elem.Z));
+        }
+
+        // Hulls become their bounding box, close enough for ledges and walls
+        for (const FKConvexElem& Elem : BodySetup->AggGeom.ConvexElems)
+        {
+            const FBox& ElemBox = Elem.ElemBox;
+            if (!ElemBox.IsValid) continue;
+
+            const FTransform ElemTransform = Elem.GetTransform();
+            AddWorldBox(FTransform(ElemTransform.GetRotation(), ElemTransform.TransformPosition(ElemBox.GetCenter())), ElemBox.GetSize());
+        }
+    }
+
+    // No simple collision, fall back to the render bounds
+    if (OutBoxes.Num() == NumBefore)
+    {
+        const FBox Bounds = Mesh->GetBoundingBox();
+        AddWorldBox(FTransform(Bounds.GetCenter()), Bounds.GetSize());
+    }
+}
+
+void ATraversalProxyGenerator::AddProxy(TArray<FKBoxElem>&& WorldBoxes, bool bLedgeCapable)
+{
+    if (WorldBoxes.Num() == 0) return;
+
+    // Boxes are stored relative to this actor
+    const FTransform WorldToLocal = GetActorTransform().Inverse();
+    for (FKBoxElem& Box : WorldBoxes)
+    {
+        const FTransform Local = FTransform(Box.Rotation, Box.Center) * WorldToLocal;
+        Box.Center = Local.GetLocation();
+        Box.Rotation = Local.Rotator();
+    }
+
+    UTraversalProxyComponent* Proxy = NewObject<UTraversalProxyComponent>(this, NAME_None, RF_Transactional);
+    Proxy->CreationMethod = EComponentCreationMethod::Instance;
+    Proxy->SetupAttachment(RootComponent);
+    Proxy->SetMobility(EComponentMobility::Static);
+    Proxy->SetLedgeCapable(bLedgeCapable);
+    Proxy->SetBoxes(MoveTemp(WorldBoxes));
+    AddInstanceComponent(Proxy);
+    Proxy->RegisterComponent();
+    ProxyComponents.Add(Proxy);
+}
+
+void ATraversalProxyGenerator::GenerateProxies()
+{
+    Modify();
+    ClearProxies();
+
+    FTraversalLedgeRules Rules;
+    Rules.MinTopDepth = MinTopDepth;
+    Rules.MinHeadroom = MinHeadroom;
+    Rules.MaxTopTiltDegrees = MaxTopTiltDegrees;
+
+    // Whole level at once so a mesh stacked on another covers its ledge
+    TArray<const AStaticMeshActor*> Sources;
+    TArray<FKBoxElem> AllBoxes;
+    TArray<int32> BoxOwner;
+    for (TActorIterator<AStaticMeshActor> It(GetWorld()); It; ++It)
+    {
+        if (!IsSource(*It)) continue;
+
+        const int32 First = AllBoxes.Num();
+        GatherBoxes(*It, AllBoxes);
+        for (int32 i = First; i < AllBoxes.Num(); ++i)
+        {
+            BoxOwner.Add(Sources.Num());
+        }
+        Sources.Add(*It);
+    }
+
+    // One ledge and one blocking proxy per source actor keeps hit component bounds local to that mesh
+    for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+    {
+        TArray<FKBoxElem> Ledge, Blocking;
+        TArray<FKBoxElem> Candidates;
+        for (int32 i = 0; i < AllBoxes.Num(); ++i)
+        {
+            if (BoxOwner[i] == SourceIndex) Candidates.Add(AllBoxes[i]);
+        }
+
+        UTraversalProxyComponent::SplitLedgeBoxes(Candidates, AllBoxes, Rules, Ledge, Blocking);
+        AddProxy(MoveTemp(Ledge), true);
+        AddProxy(MoveTemp(Blocking), false);
+    }
+
+    UE_LOG(LogParkourCharacter, Log, TEXT("%s: %d source meshes -> %d proxy components, %d boxes"),
+        *GetName(), Sources.Num(), ProxyComponents.Num(), GetNumProxyBoxes());
+}
+
+void ATraversalProxyGenerator::ClearProxies()
+{
+    Modify();
+    for (UTraversalProxyComponent* Proxy : ProxyComponents)
+    {
+        if (Proxy)
+        {
+            RemoveInstanceComponent(Proxy);
+            Proxy->DestroyComponent();
+        }
+    }
+    ProxyComponents.Reset();
+}
+#endif
+
+namespace TraversalTraceCost
+{
+    // Detector-shaped traces (forward, then down onto a top) at random spots, against the
+    // full Visibility scene and against the traversal proxy object type only
+    static void Run(UWorld* World, int32 NumTraces)
+    {
+        const ECollisionChannel ProxyObjectType = UTraversalProxyComponent::GetProxyObjectType();
+        if (ProxyObjectType == ECC_MAX) return;
+
+        FBox Area(ForceInit);
+        for (TObjectIterator<UTraversalProxyComponent> It; It; ++It)
+        {
+            if (It->GetWorld() == World && It->IsRegistered()) Area += It->Bounds.GetBox();
+        }
+        if (!Area.IsValid)
+        {
+            UE_LOG(LogParkourCharacter, Warning, TEXT("[TraceCost] No traversal proxies in the world, generate them first"));
+            return;
+        }
+
+        FRandomStream Random(1234);
+        TArray<TPair<FVector, FVector>> Segments;
+        Segments.Reserve(NumTraces);
+        for (int32 i = 0; i < NumTraces; ++i)
+        {
+            const FVector Start = Random.RandPointInBox(Area);
+            const bool bDown = (i & 1) != 0;
+            const FVector Dir = bDown ? FVector(0.f, 0.f, -100.f) : FVector(Random.VRand().GetSafeNormal2D() * 150.f);
+            Segments.Emplace(Start, Start + Dir);
+        }
+
+        FCollisionQueryParams Params(SCENE_QUERY_STAT(TraversalTraceCost));
+        FHitResult Hit;
+
+        auto Time = [&](TFunctionRef<bool(const FVector&, const FVector&)> Trace, int32& OutHits)
+            {
+                OutHits = 0;
+                const uint64 Start = FPlatformTime::Cycles64();
+                for (const TPair<FVector, FVector>& Segment : Segments)
+                {
+                    OutHits += Trace(Segment.Key, Segment.Value) ? 1 : 0;
+                }
+                return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Start) * 1000.0 / FMath::Max(1, Segments.Num());
+            };
+
+        int32 VisibilityHits = 0, ProxyHits = 0;
+        const double VisibilityUs = Time([&](const FVector& A, const FVector& B)
+            {
+                return World->LineTraceSingleByChannel(Hit, A, B, ECC_Visibility, Params);
+            }, VisibilityHits);
+        const double ProxyUs = Time([&](const FVector& A, const FVector& B)
+            {
+                return World->LineTraceSingleByObjectType(Hit, A, B, FCollisionObjectQueryParams(ProxyObjectType), Params);
+            }, ProxyHits);
+
+        UE_LOG(LogParkourCharacter, Log, TEXT("[TraceCost] %d traces  Visibility %.3f us/trace (%d hits)  Traversal proxies %.3f us/trace (%d hits)  %.2fx"),
+            Segments.Num(), VisibilityUs, VisibilityHits, ProxyUs, ProxyHits, ProxyUs > 0.0 ? VisibilityUs / ProxyUs : 0.0);
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs TraceCostCommand(
+        TEXT("Parkour.TraversalTraceCost"),
+        TEXT("Times detector-shaped line traces against Visibility vs the Traversal proxy channel. Args: [Traces=20000]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+            {
+                if (World)
+                {
+                    Run(World, Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 20000);
+                }
+            }));
+}
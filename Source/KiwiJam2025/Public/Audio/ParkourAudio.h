@@ -0,0 +1,178 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "Core/ParkourEventBus.h"
+#include "ParkourAudio.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+class USoundAttenuation;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourAudio, Log, All);
+
+UENUM()
+enum class EParkourAudioEvent : uint8
+{
+	Vault,
+	Climb,
+	LedgeGrab,
+	Land,
+	WeaponFire,
+
+	Count UMETA(Hidden)
+};
+
+UENUM()
+enum class EParkourAudioCategory : uint8
+{
+	Traversal,
+	Weapon,
+
+	Count UMETA(Hidden)
+};
+
+USTRUCT()
+struct FParkourAudioEventDef
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	EParkourAudioEvent Event = EParkourAudioEvent::Vault;
+
+	UPROPERTY(EditAnywhere)
+	EParkourAudioCategory Category = EParkourAudioCategory::Traversal;
+
+	// Played when the surface has no entry below
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<USoundBase> DefaultSound;
+
+	UPROPERTY(EditAnywhere)
+	TMap<TEnumAsByte<EPhysicalSurface>, TObjectPtr<USoundBase>> SurfaceSounds;
+
+	// Further from the listener than this it isn't started at all
+	UPROPERTY(EditAnywhere)
+	float MaxDistance = 3000.f;
+
+	UPROPERTY(EditAnywhere)
+	float VolumeMultiplier = 1.f;
+
+	// Random pitch either side of 1, so repeats don't sound identical
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0", ClampMax = "0.5"))
+	float PitchVariance = 0.05f;
+};
+
+USTRUCT()
+struct FParkourAudioCategoryDef
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere)
+	EParkourAudioCategory Category = EParkourAudioCategory::Traversal;
+
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "1"))
+	int32 MaxVoices = 6;
+
+	// At the limit: cut the oldest voice of the category, or drop the new sound
+	UPROPERTY(EditAnywhere)
+	bool bStealOldest = true;
+};
+
+/** Sounds for gameplay events, set in DefaultGame.ini on UParkourAudioSubsystem */
+UCLASS(BlueprintType)
+class KIWIJAM2025_API UParkourAudioData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UParkourAudioData();
+
+	UPROPERTY(EditAnywhere, Category = "Audio")
+	TArray<FParkourAudioEventDef> Events;
+
+	// One entry per category
+	UPROPERTY(EditAnywhere, EditFixedSize, Category = "Audio")
+	TArray<FParkourAudioCategoryDef> Categories;
+
+	// Audio components created up front, the hard cap on voices from this layer
+	UPROPERTY(EditAnywhere, Category = "Audio", meta = (ClampMin = "1", ClampMax = "128"))
+	int32 PoolSize = 24;
+
+	// For sounds without their own attenuation
+	UPROPERTY(EditAnywhere, Category = "Audio")
+	TObjectPtr<USoundAttenuation> DefaultAttenuation;
+};
+
+/**
+ * Plays gameplay event sounds through a fixed pool of audio components created when the
+ * audio data loads. A play is rejected before touching the pool when it's out of range of
+ * the listener, then held to its category's voice limit. Nothing here creates components
+ * after startup. Not created on dedicated servers.
+ */
+UCLASS(Config = Game)
+class KIWIJAM2025_API UParkourAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Picks the event's sound for Surface and plays it at Location. FallbackSound is used
+	 * when the data has nothing for the event. Returns false if nothing was started.
+	 */
+	bool PlayEvent(EParkourAudioEvent Event, const FVector& Location, EPhysicalSurface Surface = SurfaceType_Default, USoundBase* FallbackSound = nullptr);
+
+	// Convenience for callers without a cached pointer
+	static bool Play(const UWorld* World, EParkourAudioEvent Event, const FVector& Location, EPhysicalSurface Surface = SurfaceType_Default, USoundBase* FallbackSound = nullptr);
+
+	bool IsReady() const { return Pool.Num() > 0; }
+	int32 GetPoolSize() const { return Pool.Num(); }
+
+	// Voices still playing right now, per category or all of them
+	int32 GetActiveVoices(EParkourAudioCategory Category = EParkourAudioCategory::Count) const;
+
+private:
+	void OnAudioDataLoaded();
+
+	// Traversal sounds come off the event bus at the end of the frame
+	void HandleVaults(TConstArrayView<FParkourVaultEvent> Batch);
+	void HandleClimbs(TConstArrayView<FParkourClimbEvent> Batch);
+	void HandleLandings(TConstArrayView<FParkourLandedEvent> Batch);
+
+	FDelegateHandle VaultHandle;
+	FDelegateHandle ClimbHandle;
+	FDelegateHandle LandedHandle;
+
+	struct FVoice
+	{
+		double StartTime = 0.0;
+		double EndTime = 0.0;
+		EParkourAudioCategory Category = EParkourAudioCategory::Traversal;
+	};
+
+	UPROPERTY(Config)
+	TSoftObjectPtr<UParkourAudioData> AudioData;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UParkourAudioData> LoadedAudioData;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> Pool;
+
+	// Parallel to Pool
+	TArray<FVoice> Voices;
+
+	// Event to its index in the loaded data's Events, INDEX_NONE where there is none
+	int32 EventDefIndex[(int32)EParkourAudioEvent::Count];
+	FParkourAudioCategoryDef CategoryDefs[(int32)EParkourAudioCategory::Count];
+
+	FRandomStream PitchRandom;
+};
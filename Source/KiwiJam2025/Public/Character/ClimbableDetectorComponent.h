@@ -4,8 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Chaos/ChaosEngineInterface.h"
 #include "ClimbableDetectorComponent.generated.h"
 
+class UPrimitiveComponent;
 
 UENUM(BlueprintType)
 enum class EClimbableSurfaceType : uint8
@@ -16,7 +18,8 @@ enum class EClimbableSurfaceType : uint8
 	Wall,
 	Climbable,
 	WallRunLeft,
-	WallRunRight
+	WallRunRight,
+	Rail
 };
 
 USTRUCT(BlueprintType)
@@ -45,11 +48,101 @@ struct FClimbableSurfaceResult
 	UPROPERTY(BlueprintReadOnly)
 	AActor* HitActor = nullptr;
 
+	// Component that was hit, traversal follows it if it can move
 	UPROPERTY(BlueprintReadOnly)
+	UPrimitiveComponent* HitComponent = nullptr;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bHeadBlocked = false;
+
+	// Physical surface of the hit face, picks the traversal sounds
+	UPROPERTY(BlueprintReadOnly)
+	TEnumAsByte<EPhysicalSurface> PhysicalSurface = SurfaceType_Default;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTraversalAffordanceChanged, EClimbableSurfaceType, Affordance);
+
+/** Detector traces, in the order the affordance scanner runs them */
+enum class EAffordanceProbe : uint8
+{
+	VaultForward,
+	VaultLanding,
+	Head,
+	ClimbForward,
+	LedgeTop,
+	Count
+};
+
+/** One scan cycle in progress. Every probe in a cycle uses the pose captured at its start. */
+struct FAffordanceScanState
+{
+	EAffordanceProbe Probe = EAffordanceProbe::VaultForward;
+
+	FVector Origin = FVector::ZeroVector;
+	FVector Forward = FVector::ForwardVector;
+	double StartTime = 0.0;
+
+	FHitResult VaultHit;
+	float VaultHeight = 0.f;
+	bool bVaultObstacle = false;
+	bool bVault = false;
+
+	FHitResult ForwardHit;
+	FVector LedgeTop = FVector::ZeroVector;
 	bool bHeadBlocked = false;
+	bool bForwardHit = false;
+	bool bLedge = false;
+};
+
+/**
+ * Ledge edge extracted once on grab, as a polyline with cumulative arc length.
+ * Shimmying walks this instead of tracing every tick.
+ */
+struct FLedgeCache
+{
+	// Top edge points, wall out-normals (horizontal) and distance along the edge
+	TArray<FVector> Points;
+	TArray<FVector> Normals;
+	TArray<float> Distances;
+
+	// An end we already tried to extend and found the ledge stops (0 = start, 1 = end)
+	bool bEndClosed[2] = { false, false };
+
+	void Reset();
+
+	bool IsValid() const { return Points.Num() >= 2; }
+
+	float GetLength() const { return Distances.Num() > 0 ? Distances.Last() : 0.f; }
+
+	void Sample(float Distance, FVector& OutPoint, FVector& OutNormal) const;
+
+	void RebuildDistances();
+};
+
+/** The detector's reach limits and trace setup, for offline tools that must follow the same rules */
+struct FTraversalReachLimits
+{
+	// Heights are measured from the actor location (capsule centre), as the detector does
+	float MinLedgeHeight = 0.f;
+	float MaxLedgeHeight = 0.f;
+	float VaultObstacleHeightMin = 0.f;
+	float VaultObstacleHeightMax = 0.f;
+
+	float ForwardTraceDistance = 0.f;
+	float VerticalTraceHeight = 0.f;
+	float UpTraceHeight = 0.f;
+	float VaultForwardTraceDistance = 0.f;
+	float VaultObstacleDistance = 0.f;
+
+	bool bUseTraversalChannel = false;
+	ECollisionChannel TraversalObjectType = ECC_MAX;
+	ECollisionChannel TraceChannel = ECC_Visibility;
 };
 
 //class ACharacter;
+class UTraversalTelemetrySubsystem;
+struct FRailAttachment;
+enum class ETraversalTelemetryEvent : uint8;
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class KIWIJAM2025_API UClimbableDetectorComponent : public UActorComponent
@@ -62,10 +155,56 @@ public:
 
 	void SetOwnerCharacter(ACharacter* Character);
 
+	// Only the actor transform is used, so non-character pawns can share the detector
+	void SetOwnerActor(AActor* Actor);
+
 	bool DetectClimbableSurface(FClimbableSurfaceResult& OutResult);
 
 	bool CheckVaultSurface(FClimbableSurfaceResult& OutInfo);
 
+	// Traces out the ledge either side of a grab point. Runs once per grab.
+	bool ExtractLedge(const FVector& LedgePoint, const FVector& SurfaceForward, FLedgeCache& OutCache) const;
+
+	// Appends samples past one end of the cache (bAtEnd false = start). Returns false if the ledge stops there.
+	bool ExtendLedge(FLedgeCache& Cache, bool bAtEnd) const;
+
+	FTraversalReachLimits GetReachLimits() const;
+
+	// See bUseTraversalChannel
+	void SetUseTraversalChannel(bool bEnable) { bUseTraversalChannel = bEnable; }
+
+	// Start and end of each probe from the limits alone, so offline tools trace exactly what the
+	// detector does. Anchor is the inset forward hit for LedgeTop and the vault hit for
+	// VaultLanding, unused otherwise.
+	static void GetProbeSegment(const FTraversalReachLimits& Limits, EAffordanceProbe Probe, const FVector& Origin, const FVector& Forward,
+		const FVector& Anchor, FVector& OutStart, FVector& OutEnd);
+
+	/**
+	 * World Z of the top of the obstacle at a vault hit, from the hit shape's cached boxes or
+	 * its bounds. bOutRejected is set when the cached shape alone shows the vault can't work
+	 * (not vaultable, or the shape itself blocks the landing). Otherwise the landing probe
+	 * still has to be traced: the cache only knows this one shape.
+	 */
+	static float GetVaultObstacleTopZ(const FTraversalReachLimits& Limits, const FVector& Origin, const FHitResult& Hit, const FVector& Forward,
+		bool& bOutRejected);
+
+	// Nearest zipline or grind rail in grab reach. A lookup in the rail subsystem, no traces.
+	bool DetectRail(FRailAttachment& OutRail) const;
+
+	// What a jump would do right now according to the continuous scan
+	UFUNCTION(BlueprintPure, Category = "Affordance")
+	EClimbableSurfaceType GetCurrentAffordance() const { return CurrentAffordance; }
+
+	/**
+	 * Hands the latest scan result to a jump if it still matches where the owner stands and
+	 * faces (bIsValid false means nothing is in reach). Returns false when the scan is stale
+	 * or off, and the caller should run the synchronous checks instead.
+	 */
+	bool ConsumeAffordance(FClimbableSurfaceResult& OutResult) const;
+
+	UPROPERTY(BlueprintAssignable, Category = "Affordance")
+	FOnTraversalAffordanceChanged OnAffordanceChanged;
+
 protected:
 	UPROPERTY(EditAnywhere, Category = "Climb")
 	float ForwardTraceDistance = 150.f;
@@ -88,7 +227,12 @@ protected:
 	UPROPERTY(EditAnywhere)
 	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
 
-	TObjectPtr<ACharacter> OwnerCharacter;
+	// Query only traversal proxies (the TraversalProxy profile's object type) instead of
+	// TraceChannel. Only for maps that have had proxies generated, everything else is missed.
+	UPROPERTY(EditAnywhere, Category = "Collision")
+	bool bUseTraversalChannel = false;
+
+	TObjectPtr<AActor> OwnerActor;
 
 	UPROPERTY(EditAnywhere, Category = "Vault")
 	float VaultForwardTraceDistance = 150.f;
@@ -102,15 +246,87 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Vault")
 	float VaultObstacleDistance = 100.f;
 
+	// Spacing of ledge samples when building the shimmy cache
+	UPROPERTY(EditAnywhere, Category = "Ledge")
+	float LedgeSampleSpacing = 25.f;
+
+	// Samples traced per side on grab and per extension
+	UPROPERTY(EditAnywhere, Category = "Ledge")
+	int32 LedgeSamplesPerSide = 8;
+
+	// How far from the capsule centre a rail can be grabbed
+	UPROPERTY(EditAnywhere, Category = "Rail")
+	float RailGrabRadius = 150.f;
+
+	// Keep probing every frame for the HUD prompt and so jumps can skip their own traces
+	UPROPERTY(EditAnywhere, Category = "Affordance")
+	bool bContinuousScan = true;
+
+	// Rays the scanner may spend per frame; probes that a cycle skips cost nothing
+	UPROPERTY(EditAnywhere, Category = "Affordance", meta = (ClampMin = "1", ClampMax = "5"))
+	int32 MaxScanTracesPerFrame = 1;
+
+	// A jump only reuses a scan started within this many seconds...
+	UPROPERTY(EditAnywhere, Category = "Affordance")
+	float MaxAffordanceAge = 0.25f;
+
+	// ...from no further away than this...
+	UPROPERTY(EditAnywhere, Category = "Affordance")
+	float MaxAffordanceDrift = 50.f;
+
+	// ...and facing within this angle of the scan
+	UPROPERTY(EditAnywhere, Category = "Affordance")
+	float MaxAffordanceTurnDegrees = 20.f;
+
 public:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
 private:
 	bool TraceForward(FHitResult& OutHit);
 	bool TraceLedgeTop(const FVector& ForwardHitLocation, FVector& OutLedgeLocation);
 	bool TraceHead(FHitResult& OutHit);
 
+	// Finds the ledge edge point and wall normal near a guess. Two traces.
+	bool TraceLedgeSample(const FVector& GuessPoint, const FVector& GuessNormal, FVector& OutPoint, FVector& OutNormal) const;
+
 	void DrawDebugBoxAtPoint(UWorld* World, const FVector& Point, const FColor& Color, float Size = 10.f);
 
+	void RecordProbe(ETraversalTelemetryEvent Type) const;
+
+	// Every detector trace goes through here so the channel choice is in one place
+	bool TraceLine(FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params) const;
+
+	// The static probe helpers with this detector's limits, shared by the jump checks and the scanner
+	void GetProbeSegment(EAffordanceProbe Probe, const FVector& Origin, const FVector& Forward, const FVector& Anchor, FVector& OutStart, FVector& OutEnd) const;
+
+	// Proxies only let you grab tops the generator marked as ledges
+	bool IsLedgeTopHit(const FHitResult& Hit) const;
+
+	float GetVaultObstacleTopZ(const FHitResult& Hit, const FVector& Forward, bool& bOutRejected) const;
+
+	bool ShouldScan() const;
+
+	// Runs the current probe, or skips it if the cycle no longer needs it. Returns true if it traced.
+	bool StepScan();
+
+	void FinishScan();
+
+	void SetAffordance(EClimbableSurfaceType Affordance);
+
+	FAffordanceScanState Scan;
+
+	// Last finished cycle
+	FClimbableSurfaceResult ScanResult;
+	FVector ScanOrigin = FVector::ZeroVector;
+	FVector ScanForward = FVector::ForwardVector;
+	double ScanTime = -1.0;
+
+	EClimbableSurfaceType CurrentAffordance = EClimbableSurfaceType::None;
+
+	// Null when telemetry is off
+	UPROPERTY(Transient)
+	TObjectPtr<UTraversalTelemetrySubsystem> Telemetry;
 };
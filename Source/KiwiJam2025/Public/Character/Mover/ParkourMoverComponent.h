@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DefaultMovementSet/CharacterMoverComponent.h"
+#include "Character/ClimbableDetectorComponent.h"
+#include "Character/Mover/ParkourMoverTypes.h"
+#include <atomic>
+
+#include "ParkourMoverComponent.generated.h"
+
+class AParkourCharacter;
+class UTraversalActionData;
+
+/**
+ * Mover-based counterpart of UParkourMovementComponent. Climb and vault run as Mover modes
+ * against the same compiled traversal table. When async physics is enabled in
+ * the project settings the simulation ticks on the physics thread; otherwise it runs on the
+ * game thread through the prediction backend. UParkourMovementComponent stays the default.
+ */
+UCLASS()
+class KIWIJAM2025_API UParkourMoverComponent : public UCharacterMoverComponent
+{
+	GENERATED_BODY()
+
+public:
+	UParkourMoverComponent();
+
+	virtual void BeginPlay() override;
+
+	// Queues a mode start for the next input cmd. Detection stays on the game thread.
+	bool RequestTraversal(FName ModeName, const FClimbableSurfaceResult& Surface);
+
+	// Called by the input producer, hands over and clears any queued start
+	bool ConsumePendingTraversal(FParkourTraversalInputs& OutInputs);
+
+	bool IsTraversing() const;
+
+	// Safe from the simulation thread, null until the actions have loaded
+	const FTraversalActionTable* GetTraversalTable() const { return Table.load(std::memory_order_acquire); }
+
+	// For tools and the backend comparison, which run before async loads would land
+	void LoadTraversalActionsBlocking();
+
+	static bool UsesAsyncPhysics();
+
+private:
+	// Movement defaults of TraversalSource, if it has loaded
+	const UParkourMovementComponent* GetSourceMovement() const;
+
+	void GatherTraversalPaths(TArray<FSoftObjectPath>& OutPaths) const;
+	void LoadTraversalAssets();
+	void ResolveTraversalActions();
+
+	// Overrides the source's actions. When both are unset, climb and vault are built from the
+	// source's legacy tuning, the same way UParkourMovementComponent does.
+	UPROPERTY(EditAnywhere, Category = "Parkour")
+	TSoftObjectPtr<UTraversalActionData> TraversalActions;
+
+	// Character whose movement settings this pawn traverses with
+	UPROPERTY(EditAnywhere, Category = "Parkour")
+	TSoftClassPtr<AParkourCharacter> TraversalSource;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UTraversalActionData> LoadedTraversalActions;
+
+	// Keeps the source class and the curves the fallback table points into alive
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UObject>> LoadedTraversalAssets;
+
+	FTraversalActionTable FallbackTable;
+
+	// Written once on the game thread, read by the simulation
+	std::atomic<const FTraversalActionTable*> Table { nullptr };
+
+	FParkourTraversalInputs PendingTraversal;
+};
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MovementMode.h"
+#include "MovementModeTransition.h"
+
+#include "ParkourMoverModes.generated.h"
+
+/**
+ * Runs one action from the shared traversal table (climb, vault, ...). Stateless: progress
+ * lives in FParkourTraversalSyncState, so it can tick on the physics thread and resimulate.
+ * Paths are authored, so the move is kinematic with no sweeps.
+ */
+UCLASS()
+class KIWIJAM2025_API UParkourTraversalMode : public UBaseMovementMode
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GenerateMove_Implementation(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const override;
+	virtual void SimulationTick_Implementation(const FSimulationTickParams& Params, FMoverTickEndData& OutputState) override;
+
+	// Action in the traversal table this mode runs
+	UPROPERTY(EditAnywhere, Category = "Parkour")
+	FName ActionName;
+};
+
+/**
+ * Global transition into whichever parkour mode the input cmd asked for this frame.
+ */
+UCLASS()
+class KIWIJAM2025_API UParkourTraversalStartTransition : public UBaseMovementModeTransition
+{
+	GENERATED_BODY()
+
+public:
+	virtual FTransitionEvalResult Evaluate_Implementation(const FSimulationTickParams& Params) const override;
+};
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Pawn.h"
+#include "MoverSimulationTypes.h"
+
+#include "ParkourMoverPawn.generated.h"
+
+class UCapsuleComponent;
+class UCameraComponent;
+class UInputAction;
+class UInputMappingContext;
+class UClimbableDetectorComponent;
+class UParkourMoverComponent;
+struct FInputActionValue;
+
+/**
+ * First person pawn on the Mover backend, for comparing against AParkourCharacter.
+ * Input is gathered on the game thread and handed to the simulation as input cmds.
+ */
+UCLASS()
+class KIWIJAM2025_API AParkourMoverPawn : public APawn, public IMoverInputProducerInterface
+{
+	GENERATED_BODY()
+
+public:
+	AParkourMoverPawn();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual void NotifyControllerChanged() override;
+	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
+
+	// Runs the same vault/climb checks as AParkourCharacter::BeginJump
+	void TryTraversal();
+
+	UParkourMoverComponent* GetParkourMover() const { return MoverComponent; }
+
+protected:
+	virtual void ProduceInput_Implementation(int32 SimTimeMs, FMoverInputCmdContext& InputCmdResult) override;
+
+	void Move(const FInputActionValue& Value);
+	void Look(const FInputActionValue& Value);
+	void BeginJump(const FInputActionValue& Value);
+	void EndJump(const FInputActionValue& Value);
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = Collision)
+	TObjectPtr<UCapsuleComponent> CapsuleComponent;
+
+	UPROPERTY(VisibleAnywhere, Category = Camera)
+	TObjectPtr<UCameraComponent> FirstPersonCameraComponent;
+
+	UPROPERTY(VisibleAnywhere, Category = Movement)
+	TObjectPtr<UParkourMoverComponent> MoverComponent;
+
+	UPROPERTY(VisibleAnywhere, Category = Movement)
+	TObjectPtr<UClimbableDetectorComponent> ClimbableDetectorComponent;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	TObjectPtr<UInputMappingContext> DefaultMappingContext;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	TObjectPtr<UInputAction> JumpAction;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	TObjectPtr<UInputAction> MoveAction;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	TObjectPtr<UInputAction> LookAction;
+
+	FVector2D CachedMoveInput = FVector2D::ZeroVector;
+	bool bJumpPressed = false;
+	bool bJumpJustPressed = false;
+};
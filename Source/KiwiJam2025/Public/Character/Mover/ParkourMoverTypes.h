@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MoverTypes.h"
+#include "Character/TraversalActionData.h"
+
+#include "ParkourMoverTypes.generated.h"
+
+namespace ParkourModeNames
+{
+	// Mode names double as traversal action names
+	inline const FName Climb = TEXT("Climb");
+	inline const FName Vault = TEXT("Vault");
+}
+
+/**
+ * Traversal start request, carried in the input cmd so a resimulated frame starts
+ * the same move from the same surface without re-running detection.
+ */
+USTRUCT()
+struct KIWIJAM2025_API FParkourTraversalInputs : public FMoverDataStructBase
+{
+	GENERATED_BODY()
+
+	// Mode to enter this frame, None for no request
+	UPROPERTY()
+	FName ModeName;
+
+	UPROPERTY()
+	FVector SurfacePoint = FVector::ZeroVector;
+
+	// Into the surface
+	UPROPERTY()
+	FVector SurfaceForward = FVector::ForwardVector;
+
+	UPROPERTY()
+	float SurfaceHeight = 0.f;
+
+	bool HasRequest() const { return !ModeName.IsNone(); }
+
+	virtual UScriptStruct* GetScriptStruct() const override { return StaticStruct(); }
+	virtual FMoverDataStructBase* Clone() const override { return new FParkourTraversalInputs(*this); }
+	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+	virtual void ToString(FAnsiStringBuilderBase& Out) const override;
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override {}
+};
+
+template<>
+struct TStructOpsTypeTraits<FParkourTraversalInputs> : public TStructOpsTypeTraitsBase2<FParkourTraversalInputs>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true
+	};
+};
+
+/**
+ * Everything a running traversal needs between frames. The modes themselves hold no
+ * state, so rolling back this struct rolls back the move.
+ */
+USTRUCT()
+struct KIWIJAM2025_API FParkourTraversalSyncState : public FMoverDataStructBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 ActionIndex = INDEX_NONE;
+
+	UPROPERTY()
+	int32 PhaseIndex = 0;
+
+	UPROPERTY()
+	float PhaseElapsed = 0.f;
+
+	UPROPERTY()
+	FVector SurfacePoint = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector SurfaceForward = FVector::ForwardVector;
+
+	UPROPERTY()
+	float SurfaceHeight = 0.f;
+
+	UPROPERTY()
+	FVector PhaseStart = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector EntryVelocity = FVector::ZeroVector;
+
+	bool IsActive() const { return ActionIndex != INDEX_NONE; }
+
+	FTraversalRunState ToRunState() const;
+	void FromRunState(const FTraversalRunState& State);
+
+	virtual UScriptStruct* GetScriptStruct() const override { return StaticStruct(); }
+	virtual FMoverDataStructBase* Clone() const override { return new FParkourTraversalSyncState(*this); }
+	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+	virtual void ToString(FAnsiStringBuilderBase& Out) const override;
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override {}
+	virtual bool ShouldReconcile(const FMoverDataStructBase& AuthorityState) const override;
+	virtual void Interpolate(const FMoverDataStructBase& From, const FMoverDataStructBase& To, float Pct) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FParkourTraversalSyncState> : public TStructOpsTypeTraitsBase2<FParkourTraversalSyncState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true
+	};
+};
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "Character/ParkourMovementComponent.h"
+#include "ParkourArmsAnimInstance.generated.h"
+
+class UAnimSequence;
+class UParkourArmsAnimInstance;
+
+UENUM()
+enum class EParkourArmsPose : uint8
+{
+	None,
+	Grab,
+	VaultPlant,
+	PullUp,
+
+	Count UMETA(Hidden)
+};
+
+/**
+ * Everything the arms need, owned by the anim instance. PreUpdate copies the movement
+ * state on the game thread; Update and Evaluate only touch the copy and run on anim workers.
+ */
+USTRUCT()
+struct FParkourArmsAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FParkourArmsAnimInstanceProxy() = default;
+	FParkourArmsAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+	virtual void Initialize(UAnimInstance* InAnimInstance) override;
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+	virtual bool Evaluate(FPoseContext& Output) override;
+
+private:
+	friend class UParkourArmsAnimInstance;
+
+	static constexpr int32 NumPoses = (int32)EParkourArmsPose::Count;
+
+	EParkourArmsPose GetTargetPose() const;
+
+	// Copied from the instance at Initialize, the assets are kept alive by its properties
+	const UAnimSequence* IdleSequence = nullptr;
+	const UAnimSequence* MoveSequence = nullptr;
+	const UAnimSequence* PoseSequences[NumPoses] = {};
+	TMap<FName, EParkourArmsPose> PhasePoses;
+	float MoveBlendSpeed = 600.f;
+	float BlendInTime = 0.1f;
+	float BlendOutTime = 0.15f;
+	float VaultPlantRelease = 0.6f;
+
+	// Game thread side
+	TWeakObjectPtr<const UParkourMovementComponent> Movement;
+
+	// Written in PreUpdate, read on the worker
+	FParkourArmsState State;
+
+	// Worker side
+	float PoseWeights[NumPoses] = {};
+	float PoseTimes[NumPoses] = {};
+	float MoveAlpha = 0.f;
+	float MoveTime = 0.f;
+	float IdleTime = 0.f;
+};
+
+/**
+ * Native first-person arms. Blends locomotion with grab, vault-plant and pull-up poses from
+ * the parkour movement state, entirely in the proxy so update and evaluation stay on
+ * animation worker threads. Set it (or a data-only child with the sequences filled in) as
+ * the arms mesh's anim class; there is no graph or event graph to run.
+ */
+UCLASS(Transient, Blueprintable)
+class KIWIJAM2025_API UParkourArmsAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	UParkourArmsAnimInstance();
+
+	// Current blend weight of a traversal pose, for debugging and BP children
+	UFUNCTION(BlueprintPure, Category = "Parkour Arms", meta = (BlueprintThreadSafe))
+	float GetPoseWeight(EParkourArmsPose Pose) const;
+
+protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Locomotion")
+	TObjectPtr<UAnimSequence> IdleSequence;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Locomotion")
+	TObjectPtr<UAnimSequence> MoveSequence;
+
+	// Ground speed at which the move sequence fully replaces idle
+	UPROPERTY(EditDefaultsOnly, Category = "Locomotion")
+	float MoveBlendSpeed = 600.f;
+
+	// Played across the phase they're mapped to, so a clip follows the move's progress
+	UPROPERTY(EditDefaultsOnly, Category = "Traversal")
+	TObjectPtr<UAnimSequence> GrabSequence;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Traversal")
+	TObjectPtr<UAnimSequence> VaultPlantSequence;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Traversal")
+	TObjectPtr<UAnimSequence> PullUpSequence;
+
+	// Traversal action phase names and the pose each one shows. Hanging always grabs.
+	UPROPERTY(EditDefaultsOnly, Category = "Traversal")
+	TMap<FName, EParkourArmsPose> PhasePoses;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Traversal")
+	float BlendInTime = 0.1f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Traversal")
+	float BlendOutTime = 0.15f;
+
+	// Fraction of the vault the planted hand stays down for
+	UPROPERTY(EditDefaultsOnly, Category = "Traversal", meta = (ClampMin = "0", ClampMax = "1"))
+	float VaultPlantRelease = 0.6f;
+
+private:
+	friend struct FParkourArmsAnimInstanceProxy;
+};
@@ -6,6 +6,7 @@
 #include "GameFramework/Character.h"
 #include "ParkourMovementComponent.h"
 #include "Logging/LogMacros.h"
+#include "Server/ParkourBotDriver.h"
 
 #include "ParkourCharacter.generated.h"
 
@@ -16,8 +17,8 @@ class UCameraComponent;
 class UInputAction;
 class UInputMappingContext;
 struct FInputActionValue;
-class UWorldMapWidget;
-class UUserWidget;
+class UInputReplaySubsystem;
+enum class EReplayInput : uint8;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogParkourCharacter, Log, All);
 
@@ -55,19 +56,21 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
 	class UInputAction* LookAction;
 
+	/** Crouch/Slide Input Action */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
+	UInputAction* SlideAction;
+
 	/** Map Input Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
 	UInputAction* MapAction;
 
-	// Reference to the world map widget class (set in Blueprint)
-	UPROPERTY(EditAnywhere, Category = "UI")
-	TSubclassOf<UWorldMapWidget> WorldMapWidgetClass;
-
-	// Instance of the widget
-	UPROPERTY()
-	UWorldMapWidget* WorldMapWidget;
+	// World map widget class (set in Blueprint), streamed in at BeginPlay. The HUD module creates it.
+	UPROPERTY(EditAnywhere, Category = "UI", meta = (AllowedClasses = "/Script/KiwiJam2025UI.WorldMapWidget"))
+	TSoftClassPtr<UObject> WorldMapWidgetClass;
 
-	bool bMapOpen = false;
+	// Vault/climb prompt driven by the detector's affordance scan, created by the HUD module
+	UPROPERTY(EditAnywhere, Category = "UI", meta = (AllowedClasses = "/Script/KiwiJam2025UI.TraversalPromptWidget"))
+	TSoftClassPtr<UObject> TraversalPromptWidgetClass;
 
 	/** Climb detection comp */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
@@ -75,10 +78,19 @@ private:
 
 	FRotator AdditionalCameraRotation;
 
+	// Handlers report their input here for recording
+	UPROPERTY(Transient)
+	TObjectPtr<UInputReplaySubsystem> InputRecorder;
+
+	// Steers the local pawn on clients started with -ParkourBotClient
+	TOptional<FParkourBotDriver> BotDriver;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void Landed(const FHitResult& Hit) override;
+
 protected:
 	/** Called for movement input */
 	void Move(const FInputActionValue& Value);
@@ -88,6 +100,12 @@ protected:
 
 	void BeginJump(const FInputActionValue& Value);
 
+	void EndJump(const FInputActionValue& Value);
+
+	void BeginSlide(const FInputActionValue& Value);
+
+	void EndSlide(const FInputActionValue& Value);
+
 	void SetCameraRotation();
 
 	void ToggleMap(const FInputActionValue& Value);
@@ -104,10 +122,19 @@ public:
 
 	void AddCameraRotation(FRotator Rotation);
 
+	// What the jump input does: pull up, vault, climb or hang if something is in reach, else jump
+	void TryTraverse();
+
+	// Runs an input handler as if Enhanced Input had fired it, for input replay
+	void ApplyReplayInput(EReplayInput Input, const FVector2D& Value);
+
 		/** Returns Mesh1P subobject **/
 	USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
 	/** Returns FirstPersonCameraComponent subobject **/
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
 
-	UWorldMapWidget* GetWorldMapWidget();
+	UClimbableDetectorComponent* GetClimbableDetector() const { return ClimbableDetectorComponent; }
+
+	const TSoftClassPtr<UObject>& GetWorldMapWidgetClass() const { return WorldMapWidgetClass; }
+	const TSoftClassPtr<UObject>& GetTraversalPromptWidgetClass() const { return TraversalPromptWidgetClass; }
 };
@@ -5,17 +5,37 @@
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Character/ClimbableDetectorComponent.h"
+#include "Character/TraversalActionData.h"
+#include "World/RideRailComponent.h"
 
 #include "ParkourMovementComponent.generated.h"
 
+class UCurveFloat;
+class UCurveVector;
+class UTraversalTelemetrySubsystem;
+class UParkourEventBus;
 
-UENUM()
-enum class EClimbPhase : uint8
+enum class EParkourArmsAction : uint8
 {
-    None,
-    Approach,
-    Grab,
-    PullUp
+	None,
+	Climb,
+	Vault,
+	Hang
+};
+
+// What the first-person arms animate from, copied out on the game thread once per anim update
+struct FParkourArmsState
+{
+	EParkourArmsAction Action = EParkourArmsAction::None;
+
+	// Current phase of the traversal action and how far through it, and through the whole action
+	FName PhaseName;
+	float PhaseAlpha = 0.f;
+	float ActionAlpha = 0.f;
+
+	float Speed = 0.f;
+	bool bFalling = false;
+	bool bSliding = false;
 };
 
 /**
@@ -33,11 +53,15 @@ public:
         MOVE_Climb = MOVE_Custom + 0,
         MOVE_WallRun = MOVE_Custom + 1,
         MOVE_Vault = MOVE_Custom + 2,
+        MOVE_Hang = MOVE_Custom + 3,
+        MOVE_Rail = MOVE_Custom + 4,
         // etc.
     };
 
     UParkourMovementComponent();
 
+    virtual void BeginPlay() override;
+
     virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
     virtual void PhysCustom(float deltaTime, int32 Iterations) override;
@@ -46,34 +70,82 @@ public:
 
     void BeginVault(const FClimbableSurfaceResult& Surface);
 
+    // Starts any action in the traversal table by name, CustomMode is the movement mode to run it under
+    bool BeginTraversal(FName ActionName, const FClimbableSurfaceResult& Surface, uint8 CustomMode);
+
+    bool IsTraversing() const { return TraversalState.IsActive(); }
+
+    // Ledge hang / shimmy
+    bool ShouldHang(const FClimbableSurfaceResult& Surface) const;
+    bool BeginHang(const FClimbableSurfaceResult& Surface);
+    void PullUpFromHang();
+    void DropFromHang();
+    bool IsHanging() const { return MovementMode == MOVE_Custom && CustomMovementMode == MOVE_Hang; }
+
+    // Zipline / grind rail, attached where the detector found it
+    bool BeginRail(const FRailAttachment& Attachment);
+    void JumpOffRail();
+    bool IsOnRail() const { return MovementMode == MOVE_Custom && CustomMovementMode == MOVE_Rail; }
+
+    // Slide: held input, starts once grounded and fast enough, chains through vaults
+    void SetWantsToSlide(bool bWants);
+    bool IsSliding() const { return bIsSliding; }
+
+    virtual float GetMaxSpeed() const override;
+    virtual void CalcVelocity(float DeltaTime, float Friction, bool bFluid, float BrakingDeceleration) override;
+    virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+
+    // Velocity handed back to walking once a vault ends
+    const FVector& GetPendingPostVaultVelocity() const { return PendingPostVaultVelocity; }
+
+    // For tools and the traversal harness, which run before async loads would land
+    void LoadTraversalCurvesBlocking();
+
+    const FTraversalActionTable* GetTraversalTable() const { return ActiveTable; }
+
+    // The action asset and legacy curves the table comes from, for the Mover backend to load
+    const TSoftObjectPtr<UTraversalActionData>& GetTraversalActionsAsset() const { return TraversalActions; }
+    void GetTraversalCurvePaths(TArray<FSoftObjectPath>& OutPaths) const;
+
+    // Builds climb/vault from the legacy properties and whichever curves are loaded
+    void BuildDefaultTraversalTable(FTraversalActionTable& OutTable) const;
+
+    FName GetClimbActionName() const { return ClimbActionName; }
+    FName GetVaultActionName() const { return VaultActionName; }
+    const FTraversalRunState& GetTraversalState() const { return TraversalState; }
+
+    // Game thread only, the arms anim proxy calls this from PreUpdate
+    void GetArmsState(FParkourArmsState& OutState) const;
+
 protected:
-    void PhysClimb(float deltaTime, int32 Iterations);
+    void PhysTraversal(float deltaTime, int32 Iterations);
     void PhysWallRun(float deltaTime, int32 Iterations);
-    void PhysVault(float deltaTime, int32 Iterations);
+    void PhysHang(float deltaTime, int32 Iterations);
+    void PhysRail(float deltaTime, int32 Iterations);
+
+    // Leaves the rail at its current speed along it, plus ExtraVelocity
+    void DetachFromRail(const FVector& ExtraVelocity);
 
+    void EndTraversal();
 
 private:
 
     UPROPERTY(EditAnywhere, Category = "Debug")
     bool bDebugDraw = true;
 
-    FVector ClimbStartLocation;
-    FVector ClimbMidLocation;     // ledge grab point
-    FVector ClimbTargetLocation;  // over-the-top location
-    FRotator DesiredClimbFacingRotation;
-
-    float ClimbDuration = 0.5f;
-    float ClimbElapsed = 0.f;
-    bool bClimbActive = false;
+    // Moves as data. When unset, climb and vault are built from the legacy tuning below.
+    UPROPERTY(EditAnywhere, Category = "Parkour")
+    TSoftObjectPtr<UTraversalActionData> TraversalActions;
 
-    float ClimbStartPitch = 0.f;
+    UPROPERTY(EditAnywhere, Category = "Parkour")
+    FName ClimbActionName = TEXT("Climb");
 
-
-    EClimbPhase ClimbPhase = EClimbPhase::None;
+    UPROPERTY(EditAnywhere, Category = "Parkour")
+    FName VaultActionName = TEXT("Vault");
 
     // Curve for climb progress
-    UPROPERTY(EditAnywhere, Category = "Parkour|Climb") 
-    UCurveFloat* ClimbProgressCurve = nullptr; 
+    UPROPERTY(EditAnywhere, Category = "Parkour|Climb")
+    TSoftObjectPtr<UCurveFloat> ClimbProgressCurve;
 
 
     UPROPERTY(EditAnywhere, Category = "Parkour|Climb")
@@ -90,7 +162,7 @@ private:
 
     // Configurable asset
     UPROPERTY(EditAnywhere, Category = "Parkour|Vault")
-    UCurveVector* VaultCurve;
+    TSoftObjectPtr<UCurveVector> VaultCurve;
 
     // Configurable asset
     UPROPERTY(EditAnywhere, Category = "Parkour|Vault")
@@ -108,27 +180,128 @@ private:
 
     // Curve for climb progress
     UPROPERTY(EditAnywhere, Category = "Parkour|Vault")
-    UCurveFloat* VaultCameraTiltCurve = nullptr;
+    TSoftObjectPtr<UCurveFloat> VaultCameraTiltCurve;
 
     // Configurable asset
     UPROPERTY(EditAnywhere, Category = "Parkour|Vault")
     float MaxCameraTilt = 15.f;
 
-    // Internal state
-    FVector VaultStart;
-    FVector VaultTarget;
-    FVector VaultDirection;
-    FVector VaultMomentum;
-    FVector VaultMomentumVelocity;
-    float VaultHeight = 0.f;
-    float VaultElapsed = 0.f;
-    float VaultDuration = 0.f;
-    bool bVaulting = false;
+    // Resolved curves, filled once the soft refs above are loaded
+    UPROPERTY(Transient)
+    TObjectPtr<UCurveFloat> LoadedClimbProgressCurve;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UCurveVector> LoadedVaultCurve;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UCurveFloat> LoadedVaultCameraTiltCurve;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UTraversalActionData> LoadedTraversalActions;
+
+    void ResolveTraversalCurves();
+
+    // Curves or the action asset arrived mid-move; the table is rebuilt once the move ends
+    bool bTableRebuildPending = false;
+    void ResolvePendingTraversalTable();
+
+    // Used when no action asset is set
+    FTraversalActionTable DefaultTable;
+
+    // Either the asset's shared table or DefaultTable
+    const FTraversalActionTable* ActiveTable = nullptr;
+
+    FTraversalRunState TraversalState;
+    FRotator DesiredFacingRotation;
+
+    // Where the traversal base was as of the last step: its location and yaw, so a tilted
+    // or scaled mesh doesn't bend the move. Identity on static geometry.
+    FTransform TraversalBaseFrame;
+
+    // Follows the base to where it is now; keeps the last frame if it was destroyed
+    void UpdateTraversalBaseFrame();
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Hang")
+    bool bEnableLedgeHang = true;
+
+    // Ledges at least this high are grabbed and held instead of climbed straight away
+    UPROPERTY(EditAnywhere, Category = "Parkour|Hang")
+    float HangMinLedgeHeight = 100.f;
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Hang")
+    float ShimmySpeed = 150.f;
+
+    // Hanging position relative to the ledge edge: out from the wall, and down
+    UPROPERTY(EditAnywhere, Category = "Parkour|Hang")
+    float HangWallOffset = 50.f;
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Hang")
+    float HangHeightOffset = -40.f;
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Hang")
+    float HangEnterTime = 0.2f;
+
+    // Cached ledge, only retraced when shimmying off an end
+    FLedgeCache LedgeCache;
+    float LedgeDistance = 0.f;
+    float HangEnterAlpha = 1.f;
+    FVector HangEnterStart = FVector::ZeroVector;
+
+    TWeakObjectPtr<UClimbableDetectorComponent> LedgeDetector;
+
+    // Blend from where the grab happened onto the rail
+    UPROPERTY(EditAnywhere, Category = "Parkour|Rail")
+    float RailEnterTime = 0.15f;
+
+    // Can't grab a rail again this soon after leaving one, so jumping off doesn't re-catch it
+    UPROPERTY(EditAnywhere, Category = "Parkour|Rail")
+    float RailRegrabDelay = 0.4f;
+
+    FRailAttachment RailAttachment;
+    float RailSpeed = 0.f;
+    float RailEnterAlpha = 1.f;
+    FVector RailEnterStart = FVector::ZeroVector;
+    FVector RailTangent = FVector::ForwardVector;
+    double RailLeftTime = -1.0;
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Slide")
+    float SlideMinStartSpeed = 350.f;
+
+    // Slide ends below this on the ground
+    UPROPERTY(EditAnywhere, Category = "Parkour|Slide")
+    float SlideMinSpeed = 150.f;
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Slide")
+    float SlideMaxSpeed = 1400.f;
+
+    // Added when a slide starts, up to SlideMaxSpeed. Once per slide input: vaults chained mid-slide don't boost again.
+    UPROPERTY(EditAnywhere, Category = "Parkour|Slide")
+    float SlideEnterBoost = 150.f;
+
+    // How much of gravity along the floor slope accelerates the slide
+    UPROPERTY(EditAnywhere, Category = "Parkour|Slide")
+    float SlideGravityScale = 1.f;
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Slide")
+    float SlideFriction = 250.f;
+
+    UPROPERTY(EditAnywhere, Category = "Parkour|Slide")
+    float SlideSteerAcceleration = 400.f;
+
+    bool CanStartSlide() const;
+
+    bool bWantsToSlide = false;
+    bool bIsSliding = false;
+    bool bSlideBoostSpent = false;
 
     FVector PendingPostVaultVelocity = FVector::ZeroVector;
-    bool bShouldApplyPostVaultVelocity = false;
 
-    FRotator CameraTiltTarget;
-    float CurrentVaultTilt;
-    float CameraTiltInterpSpeed = 6.0f;
+    float CurrentVaultTilt = 0.f;
+
+    // Null when telemetry is off
+    UPROPERTY(Transient)
+    TObjectPtr<UTraversalTelemetrySubsystem> Telemetry;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UParkourEventBus> Events;
 };
@@ -0,0 +1,222 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TraversalActionData.generated.h"
+
+class UCurveFloat;
+class UCurveVector;
+class UPrimitiveComponent;
+struct FRichCurve;
+
+UENUM()
+enum class ETraversalPathMode : uint8
+{
+	// Lerp from the phase start to TargetOffset, shaped by AlphaCurve
+	Lerp,
+	// PathCurve (forward/right/up) scaled by PathScale, added to the phase start plus TargetOffset
+	CurveOffset
+};
+
+UENUM()
+enum class ETraversalCameraPolicy : uint8
+{
+	None,
+	// Turn to face the surface and pitch to CameraPitch
+	FaceSurface,
+	// Only pitch to CameraPitch
+	Pitch
+};
+
+/** One phase of a move. Offsets are in the surface frame: X into the surface, Y right, Z up. */
+USTRUCT()
+struct FTraversalPhaseDef
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FName Name;
+
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.01"))
+	float Duration = 0.25f;
+
+	UPROPERTY(EditAnywhere)
+	ETraversalPathMode PathMode = ETraversalPathMode::Lerp;
+
+	// Lerp: target relative to the surface point. CurveOffset: constant bias added to the curve.
+	UPROPERTY(EditAnywhere)
+	FVector TargetOffset = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "PathMode == ETraversalPathMode::Lerp"))
+	TObjectPtr<UCurveFloat> AlphaCurve;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "PathMode == ETraversalPathMode::CurveOffset"))
+	TObjectPtr<UCurveVector> PathCurve;
+
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "PathMode == ETraversalPathMode::CurveOffset"))
+	FVector PathScale = FVector::OneVector;
+
+	// Use the detected surface height instead of PathScale.Z
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "PathMode == ETraversalPathMode::CurveOffset"))
+	bool bScalePathZBySurfaceHeight = false;
+
+	UPROPERTY(EditAnywhere)
+	bool bDisableCollision = true;
+
+	UPROPERTY(EditAnywhere)
+	ETraversalCameraPolicy CameraPolicy = ETraversalCameraPolicy::None;
+
+	UPROPERTY(EditAnywhere)
+	float CameraPitch = 0.f;
+
+	UPROPERTY(EditAnywhere)
+	float CameraInterpSpeed = 6.f;
+
+	// Turn speed towards the surface, FaceSurface only
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "CameraPolicy == ETraversalCameraPolicy::FaceSurface"))
+	float CameraYawInterpSpeed = 8.f;
+
+	// Camera roll over the phase, scaled by MaxCameraRoll
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UCurveFloat> CameraRollCurve;
+
+	UPROPERTY(EditAnywhere)
+	float MaxCameraRoll = 0.f;
+};
+
+USTRUCT()
+struct FTraversalActionDef
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FName Name;
+
+	UPROPERTY(EditAnywhere)
+	TArray<FTraversalPhaseDef> Phases;
+
+	// Hand the velocity we entered with back to walking at the end
+	UPROPERTY(EditAnywhere)
+	bool bCarryEntryVelocity = false;
+
+	// Extra exit speed along the surface forward
+	UPROPERTY(EditAnywhere)
+	float ExitForwardSpeed = 0.f;
+};
+
+/** Flattened phase, everything the runner needs with no UObject hops */
+struct FTraversalCompiledPhase
+{
+	// Kept for presentation (arms poses, debug), the runner never looks at it
+	FName Name;
+
+	float Duration = 0.f;
+	float InvDuration = 0.f;
+	FVector3f TargetOffset = FVector3f::ZeroVector;
+	FVector3f PathScale = FVector3f::OneVector;
+	float CameraPitch = 0.f;
+	float CameraInterpSpeed = 0.f;
+	float CameraYawInterpSpeed = 0.f;
+	float MaxCameraRoll = 0.f;
+
+	const FRichCurve* AlphaCurve = nullptr;
+	const FRichCurve* PathCurve[3] = { nullptr, nullptr, nullptr };
+	const FRichCurve* CameraRollCurve = nullptr;
+
+	ETraversalPathMode PathMode = ETraversalPathMode::Lerp;
+	ETraversalCameraPolicy CameraPolicy = ETraversalCameraPolicy::None;
+	bool bDisableCollision = true;
+	bool bScalePathZBySurfaceHeight = false;
+};
+
+struct FTraversalCompiledAction
+{
+	FName Name;
+	int32 FirstPhase = 0;
+	int32 NumPhases = 0;
+	float ExitForwardSpeed = 0.f;
+	bool bCarryEntryVelocity = false;
+};
+
+/** Per-character progress through an action in a table */
+struct FTraversalRunState
+{
+	int32 ActionIndex = INDEX_NONE;
+	int32 PhaseIndex = 0;
+	float PhaseElapsed = 0.f;
+
+	// Surface frame the offsets are relative to
+	FVector SurfacePoint = FVector::ZeroVector;
+	FVector SurfaceForward = FVector::ForwardVector;
+	float SurfaceHeight = 0.f;
+
+	FVector PhaseStart = FVector::ZeroVector;
+	FVector EntryVelocity = FVector::ZeroVector;
+
+	// Set when the surface can move. SurfacePoint, SurfaceForward and PhaseStart are then relative
+	// to it, as is what Evaluate writes, and the caller maps them to world space each step.
+	TWeakObjectPtr<UPrimitiveComponent> Base;
+
+	bool IsActive() const { return ActionIndex != INDEX_NONE; }
+
+	bool HasBase() const { return !Base.IsExplicitlyNull(); }
+};
+
+/**
+ * All phases of all actions packed into one contiguous array. Built once at load
+ * and shared by every character using the asset.
+ */
+struct KIWIJAM2025_API FTraversalActionTable
+{
+	TArray<FTraversalCompiledPhase> Phases;
+	TArray<FTraversalCompiledAction> Actions;
+
+	void Reset();
+
+	// Returns the action index
+	int32 Compile(const FTraversalActionDef& Def);
+
+	int32 FindAction(FName Name) const;
+
+	// Sum of the action's phase durations, 0 for a bad index
+	float GetActionDuration(int32 ActionIndex) const;
+
+	// World-space location of a run at Alpha through the given phase
+	FVector EvaluatePhase(const FTraversalCompiledPhase& Phase, const FTraversalRunState& State, float Alpha) const;
+
+	/**
+	 * Advances a run by DeltaTime and writes where the character should be.
+	 * Steps across phase boundaries; returns false once the action has finished.
+	 */
+	bool Evaluate(FTraversalRunState& State, float DeltaTime, FVector& OutLocation) const;
+
+	const FTraversalCompiledPhase* GetCurrentPhase(const FTraversalRunState& State) const;
+};
+
+/**
+ * Data-driven traversal moves (climb, vault, ...). Each action is a list of timed phases.
+ */
+UCLASS(BlueprintType)
+class KIWIJAM2025_API UTraversalActionData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	const FTraversalActionTable& GetTable() const { return Table; }
+
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	TArray<FTraversalActionDef> Actions;
+
+private:
+	void CompileTable();
+
+	FTraversalActionTable Table;
+};
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MapLoadTimer.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMapLoad, Log, All);
+
+/**
+ * Stamps the start of every map transition so the game mode can log how long the
+ * load took, up to the pawn class and the first frame after it.
+ */
+UCLASS()
+class KIWIJAM2025_API UMapLoadTimer : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FPlatformTime seconds when the current map started loading
+	double GetLoadStartTime() const { return LoadStartTime; }
+
+	// Milliseconds since the current map started loading
+	double GetMsSinceLoadStart() const { return (FPlatformTime::Seconds() - LoadStartTime) * 1000.0; }
+
+private:
+	void HandlePreLoadMap(const FString& MapName);
+
+	double LoadStartTime = 0.0;
+
+	FDelegateHandle PreLoadMapHandle;
+};
@@ -0,0 +1,295 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/World.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "Tasks/Pipe.h"
+#include "ParkourEventBus.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourEvents, Log, All);
+
+enum class EParkourEventType : uint8
+{
+	GoalReached,
+	Vault,
+	Climb,
+	Landed,
+
+	Count
+};
+
+/** Where in the world tick subscribers get their batch */
+enum class EParkourEventPhase : uint8
+{
+	// Before actors tick, with everything published since the last FrameStart. Gameplay reacting to last frame.
+	FrameStart,
+	// After actors and tickables, with everything published this frame. UI and audio.
+	FrameEnd,
+
+	Count
+};
+
+// Events are plain copyable structs. Actor references are weak so background consumers can hold them.
+
+struct FParkourGoalReachedEvent
+{
+	static constexpr EParkourEventType Type = EParkourEventType::GoalReached;
+
+	FGuid GoalId;
+	FVector3f Location = FVector3f::ZeroVector;
+
+	// Seconds from level start
+	float Split = 0.f;
+
+	TWeakObjectPtr<APawn> Racer;
+	TWeakObjectPtr<AActor> Goal;
+};
+
+struct FParkourVaultEvent
+{
+	static constexpr EParkourEventType Type = EParkourEventType::Vault;
+
+	FVector3f Location = FVector3f::ZeroVector;
+	float Height = 0.f;
+	float Speed = 0.f;
+	TEnumAsByte<EPhysicalSurface> Surface = SurfaceType_Default;
+	TWeakObjectPtr<APawn> Pawn;
+};
+
+struct FParkourClimbEvent
+{
+	static constexpr EParkourEventType Type = EParkourEventType::Climb;
+
+	FVector3f Location = FVector3f::ZeroVector;
+	float Height = 0.f;
+
+	// Grabbed and holding the ledge rather than climbing straight over
+	bool bHang = false;
+	TEnumAsByte<EPhysicalSurface> Surface = SurfaceType_Default;
+	TWeakObjectPtr<APawn> Pawn;
+};
+
+struct FParkourLandedEvent
+{
+	static constexpr EParkourEventType Type = EParkourEventType::Landed;
+
+	FVector3f Location = FVector3f::ZeroVector;
+	float FallSpeed = 0.f;
+	TEnumAsByte<EPhysicalSurface> Surface = SurfaceType_Default;
+	TWeakObjectPtr<APawn> Pawn;
+};
+
+class FParkourEventChannelBase
+{
+public:
+	virtual ~FParkourEventChannelBase() = default;
+
+	virtual void Dispatch(EParkourEventPhase Phase, UE::Tasks::FPipe* Pipe) = 0;
+
+	// Blocks until no background batch of this channel is in flight
+	virtual void WaitForBackground() = 0;
+};
+
+/**
+ * One event type's queue. Publishing appends to an array reserved up front that is reset,
+ * never freed, between frames, so it stops allocating once it has seen the busiest frame.
+ * Each phase keeps its own read cursor and gets everything past it as one contiguous batch.
+ */
+template<typename EventType>
+class TParkourEventChannel final : public FParkourEventChannelBase
+{
+public:
+	using FBatch = TConstArrayView<EventType>;
+	using FSubscribers = TMulticastDelegate<void(FBatch)>;
+
+	explicit TParkourEventChannel(int32 Capacity)
+	{
+		Pending.Reserve(Capacity);
+		Deferred.Reserve(Capacity);
+		for (TArray<EventType>& Buffer : BackgroundBuffers)
+		{
+			Buffer.Reserve(Capacity);
+		}
+	}
+
+	virtual ~TParkourEventChannel() override
+	{
+		WaitForBackground();
+	}
+
+	FORCEINLINE void Publish(const EventType& Event)
+	{
+		// A subscriber publishing the type it's reading would move the batch under it
+		(bDispatching ? Deferred : Pending).Add(Event);
+	}
+
+	virtual void Dispatch(EParkourEventPhase Phase, UE::Tasks::FPipe* Pipe) override
+	{
+		const int32 PhaseIndex = (int32)Phase;
+		const int32 End = Pending.Num();
+		if (Consumed[PhaseIndex] < End)
+		{
+			const FBatch Batch(Pending.GetData() + Consumed[PhaseIndex], End - Consumed[PhaseIndex]);
+
+			bDispatching = true;
+			Subscribers[PhaseIndex].Broadcast(Batch);
+			if (Phase == EParkourEventPhase::FrameEnd && Pipe && BackgroundSubscribers.IsBound())
+			{
+				QueueBackground(Batch, *Pipe);
+			}
+			bDispatching = false;
+
+			Consumed[PhaseIndex] = End;
+			if (Deferred.Num() > 0)
+			{
+				Pending.Append(Deferred);
+				Deferred.Reset();
+			}
+		}
+
+		// Drop what every phase has seen; usually all of it, which is just a count reset
+		int32 Seen = Consumed[0];
+		for (int32 Index = 1; Index < (int32)EParkourEventPhase::Count; ++Index)
+		{
+			Seen = FMath::Min(Seen, Consumed[Index]);
+		}
+		if (Seen > 0)
+		{
+			Pending.RemoveAt(0, Seen, EAllowShrinking::No);
+			for (int32& Cursor : Consumed)
+			{
+				Cursor -= Seen;
+			}
+		}
+	}
+
+	virtual void WaitForBackground() override
+	{
+		for (UE::Tasks::FTask& Task : BackgroundTasks)
+		{
+			if (Task.IsValid())
+			{
+				Task.Wait();
+			}
+		}
+	}
+
+	int32 Num() const { return Pending.Num(); }
+
+	FSubscribers Subscribers[(int32)EParkourEventPhase::Count];
+
+	// Called on a worker, one batch at a time in frame order. Only change on the game thread after WaitForBackground.
+	FSubscribers BackgroundSubscribers;
+
+private:
+	// Two buffers so a slow consumer can run a frame behind; only two frames behind waits
+	void QueueBackground(FBatch Batch, UE::Tasks::FPipe& Pipe)
+	{
+		const int32 Index = NextBackground;
+		NextBackground ^= 1;
+
+		if (BackgroundTasks[Index].IsValid())
+		{
+			BackgroundTasks[Index].Wait();
+		}
+		BackgroundBuffers[Index].Reset();
+		BackgroundBuffers[Index].Append(Batch);
+
+		BackgroundTasks[Index] = Pipe.Launch(TEXT("ParkourEventBackground"), [this, Index]()
+			{
+				BackgroundSubscribers.Broadcast(BackgroundBuffers[Index]);
+			});
+	}
+
+	TArray<EventType> Pending;
+	TArray<EventType> Deferred;
+	int32 Consumed[(int32)EParkourEventPhase::Count] = {};
+	bool bDispatching = false;
+
+	TArray<EventType> BackgroundBuffers[2];
+	UE::Tasks::FTask BackgroundTasks[2];
+	int32 NextBackground = 0;
+};
+
+/**
+ * Typed gameplay events for the world. Producers publish by value on the game thread, which
+ * is an array append. Subscribers bind native delegates per phase and get each phase's events
+ * as one batch, once per frame:
+ *
+ *   Bus->OnEvents<FParkourVaultEvent>(EParkourEventPhase::FrameEnd).AddUObject(this, &UMyThing::HandleVaults);
+ *
+ * Background consumers get the FrameEnd batch on a worker, in order, through a pipe.
+ */
+UCLASS()
+class KIWIJAM2025_API UParkourEventBus : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	template<typename EventType>
+	FORCEINLINE void Publish(const EventType& Event)
+	{
+		checkSlow(IsInGameThread());
+		GetChannel<EventType>().Publish(Event);
+	}
+
+	// Convenience for callers without a cached pointer
+	template<typename EventType>
+	static void Publish(const UWorld* World, const EventType& Event)
+	{
+		if (UParkourEventBus* Bus = World ? World->GetSubsystem<UParkourEventBus>() : nullptr)
+		{
+			Bus->Publish(Event);
+		}
+	}
+
+	template<typename EventType>
+	typename TParkourEventChannel<EventType>::FSubscribers& OnEvents(EParkourEventPhase Phase)
+	{
+		return GetChannel<EventType>().Subscribers[(int32)Phase];
+	}
+
+	template<typename EventType, typename FunctorType>
+	FDelegateHandle AddBackgroundConsumer(FunctorType&& Functor)
+	{
+		TParkourEventChannel<EventType>& Channel = GetChannel<EventType>();
+		Channel.WaitForBackground();
+		return Channel.BackgroundSubscribers.AddLambda(Forward<FunctorType>(Functor));
+	}
+
+	template<typename EventType>
+	void RemoveBackgroundConsumer(FDelegateHandle Handle)
+	{
+		TParkourEventChannel<EventType>& Channel = GetChannel<EventType>();
+		Channel.WaitForBackground();
+		Channel.BackgroundSubscribers.Remove(Handle);
+	}
+
+	// Hands every channel's batch to the phase's subscribers. The bus calls this from the world tick.
+	void Dispatch(EParkourEventPhase Phase);
+
+private:
+	template<typename EventType>
+	FORCEINLINE TParkourEventChannel<EventType>& GetChannel()
+	{
+		return static_cast<TParkourEventChannel<EventType>&>(*Channels[(int32)EventType::Type]);
+	}
+
+	void OnPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	// Declared before the channels so it outlives their background tasks
+	TUniquePtr<UE::Tasks::FPipe> BackgroundPipe;
+
+	// Live until the bus is destroyed, so subscribers that unbind after Deinitialize still find them
+	TUniquePtr<FParkourEventChannelBase> Channels[(int32)EParkourEventType::Count];
+
+	FDelegateHandle PreActorTickHandle;
+	FDelegateHandle PostActorTickHandle;
+};
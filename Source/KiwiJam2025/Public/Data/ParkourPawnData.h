@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ParkourPawnData.generated.h"
+
+class APawn;
+class AActor;
+
+/**
+ * What a player pawn needs beyond its own class, as soft references grouped into bundles.
+ * The game mode loads it with its bundles while the map loads, so the weapon and the world
+ * map widget are resident before anyone asks for them instead of loading on first use.
+ * Register assets under /Game/Data; without one the game mode streams its own PawnClass.
+ */
+UCLASS(BlueprintType)
+class KIWIJAM2025_API UParkourPawnData : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	// Bundle names, matching the AssetBundles meta below
+	static const FName GameBundle;
+	static const FName UIBundle;
+
+	// UI only where something renders it
+	static TArray<FName> GetBundlesFor(const UWorld* World);
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	/** Pawn spawned for players; the game mode's own PawnClass when unset */
+	UPROPERTY(EditDefaultsOnly, Category = "Pawn", meta = (AssetBundles = "Game"))
+	TSoftClassPtr<APawn> PawnClass;
+
+	/** Weapon pickup the pawn is handed */
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (AssetBundles = "Game"))
+	TSoftClassPtr<AActor> WeaponPickupClass;
+
+	/** World map widget opened by the map action. A path so this asset doesn't pull UMG into the server. */
+	UPROPERTY(EditDefaultsOnly, Category = "UI", meta = (AssetBundles = "UI", MetaClass = "/Script/UMG.UserWidget"))
+	FSoftClassPath WorldMapWidgetClass;
+};
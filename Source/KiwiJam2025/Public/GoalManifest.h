@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GoalManifest.generated.h"
+
+// One row per goal in the level, small enough to keep every goal resident
+USTRUCT()
+struct FGoalManifestEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere)
+	FGuid GoalId;
+
+	UPROPERTY(VisibleAnywhere)
+	FVector3f Location = FVector3f::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere)
+	bool bStartsActive = true;
+};
+
+/**
+ * Always-loaded table of every AGoalPoint in the level, built in the editor.
+ * Lets the map show goals whose World Partition cells are not streamed in.
+ */
+UCLASS(NotBlueprintable)
+class KIWIJAM2025_API AGoalManifest : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGoalManifest();
+
+	const TArray<FGoalManifestEntry>& GetEntries() const { return Entries; }
+
+	const TSoftClassPtr<UObject>& GetMarkerClass() const { return MarkerClass; }
+
+#if WITH_EDITOR
+	// Collects every goal in the level (loading unloaded cells if needed) into the manifest
+	UFUNCTION(CallInEditor, Category = "Goal")
+	void RebuildManifest();
+#endif
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = "Goal")
+	TArray<FGoalManifestEntry> Entries;
+
+	// Marker widget used for all goals, taken from the goals when rebuilding
+	UPROPERTY(EditAnywhere, Category = "Goal", meta = (AllowedClasses = "/Script/UMG.UserWidget"))
+	TSoftClassPtr<UObject> MarkerClass;
+};
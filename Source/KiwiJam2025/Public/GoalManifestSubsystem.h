@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GoalManifest.h"
+#include "GoalManifestSubsystem.generated.h"
+
+class AGoalPoint;
+struct FParkourSaveData;
+struct FCourseGoalTimes;
+class FCourseRouteSolver;
+
+// Runtime state of one manifest row
+struct FGoalRuntimeState
+{
+	FGuid GoalId;
+	FVector Location = FVector::ZeroVector;
+	bool bActive = true;
+
+	// Fastest time from level start, 0 until reached
+	float BestSplit = 0.f;
+
+	// Live actor when its cell is streamed in
+	TWeakObjectPtr<AGoalPoint> Actor;
+};
+
+/**
+ * Reads the level's goal manifest at startup and binds goal actors to it as
+ * their cells stream in and out. Owns goal state; the map reads it and draws the markers.
+ */
+UCLASS()
+class KIWIJAM2025_API UGoalManifestSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// Called by goals from BeginPlay/EndPlay as their cell loads/unloads
+	void BindGoal(AGoalPoint* Goal);
+	void UnbindGoal(AGoalPoint* Goal);
+
+	void NotifyGoalReached(AGoalPoint* Goal);
+
+	// Local player reached a goal, Split in seconds from level start
+	void NotifyGoalReached(const FGuid& GoalId, float Split);
+
+	// Seconds since the level started, what splits are measured in
+	float GetLevelTime() const;
+
+	// Restarts the level clock as if RunTime seconds had passed, for a run restored at its
+	// checkpoint. A negative RunTime (unknown) keeps this run's splits out of the bests.
+	void ResumeRun(float RunTime);
+
+	// Marker widget for the map, from the manifest or the first goal that names one
+	const TSoftClassPtr<UObject>& GetMarkerClass() const { return MarkerClass; }
+
+	// A goal was bound, reached or restored; the map re-syncs its markers from GetGoals
+	FSimpleMulticastDelegate OnGoalsChanged;
+
+	// GetRoute changed: a solve finished or the route was dropped
+	FSimpleMulticastDelegate OnRouteChanged;
+
+	// While the map is up, reaching a goal re-plans the route right away
+	void SetMapOpen(bool bOpen) { bMapOpen = bOpen; }
+
+	bool IsGoalActive(const FGuid& GoalId) const;
+
+	// Solves an order for the remaining goals from FromLocation in the background and shows it on the map.
+	// FallbackSpeed (cm/s) prices goal pairs the reachability data doesn't cover.
+	void RequestRoute(const FVector& FromLocation, float FallbackSpeed);
+
+	// Last solved route, FromLocation first, empty until one finishes
+	const TArray<FVector>& GetRoute() const { return Route; }
+
+	const TArray<FGoalRuntimeState>& GetGoals() const { return Goals; }
+
+	// Copies goal progress out for the save system. Linear in goals, nothing else.
+	void GatherProgress(FParkourSaveData& OutData) const;
+
+	static void BuildSaveData(TConstArrayView<FGoalRuntimeState> InGoals, int32 InCheckpointIndex, float InCheckpointYaw, float InCheckpointRunTime, FParkourSaveData& OutData);
+
+	// Marks saved goals reached and restores their splits. Ids no longer in the level are ignored.
+	void ApplySavedProgress(const FParkourSaveData& Data);
+
+private:
+	int32 FindOrAddGoal(const FGuid& GoalId, const FVector& Location);
+
+	void ClearRoute();
+
+	TArray<FGoalRuntimeState> Goals;
+	TMap<FGuid, int32> GoalIndexById;
+
+	bool bMapOpen = false;
+
+	double LevelStartTime = 0.0;
+
+	// False for a run restored from a save that didn't keep its time
+	bool bRunCountsForBests = true;
+
+	// Last goal reached, the respawn point, and the run time it was reached at
+	int32 CheckpointIndex = INDEX_NONE;
+	float CheckpointYaw = 0.f;
+	float CheckpointRunTime = -1.f;
+
+	// Saved/Reachability/<Map>.kcgt if the commandlet has been run, loaded in the background
+	TSharedPtr<const FCourseGoalTimes, ESPMode::ThreadSafe> GoalTimes;
+
+	TSharedPtr<FCourseRouteSolver, ESPMode::ThreadSafe> RouteSolver;
+	uint32 RouteRequest = 0;
+	float RouteFallbackSpeed = 600.f;
+	TArray<FVector> Route;
+
+	TSoftClassPtr<UObject> MarkerClass;
+};
@@ -21,7 +21,7 @@ public:
 	// Sets default values for this actor's properties
 	AGoalPoint();
 
-	// Event that other classes (GameMode, Player) can bind to
+	// For Blueprints. Native code listens for FParkourGoalReachedEvent on the event bus instead.
 	UPROPERTY(BlueprintAssignable, Category = "Goal")
 	FOnGoalReached OnGoalReached;
 
@@ -29,17 +29,36 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void PostActorCreated() override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostDuplicate(EDuplicateMode::Type DuplicateMode) override;
+#endif
+
 	// Trigger overlap
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor,
 		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep,
 		const FHitResult& SweepResult);
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	// Tells the event bus, and any Blueprint bound to OnGoalReached
+	void PublishGoalReached(APawn* Racer, float Split);
+
+	// Reachable for the local player. Per-player completion lives on AParkourPlayerState.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated)
 	bool bIsActive = true;
 
-	UPROPERTY(EditAnywhere, Category = "Goal")
-	TSubclassOf<UUserWidget> GoalMarkerClass; // Widget class for marker
+	UPROPERTY(EditAnywhere, Category = "Goal", meta = (AllowedClasses = "/Script/UMG.UserWidget"))
+	TSubclassOf<UObject> GoalMarkerClass; // Widget class for marker
+
+	// Stable id used by the goal manifest, survives cell streaming
+	UPROPERTY(VisibleAnywhere, Category = "Goal", NonPIEDuplicateTransient)
+	FGuid GoalId;
 
 private:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
@@ -48,17 +67,19 @@ private:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	UBillboardComponent* IconBillboard; // For editor visualization
 
-	// Store the marker widget
-	UPROPERTY()
-	UUserWidget* GoalMarkerWidget;
+public:	
+	// Returns location for map marker
+	FVector GetGoalLocation() const;
 
-	AParkourCharacter* PlayerChar;
+	const FGuid& GetGoalId() const { return GoalId; }
 
-	bool bMarkerAdded = false;
+#if WITH_EDITOR
+	// Gives a goal without an id a new one and dirties its package. Returns true if it did.
+	bool EnsureGoalId();
+#endif
 
-public:	
-	void Tick(float DeltaTime) override;
+	bool IsGoalActive() const { return bIsActive; }
+	void SetGoalActive(bool bActive) { bIsActive = bActive; }
 
-	// Returns location for map marker
-	FVector GetGoalLocation() const;
+	TSubclassOf<UObject> GetMarkerClass() const { return GoalMarkerClass; }
 };
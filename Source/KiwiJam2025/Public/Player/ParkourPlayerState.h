@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerState.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "ParkourPlayerState.generated.h"
+
+class AParkourPlayerState;
+
+// One goal this player has reached
+USTRUCT()
+struct FGoalCompletionItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGuid GoalId;
+
+	// Server time from level start
+	UPROPERTY()
+	float Split = 0.f;
+
+	void PostReplicatedAdd(const struct FGoalCompletionArray& InArraySerializer);
+};
+
+/** Append-only list of reached goals; delta replication only sends the new items */
+USTRUCT()
+struct FGoalCompletionArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FGoalCompletionItem> Items;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<AParkourPlayerState> Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FGoalCompletionItem, FGoalCompletionArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FGoalCompletionArray> : public TStructOpsTypeTraitsBase2<FGoalCompletionArray>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+/**
+ * Per-player goal completion. The server appends to a push-model fast array that only
+ * the owning client receives; everyone else just gets the count. The local player's
+ * completions drive the map markers and the save through the goal manifest.
+ */
+UCLASS()
+class KIWIJAM2025_API AParkourPlayerState : public APlayerState
+{
+	GENERATED_BODY()
+
+public:
+	AParkourPlayerState();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Server only. Returns false if this player already had the goal.
+	bool MarkGoalReached(const FGuid& GoalId, float Split);
+
+	bool HasReachedGoal(const FGuid& GoalId) const { return ReachedGoals.Contains(GoalId); }
+
+	int32 GetNumGoalsReached() const { return NumGoalsReached; }
+
+	// Picks up goals the manifest already has as reached (restored from a save) without
+	// sending them back through the manifest. Local player on the server only.
+	void SeedFromManifest();
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	friend struct FGoalCompletionItem;
+
+	void HandleGoalCompleted(const FGoalCompletionItem& Item, bool bNotifyManifest);
+
+	bool IsLocalPlayerState() const;
+
+	UPROPERTY(Replicated)
+	FGoalCompletionArray GoalCompletion;
+
+	// For scoreboards, replicated to everyone
+	UPROPERTY(Replicated)
+	int32 NumGoalsReached = 0;
+
+	// Lookup for the items, rebuilt as they arrive
+	TSet<FGuid> ReachedGoals;
+};
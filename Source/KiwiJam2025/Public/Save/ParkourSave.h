@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tasks/Pipe.h"
+#include "World/ExplorationGrid.h"
+#include "ParkourSave.generated.h"
+
+class UGoalManifestSubsystem;
+class APawn;
+class AController;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourSave, Log, All);
+
+// One goal with progress. Goals never reached are left out of the save.
+struct FParkourGoalProgress
+{
+	FGuid GoalId;
+	bool bReached = false;
+
+	// Seconds from level start to the goal, 0 if it has no time yet
+	float BestSplit = 0.f;
+};
+
+/**
+ * Course progress for one map and its on-disk format: a fixed header (magic, version,
+ * sizes, CRC) followed by the Oodle-compressed payload. Safe to build and serialize off
+ * the game thread, it holds no UObjects.
+ */
+struct KIWIJAM2025_API FParkourSaveData
+{
+	static constexpr uint32 Magic = 0x5653414B; // "KASV"
+
+	enum EVersion : uint16
+	{
+		InitialVersion = 1,
+		ExplorationVersion = 2,
+		CheckpointTimeVersion = 3,
+
+		LatestVersion = CheckpointTimeVersion
+	};
+
+	FString MapName;
+	TArray<FParkourGoalProgress> Goals;
+
+	// Last goal reached, where the player respawns
+	bool bHasCheckpoint = false;
+	FGuid CheckpointGoalId;
+	FVector3f CheckpointLocation = FVector3f::ZeroVector;
+	float CheckpointYaw = 0.f;
+
+	// Run time when the checkpoint was reached, negative in saves from before it was kept
+	float CheckpointRunTime = -1.f;
+
+	// Explored cells of the world map, empty in saves from before it existed
+	FExplorationGrid Exploration;
+
+	// Payload + compression. Returns false on a bad header, version, size or CRC.
+	bool SaveToBytes(TArray<uint8>& OutBytes) const;
+	bool LoadFromBytes(const TArray<uint8>& Bytes);
+
+	// Writes a temp file and renames it over the old save, so a crash mid-write keeps the previous one
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+
+	static FString GetSavePath(const FString& MapName);
+
+private:
+	void SerializePayload(FArchive& Ar, uint16 Version);
+};
+
+/**
+ * Saves and loads course progress. The game thread only copies goal state into an
+ * FParkourSaveData; serialization, compression and the file write run on a task pipe
+ * so saves land in order. Loading starts as soon as a map transition begins and is
+ * applied to the goal manifest once both are ready.
+ */
+UCLASS()
+class KIWIJAM2025_API UParkourSaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Snapshots the world's goal progress and writes it in the background
+	void RequestSave(UWorld* World);
+
+	// Applies the map's save now if loaded, otherwise when the load finishes
+	void ApplyWhenLoaded(UGoalManifestSubsystem* Manifest);
+
+	// Queues an already built snapshot, used by the benchmark
+	void SubmitSave(FParkourSaveData&& Data, TFunction<void(bool bSuccess, int64 Bytes, double WorkerMs)> OnWritten = nullptr);
+
+	// Game thread cost of the most recent RequestSave
+	double GetLastSnapshotMs() const { return LastSnapshotMs; }
+
+	// Blocks until queued saves and loads are done
+	void Flush();
+
+private:
+	void StartLoad(const FString& MapName);
+	void OnLoadFinished(const FString& MapName, TSharedPtr<FParkourSaveData> Data);
+	void Apply(UGoalManifestSubsystem* Manifest, const FParkourSaveData& Data);
+
+	void HandlePreLoadMap(const FString& MapName);
+
+	UFUNCTION()
+	void HandlePawnControllerChanged(APawn* Pawn, AController* Controller);
+
+	UE::Tasks::FPipe IOPipe { TEXT("ParkourSave") };
+
+	// Map being loaded and the result once it lands (null = no save on disk yet)
+	FString LoadingMap;
+	bool bLoadFinished = false;
+	TSharedPtr<FParkourSaveData> LoadedData;
+
+	TWeakObjectPtr<UGoalManifestSubsystem> PendingManifest;
+
+	// Moves the next local player pawn here after a load
+	bool bPendingCheckpoint = false;
+	FVector PendingCheckpointLocation = FVector::ZeroVector;
+	float PendingCheckpointYaw = 0.f;
+	float PendingCheckpointRunTime = -1.f;
+
+	double LastSnapshotMs = 0.0;
+
+	FDelegateHandle PreLoadMapHandle;
+};
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "Server/ParkourBotDriver.h"
+#include "ParkourBotController.generated.h"
+
+/**
+ * Server-side stand-in for a racer, for load testing hosted races. Drives its pawn with
+ * FParkourBotDriver. Has a player state so it counts and replicates like a real player.
+ */
+UCLASS()
+class KIWIJAM2025_API AParkourBotController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	AParkourBotController();
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	virtual void OnPossess(APawn* InPawn) override;
+
+private:
+	// Closer than this to the target counts as there
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float AcceptRadius = 200.f;
+
+	// Used when the level has no goals
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float WanderRadius = 3000.f;
+
+	// Slower than this while pushing forward counts as blocked
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float StallSpeed = 100.f;
+
+	// Gives up on a target after this long
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float TargetTimeout = 20.f;
+
+	FParkourBotDriver Driver;
+};
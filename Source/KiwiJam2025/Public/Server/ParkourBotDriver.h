@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AParkourCharacter;
+
+/**
+ * Racer steering shared by server bots and bot clients: runs at the goals in random order
+ * and jumps whenever it stalls, so the detector, vaults and climbs all get exercised.
+ */
+struct KIWIJAM2025_API FParkourBotDriver
+{
+	// Closer than this to the target counts as there
+	float AcceptRadius = 200.f;
+
+	// Used when the level has no goals
+	float WanderRadius = 3000.f;
+
+	// Slower than this while pushing forward counts as blocked
+	float StallSpeed = 100.f;
+
+	// Gives up on a target after this long
+	float TargetTimeout = 20.f;
+
+	void Start(const AParkourCharacter& Character, int32 Seed);
+
+	// Pushes the character at the target. Returns true when it picked a new one.
+	bool Tick(AParkourCharacter& Character, float DeltaTime);
+
+	const FVector& GetTarget() const { return Target; }
+
+	// Run by clients started with -ParkourBotClient, for load tests with real connections
+	static bool IsBotClient();
+
+private:
+	void PickTarget(const UWorld* World);
+
+	FVector Target = FVector::ZeroVector;
+	FVector Home = FVector::ZeroVector;
+	float TargetAge = 0.f;
+	float StallTime = 0.f;
+	FRandomStream Random;
+};
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Containers/Ticker.h"
+#include "RaceHostSubsystem.generated.h"
+
+class UGameInstance;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogRaceHost, Log, All);
+
+/** One extra race hosted by this process */
+USTRUCT()
+struct FHostedRace
+{
+	GENERATED_BODY()
+
+	int32 Id = 0;
+	int32 Port = 0;
+
+	// The map package loaded again under this name, so the race owns its own level and actors
+	FString PackageName;
+
+	UPROPERTY()
+	TObjectPtr<UGameInstance> GameInstance;
+
+	// Bots still to spawn, waiting on the game mode's pawn class
+	int32 PendingBots = 0;
+};
+
+/**
+ * Hosts extra independent races in this process, each its own UWorld with its own game
+ * instance, game mode and listen net driver on its own port. The engine ticks every world
+ * context in turn on the game thread; inside each world tick the usual task-graph work
+ * (physics, animation, net serialization) still fans out to workers. Meant for dedicated
+ * servers, where the default world is race 0.
+ */
+UCLASS()
+class KIWIJAM2025_API URaceHostSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Loads MapPackage (a long package name) as a new race listening on Port and fills it
+	 * with NumBots bots once its pawn class is in. Returns the race id, or INDEX_NONE.
+	 */
+	int32 StartRace(const FString& MapPackage, int32 Port, int32 NumBots);
+
+	void StopRace(int32 RaceId);
+	void StopAllRaces();
+
+	int32 GetNumRaces() const { return Races.Num(); }
+
+	// Spawns bots into any race world, the default one included. Waits for the pawn class if needed.
+	static int32 SpawnBots(UWorld* World, int32 NumBots);
+
+private:
+	bool TickPendingBots(float DeltaTime);
+
+	static void ShutdownGameInstance(UGameInstance* GameInstance);
+
+	UPROPERTY()
+	TArray<FHostedRace> Races;
+
+	int32 NextRaceId = 1;
+	FTSTicker::FDelegateHandle BotTickHandle;
+};
@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InputReplay.generated.h"
+
+class AParkourCharacter;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogInputReplay, Log, All);
+
+// The character input handlers a recording captures
+enum class EReplayInput : uint8
+{
+	Move,
+	Look,
+	BeginJump,
+	EndJump,
+	ToggleMap,
+	BeginSlide,
+	EndSlide,
+
+	Count
+};
+
+/**
+ * One player's inputs over a run, frame by frame, and the pawn state they started from.
+ * Saved as Saved/InputRecordings/<Name>.kinp, about 4 bytes a frame plus 10 per axis event.
+ */
+struct KIWIJAM2025_API FInputRecording
+{
+	static constexpr uint32 Magic = 0x504E494B; // "KINP"
+	static constexpr uint16 Version = 1;
+
+	struct FEvent
+	{
+		// Index into FrameDeltas
+		uint32 Frame = 0;
+		EReplayInput Input = EReplayInput::Move;
+		FVector2f Value = FVector2f::ZeroVector;
+	};
+
+	FString MapName;
+
+	FVector StartLocation = FVector::ZeroVector;
+	FRotator StartRotation = FRotator::ZeroRotator;
+	FRotator StartControlRotation = FRotator::ZeroRotator;
+	FVector StartVelocity = FVector::ZeroVector;
+	uint8 StartMovementMode = 0;
+
+	// Game time step of every recorded frame
+	TArray<float> FrameDeltas;
+
+	// In frame order, and within a frame in the order the handlers ran
+	TArray<FEvent> Events;
+
+	// Returns false on a bad header
+	bool Serialize(FArchive& Ar);
+
+	bool SaveToFile(const FString& Path);
+	bool LoadFromFile(const FString& Path);
+
+	// Bare names resolve to Saved/InputRecordings/<Name>.kinp
+	static FString ResolvePath(const FString& NameOrPath);
+};
+
+/**
+ * Records the local character's input handlers, or replays a recording into them.
+ *
+ * Replay drives the engine with a fixed time step, taken from the recording frame by frame
+ * or set to one constant, so the simulation sees the same deltas whatever the machine does.
+ * Each frame's cost goes to a CSV next to the recording. Headless repro of a hitch:
+ *
+ *   -game -nullrhi -ExecCmds="Parkour.Input.Replay <Name> 0 exit"
+ */
+UCLASS()
+class KIWIJAM2025_API UInputReplaySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// From the character's input handlers; nothing unless recording
+	FORCEINLINE void Record(EReplayInput Input, const FVector2D& Value = FVector2D::ZeroVector)
+	{
+		if (bRecording)
+		{
+			Recording.Events.Add({ (uint32)(Recording.FrameDeltas.Num() - 1), Input, FVector2f(Value) });
+		}
+	}
+
+	// Starts with the next frame. Not while replaying.
+	bool StartRecording();
+
+	// Writes the recording, returns the path or empty on failure
+	FString StopRecording(const FString& Name);
+
+	bool IsRecording() const { return bRecording; }
+	bool IsReplaying() const { return bReplaying; }
+
+	/**
+	 * Replays from the next frame. FixedDelta 0 steps every frame by its recorded delta,
+	 * otherwise by FixedDelta. With bExitWhenDone the process quits after the CSV is written.
+	 */
+	bool StartReplay(FInputRecording&& InRecording, const FString& CsvPath, float FixedDelta, bool bExitWhenDone);
+
+private:
+	void OnPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	AParkourCharacter* GetLocalCharacter() const;
+
+	void FinishReplay();
+
+	float GetReplayDelta(int32 Frame) const;
+
+	FInputRecording Recording;
+	bool bRecordPending = false;
+	bool bRecording = false;
+
+	bool bReplaying = false;
+
+	// Frames to let pass before the first replayed one, so its delta is already the fixed one
+	int32 ReplayWarmupFrames = 0;
+
+	bool bExitAfterReplay = false;
+	float ReplayFixedDelta = 0.f;
+	int32 ReplayFrame = 0;
+	int32 NextReplayEvent = 0;
+	FString ReplayCsvPath;
+	TArray<FString> ReplayCsv;
+
+	// The last replayed frame's row, finished once the next frame starts and its full cost is known
+	struct FReplayRow
+	{
+		int32 Frame = INDEX_NONE;
+		float DeltaSeconds = 0.f;
+		double WorldTickMs = 0.0;
+		int32 NumEvents = 0;
+		FVector Location = FVector::ZeroVector;
+		float Speed = 0.f;
+		uint8 MovementMode = 0;
+		uint8 CustomMode = 0;
+	};
+	FReplayRow PendingRow;
+
+	void FlushRow(uint64 NowCycles);
+
+	uint64 FrameStartCycles = 0;
+
+	// Engine time step settings to put back after a replay
+	bool bSavedUseFixedTimeStep = false;
+	double SavedFixedDeltaTime = 0.0;
+
+	FDelegateHandle PreActorTickHandle;
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "TraversalHeatmapCommandlet.generated.h"
+
+/**
+ * Offline: merges traversal telemetry files per map and rasterizes one PNG heatmap per event type.
+ *
+ * UnrealEditor-Cmd KiwiJam2025 -run=TraversalHeatmap [-In=<file or dir>] [-Out=<dir>] [-PixelsPerCell=4]
+ * Defaults read Saved/Telemetry and write Saved/Telemetry/Heatmaps.
+ */
+UCLASS()
+class KIWIJAM2025_API UTraversalHeatmapCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTraversalHeatmapCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
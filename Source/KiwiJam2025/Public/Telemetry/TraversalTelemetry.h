@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/CircularQueue.h"
+#include <atomic>
+
+#include "TraversalTelemetry.generated.h"
+
+class FRunnableThread;
+class FTraversalTelemetryWorker;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogTraversalTelemetry, Log, All);
+
+enum class ETraversalTelemetryEvent : uint8
+{
+	ProbeSuccess,
+	ProbeHeadBlocked,
+	ProbeHeightOutOfRange,
+	ProbeLandingBlocked,
+	TraversalStart,
+	TraversalEnd,
+
+	Count
+};
+
+KIWIJAM2025_API const TCHAR* LexToString(ETraversalTelemetryEvent Event);
+
+// What the game thread pushes, 16 bytes
+struct FTraversalTelemetryEvent
+{
+	FVector3f Location = FVector3f::ZeroVector;
+	ETraversalTelemetryEvent Type = ETraversalTelemetryEvent::ProbeSuccess;
+};
+
+/**
+ * Per-level 2D histogram of event counts, and its on-disk format.
+ * Shared by the runtime writer and the heatmap commandlet.
+ */
+struct KIWIJAM2025_API FTraversalHeatmapData
+{
+	static constexpr uint32 Magic = 0x5452544B; // "KTRT"
+	static constexpr uint16 Version = 1;
+	static constexpr int32 NumTypes = (int32)ETraversalTelemetryEvent::Count;
+
+	struct FCell
+	{
+		uint32 Counts[NumTypes] = {};
+	};
+
+	FString MapName;
+	float CellSize = 200.f;
+	uint32 DroppedEvents = 0;
+	TMap<FIntPoint, FCell> Cells;
+
+	void Add(const FTraversalTelemetryEvent& Event);
+
+	// Sums another histogram with the same cell size into this one
+	void Merge(const FTraversalHeatmapData& Other);
+
+	// Returns false on a bad header
+	bool Serialize(FArchive& Ar);
+
+	bool SaveToFile(const FString& Path);
+	bool LoadFromFile(const FString& Path);
+};
+
+/**
+ * Collects traversal probe outcomes and traversal start/end for the level. Recording is a
+ * single push into a lock-free single-producer ring; a worker thread drains it into the
+ * histogram and writes Saved/Telemetry/<Map>-<Time>.ktrt when the world goes away.
+ * Game thread only on the producer side.
+ */
+UCLASS()
+class KIWIJAM2025_API UTraversalTelemetrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual ~UTraversalTelemetrySubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	FORCEINLINE void Record(ETraversalTelemetryEvent Type, const FVector& Location)
+	{
+		checkSlow(IsInGameThread());
+
+		// Null when telemetry is off
+		if (!Queue) return;
+
+		// Full ring means the worker is behind, drop rather than stall
+		if (!Queue->Enqueue(FTraversalTelemetryEvent{ FVector3f(Location), Type }))
+		{
+			DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// Convenience for callers without a cached pointer
+	static void Record(const UWorld* World, ETraversalTelemetryEvent Type, const FVector& Location);
+
+private:
+	friend class FTraversalTelemetryWorker;
+
+	TUniquePtr<TCircularQueue<FTraversalTelemetryEvent>> Queue;
+	std::atomic<uint32> DroppedEvents { 0 };
+
+	TUniquePtr<FTraversalTelemetryWorker> Worker;
+	TUniquePtr<FRunnableThread> WorkerThread;
+};
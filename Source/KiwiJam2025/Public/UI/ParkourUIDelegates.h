@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AParkourCharacter;
+
+/**
+ * Where the game tells the HUD something happened. The widgets live in the client-only
+ * KiwiJam2025UI module, which binds these; a server build has nothing bound and never
+ * compiles UMG.
+ */
+struct KIWIJAM2025_API FParkourUIDelegates
+{
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnCharacterEvent, AParkourCharacter& /*Character*/);
+
+	// A parkour character got a local player controller
+	static FOnCharacterEvent OnLocalCharacterReady;
+
+	// The map input fired (or was replayed) for a local character
+	static FOnCharacterEvent OnToggleMap;
+};
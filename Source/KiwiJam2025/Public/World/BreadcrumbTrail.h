@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FBreadcrumbPoint
+{
+	FVector3f Location = FVector3f::ZeroVector;
+
+	// World seconds when it was sampled
+	float Time = 0.f;
+
+	friend FArchive& operator<<(FArchive& Ar, FBreadcrumbPoint& Point)
+	{
+		return Ar << Point.Location << Point.Time;
+	}
+};
+
+/**
+ * The path a player took, simplified as it streams in. Each sample either extends the last
+ * segment, if a line from the last vertex can still pass within the tolerance of every sample
+ * since (tracked as a cone of directions, O(1) per sample), or fixes the previous sample as a
+ * vertex. Error is measured on the map plane (XY).
+ *
+ * Memory is capped at MaxPoints: past that the tolerance doubles and the vertices are run
+ * through again, so a long session gets coarser rather than bigger. ErrorBound is the worst
+ * any sample can now be off the line.
+ *
+ * Saved as Saved/Trails/<Name>.ktrl for replay on the map.
+ */
+struct KIWIJAM2025_API FBreadcrumbTrail
+{
+	static constexpr uint32 Magic = 0x4C52544B; // "KTRL"
+	static constexpr uint16 Version = 1;
+
+	FString MapName;
+
+	void Reset(float InTolerance, int32 InMaxPoints);
+
+	void AddSample(const FVector& Location, float Time);
+
+	// Fixes the newest sample as the last vertex, for export
+	void Finish();
+
+	// Vertices plus the newest sample, in order
+	int32 Num() const { return Points.Num() + (bHasHead ? 1 : 0); }
+	const FBreadcrumbPoint& GetPoint(int32 Index) const { return Index < Points.Num() ? Points[Index] : Head; }
+
+	// Position along the trail at a time, clamped to its ends
+	FVector SampleAtTime(float Time) const;
+
+	float GetTolerance() const { return ActiveTolerance; }
+	float GetErrorBound() const { return ErrorBound; }
+
+	// Returns false on a bad header
+	bool Serialize(FArchive& Ar);
+
+	bool SaveToFile(const FString& Path);
+	bool LoadFromFile(const FString& Path);
+
+	// Bare names resolve to Saved/Trails/<Name>.ktrl
+	static FString ResolvePath(const FString& NameOrPath);
+
+private:
+	void Push(const FBreadcrumbPoint& Point);
+	void Coarsen();
+
+	TArray<FBreadcrumbPoint> Points;
+
+	// Newest sample the open segment reaches, not a vertex yet
+	FBreadcrumbPoint Head;
+	bool bHasHead = false;
+
+	float ActiveTolerance = 50.f;
+	float ErrorBound = 50.f;
+	int32 MaxPoints = 1024;
+
+	// Directions from the last vertex that stay within tolerance of every sample since,
+	// as offsets from the first one's angle
+	bool bConeOpen = false;
+	float ConeReference = 0.f;
+	float ConeMin = 0.f;
+	float ConeMax = 0.f;
+
+	TArray<FBreadcrumbPoint> Scratch;
+};
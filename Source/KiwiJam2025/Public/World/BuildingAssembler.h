@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "BuildingAssembler.generated.h"
+
+class UStaticMesh;
+class UHierarchicalInstancedStaticMeshComponent;
+class UBuildingCollisionComponent;
+class UTraversalProxyComponent;
+struct FKBoxElem;
+
+UENUM()
+enum class EBuildingModule : uint8
+{
+	Wall1,
+	Wall2,
+	Wall3,
+	BlankWall,
+	Door
+};
+
+/**
+ * One building in the layout. Facade is read around the perimeter starting at the
+ * min corner (+X side, then +Y, -X, -Y) and repeats:
+ * '1' '2' '3' = wall1/2/3, 'b' = blankWall, 'd' = door (ground floor only)
+ */
+USTRUCT()
+struct FBuildingLayout
+{
+	GENERATED_BODY()
+
+	// Grid cell of the min corner
+	UPROPERTY(EditAnywhere)
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	// Size in modules
+	UPROPERTY(EditAnywhere)
+	FIntPoint Footprint = FIntPoint(2, 2);
+
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "1"))
+	int32 Floors = 1;
+
+	UPROPERTY(EditAnywhere)
+	FString Facade = TEXT("1d23");
+};
+
+/**
+ * Places the modular building meshes on a grid from a compact layout.
+ * Every module of a type renders through one HISM for the whole actor and each
+ * building gets one merged simple collision body.
+ */
+UCLASS()
+class KIWIJAM2025_API ABuildingAssembler : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ABuildingAssembler();
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+#if WITH_EDITOR
+	// Logs components, bodies and setup time for this district vs the loose module actors in the level
+	UFUNCTION(CallInEditor, Category = "Buildings")
+	void LogDistrictStats();
+
+	// Fills the layout with a random district for profiling
+	UFUNCTION(CallInEditor, Category = "Buildings")
+	void GenerateTestDistrict();
+#endif
+
+protected:
+	UPROPERTY(EditAnywhere, Category = "Buildings")
+	TMap<EBuildingModule, TObjectPtr<UStaticMesh>> ModuleMeshes;
+
+	UPROPERTY(EditAnywhere, Category = "Buildings")
+	TArray<FBuildingLayout> Buildings;
+
+	// Width/height of one module
+	UPROPERTY(EditAnywhere, Category = "Buildings")
+	FVector2D ModuleSize = FVector2D(400.f, 300.f);
+
+	UPROPERTY(EditAnywhere, Category = "Buildings")
+	float WallThickness = 20.f;
+
+	// World size of one layout grid cell
+	UPROPERTY(EditAnywhere, Category = "Buildings")
+	float CellSize = 400.f;
+
+	// Applied to every module so the mesh faces outward
+	UPROPERTY(EditAnywhere, Category = "Buildings")
+	float MeshYawOffset = 0.f;
+
+	// Adds Traversal-channel proxies (ledge tops split out) alongside each building's collision
+	UPROPERTY(EditAnywhere, Category = "Buildings")
+	bool bGenerateTraversalProxies = true;
+
+	UPROPERTY(EditAnywhere, Category = "Buildings|Test")
+	int32 TestDistrictSize = 200;
+
+private:
+	void Assemble();
+
+	void AddTraversalProxy(TArray<FKBoxElem>&& Boxes, bool bLedgeCapable);
+
+	static bool ParseModule(TCHAR Char, EBuildingModule& OutModule);
+
+	// Built by the construction script and saved with the level, so cooked and streamed cells load them as is
+	UPROPERTY()
+	TMap<EBuildingModule, TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> ModuleComponents;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UBuildingCollisionComponent>> CollisionComponents;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UTraversalProxyComponent>> TraversalProxyComponents;
+
+	double LastSetupMs = 0.0;
+};
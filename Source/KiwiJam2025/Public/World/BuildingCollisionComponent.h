@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/BoxElem.h"
+#include "BuildingCollisionComponent.generated.h"
+
+class UBodySetup;
+
+/**
+ * Invisible primitive holding one building's collision as a single body made
+ * of merged boxes, instead of one body per wall module.
+ */
+UCLASS(ClassGroup = (Custom))
+class KIWIJAM2025_API UBuildingCollisionComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBuildingCollisionComponent(const FObjectInitializer& ObjectInitializer);
+
+	// Replaces the building's boxes (component space) and rebuilds the body
+	void SetBoxes(TArray<FKBoxElem>&& InBoxes);
+
+	int32 GetNumBoxes() const { return Boxes.Num(); }
+
+	const TArray<FKBoxElem>& GetBoxes() const { return Boxes; }
+
+	virtual UBodySetup* GetBodySetup() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+protected:
+	virtual void OnRegister() override;
+
+private:
+	void RebuildBodySetup();
+
+	// Saved so placed (non construction script) components come back with their shape
+	UPROPERTY()
+	TArray<FKBoxElem> Boxes;
+
+	UPROPERTY(Transient, DuplicateTransient)
+	TObjectPtr<UBodySetup> ShapeBodySetup;
+};
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Estimated shortest traversal time between every pair of goals in a level, written by
+ * the reachability commandlet to Saved/Reachability/<Map>.kcgt. Row-major, seconds,
+ * negative where the second goal can't be reached from the first.
+ */
+struct KIWIJAM2025_API FCourseGoalTimes
+{
+	static constexpr uint32 Magic = 0x5447434B; // "KCGT"
+	static constexpr uint16 Version = 1;
+
+	FString MapName;
+	TArray<FGuid> GoalIds;
+	TArray<FVector3f> GoalLocations;
+	TArray<float> Times;
+
+	// Goals reachable from a player start
+	TBitArray<> ReachableFromStart;
+
+	int32 Num() const { return GoalIds.Num(); }
+
+	float GetTime(int32 From, int32 To) const { return Times[From * GoalIds.Num() + To]; }
+
+	// Returns false on a bad header
+	bool Serialize(FArchive& Ar);
+
+	bool SaveToFile(const FString& Path);
+	bool LoadFromFile(const FString& Path);
+
+	static FString GetDefaultPath(const FString& MapName);
+};
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "CourseReachabilityCommandlet.generated.h"
+
+/**
+ * Offline: samples the level's walkable surfaces into a graph, links them with the moves the
+ * character can make (walk, jump/drop, vault and climb using the detector's limits and the
+ * movement component's timings) and reports goals no player start can reach, plus the
+ * estimated shortest time between every pair of goals.
+ *
+ * UnrealEditor-Cmd KiwiJam2025 -run=CourseReachability -Map=/Game/Maps/MyMap
+ *     [-Pawn=/Game/Path/BP_Pawn.BP_Pawn_C] [-Spacing=100] [-SingleThread]
+ * Writes Saved/Reachability/<Map>.kcgt and <Map>_GoalTimes.csv. -SingleThread runs every
+ * phase on one core, to compare against the default parallel run.
+ */
+UCLASS()
+class KIWIJAM2025_API UCourseReachabilityCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCourseReachabilityCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
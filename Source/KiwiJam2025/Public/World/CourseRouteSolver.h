@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+struct FCourseGoalTimes;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCourseRoute, Log, All);
+
+/** What to route through, copied off the game thread's goal state */
+struct FCourseRouteInput
+{
+	FVector Start = FVector::ZeroVector;
+	TArray<FGuid> GoalIds;
+	TArray<FVector> GoalLocations;
+
+	// Estimated times from the reachability commandlet, null to go by distance only
+	TSharedPtr<const FCourseGoalTimes, ESPMode::ThreadSafe> GoalTimes;
+
+	// For pairs missing from GoalTimes, cm/s
+	float FallbackSpeed = 600.f;
+};
+
+/**
+ * Suggests an order to visit every goal from a start point: an open path, asymmetric
+ * costs. Each worker runs its own iterated local search (2-opt and or-opt over nearest
+ * neighbour candidates, double-bridge kicks) from a different seed and publishes when it
+ * beats the shared best, so there is a usable route as soon as the first seed is built
+ * and it only gets shorter until the budget runs out or Cancel is called.
+ *
+ * Everything after Start runs on background tasks. Keep the solver alive via the shared
+ * pointer until OnFinished fires, which happens on a worker thread.
+ */
+class KIWIJAM2025_API FCourseRouteSolver : public TSharedFromThis<FCourseRouteSolver, ESPMode::ThreadSafe>
+{
+public:
+	// Best order as indices into the input goals, and its estimated time in seconds
+	struct FResult
+	{
+		TArray<int32> Order;
+		float Cost = 0.f;
+		float SeedCost = 0.f;
+		int32 NumWorkers = 0;
+		int32 NumKicks = 0;
+		double FirstResultMs = 0.0;
+		double TotalMs = 0.0;
+	};
+
+	// Called once from a worker thread when all workers have stopped
+	TFunction<void(const FCourseRouteSolver&)> OnFinished;
+
+	// MaxWorkers 0 uses every background worker
+	void Start(FCourseRouteInput&& Input, double BudgetSeconds, int32 MaxWorkers = 0);
+
+	// Workers stop at their next check, OnFinished still fires
+	void Cancel() { bCancelled.store(true, std::memory_order_relaxed); }
+
+	bool IsDone() const { return bDone.load(std::memory_order_acquire); }
+
+	// Blocks until finished. Tools and benchmarks only.
+	void Wait() const { FinishedTask.Wait(); }
+
+	// Anytime: the best route found so far, false if no worker has one yet
+	bool GetBest(FResult& OutResult) const;
+
+private:
+	void Prepare(FCourseRouteInput&& Input);
+	void RunWorker(int32 WorkerIndex);
+	void Publish(TConstArrayView<int32> Tour, float Cost);
+
+	float Cost(int32 From, int32 To) const { return Costs[From * NumNodes + To]; }
+
+	// Node 0 is the start, goal i is node i + 1
+	int32 NumNodes = 0;
+	TArray<float> Costs;
+
+	// The closest few targets of each node, where moves look for improvements
+	static constexpr int32 NumCandidates = 10;
+	TArray<int32> Candidates;
+
+	double StartTime = 0.0;
+	double Deadline = 0.0;
+	std::atomic<bool> bCancelled { false };
+	std::atomic<bool> bDone { false };
+
+	mutable FCriticalSection BestLock;
+	FResult Best;
+	TArray<int32> BestTour;
+
+	UE::Tasks::FTask FinishedTask;
+};
@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/World.h"
+#include "World/BreadcrumbTrail.h"
+#include "ExplorationGrid.generated.h"
+
+struct FParkourSaveData;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogExploration, Log, All);
+
+/**
+ * Where the player has been, one bit per cell over the map's bounds. Cells are grouped in
+ * 32x32 tiles, one word per tile row, and a tile is marked dirty when any of its cells is
+ * revealed. A 2 km x 2 km map at 1 m cells is 504 KB.
+ */
+struct KIWIJAM2025_API FExplorationGrid
+{
+	static constexpr int32 TileCells = 32;
+
+	// World XY of cell (0, 0)'s corner
+	FVector2D Origin = FVector2D::ZeroVector;
+	float CellSize = 100.f;
+
+	// In cells, rounded up to whole tiles
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// Row-major, Width / 32 words a row. Cell X is bit X & 31 of word X >> 5.
+	TArray<uint32> Words;
+
+	// One bit per tile, set when a cell in it is revealed
+	TBitArray<> DirtyTiles;
+
+	// Clears everything, then covers Bounds (XY) with cells of InCellSize
+	void Init(const FBox& Bounds, float InCellSize);
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+
+	int32 GetWordsPerRow() const { return Width / 32; }
+	int32 GetTilesX() const { return Width / TileCells; }
+	int32 GetTilesY() const { return Height / TileCells; }
+
+	FBox2D GetWorldBounds() const { return FBox2D(Origin, Origin + FVector2D(Width, Height) * CellSize); }
+
+	bool IsExplored(int32 X, int32 Y) const
+	{
+		return (Words[Y * GetWordsPerRow() + (X >> 5)] >> (X & 31)) & 1;
+	}
+
+	bool HasSameLayout(const FExplorationGrid& Other) const
+	{
+		return Origin.Equals(Other.Origin) && CellSize == Other.CellSize && Width == Other.Width && Height == Other.Height;
+	}
+
+	// Reveals every cell whose centre is within Radius of Location, a word at a time. Returns how many were new.
+	int32 RevealCircle(const FVector& Location, float Radius);
+
+	// Adds Other's explored cells; nothing if it was built for different bounds or cell size
+	bool Merge(const FExplorationGrid& Other);
+
+	int32 CountExplored() const;
+
+	void MarkAllDirty();
+
+	/**
+	 * Writes one tile of the fog mask, alpha 255 where unexplored. Downsample cells per texel
+	 * on each axis (a power of two up to 8), partly explored texels get partial alpha.
+	 */
+	void BuildMaskTile(int32 TileX, int32 TileY, int32 Downsample, uint8* Dest, int32 DestPitch) const;
+
+	// Layout and bits, not dirty state. Returns false on bad sizes.
+	bool Serialize(FArchive& Ar);
+};
+
+/**
+ * Reveals the map around the local player at a low fixed rate. The world map widget reads
+ * the grid and re-uploads the tiles revealed since it last looked; progress rides along in
+ * the course save. The same samples feed the breadcrumb trail of this run.
+ */
+UCLASS()
+class KIWIJAM2025_API UExplorationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	// XY area of the world's partition, or of its loaded levels, with a fallback when neither has any
+	static FBox ComputeWorldMapBounds(const UWorld& World);
+
+	// Area the world map shows. Changing it starts exploration over.
+	void SetMapBounds(const FBox& Bounds);
+	const FBox& GetMapBounds() const { return MapBounds; }
+
+	const FExplorationGrid& GetGrid() const { return Grid; }
+
+	// Tiles revealed since the last call, for the one mask that mirrors the grid
+	void TakeDirtyTiles(TBitArray<>& OutTiles);
+
+	// Grid cells per fog mask texel on each axis
+	int32 GetMaskDownsample() const;
+
+	// Copies exploration into a save snapshot, and back (merged with anything seen since the map started)
+	void GatherProgress(FParkourSaveData& Data) const;
+	void ApplySavedProgress(const FParkourSaveData& Data);
+
+	// Cost of the most recent reveal and trail sample
+	double GetLastUpdateMs() const { return LastUpdateMs; }
+
+	// Where the player has been since the map started
+	const FBreadcrumbTrail& GetTrail() const { return Trail; }
+
+	// Writes the trail so far, returns the path or empty on failure
+	FString ExportTrail(const FString& Name) const;
+
+	// Plays a saved trail back on the map next to the live one, Speed times real time
+	void StartGhost(FBreadcrumbTrail&& InGhost, float Speed);
+
+	// Null unless a ghost is playing
+	const FBreadcrumbTrail* GetGhost() const { return Ghost.Num() >= 2 ? &Ghost : nullptr; }
+	float GetGhostTime() const { return GhostTime; }
+
+private:
+	void OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void Update();
+
+	void MergeSaved(const FExplorationGrid& Saved);
+
+	FExplorationGrid Grid;
+	FBox MapBounds;
+
+	// The world's bounds are only known at begin play; a save applied before then waits here
+	bool bHasWorldBounds = false;
+	FExplorationGrid PendingSaved;
+
+	FBreadcrumbTrail Trail;
+
+	FBreadcrumbTrail Ghost;
+	float GhostTime = 0.f;
+	float GhostSpeed = 1.f;
+
+	float UpdateAccumulator = 0.f;
+	float SaveAccumulator = 0.f;
+	bool bUnsavedReveals = false;
+
+	// Standing still doesn't rescan the same circle
+	FVector LastRevealLocation = FVector(UE_BIG_NUMBER);
+
+	double LastUpdateMs = 0.0;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RideRailComponent.generated.h"
+
+class USplineComponent;
+
+UENUM()
+enum class ERideRailType : uint8
+{
+	// Hang under it by the hands
+	Zipline,
+	// Stand on top of it
+	Grind
+};
+
+/**
+ * A spline resampled at even arc length steps, in the spline's component space. Built once
+ * when the rail loads; riding is an index and a lerp, with no spline evaluation.
+ */
+struct FRailArcTable
+{
+	TArray<FVector3f> Points;
+	TArray<FVector3f> Tangents;
+
+	// Bounding spheres over runs of ChunkSize samples, so a nearest query skips most of the rail
+	struct FChunk
+	{
+		FVector3f Center;
+		float Radius = 0.f;
+	};
+	TArray<FChunk> Chunks;
+
+	static constexpr int32 ChunkSize = 16;
+
+	float Length = 0.f;
+	float Spacing = 0.f;
+	float InvSpacing = 0.f;
+	bool bClosedLoop = false;
+
+	void Build(const USplineComponent& Spline, float DesiredSpacing);
+
+	bool IsValid() const { return Points.Num() >= 2; }
+
+	// Wraps on loops, clamps otherwise
+	float ClampDistance(float Distance) const;
+
+	void Sample(float Distance, FVector& OutPoint, FVector& OutTangent) const;
+
+	// Closest point within Radius of Point, all in table space. Returns false if none.
+	bool FindNearest(const FVector& Point, float Radius, float& OutDistance, float& OutDistSq) const;
+
+	SIZE_T GetAllocatedSize() const { return Points.GetAllocatedSize() + Tangents.GetAllocatedSize() + Chunks.GetAllocatedSize(); }
+};
+
+/**
+ * Makes the owner's spline a zipline or grind rail. The detector finds it by proximity and the
+ * movement component rides it from the table, so a rider costs the same on any rail length.
+ * Keep rail actors uniformly scaled; distances are along the unscaled spline.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class KIWIJAM2025_API URideRailComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	URideRailComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	const FRailArcTable& GetTable() const { return Table; }
+	USplineComponent* GetSpline() const { return Spline; }
+
+	// Where the table's points are, follows the spline if the rail moves
+	FTransform GetRailTransform() const;
+
+	// Rider's actor location relative to the rail point, in world space
+	FVector GetRiderOffset(float CapsuleHalfHeight) const;
+
+	UPROPERTY(EditAnywhere, Category = "Rail")
+	ERideRailType Type = ERideRailType::Zipline;
+
+	// Table step. Smaller follows tight bends closer, at 24 bytes a sample.
+	UPROPERTY(EditAnywhere, Category = "Rail", meta = (ClampMin = "5"))
+	float SampleSpacing = 25.f;
+
+	// Hands to capsule centre for ziplines, rail to feet for grinds
+	UPROPERTY(EditAnywhere, Category = "Rail")
+	float RiderOffset = 100.f;
+
+	// Share of gravity along the slope that speeds the rider up
+	UPROPERTY(EditAnywhere, Category = "Rail|Speed")
+	float GravityScale = 1.f;
+
+	// Constant deceleration
+	UPROPERTY(EditAnywhere, Category = "Rail|Speed")
+	float Friction = 50.f;
+
+	// Quadratic deceleration, sets the terminal speed on long drops
+	UPROPERTY(EditAnywhere, Category = "Rail|Speed")
+	float Drag = 0.0004f;
+
+	// Input along the rail, for pumping a grind on the flat
+	UPROPERTY(EditAnywhere, Category = "Rail|Speed")
+	float PumpAcceleration = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Rail|Speed")
+	float MaxSpeed = 2000.f;
+
+	// Speed given on attach if the rider's own momentum along the rail is less
+	UPROPERTY(EditAnywhere, Category = "Rail|Speed")
+	float MinAttachSpeed = 200.f;
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<USplineComponent> Spline;
+
+	FRailArcTable Table;
+};
+
+/** A rider's place on a rail */
+struct FRailAttachment
+{
+	TWeakObjectPtr<URideRailComponent> Rail;
+	float Distance = 0.f;
+
+	bool IsValid() const { return Rail.IsValid(); }
+};
+
+/** Rails in the world, for the detector's proximity check */
+UCLASS()
+class KIWIJAM2025_API URideRailSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterRail(URideRailComponent* Rail);
+	void UnregisterRail(URideRailComponent* Rail);
+
+	// Nearest rail point within Radius of Location. Bounds then table chunks, no traces.
+	bool FindRail(const FVector& Location, float Radius, FRailAttachment& OutAttachment) const;
+
+	int32 GetNumRails() const { return Rails.Num(); }
+
+private:
+	TArray<TWeakObjectPtr<URideRailComponent>> Rails;
+};
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Character/ClimbableDetectorComponent.h"
+
+class UBodySetup;
+struct FHitResult;
+
+/** What a hit shape's cached boxes say about the obstacle at a hit, world space */
+struct FTraversalObstacle
+{
+	// Top of the solid column above the hit
+	float TopZ = 0.f;
+
+	// Thickness along the probe direction just under the top
+	float Depth = 0.f;
+
+	bool bFlatTop = false;
+
+	// Vaultable when thinner than the max vault depth, else Ledge on a flat top, else Wall
+	EClimbableSurfaceType SurfaceType = EClimbableSurfaceType::None;
+};
+
+/**
+ * Traversal shape of one body setup: its simple collision as oriented boxes (hulls, spheres
+ * and capsules become their bounding box), in the body's own space. Built on first use and
+ * shared by everything using the body setup, so every instance of a static mesh reads the
+ * same entry and only the query is transformed per hit. Game thread only.
+ */
+struct KIWIJAM2025_API FTraversalMeshInfo
+{
+	struct FShapeBox
+	{
+		FVector Center = FVector::ZeroVector;
+		FQuat InvRotation = FQuat::Identity;
+		FVector Extent = FVector::ZeroVector;
+
+		// Box axis closest to up, in body space, for the flat top test
+		FVector UpAxis = FVector::UpVector;
+	};
+
+	TArray<FShapeBox> Boxes;
+
+	/**
+	 * Cached info for the shape a hit landed on, with the transform from its body space to
+	 * world (per instance for instanced meshes). Null when the component has no body setup.
+	 * Off the game thread only entries already built are returned.
+	 */
+	static const FTraversalMeshInfo* FindForHit(const FHitResult& Hit, FTransform& OutToWorld);
+
+	// Builds the entry on first use. Game thread only.
+	static const FTraversalMeshInfo* Get(const UBodySetup* BodySetup);
+
+	// Existing entry or null, never builds. Safe from workers while nothing calls Get.
+	static const FTraversalMeshInfo* Find(const UBodySetup* BodySetup);
+
+	// Drops the entry so the next use rebuilds it, for body setups whose shapes change
+	static void Invalidate(const UBodySetup* BodySetup);
+
+	static void Reset();
+
+	/**
+	 * Solid column above ImpactPoint (inset along Forward) up to MaxRise, and its depth along
+	 * Forward under the top up to MaxDepth. Returns false if the hit isn't inside this shape or
+	 * the column runs past MaxRise.
+	 */
+	bool QueryObstacle(const FTransform& ToWorld, const FVector& ImpactPoint, const FVector& Forward, float MaxRise, float MaxDepth, float MaxVaultDepth, FTraversalObstacle& Out) const;
+
+	// Same answer a line trace against this shape alone would give
+	bool IntersectsSegment(const FTransform& ToWorld, const FVector& Start, const FVector& End) const;
+
+	SIZE_T GetAllocatedSize() const { return Boxes.GetAllocatedSize(); }
+
+private:
+	struct FInterval
+	{
+		float Enter = 0.f;
+		float Exit = 0.f;
+		int32 Box = INDEX_NONE;
+	};
+	using FIntervalArray = TArray<FInterval, TInlineAllocator<16>>;
+
+	void Build(const UBodySetup& BodySetup);
+
+	// Entry and exit of a world segment through each box as fractions of the segment, sorted by entry
+	void GetIntervals(const FTransform& ToWorld, const FVector& Start, const FVector& End, FIntervalArray& OutIntervals) const;
+
+	// End of the solid run starting at the segment start, as a fraction. Negative if the start isn't solid.
+	static float GetSolidRunEnd(const FIntervalArray& Intervals, float Tolerance, int32& OutLastBox);
+};
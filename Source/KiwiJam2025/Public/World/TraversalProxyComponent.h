@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "World/BuildingCollisionComponent.h"
+#include "TraversalProxyComponent.generated.h"
+
+/** Tuning for which box tops count as grabbable ledges */
+struct FTraversalLedgeRules
+{
+	// Narrowest top that can be stood on
+	float MinTopDepth = 30.f;
+
+	// Clear space needed above a top, roughly a crouched capsule
+	float MinHeadroom = 100.f;
+
+	// How far the top face may tilt from flat
+	float MaxTopTiltDegrees = 10.f;
+};
+
+/**
+ * Simplified box collision only traversal queries see. Ledge-capable tops and plain
+ * blockers go in separate components so a hit says which it is without extra lookups.
+ */
+UCLASS(ClassGroup = (Custom))
+class KIWIJAM2025_API UTraversalProxyComponent : public UBuildingCollisionComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTraversalProxyComponent(const FObjectInitializer& ObjectInitializer);
+
+	// Object type of the TraversalProxy collision profile, looked up once
+	static ECollisionChannel GetProxyObjectType();
+
+	bool IsLedgeCapable() const { return bLedgeCapable; }
+	void SetLedgeCapable(bool bInLedgeCapable) { bLedgeCapable = bInLedgeCapable; }
+
+	/**
+	 * Splits boxes into ones with a grabbable top and the rest. A top counts when it is near
+	 * flat, deep enough, and none of Occluders (which may include Boxes) starts within the
+	 * headroom above it. All boxes in the same space, Z up.
+	 */
+	static void SplitLedgeBoxes(const TArray<FKBoxElem>& Boxes, const TArray<FKBoxElem>& Occluders, const FTraversalLedgeRules& Rules,
+		TArray<FKBoxElem>& OutLedge, TArray<FKBoxElem>& OutBlocking);
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	bool bLedgeCapable = false;
+};
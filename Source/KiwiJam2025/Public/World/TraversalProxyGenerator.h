@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/EngineTypes.h"
+#include "World/TraversalProxyComponent.h"
+#include "TraversalProxyGenerator.generated.h"
+
+class AStaticMeshActor;
+
+/**
+ * Editor tool: bakes simplified traversal proxies for the level's prototyping and building
+ * meshes. Boxes come from each mesh's simple collision (convex hulls become their bounding
+ * box), ledge-capable tops are split out, and the result is saved on this actor.
+ * Buildings from ABuildingAssembler make their own proxies.
+ */
+UCLASS()
+class KIWIJAM2025_API ATraversalProxyGenerator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATraversalProxyGenerator();
+
+#if WITH_EDITOR
+	UFUNCTION(CallInEditor, Category = "Traversal")
+	void GenerateProxies();
+
+	UFUNCTION(CallInEditor, Category = "Traversal")
+	void ClearProxies();
+#endif
+
+	int32 GetNumProxyBoxes() const;
+
+private:
+#if WITH_EDITOR
+	bool IsSource(const AStaticMeshActor* Actor) const;
+
+	// Appends world-space boxes for the actor's mesh
+	void GatherBoxes(const AStaticMeshActor* Actor, TArray<FKBoxElem>& OutBoxes) const;
+
+	void AddProxy(TArray<FKBoxElem>&& WorldBoxes, bool bLedgeCapable);
+#endif
+
+	// Meshes under these folders are proxied
+	UPROPERTY(EditAnywhere, Category = "Traversal", meta = (LongPackageName))
+	TArray<FDirectoryPath> SourceMeshFolders;
+
+	// Actors with this tag are proxied whatever their mesh
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	FName SourceTag = TEXT("TraversalSource");
+
+	UPROPERTY(EditAnywhere, Category = "Traversal|Ledges")
+	float MinTopDepth = 30.f;
+
+	UPROPERTY(EditAnywhere, Category = "Traversal|Ledges")
+	float MinHeadroom = 100.f;
+
+	UPROPERTY(EditAnywhere, Category = "Traversal|Ledges")
+	float MaxTopTiltDegrees = 10.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal")
+	TArray<TObjectPtr<UTraversalProxyComponent>> ProxyComponents;
+};
@@ -27,13 +27,16 @@ AKiwiJam2025Character::AKiwiJam2025Character()
 	FirstPersonCameraComponent->SetRelativeLocation(FVector(-10.f, 0.f, 60.f)); // Position the camera
 	FirstPersonCameraComponent->bUsePawnControlRotation = true;
 
+#if !UE_SERVER
 	// Create a mesh component that will be used when being viewed from a '1st person' view (when controlling this pawn)
+	// Nothing replicates against it, so server builds leave it out along with the arms mesh and its anim blueprint
 	Mesh1P = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("CharacterMesh1P"));
 	Mesh1P->SetOnlyOwnerSee(true);
 	Mesh1P->SetupAttachment(FirstPersonCameraComponent);
 	Mesh1P->bCastDynamicShadow = false;
 	Mesh1P->CastShadow = false;
 	Mesh1P->SetRelativeLocation(FVector(-30.f, 0.f, -150.f));
+#endif
 
 }
 
@@ -2,13 +2,141 @@
 
 #include "KiwiJam2025GameMode.h"
 #include "KiwiJam2025Character.h"
-#include "UObject/ConstructorHelpers.h"
+#include "Core/MapLoadTimer.h"
+#include "Data/ParkourPawnData.h"
+#include "Player/ParkourPlayerState.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CoreDelegates.h"
 
 AKiwiJam2025GameMode::AKiwiJam2025GameMode()
 	: Super()
 {
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter"));
-	DefaultPawnClass = PlayerPawnClassFinder.Class;
+	// pawn data and pawn class are streamed in by InitGame
+	PawnDataId = FPrimaryAssetId(UParkourPawnData::PrimaryAssetType, TEXT("DA_DefaultPawnData"));
+	PawnClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter.BP_FirstPersonCharacter_C")));
 
+	// Replicates goal completions and splits
+	PlayerStateClass = AParkourPlayerState::StaticClass();
+}
+
+void AKiwiJam2025GameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+	if (PawnDataId.IsValid() && AssetManager.GetPrimaryAssetPath(PawnDataId).IsValid())
+	{
+		PawnDataHandle = AssetManager.LoadPrimaryAsset(PawnDataId, UParkourPawnData::GetBundlesFor(GetWorld()),
+			FStreamableDelegate::CreateUObject(this, &AKiwiJam2025GameMode::OnPawnDataLoaded));
+
+		// Handle is null when it was already resident
+		if (!PawnDataHandle.IsValid() || PawnDataHandle->HasLoadCompleted())
+		{
+			OnPawnDataLoaded();
+		}
+	}
+	else
+	{
+		LoadPawnClass();
+	}
+}
+
+void AKiwiJam2025GameMode::OnPawnDataLoaded()
+{
+	if (bPawnDataResolved) return;
+	bPawnDataResolved = true;
+
+	PawnData = UAssetManager::Get().GetPrimaryAssetObject<UParkourPawnData>(PawnDataId);
+	if (PawnData && !PawnData->PawnClass.IsNull())
+	{
+		PawnClass = PawnData->PawnClass;
+	}
+
+	if (const UMapLoadTimer* LoadTimer = GetGameInstance()->GetSubsystem<UMapLoadTimer>())
+	{
+		UE_LOG(LogMapLoad, Log, TEXT("Pawn data %s and its bundles ready %.2f ms after the map started loading"),
+			*PawnDataId.ToString(), LoadTimer->GetMsSinceLoadStart());
+	}
+
+	// Already resident when the pawn data set it, the Game bundle carries the class
+	LoadPawnClass();
+}
+
+void AKiwiJam2025GameMode::LoadPawnClass()
+{
+	if (!PawnClass.IsNull())
+	{
+		PawnClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PawnClass.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &AKiwiJam2025GameMode::OnPawnClassLoaded));
+	}
+
+	// Handle is null when it was already resident
+	if (!PawnClassHandle.IsValid() || PawnClassHandle->HasLoadCompleted())
+	{
+		OnPawnClassLoaded();
+	}
+}
+
+void AKiwiJam2025GameMode::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
+{
+	if (!bPawnClassReady)
+	{
+		// Spawned in OnPawnClassLoaded
+		PendingPlayers.AddUnique(NewPlayer);
+		return;
+	}
+
+	Super::HandleStartingNewPlayer_Implementation(NewPlayer);
+}
+
+void AKiwiJam2025GameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AKiwiJam2025GameMode::OnPawnClassLoaded()
+{
+	if (bPawnClassReady) return;
+	bPawnClassReady = true;
+
+	if (UClass* LoadedClass = PawnClass.Get())
+	{
+		DefaultPawnClass = LoadedClass;
+	}
+
+	if (const UMapLoadTimer* LoadTimer = GetGameInstance()->GetSubsystem<UMapLoadTimer>())
+	{
+		UE_LOG(LogMapLoad, Log, TEXT("Pawn class ready %.2f ms after the map started loading (pawn %s)"),
+			LoadTimer->GetMsSinceLoadStart(), *GetNameSafe(DefaultPawnClass));
+	}
+
+	// Measure the first rendered frame after the pawn exists
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &AKiwiJam2025GameMode::OnFirstFrameEnded);
+
+	TArray<TObjectPtr<APlayerController>> Players = MoveTemp(PendingPlayers);
+	for (APlayerController* PC : Players)
+	{
+		if (IsValid(PC))
+		{
+			HandleStartingNewPlayer(PC);
+		}
+	}
+}
+
+void AKiwiJam2025GameMode::OnFirstFrameEnded()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+
+	if (const UMapLoadTimer* LoadTimer = GetGameInstance()->GetSubsystem<UMapLoadTimer>())
+	{
+		const FPlatformMemoryStats MemStats = FPlatformMemory::GetStats();
+		UE_LOG(LogMapLoad, Log, TEXT("Time to first frame: %.2f ms, peak used physical: %.1f MB"),
+			LoadTimer->GetMsSinceLoadStart(), MemStats.PeakUsedPhysical / (1024.0 * 1024.0));
+	}
 }
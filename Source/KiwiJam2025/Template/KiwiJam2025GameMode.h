@@ -6,6 +6,9 @@
 #include "GameFramework/GameModeBase.h"
 #include "KiwiJam2025GameMode.generated.h"
 
+class UParkourPawnData;
+struct FStreamableHandle;
+
 UCLASS(minimalapi)
 class AKiwiJam2025GameMode : public AGameModeBase
 {
@@ -13,7 +16,45 @@ class AKiwiJam2025GameMode : public AGameModeBase
 
 public:
 	AKiwiJam2025GameMode();
-};
 
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** True once DefaultPawnClass is final and players can be spawned */
+	bool IsPawnClassReady() const { return bPawnClassReady; }
+
+	/** The pawn data with its bundles resident, null if none is registered or it is still loading */
+	const UParkourPawnData* GetPawnData() const { return PawnData; }
+
+protected:
+	/** Pawn data loaded with its Game (and, where something renders, UI) bundle from InitGame */
+	UPROPERTY(EditDefaultsOnly, Category = "Assets")
+	FPrimaryAssetId PawnDataId;
+
+	/** Pawn spawned for players when the pawn data doesn't set one, streamed in so the map load doesn't block on it */
+	UPROPERTY(EditDefaultsOnly, Category = "Assets")
+	TSoftClassPtr<APawn> PawnClass;
 
+private:
+	void OnPawnDataLoaded();
+	void LoadPawnClass();
+	void OnPawnClassLoaded();
+	void OnFirstFrameEnded();
 
+	UPROPERTY(Transient)
+	TObjectPtr<const UParkourPawnData> PawnData;
+
+	// Kept for the match so the bundles stay resident
+	TSharedPtr<FStreamableHandle> PawnDataHandle;
+	TSharedPtr<FStreamableHandle> PawnClassHandle;
+
+	/** Players that joined before the pawn class finished loading */
+	UPROPERTY()
+	TArray<TObjectPtr<APlayerController>> PendingPlayers;
+
+	bool bPawnDataResolved = false;
+	bool bPawnClassReady = false;
+
+	FDelegateHandle EndFrameHandle;
+};
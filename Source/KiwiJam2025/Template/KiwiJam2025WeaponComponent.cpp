@@ -12,6 +12,7 @@
 #include "Animation/AnimInstance.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
+#include "Audio/ParkourAudio.h"
 
 // Sets default values for this component's properties
 UKiwiJam2025WeaponComponent::UKiwiJam2025WeaponComponent()
@@ -48,14 +49,18 @@ void UKiwiJam2025WeaponComponent::Fire()
 		}
 	}
 	
-	// Try and play the sound if specified
-	if (FireSound != nullptr)
+	// Try and play the sound if specified, through the pooled audio layer when it's up
+	if (FireSound != nullptr && !UParkourAudioSubsystem::Play(GetWorld(), EParkourAudioEvent::WeaponFire, Character->GetActorLocation(), SurfaceType_Default, FireSound))
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, Character->GetActorLocation());
+		const UParkourAudioSubsystem* Audio = GetWorld()->GetSubsystem<UParkourAudioSubsystem>();
+		if (!Audio || !Audio->IsReady())
+		{
+			UGameplayStatics::PlaySoundAtLocation(this, FireSound, Character->GetActorLocation());
+		}
 	}
 	
 	// Try and play a firing animation if specified
-	if (FireAnimation != nullptr)
+	if (FireAnimation != nullptr && Character->GetMesh1P() != nullptr)
 	{
 		// Get the animation object for the arms mesh
 		UAnimInstance* AnimInstance = Character->GetMesh1P()->GetAnimInstance();
@@ -78,7 +83,15 @@ bool UKiwiJam2025WeaponComponent::AttachWeapon(AKiwiJam2025Character* TargetChar
 
 	// Attach the weapon to the First Person Character
 	FAttachmentTransformRules AttachmentRules(EAttachmentRule::SnapToTarget, true);
-	AttachToComponent(Character->GetMesh1P(), AttachmentRules, FName(TEXT("GripPoint")));
+	// Server builds have no arms, the weapon rides the capsule there
+	if (Character->GetMesh1P() != nullptr)
+	{
+		AttachToComponent(Character->GetMesh1P(), AttachmentRules, FName(TEXT("GripPoint")));
+	}
+	else
+	{
+		AttachToComponent(Character->GetRootComponent(), AttachmentRules);
+	}
 
 	// Set up action bindings
 	if (APlayerController* PlayerController = Cast<APlayerController>(Character->GetController()))
@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/ParkourHUDSubsystem.h"
+#include "UI/ParkourUIDelegates.h"
+#include "UI/TraversalPromptWidget.h"
+#include "UI/WorldMapWidget.h"
+#include "Character/ParkourCharacter.h"
+#include "GoalManifestSubsystem.h"
+#include "World/ExplorationGrid.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+
+bool UParkourHUDSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UParkourHUDSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    ReadyHandle = FParkourUIDelegates::OnLocalCharacterReady.AddUObject(this, &UParkourHUDSubsystem::HandleLocalCharacterReady);
+    ToggleMapHandle = FParkourUIDelegates::OnToggleMap.AddUObject(this, &UParkourHUDSubsystem::HandleToggleMap);
+
+    GoalManifest = Collection.InitializeDependency<UGoalManifestSubsystem>();
+    if (GoalManifest)
+    {
+        GoalsChangedHandle = GoalManifest->OnGoalsChanged.AddUObject(this, &UParkourHUDSubsystem::SyncMarkers);
+        RouteChangedHandle = GoalManifest->OnRouteChanged.AddUObject(this, &UParkourHUDSubsystem::SyncRoute);
+    }
+}
+
+void UParkourHUDSubsystem::Deinitialize()
+{
+    FParkourUIDelegates::OnLocalCharacterReady.Remove(ReadyHandle);
+    FParkourUIDelegates::OnToggleMap.Remove(ToggleMapHandle);
+
+    if (GoalManifest)
+    {
+        GoalManifest->OnGoalsChanged.Remove(GoalsChangedHandle);
+        GoalManifest->OnRouteChanged.Remove(RouteChangedHandle);
+    }
+
+    Markers.Reset();
+    WorldMapWidget = nullptr;
+    TraversalPromptWidget = nullptr;
+
+    Super::Deinitialize();
+}
+
+void UParkourHUDSubsystem::HandleLocalCharacterReady(AParkourCharacter& Character)
+{
+    // The delegates are global, PIE runs several worlds off them
+    if (Character.GetWorld() != GetWorld()) return;
+
+    ShowTraversalPrompt(Character);
+}
+
+void UParkourHUDSubsystem::ShowTraversalPrompt(AParkourCharacter& Character)
+{
+    // Respawned pawn, same prompt on its detector
+    if (TraversalPromptWidget)
+    {
+        TraversalPromptWidget->BindToDetector(Character.GetClimbableDetector());
+        return;
+    }
+
+    APlayerController* PC = Cast<APlayerController>(Character.GetController());
+    const TSoftClassPtr<UObject>& PromptClassPtr = Character.GetTraversalPromptWidgetClass();
+    if (!PC || !PC->IsLocalController() || PromptClassPtr.IsNull()) return;
+
+    UClass* PromptClass = PromptClassPtr.Get();
+    if (!PromptClass)
+    {
+        TWeakObjectPtr<UParkourHUDSubsystem> WeakThis(this);
+        TWeakObjectPtr<AParkourCharacter> WeakCharacter(&Character);
+        UAssetManager::GetStreamableManager().RequestAsyncLoad(PromptClassPtr.ToSoftObjectPath(), [WeakThis, WeakCharacter]()
+            {
+                if (WeakThis.IsValid() && WeakCharacter.IsValid() && WeakCharacter->GetTraversalPromptWidgetClass().Get())
+                {
+                    WeakThis->ShowTraversalPrompt(*WeakCharacter);
+                }
+            });
+        return;
+    }
+    if (!PromptClass->IsChildOf<UTraversalPromptWidget>()) return;
+
+    TraversalPromptWidget = CreateWidget<UTraversalPromptWidget>(PC, PromptClass);
+    if (TraversalPromptWidget)
+    {
+        TraversalPromptWidget->BindToDetector(Character.GetClimbableDetector());
+        TraversalPromptWidget->AddToViewport();
+    }
+}
+
+void UParkourHUDSubsystem::HandleToggleMap(AParkourCharacter& Character)
+{
+    if (Character.GetWorld() != GetWorld()) return;
+
+    if (bMapOpen)
+    {
+        if (WorldMapWidget)
+        {
+            WorldMapWidget->RemoveFromParent();
+        }
+        bMapOpen = false;
+        if (GoalManifest)
+        {
+            GoalManifest->SetMapOpen(false);
+        }
+        return;
+    }
+
+    const TSoftClassPtr<UObject>& MapClass = Character.GetWorldMapWidgetClass();
+    if (MapClass.Get())
+    {
+        OpenMap(Character);
+    }
+    else if (!MapClass.IsNull())
+    {
+        // Still streaming, open once it lands rather than hitching on a sync load
+        TWeakObjectPtr<UParkourHUDSubsystem> WeakThis(this);
+        TWeakObjectPtr<AParkourCharacter> WeakCharacter(&Character);
+        UAssetManager::GetStreamableManager().RequestAsyncLoad(MapClass.ToSoftObjectPath(), [WeakThis, WeakCharacter]()
+            {
+                if (WeakThis.IsValid() && WeakCharacter.IsValid() && !WeakThis->bMapOpen)
+                {
+                    WeakThis->OpenMap(*WeakCharacter);
+                }
+            });
+    }
+}
+
+void UParkourHUDSubsystem::OpenMap(AParkourCharacter& Character)
+{
+    APlayerController* PC = Cast<APlayerController>(Character.GetController());
+    UClass* MapClass = Character.GetWorldMapWidgetClass().Get();
+    if (!PC || !MapClass || !MapClass->IsChildOf<UWorldMapWidget>()) return;
+
+    if (!WorldMapWidget)
+    {
+        WorldMapWidget = CreateWidget<UWorldMapWidget>(PC, MapClass);
+        if (!WorldMapWidget) return;
+
+        // Same area exploration is tracked over, so the fog lines up
+        FBox MapBounds(FVector(-2000, -2000, 0), FVector(2000, 2000, 0));
+        if (UExplorationSubsystem* Exploration = GetWorld()->GetSubsystem<UExplorationSubsystem>())
+        {
+            MapBounds = Exploration->GetMapBounds();
+        }
+        WorldMapWidget->SetWorldBounds(MapBounds);
+
+        // Goal markers come from the manifest so goals in unloaded cells still show
+        SyncMarkers();
+        SyncRoute();
+    }
+
+    WorldMapWidget->AddToViewport();
+    bMapOpen = true;
+
+    // Fresh route from where we are, drawn when the solver finishes
+    if (GoalManifest)
+    {
+        GoalManifest->SetMapOpen(true);
+        GoalManifest->RequestRoute(Character.GetActorLocation(), Character.GetCharacterMovement()->MaxWalkSpeed);
+    }
+}
+
+void UParkourHUDSubsystem::SyncMarkers()
+{
+    if (!WorldMapWidget || !GoalManifest) return;
+
+    const TSoftClassPtr<UObject>& MarkerClassPtr = GoalManifest->GetMarkerClass();
+    UClass* MarkerClass = MarkerClassPtr.Get();
+    if (!MarkerClass)
+    {
+        if (!MarkerClassPtr.IsNull())
+        {
+            TWeakObjectPtr<UParkourHUDSubsystem> WeakThis(this);
+            UAssetManager::GetStreamableManager().RequestAsyncLoad(MarkerClassPtr.ToSoftObjectPath(), [WeakThis]()
+                {
+                    if (WeakThis.IsValid())
+                    {
+                        WeakThis->SyncMarkers();
+                    }
+                });
+        }
+        return;
+    }
+
+    APlayerController* PC = WorldMapWidget->GetOwningPlayer();
+    if (!PC || !MarkerClass->IsChildOf<UUserWidget>()) return;
+
+    for (const FGoalRuntimeState& State : GoalManifest->GetGoals())
+    {
+        if (State.bActive && !Markers.Contains(State.GoalId))
+        {
+            if (UUserWidget* Marker = CreateWidget<UUserWidget>(PC, MarkerClass))
+            {
+                WorldMapWidget->AddMarkerPersistent(Marker, State.Location);
+                Markers.Add(State.GoalId, Marker);
+            }
+        }
+        else if (!State.bActive)
+        {
+            TObjectPtr<UUserWidget> Marker;
+            if (Markers.RemoveAndCopyValue(State.GoalId, Marker))
+            {
+                WorldMapWidget->RemoveMarker(Marker);
+            }
+        }
+    }
+}
+
+void UParkourHUDSubsystem::SyncRoute()
+{
+    if (!WorldMapWidget || !GoalManifest) return;
+
+    const TArray<FVector>& Route = GoalManifest->GetRoute();
+    if (Route.Num() > 0)
+    {
+        WorldMapWidget->SetRoute(Route);
+    }
+    else
+    {
+        WorldMapWidget->ClearRoute();
+    }
+}
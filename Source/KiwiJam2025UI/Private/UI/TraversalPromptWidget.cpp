@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/TraversalPromptWidget.h"
+#include "Components/TextBlock.h"
+
+void UTraversalPromptWidget::BindToDetector(UClimbableDetectorComponent* Detector)
+{
+    if (UClimbableDetectorComponent* Previous = BoundDetector.Get())
+    {
+        Previous->OnAffordanceChanged.RemoveDynamic(this, &UTraversalPromptWidget::SetAffordance);
+    }
+
+    BoundDetector = Detector;
+    if (Detector)
+    {
+        Detector->OnAffordanceChanged.AddUniqueDynamic(this, &UTraversalPromptWidget::SetAffordance);
+    }
+    SetAffordance(Detector ? Detector->GetCurrentAffordance() : EClimbableSurfaceType::None);
+}
+
+void UTraversalPromptWidget::SetAffordance(EClimbableSurfaceType Affordance)
+{
+    const bool bVault = Affordance == EClimbableSurfaceType::Vaultable;
+    const bool bClimb = Affordance == EClimbableSurfaceType::Ledge || Affordance == EClimbableSurfaceType::Climbable;
+    const bool bRail = Affordance == EClimbableSurfaceType::Rail;
+
+    if (PromptText && (bVault || bClimb || bRail))
+    {
+        PromptText->SetText(bVault ? VaultPrompt : bRail ? RailPrompt : ClimbPrompt);
+    }
+    SetVisibility((bVault || bClimb || bRail) ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+
+    OnAffordanceChanged(Affordance);
+}
+
+void UTraversalPromptWidget::NativeDestruct()
+{
+    if (UClimbableDetectorComponent* Detector = BoundDetector.Get())
+    {
+        Detector->OnAffordanceChanged.RemoveDynamic(this, &UTraversalPromptWidget::SetAffordance);
+    }
+    BoundDetector.Reset();
+
+    Super::NativeDestruct();
+}
@@ -0,0 +1,279 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/WorldMapWidget.h"
+#include "Components/Image.h"
+#include "Components/CanvasPanel.h"
+#include "Components/CanvasPanelSlot.h"
+#include "Rendering/DrawElements.h"
+#include "Engine/Texture2D.h"
+#include "World/ExplorationGrid.h"
+
+void UWorldMapWidget::SetWorldBounds(const FBox& InBounds)
+{
+	WorldBounds = InBounds;
+}
+
+FVector2D UWorldMapWidget::WorldToMapPosition(const FVector& WorldLocation) const
+{
+    if (!MarkerCanvas) return FVector2D::ZeroVector;
+
+    FVector2D MapSize = MarkerCanvas->GetCachedGeometry().GetLocalSize();
+
+    float NormalizedX = (WorldLocation.X - WorldBounds.Min.X) / (WorldBounds.Max.X - WorldBounds.Min.X);
+    float NormalizedY = (WorldLocation.Y - WorldBounds.Min.Y) / (WorldBounds.Max.Y - WorldBounds.Min.Y);
+
+    // Flip Y because UI Y grows downward
+    //NormalizedY = 1.f - NormalizedY;
+
+    float MapPosX = NormalizedX * MapSize.X;
+    float MapPosY = (NormalizedY) * MapSize.Y;
+
+    return FVector2D(MapPosX, MapPosY);
+}
+
+void UWorldMapWidget::AddMarkerPersistent(UUserWidget* MarkerWidget, const FVector& WorldLocation)
+{
+    if (!MarkerWidget) return;
+
+    PersistentMarkers.Add(FWorldMapMarker(MarkerWidget, WorldLocation));
+    UE_LOG(LogTemp, Warning, TEXT("Added Marker to array at %s"), *WorldLocation.ToString());
+    // If map is open, add immediately
+    if (MarkerCanvas && !MarkerCanvas->HasChild(MarkerWidget))
+    {
+        MarkerCanvas->AddChild(MarkerWidget);
+        UE_LOG(LogTemp, Warning, TEXT("Added Marker at %s"), *WorldLocation.ToString());
+    }
+}
+
+void UWorldMapWidget::RemoveMarker(UUserWidget* MarkerWidget)
+{
+    if (!MarkerWidget) return;
+
+    // Remove from UI
+    if (MarkerCanvas && MarkerCanvas->HasChild(MarkerWidget))
+    {
+        MarkerCanvas->RemoveChild(MarkerWidget);
+    }
+
+    // Remove from persistent array
+    PersistentMarkers.RemoveAll([MarkerWidget](const FWorldMapMarker& Marker)
+        {
+            return Marker.Widget == MarkerWidget;
+        });
+}
+
+void UWorldMapWidget::SetZoom(float NewZoom)
+{
+    ZoomLevel = FMath::Clamp(NewZoom, 0.5f, 4.0f); // Limit zoom range
+    if (MapImage)
+    {
+        UCanvasPanelSlot* MapSlot = Cast<UCanvasPanelSlot>(MapImage->Slot);
+        if (MapSlot)
+        {
+            MapSlot->SetSize(CachedMapSize * ZoomLevel);
+        }
+    }
+}
+
+void UWorldMapWidget::SetRoute(const TArray<FVector>& WorldPoints)
+{
+    RoutePoints = WorldPoints;
+}
+
+void UWorldMapWidget::ClearRoute()
+{
+    RoutePoints.Reset();
+}
+
+void UWorldMapWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+	UpdateMapSize();
+
+    UE_LOG(LogTemp, Warning, TEXT("Called"));
+
+    // When map opens, add all markers to the canvas
+    for (FWorldMapMarker& Marker : PersistentMarkers)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Marker"));
+        if (Marker.Widget && !MarkerCanvas->HasChild(Marker.Widget))
+        {
+            MarkerCanvas->AddChild(Marker.Widget);
+            UE_LOG(LogTemp, Warning, TEXT("Added Marker at %s"), *Marker.WorldLocation.ToString());
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Invalid"));
+        }
+    }
+}
+
+
+void UWorldMapWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+	UpdateMapSize(); // Ensure map size is always correct
+    UpdateMarkerPositions();
+    UpdateFogTexture();
+}
+
+void UWorldMapWidget::UpdateFogTexture()
+{
+    UExplorationSubsystem* Exploration = GetWorld() ? GetWorld()->GetSubsystem<UExplorationSubsystem>() : nullptr;
+    if (!Exploration || !Exploration->GetGrid().IsValid()) return;
+
+    const FExplorationGrid& Grid = Exploration->GetGrid();
+    Exploration->TakeDirtyTiles(FogDirtyTiles);
+
+    // New grid or first open: a fresh mask, every tile uploaded
+    const int32 Downsample = FogTexture ? FogDownsample : Exploration->GetMaskDownsample();
+    const int32 MaskWidth = Grid.Width / Downsample;
+    const int32 MaskHeight = Grid.Height / Downsample;
+    if (!FogTexture || FogTexture->GetSizeX() != MaskWidth || FogTexture->GetSizeY() != MaskHeight)
+    {
+        FogTexture = UTexture2D::CreateTransient(MaskWidth, MaskHeight, PF_A8, TEXT("WorldMapFog"));
+        if (!FogTexture) return;
+
+        FogTexture->SRGB = false;
+        FogTexture->Filter = TF_Bilinear;
+        FogTexture->AddressX = TA_Clamp;
+        FogTexture->AddressY = TA_Clamp;
+        FogTexture->UpdateResource();
+
+        FogBrush.SetResourceObject(FogTexture);
+        FogBrush.ImageSize = FVector2D(MaskWidth, MaskHeight);
+        FogBrush.DrawAs = ESlateBrushDrawType::Image;
+
+        FogDownsample = Downsample;
+        FogWorldBounds = Grid.GetWorldBounds();
+        FogDirtyTiles.Init(true, Grid.GetTilesX() * Grid.GetTilesY());
+    }
+
+    const int32 NumDirty = FogDirtyTiles.CountSetBits();
+    if (NumDirty == 0) return;
+
+    // Dirty tiles side by side in one strip, one region each. The render thread frees both.
+    const int32 TileTexels = FExplorationGrid::TileCells / Downsample;
+    const int32 StripPitch = NumDirty * TileTexels;
+    uint8* Strip = (uint8*)FMemory::Malloc(StripPitch * TileTexels);
+    FUpdateTextureRegion2D* Regions = new FUpdateTextureRegion2D[NumDirty];
+
+    const int32 TilesX = Grid.GetTilesX();
+    int32 NumRegions = 0;
+    for (TConstSetBitIterator<> It(FogDirtyTiles); It; ++It)
+    {
+        const int32 TileX = It.GetIndex() % TilesX;
+        const int32 TileY = It.GetIndex() / TilesX;
+        Grid.BuildMaskTile(TileX, TileY, Downsample, Strip + NumRegions * TileTexels, StripPitch);
+        Regions[NumRegions] = FUpdateTextureRegion2D(TileX * TileTexels, TileY * TileTexels, NumRegions * TileTexels, 0, TileTexels, TileTexels);
+        ++NumRegions;
+    }
+
+    FogTexture->UpdateTextureRegions(0, NumRegions, Regions, StripPitch, 1, Strip,
+        [](uint8* SrcData, const FUpdateTextureRegion2D* SrcRegions)
+        {
+            FMemory::Free(SrcData);
+            delete[] SrcRegions;
+        });
+}
+
+void UWorldMapWidget::UpdateMapSize()
+{
+    if (MapImage)
+    {
+        // Cache current size
+        CachedMapSize = MapImage->GetCachedGeometry().GetLocalSize();
+    }
+}
+
+void UWorldMapWidget::UpdateMarkerPositions()
+{
+    for (FWorldMapMarker& Marker : PersistentMarkers)
+    {
+        if (Marker.Widget && MarkerCanvas)
+        {
+            FVector2D MapPos = WorldToMapPosition(Marker.WorldLocation);
+
+            if (UCanvasPanelSlot* CanvasSlot = Cast<UCanvasPanelSlot>(Marker.Widget->Slot))
+            {
+                CanvasSlot->SetPosition(MapPos);
+                CanvasSlot->SetAlignment(FVector2D(0.5f, 0.5f)); // Center the icon
+                CanvasSlot->SetAutoSize(false);
+                CanvasSlot->SetSize(FVector2D(32.f, 32.f));
+            }
+        }
+    }
+}
+
+int32 UWorldMapWidget::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+    FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+    int32 MaxLayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+    if (!MarkerCanvas) return MaxLayerId;
+
+    // Map positions are in the marker canvas' space, the fog and line are drawn in ours
+    const FGeometry& CanvasGeometry = MarkerCanvas->GetCachedGeometry();
+
+    // Fog over the map and goal markers, one textured quad
+    if (FogTexture)
+    {
+        const FVector2D FogTopLeft = AllottedGeometry.AbsoluteToLocal(CanvasGeometry.LocalToAbsolute(WorldToMapPosition(FVector(FogWorldBounds.Min, 0.f))));
+        const FVector2D FogBottomRight = AllottedGeometry.AbsoluteToLocal(CanvasGeometry.LocalToAbsolute(WorldToMapPosition(FVector(FogWorldBounds.Max, 0.f))));
+
+        ++MaxLayerId;
+        FSlateDrawElement::MakeBox(OutDrawElements, MaxLayerId, AllottedGeometry.ToPaintGeometry(FogBottomRight - FogTopLeft, FSlateLayoutTransform(FogTopLeft)),
+            &FogBrush, ESlateDrawEffect::None, FLinearColor(0.f, 0.f, 0.f, FogOpacity) * InWidgetStyle.GetColorAndOpacityTint());
+    }
+
+    // Trails over the fog, each one line element however long
+    if (const UExplorationSubsystem* Exploration = GetWorld() ? GetWorld()->GetSubsystem<UExplorationSubsystem>() : nullptr)
+    {
+        const FLinearColor Tint = InWidgetStyle.GetColorAndOpacityTint();
+        const int32 TrailLayer = MaxLayerId + 1;
+
+        const FBreadcrumbTrail& Trail = Exploration->GetTrail();
+        if (Trail.Num() >= 2)
+        {
+            TrailPaintPoints.Reset(Trail.Num());
+            for (int32 i = 0; i < Trail.Num(); ++i)
+            {
+                TrailPaintPoints.Add(AllottedGeometry.AbsoluteToLocal(CanvasGeometry.LocalToAbsolute(WorldToMapPosition(FVector(Trail.GetPoint(i).Location)))));
+            }
+            FSlateDrawElement::MakeLines(OutDrawElements, TrailLayer, AllottedGeometry.ToPaintGeometry(), TrailPaintPoints,
+                ESlateDrawEffect::None, TrailColor * Tint, true, TrailThickness);
+            MaxLayerId = TrailLayer;
+        }
+
+        if (const FBreadcrumbTrail* Ghost = Exploration->GetGhost())
+        {
+            const float GhostTime = Exploration->GetGhostTime();
+            TrailPaintPoints.Reset(Ghost->Num());
+            for (int32 i = 0; i < Ghost->Num() && Ghost->GetPoint(i).Time < GhostTime; ++i)
+            {
+                TrailPaintPoints.Add(AllottedGeometry.AbsoluteToLocal(CanvasGeometry.LocalToAbsolute(WorldToMapPosition(FVector(Ghost->GetPoint(i).Location)))));
+            }
+            TrailPaintPoints.Add(AllottedGeometry.AbsoluteToLocal(CanvasGeometry.LocalToAbsolute(WorldToMapPosition(Ghost->SampleAtTime(GhostTime)))));
+            if (TrailPaintPoints.Num() >= 2)
+            {
+                FSlateDrawElement::MakeLines(OutDrawElements, TrailLayer, AllottedGeometry.ToPaintGeometry(), TrailPaintPoints,
+                    ESlateDrawEffect::None, GhostTrailColor * Tint, true, TrailThickness);
+                MaxLayerId = TrailLayer;
+            }
+        }
+    }
+
+    if (RoutePoints.Num() < 2) return MaxLayerId;
+
+    RoutePaintPoints.Reset(RoutePoints.Num());
+    for (const FVector& Point : RoutePoints)
+    {
+        RoutePaintPoints.Add(AllottedGeometry.AbsoluteToLocal(CanvasGeometry.LocalToAbsolute(WorldToMapPosition(Point))));
+    }
+
+    // Whole route in one element, over the markers
+    FSlateDrawElement::MakeLines(OutDrawElements, MaxLayerId + 1, AllottedGeometry.ToPaintGeometry(), RoutePaintPoints,
+        ESlateDrawEffect::None, RouteColor * InWidgetStyle.GetColorAndOpacityTint(), true, RouteThickness);
+
+    return MaxLayerId + 1;
+}
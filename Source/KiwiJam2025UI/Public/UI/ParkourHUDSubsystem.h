@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParkourHUDSubsystem.generated.h"
+
+class AParkourCharacter;
+class UGoalManifestSubsystem;
+class UTraversalPromptWidget;
+class UUserWidget;
+class UWorldMapWidget;
+
+/**
+ * Owns the local player's HUD widgets: the traversal prompt and the world map with its goal
+ * markers and route. Driven by FParkourUIDelegates from the character and by the goal
+ * manifest's change delegates. Not created on dedicated servers.
+ */
+UCLASS()
+class KIWIJAM2025UI_API UParkourHUDSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UWorldMapWidget* GetWorldMapWidget() const { return WorldMapWidget; }
+
+private:
+	void HandleLocalCharacterReady(AParkourCharacter& Character);
+	void HandleToggleMap(AParkourCharacter& Character);
+
+	void ShowTraversalPrompt(AParkourCharacter& Character);
+	void OpenMap(AParkourCharacter& Character);
+
+	// Adds markers for active goals and drops the ones reached since
+	void SyncMarkers();
+	void SyncRoute();
+
+	FDelegateHandle ReadyHandle;
+	FDelegateHandle ToggleMapHandle;
+	FDelegateHandle GoalsChangedHandle;
+	FDelegateHandle RouteChangedHandle;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UGoalManifestSubsystem> GoalManifest;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UWorldMapWidget> WorldMapWidget;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UTraversalPromptWidget> TraversalPromptWidget;
+
+	// One per active goal, streamed in or not
+	UPROPERTY(Transient)
+	TMap<FGuid, TObjectPtr<UUserWidget>> Markers;
+
+	bool bMapOpen = false;
+};
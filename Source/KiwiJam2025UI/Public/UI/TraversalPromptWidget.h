@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Character/ClimbableDetectorComponent.h"
+#include "TraversalPromptWidget.generated.h"
+
+class UTextBlock;
+
+/**
+ * "Vault" / "Climb" prompt. Follows the affordance the detector publishes from its
+ * continuous scan and hides itself when nothing is in reach.
+ */
+UCLASS()
+class KIWIJAM2025UI_API UTraversalPromptWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	void BindToDetector(UClimbableDetectorComponent* Detector);
+
+	UFUNCTION()
+	void SetAffordance(EClimbableSurfaceType Affordance);
+
+protected:
+	virtual void NativeDestruct() override;
+
+	// Hook for styling or animation in UMG, after the text is set
+	UFUNCTION(BlueprintImplementableEvent, Category = "Traversal")
+	void OnAffordanceChanged(EClimbableSurfaceType Affordance);
+
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	FText VaultPrompt = NSLOCTEXT("Traversal", "VaultPrompt", "Vault");
+
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	FText ClimbPrompt = NSLOCTEXT("Traversal", "ClimbPrompt", "Climb");
+
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	FText RailPrompt = NSLOCTEXT("Traversal", "RailPrompt", "Grab");
+
+private:
+	UPROPERTY(meta = (BindWidgetOptional))
+	TObjectPtr<UTextBlock> PromptText;
+
+	TWeakObjectPtr<UClimbableDetectorComponent> BoundDetector;
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "WorldMapWidget.generated.h"
+
+
+class UImage;
+class UCanvasPanel;
+class UCanvasPanelSlot;
+class UTexture2D; 
+
+USTRUCT()
+struct FWorldMapMarker
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UUserWidget* Widget;
+
+    FVector WorldLocation;
+
+    FWorldMapMarker() : Widget(nullptr), WorldLocation(FVector::ZeroVector) {}
+    FWorldMapMarker(UUserWidget* InWidget, const FVector& InLocation)
+        : Widget(InWidget), WorldLocation(InLocation) {
+    }
+};
+
+/**
+ * 
+ */
+UCLASS()
+class KIWIJAM2025UI_API UWorldMapWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:	
+    // Sets the bounds of the playable area (for position normalization)
+    UFUNCTION(BlueprintCallable, Category = "World Map")
+    void SetWorldBounds(const FBox& InBounds);
+
+    // Converts world position to UI map position
+    UFUNCTION(BlueprintCallable, Category = "World Map")
+    FVector2D WorldToMapPosition(const FVector& WorldLocation) const;
+
+    
+    UFUNCTION(BlueprintCallable)
+    void AddMarkerPersistent(UUserWidget* MarkerWidget, const FVector& WorldLocation);
+
+    UFUNCTION(BlueprintCallable)
+    void RemoveMarker(UUserWidget* MarkerWidget);
+
+    // Set zoom level (1.0 = normal, >1 = zoom in)
+    UFUNCTION(BlueprintCallable, Category = "World Map")
+    void SetZoom(float NewZoom);
+
+    // Suggested route through the goals, world space, drawn as one line over the map
+    UFUNCTION(BlueprintCallable, Category = "World Map")
+    void SetRoute(const TArray<FVector>& WorldPoints);
+
+    UFUNCTION(BlueprintCallable, Category = "World Map")
+    void ClearRoute();
+
+protected:
+    virtual void NativeConstruct() override;
+    virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+    virtual int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+        FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+private:
+    // Widgets bound from UMG
+    UPROPERTY(meta = (BindWidget))
+    UImage* MapImage;
+
+    UPROPERTY(meta = (BindWidget))
+    UCanvasPanel* MarkerCanvas;
+
+    UPROPERTY()
+    TArray<FWorldMapMarker> PersistentMarkers;
+
+    UPROPERTY(EditAnywhere, Category = "World Map|Route")
+    FLinearColor RouteColor = FLinearColor(1.f, 0.75f, 0.1f, 0.9f);
+
+    UPROPERTY(EditAnywhere, Category = "World Map|Route")
+    float RouteThickness = 2.f;
+
+    TArray<FVector> RoutePoints;
+
+    // Scratch for painting, reused so drawing the route doesn't allocate
+    mutable TArray<FVector2D> RoutePaintPoints;
+
+    // This run's path, from the exploration subsystem's breadcrumb trail
+    UPROPERTY(EditAnywhere, Category = "World Map|Trail")
+    FLinearColor TrailColor = FLinearColor(0.2f, 0.8f, 1.f, 0.8f);
+
+    // A replayed trail, drawn up to where its playback has got to
+    UPROPERTY(EditAnywhere, Category = "World Map|Trail")
+    FLinearColor GhostTrailColor = FLinearColor(1.f, 1.f, 1.f, 0.5f);
+
+    UPROPERTY(EditAnywhere, Category = "World Map|Trail")
+    float TrailThickness = 2.f;
+
+    mutable TArray<FVector2D> TrailPaintPoints;
+
+    // Unexplored ground is covered in black at this opacity
+    UPROPERTY(EditAnywhere, Category = "World Map|Fog")
+    float FogOpacity = 0.9f;
+
+    // Alpha-only mask mirroring the exploration grid, patched a tile at a time
+    UPROPERTY(Transient)
+    TObjectPtr<UTexture2D> FogTexture;
+
+    FSlateBrush FogBrush;
+
+    // World area the mask covers, the grid's whole tiles
+    FBox2D FogWorldBounds;
+
+    int32 FogDownsample = 1;
+
+    TBitArray<> FogDirtyTiles;
+
+    void UpdateFogTexture();
+
+    // Data
+    FBox WorldBounds;
+    float ZoomLevel = 1.0f;
+
+    FVector2D CachedMapSize;
+
+    void UpdateMapSize();
+    void UpdateMarkerPositions();
+
+};